@@ -0,0 +1,89 @@
+#include "adxl345_fifo.h"
+
+float adxl345RateHz(Adxl345Rate rate) {
+  // Each BW_RATE step doubles the rate; code 0x0A is 100 Hz
+  return 100.0f * (float)(1 << ((int)rate - (int)ADXL345_ODR_100_HZ));
+}
+
+Adxl345Fifo::Adxl345Fifo(Adxl345Bus& bus)
+  : bus(bus), rateHz(0), streaming(false),
+    overruns(0), samples(0), busErrors(0), maxLevel(0) {
+}
+
+bool Adxl345Fifo::begin(Adxl345Rate rate, uint8_t watermark) {
+  if (watermark == 0 || watermark >= ADXL345_FIFO_DEPTH) watermark = ADXL345_FIFO_DEPTH / 2;
+
+  // Measurement must be stopped while the FIFO mode changes, and switching
+  // through bypass flushes whatever was left in the FIFO
+  bool ok = bus.writeRegister(ADXL345_REG_POWER_CTL, 0x00);
+  ok = ok && bus.writeRegister(ADXL345_REG_BW_RATE, (uint8_t)rate);
+  ok = ok && bus.writeRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_MODE_BYPASS);
+  ok = ok && bus.writeRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_MODE_STREAM | (watermark & 0x1F));
+  ok = ok && bus.writeRegister(ADXL345_REG_POWER_CTL, 0x08); // Measure bit
+
+  if (!ok) {
+    busErrors++;
+    streaming = false;
+    return false;
+  }
+
+  rateHz = adxl345RateHz(rate);
+  streaming = true;
+  return true;
+}
+
+bool Adxl345Fifo::stop() {
+  streaming = false;
+  if (!bus.writeRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_MODE_BYPASS)) {
+    busErrors++;
+    return false;
+  }
+  return true;
+}
+
+size_t Adxl345Fifo::drain(RawSample* out, size_t maxSamples) {
+  if (!streaming) return 0;
+
+  // The overrun flag stays set until the FIFO has been read, so sample it first
+  uint8_t intSource = 0;
+  uint8_t fifoStatus = 0;
+  if (!bus.readRegisters(ADXL345_REG_INT_SOURCE, &intSource, 1) ||
+      !bus.readRegisters(ADXL345_REG_FIFO_STATUS, &fifoStatus, 1)) {
+    busErrors++;
+    return 0;
+  }
+  if (intSource & ADXL345_INT_OVERRUN) overruns++;
+
+  // FIFO_STATUS bits 5:0 hold the number of queued entries
+  size_t entries = fifoStatus & 0x3F;
+  if (entries > maxLevel) maxLevel = (uint8_t)entries;
+  if (entries > maxSamples) entries = maxSamples;
+
+  size_t count = 0;
+  for (; count < entries; count++) {
+    // Reading DATAX0..DATAZ1 in one burst pops exactly one FIFO entry
+    if (!readSample(out[count])) break;
+  }
+
+  samples += count;
+  return count;
+}
+
+bool Adxl345Fifo::readSample(RawSample& out) {
+  uint8_t raw[6];
+  if (!bus.readRegisters(ADXL345_REG_DATAX0, raw, sizeof(raw))) {
+    busErrors++;
+    return false;
+  }
+  out.x = (int16_t)(raw[0] | (raw[1] << 8));
+  out.y = (int16_t)(raw[2] | (raw[3] << 8));
+  out.z = (int16_t)(raw[4] | (raw[5] << 8));
+  return true;
+}
+
+void Adxl345Fifo::resetStats() {
+  overruns = 0;
+  samples = 0;
+  busErrors = 0;
+  maxLevel = 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ADXL345 register map (only the registers used by the FIFO path)
+#define ADXL345_REG_INT_SOURCE   0x30
+#define ADXL345_REG_DATA_FORMAT  0x31
+#define ADXL345_REG_DATAX0       0x32
+#define ADXL345_REG_BW_RATE      0x2C
+#define ADXL345_REG_POWER_CTL    0x2D
+#define ADXL345_REG_FIFO_CTL     0x38
+#define ADXL345_REG_FIFO_STATUS  0x39
+
+#define ADXL345_FIFO_DEPTH       32
+#define ADXL345_FIFO_MODE_BYPASS 0x00
+#define ADXL345_FIFO_MODE_STREAM 0x80
+#define ADXL345_INT_OVERRUN      0x01
+#define ADXL345_INT_WATERMARK    0x02
+
+// Full-resolution mode is always 4 mg/LSB regardless of range
+#define ADXL345_MG_PER_LSB       4.0f
+#define ADXL345_MS2_PER_LSB      (ADXL345_MG_PER_LSB * 0.00980665f)
+
+// One accelerometer sample in raw counts
+struct RawSample {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+// Register-level access to the sensor. Implemented with Wire on the board and
+// by Adxl345Sim on the host.
+class Adxl345Bus {
+  public:
+    virtual ~Adxl345Bus() {}
+    virtual bool writeRegister(uint8_t reg, uint8_t value) = 0;
+    virtual bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length) = 0;
+};
+
+// Output data rates supported by the FIFO path (BW_RATE codes)
+enum Adxl345Rate {
+  ADXL345_ODR_100_HZ  = 0x0A,
+  ADXL345_ODR_200_HZ  = 0x0B,
+  ADXL345_ODR_400_HZ  = 0x0C,
+  ADXL345_ODR_800_HZ  = 0x0D,
+  ADXL345_ODR_1600_HZ = 0x0E,
+  ADXL345_ODR_3200_HZ = 0x0F
+};
+
+float adxl345RateHz(Adxl345Rate rate);
+
+// Stream-mode FIFO acquisition. The sensor keeps sampling into its 32-entry
+// FIFO; drain() empties it in one pass, one 6-byte burst read per entry.
+class Adxl345Fifo {
+  public:
+    explicit Adxl345Fifo(Adxl345Bus& bus);
+
+    // Configure output data rate and watermark, then enter stream mode
+    bool begin(Adxl345Rate rate, uint8_t watermark = 16);
+
+    // Put the FIFO back in bypass mode (single-register reads work again)
+    bool stop();
+
+    // Read every entry currently in the FIFO into out (at most maxSamples).
+    // Returns the number of samples read.
+    size_t drain(RawSample* out, size_t maxSamples);
+
+    // Read DATAX0..DATAZ1 once. In stream mode this pops one FIFO entry; while
+    // stopped it returns the current output registers.
+    bool readSample(RawSample& out);
+
+    float sampleRateHz() const { return rateHz; }
+    bool isStreaming() const { return streaming; }
+
+    // Counters
+    uint32_t overrunCount() const { return overruns; }
+    uint32_t sampleCount() const { return samples; }
+    uint32_t busErrorCount() const { return busErrors; }
+    uint8_t maxFifoLevel() const { return maxLevel; }
+    void resetStats();
+
+  private:
+    Adxl345Bus& bus;
+    float rateHz;
+    bool streaming;
+    uint32_t overruns;
+    uint32_t samples;
+    uint32_t busErrors;
+    uint8_t maxLevel;
+};
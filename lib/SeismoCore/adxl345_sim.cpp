@@ -0,0 +1,124 @@
+#include "adxl345_sim.h"
+#include <string.h>
+
+static RawSample stillSensor(uint32_t index, void* context) {
+  (void)index;
+  (void)context;
+  RawSample sample = { 0, 0, 256 }; // 1 g at 4 mg/LSB
+  return sample;
+}
+
+Adxl345Sim::Adxl345Sim()
+  : head(0), level(0), overrun(false), pendingTime(0),
+    produced(0), dropped(0), reads(0),
+    generator(stillSensor), generatorContext(NULL) {
+  memset(registers, 0, sizeof(registers));
+  memset(fifo, 0, sizeof(fifo));
+  registers[0x00] = 0xE5;                       // DEVID
+  registers[ADXL345_REG_BW_RATE] = ADXL345_ODR_100_HZ;
+}
+
+void Adxl345Sim::setGenerator(Generator gen, void* context) {
+  generator = gen ? gen : stillSensor;
+  generatorContext = context;
+}
+
+void Adxl345Sim::produce(uint32_t count) {
+  // Nothing is sampled unless the measure bit is set
+  if (!(registers[ADXL345_REG_POWER_CTL] & 0x08)) return;
+
+  for (uint32_t i = 0; i < count; i++) {
+    push(generator(produced, generatorContext));
+    produced++;
+  }
+}
+
+void Adxl345Sim::advance(float seconds) {
+  float rate = adxl345RateHz((Adxl345Rate)(registers[ADXL345_REG_BW_RATE] & 0x0F));
+  pendingTime += seconds * rate;
+  uint32_t whole = (uint32_t)pendingTime;
+  pendingTime -= whole;
+  produce(whole);
+}
+
+void Adxl345Sim::push(const RawSample& sample) {
+  uint8_t mode = registers[ADXL345_REG_FIFO_CTL] & 0xC0;
+
+  if (mode == ADXL345_FIFO_MODE_BYPASS) {
+    // Only the output registers hold data; an unread sample is overwritten
+    if (level > 0) {
+      overrun = true;
+      dropped++;
+    }
+    fifo[0] = sample;
+    head = 0;
+    level = 1;
+    return;
+  }
+
+  if (level == ADXL345_FIFO_DEPTH) {
+    // Stream mode keeps the newest 32 samples
+    head = (head + 1) % ADXL345_FIFO_DEPTH;
+    level--;
+    overrun = true;
+    dropped++;
+  }
+  fifo[(head + level) % ADXL345_FIFO_DEPTH] = sample;
+  level++;
+}
+
+bool Adxl345Sim::writeRegister(uint8_t reg, uint8_t value) {
+  if (reg >= sizeof(registers)) return false;
+
+  if (reg == ADXL345_REG_FIFO_CTL && (value & 0xC0) == ADXL345_FIFO_MODE_BYPASS) {
+    // Entering bypass mode clears the FIFO
+    head = 0;
+    level = 0;
+    overrun = false;
+  }
+  registers[reg] = value;
+  return true;
+}
+
+uint8_t Adxl345Sim::readRegister(uint8_t reg) {
+  switch (reg) {
+    case ADXL345_REG_INT_SOURCE: {
+      uint8_t watermark = registers[ADXL345_REG_FIFO_CTL] & 0x1F;
+      uint8_t value = 0x80; // DATA_READY is not modelled, report it as set
+      if (level > watermark) value |= ADXL345_INT_WATERMARK;
+      if (overrun) value |= ADXL345_INT_OVERRUN;
+      return value;
+    }
+    case ADXL345_REG_FIFO_STATUS:
+      return level;
+    default:
+      return registers[reg];
+  }
+}
+
+bool Adxl345Sim::readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+  if ((size_t)reg + length > sizeof(registers)) return false;
+  reads++;
+
+  if (reg == ADXL345_REG_DATAX0 && length == 6) {
+    RawSample sample = { 0, 0, 0 };
+    if (level > 0) {
+      sample = fifo[head];
+      head = (head + 1) % ADXL345_FIFO_DEPTH;
+      level--;
+      overrun = false; // Reading the FIFO clears the overrun condition
+    }
+    buffer[0] = (uint8_t)(sample.x & 0xFF);
+    buffer[1] = (uint8_t)((uint16_t)sample.x >> 8);
+    buffer[2] = (uint8_t)(sample.y & 0xFF);
+    buffer[3] = (uint8_t)((uint16_t)sample.y >> 8);
+    buffer[4] = (uint8_t)(sample.z & 0xFF);
+    buffer[5] = (uint8_t)((uint16_t)sample.z >> 8);
+    return true;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    buffer[i] = readRegister((uint8_t)(reg + i));
+  }
+  return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "adxl345_fifo.h"
+
+// Simulated ADXL345 register file for host builds. It models the parts of the
+// FIFO the acquisition path depends on: stream-mode overwrite of the oldest
+// entry when full, the overrun/watermark bits in INT_SOURCE, the entry count
+// in FIFO_STATUS and popping one entry per DATAX0..DATAZ1 burst read.
+class Adxl345Sim : public Adxl345Bus {
+  public:
+    typedef RawSample (*Generator)(uint32_t index, void* context);
+
+    Adxl345Sim();
+
+    // Source of simulated samples; defaults to a motionless sensor at 1 g on Z
+    void setGenerator(Generator generator, void* context);
+
+    // Let the simulated sensor produce the given number of output samples
+    void produce(uint32_t count);
+
+    // Let simulated time pass; produces samples at the configured data rate
+    void advance(float seconds);
+
+    bool writeRegister(uint8_t reg, uint8_t value);
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length);
+
+    // Inspection
+    uint8_t fifoLevel() const { return level; }
+    uint32_t producedCount() const { return produced; }
+    uint32_t droppedCount() const { return dropped; }
+    uint32_t readTransactions() const { return reads; }
+    uint8_t reg(uint8_t address) const { return registers[address]; }
+
+  private:
+    void push(const RawSample& sample);
+    uint8_t readRegister(uint8_t reg);
+
+    uint8_t registers[64];
+    RawSample fifo[ADXL345_FIFO_DEPTH];
+    uint8_t head;
+    uint8_t level;
+    bool overrun;
+    float pendingTime;
+    uint32_t produced;
+    uint32_t dropped;
+    uint32_t reads;
+    Generator generator;
+    void* generatorContext;
+};
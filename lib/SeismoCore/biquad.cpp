@@ -0,0 +1,148 @@
+#include "biquad.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Coefficients are computed in double and rounded once; with corners far
+// below the sample rate the poles sit very close to z = 1 and float
+// intermediates would move them noticeably.
+static BiquadCoeffs normalise(double b0, double b1, double b2, double a0, double a1, double a2) {
+  BiquadCoeffs c;
+  c.b0 = (float)(b0 / a0);
+  c.b1 = (float)(b1 / a0);
+  c.b2 = (float)(b2 / a0);
+  c.a1 = (float)(a1 / a0);
+  c.a2 = (float)(a2 / a0);
+  return c;
+}
+
+BiquadCoeffs designHighpass(float cutoffHz, float sampleRate, float q) {
+  double w0 = 2.0 * M_PI * cutoffHz / sampleRate;
+  double cosw = cos(w0);
+  double alpha = sin(w0) / (2.0 * q);
+  return normalise((1.0 + cosw) / 2.0, -(1.0 + cosw), (1.0 + cosw) / 2.0,
+                   1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+}
+
+BiquadCoeffs designLowpass(float cutoffHz, float sampleRate, float q) {
+  double w0 = 2.0 * M_PI * cutoffHz / sampleRate;
+  double cosw = cos(w0);
+  double alpha = sin(w0) / (2.0 * q);
+  return normalise((1.0 - cosw) / 2.0, 1.0 - cosw, (1.0 - cosw) / 2.0,
+                   1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+}
+
+BiquadCoeffs designLeakyIntegrator(float cornerHz, float sampleRate, float q) {
+  // The RBJ band-pass with 0 dB peak is (s/Q) / (s² + s/Q + 1) in s / w0,
+  // w0 the prewarped analog corner; scaled by Q / w0 it is the integrator
+  double w0 = 2.0 * M_PI * cornerHz / sampleRate;
+  double cosw = cos(w0);
+  double alpha = sin(w0) / (2.0 * q);
+  double scale = q / (2.0 * sampleRate * tan(w0 / 2.0));
+  return normalise(alpha * scale, 0.0, -alpha * scale, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+}
+
+float butterworthQ(int order, int index) {
+  // Pole pair k of an order-N Butterworth filter has Q = 1 / (2 sin((2k+1) pi / 2N))
+  return (float)(1.0 / (2.0 * sin((2 * index + 1) * M_PI / (2.0 * order))));
+}
+
+float biquadDcGain(const BiquadCoeffs& c) {
+  return (c.b0 + c.b1 + c.b2) / (1.0f + c.a1 + c.a2);
+}
+
+SosFilter3::SosFilter3() : count(0) {
+  reset();
+}
+
+bool SosFilter3::setSections(const BiquadCoeffs* sections, int sectionCount) {
+  if (sectionCount < 0 || sectionCount > SOS_MAX_SECTIONS) return false;
+  for (int i = 0; i < sectionCount; i++) coeffs[i] = sections[i];
+  count = sectionCount;
+  reset();
+  return true;
+}
+
+void SosFilter3::reset() {
+  memset(state, 0, sizeof(state));
+  memset(bias, 0, sizeof(bias));
+  memset(biasOut, 0, sizeof(biasOut));
+}
+
+void SosFilter3::prime(float x, float y, float z) {
+  // Steady state for a constant input: zero state with the input carried as a
+  // bias. Filtering x - bias keeps the numbers small, which matters with float
+  // state when a high-pass corner is far below the sample rate.
+  float gain = 1.0f;
+  for (int s = 0; s < count; s++) gain *= biquadDcGain(coeffs[s]);
+
+  memset(state, 0, sizeof(state));
+  bias[0] = x;
+  bias[1] = y;
+  bias[2] = z;
+  for (int axis = 0; axis < 3; axis++) biasOut[axis] = gain * bias[axis];
+}
+
+void SosFilter3::process(float& x, float& y, float& z) {
+  x -= bias[0];
+  y -= bias[1];
+  z -= bias[2];
+
+  for (int s = 0; s < count; s++) {
+    const float b0 = coeffs[s].b0, b1 = coeffs[s].b1, b2 = coeffs[s].b2;
+    const float a1 = coeffs[s].a1, a2 = coeffs[s].a2;
+    float* sx = state[s][0];
+    float* sy = state[s][1];
+    float* sz = state[s][2];
+
+    float ox = b0 * x + sx[0];
+    float oy = b0 * y + sy[0];
+    float oz = b0 * z + sz[0];
+    sx[0] = b1 * x - a1 * ox + sx[1];
+    sy[0] = b1 * y - a1 * oy + sy[1];
+    sz[0] = b1 * z - a1 * oz + sz[1];
+    sx[1] = b2 * x - a2 * ox;
+    sy[1] = b2 * y - a2 * oy;
+    sz[1] = b2 * z - a2 * oz;
+    x = ox;
+    y = oy;
+    z = oz;
+  }
+
+  x += biasOut[0];
+  y += biasOut[1];
+  z += biasOut[2];
+}
+
+FilterBandConfig defaultFilterBandConfig() {
+  FilterBandConfig band;
+  band.highpass_hz = 0.1;
+  band.highpass_order = 2;
+  band.lowpass_hz = 10.0;
+  band.lowpass_order = 2;
+  return band;
+}
+
+bool designFilterBand(const FilterBandConfig& band, float sampleRate, SosFilter3& filter) {
+  BiquadCoeffs sections[SOS_MAX_SECTIONS];
+  int count = 0;
+
+  int hpSections = band.highpass_order >= 4 ? 2 : 1;
+  int hpOrder = hpSections * 2;
+  for (int i = 0; i < hpSections; i++) {
+    sections[count++] = designHighpass(band.highpass_hz, sampleRate, butterworthQ(hpOrder, i));
+  }
+
+  if (band.lowpass_hz > 0 && band.lowpass_hz < sampleRate / 2) {
+    int lpSections = band.lowpass_order >= 4 ? 2 : 1;
+    int lpOrder = lpSections * 2;
+    for (int i = 0; i < lpSections; i++) {
+      sections[count++] = designLowpass(band.lowpass_hz, sampleRate, butterworthQ(lpOrder, i));
+    }
+  }
+
+  return filter.setSections(sections, count);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+
+// Second-order IIR sections and a cascaded 3-axis filter built from them.
+
+struct BiquadCoeffs {
+  float b0, b1, b2; // Numerator
+  float a1, a2;     // Denominator (a0 normalised to 1)
+};
+
+// Butterworth-style designs via the bilinear transform (RBJ cookbook). A
+// Butterworth cascade of order 2n uses the Q values from butterworthQ().
+BiquadCoeffs designHighpass(float cutoffHz, float sampleRate, float q);
+BiquadCoeffs designLowpass(float cutoffHz, float sampleRate, float q);
+
+// Integrator that forgets: s / (s² + (w0/Q) s + w0²). Well above the corner
+// it is 1/s, trapezoidal integration with the output in input units times
+// seconds; below it, a second-order high-pass, so an offset or low-frequency
+// noise in the input cannot make the output drift away
+BiquadCoeffs designLeakyIntegrator(float cornerHz, float sampleRate, float q);
+
+// Q of section `index` in an even-order Butterworth cascade of `order`
+float butterworthQ(int order, int index);
+
+// DC gain of one section (H at z = 1)
+float biquadDcGain(const BiquadCoeffs& c);
+
+#define SOS_MAX_SECTIONS 4
+
+// Cascade of second-order sections applied to X, Y and Z in one interleaved
+// pass. Transposed direct form II, float state. All three axes share the same
+// coefficients, so each section's coefficients are loaded once per sample.
+class SosFilter3 {
+  public:
+    SosFilter3();
+
+    // Copy up to SOS_MAX_SECTIONS sections; returns false if there are too many
+    bool setSections(const BiquadCoeffs* sections, int count);
+    int sectionCount() const { return count; }
+    const BiquadCoeffs& section(int index) const { return coeffs[index]; }
+
+    // Zero all state
+    void reset();
+
+    // Start in the steady state for a constant input, so there is no step
+    // transient; the level is also subtracted ahead of the sections
+    void prime(float x, float y, float z);
+
+    // Filter one sample in place
+    void process(float& x, float& y, float& z);
+
+  private:
+    BiquadCoeffs coeffs[SOS_MAX_SECTIONS];
+    float state[SOS_MAX_SECTIONS][3][2]; // [section][axis][s1, s2]
+    float bias[3];                       // Input level captured by prime()
+    float biasOut[3];                    // Its contribution to the output (DC gain * bias)
+    int count;
+};
+
+// Which band the detector looks at
+struct FilterBandConfig {
+  float highpass_hz;  // Removes gravity, tilt and drift
+  int highpass_order; // 2 or 4
+  float lowpass_hz;   // Upper band edge; 0 disables it (high-pass only)
+  int lowpass_order;  // 2 or 4
+};
+
+FilterBandConfig defaultFilterBandConfig();
+
+// Design the cascade for a band at the given sample rate. The coefficients
+// follow the sample rate, so changing the acquisition rate needs no retuning.
+// A low-pass edge at or above Nyquist is dropped.
+bool designFilterBand(const FilterBandConfig& band, float sampleRate, SosFilter3& filter);
@@ -0,0 +1,86 @@
+#include "ble_frame.h"
+
+// Byte-wise access keeps the layout independent of host endianness and alignment
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  put16(p, (uint16_t)value);
+  put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+size_t bleFrameCapacity(size_t maxBytes) {
+  if (maxBytes > BLE_FRAME_MAX_SIZE) maxBytes = BLE_FRAME_MAX_SIZE;
+  if (maxBytes < BLE_FRAME_HEADER_SIZE) return 0;
+  size_t samples = (maxBytes - BLE_FRAME_HEADER_SIZE) / BLE_FRAME_SAMPLE_SIZE;
+  return samples > BLE_FRAME_MAX_SAMPLES ? BLE_FRAME_MAX_SAMPLES : samples;
+}
+
+size_t encodeBleFrame(const BleFrameHeader& header, const RawSample* samples, size_t count,
+                      uint8_t* out, size_t maxBytes) {
+  if (count > bleFrameCapacity(maxBytes) || maxBytes < BLE_FRAME_HEADER_SIZE) return 0;
+
+  out[0] = BLE_FRAME_VERSION;
+  out[1] = (uint8_t)count;
+  put16(out + 2, header.sequence);
+  put32(out + 4, header.time_ms);
+  put16(out + 8, header.rate_dhz);
+  put16(out + 10, header.scale_um);
+  out[12] = header.mercalli_now;
+  out[13] = header.mercalli_peak;
+  out[14] = header.flags;
+  out[15] = 0;
+  put16(out + 16, header.sta_lta_x100);
+  put16(out + 18, (uint16_t)header.peak_x);
+  put16(out + 20, (uint16_t)header.peak_y);
+  put16(out + 22, (uint16_t)header.peak_z);
+  put16(out + 24, header.peak_magnitude);
+
+  uint8_t* p = out + BLE_FRAME_HEADER_SIZE;
+  for (size_t i = 0; i < count; i++, p += BLE_FRAME_SAMPLE_SIZE) {
+    put16(p, (uint16_t)samples[i].x);
+    put16(p + 2, (uint16_t)samples[i].y);
+    put16(p + 4, (uint16_t)samples[i].z);
+  }
+  return BLE_FRAME_HEADER_SIZE + count * BLE_FRAME_SAMPLE_SIZE;
+}
+
+bool decodeBleFrame(const uint8_t* data, size_t length, BleFrameHeader& header,
+                    RawSample* samples, size_t maxSamples, size_t& count) {
+  count = 0;
+  if (length < BLE_FRAME_HEADER_SIZE || data[0] != BLE_FRAME_VERSION) return false;
+  size_t n = data[1];
+  if (n > maxSamples || length < BLE_FRAME_HEADER_SIZE + n * BLE_FRAME_SAMPLE_SIZE) return false;
+
+  header.sequence = get16(data + 2);
+  header.time_ms = get32(data + 4);
+  header.rate_dhz = get16(data + 8);
+  header.scale_um = get16(data + 10);
+  header.mercalli_now = data[12];
+  header.mercalli_peak = data[13];
+  header.flags = data[14];
+  header.sta_lta_x100 = get16(data + 16);
+  header.peak_x = (int16_t)get16(data + 18);
+  header.peak_y = (int16_t)get16(data + 20);
+  header.peak_z = (int16_t)get16(data + 22);
+  header.peak_magnitude = get16(data + 24);
+
+  const uint8_t* p = data + BLE_FRAME_HEADER_SIZE;
+  for (size_t i = 0; i < n; i++, p += BLE_FRAME_SAMPLE_SIZE) {
+    samples[i].x = (int16_t)get16(p);
+    samples[i].y = (int16_t)get16(p + 2);
+    samples[i].z = (int16_t)get16(p + 4);
+  }
+  count = n;
+  return true;
+}
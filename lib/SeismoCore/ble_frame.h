@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "adxl345_fifo.h"
+
+// Binary frame carried by the BLE data characteristic. All fields are
+// little-endian and byte-packed:
+//
+//   offset  size  field
+//    0      1     version (BLE_FRAME_VERSION)
+//    1      1     sample count N
+//    2      2     sequence number, +1 per frame, wraps
+//    4      4     time of the first sample, ms since boot
+//    8      2     sample rate, 0.1 Hz units
+//   10      2     scale, µm/s² per count
+//   12      1     current Mercalli intensity
+//   13      1     peak Mercalli intensity
+//   14      1     flags (BLE_FRAME_*)
+//   15      1     reserved, 0
+//   16      2     highest STA/LTA ratio x100, saturated
+//   18      6     peak deviation x, y, z (int16 counts)
+//   24      2     peak deviation magnitude (counts)
+//   26      6N    samples: int16 x, y, z counts each
+//
+// A frame with N = 0 carries the status fields only.
+
+#define BLE_FRAME_VERSION      1
+#define BLE_FRAME_HEADER_SIZE  26
+#define BLE_FRAME_SAMPLE_SIZE  6
+#define BLE_FRAME_MAX_SAMPLES  255
+#define BLE_FRAME_MAX_SIZE     512 // Largest attribute value BLE allows
+
+// Flags
+#define BLE_FRAME_TRIGGERED    0x01 // Some axis is in the triggered state
+#define BLE_FRAME_GAP          0x02 // Samples were dropped before this frame
+
+// Header fields in wire units
+struct BleFrameHeader {
+  uint16_t sequence;
+  uint32_t time_ms;
+  uint16_t rate_dhz;
+  uint16_t scale_um;
+  uint8_t mercalli_now;
+  uint8_t mercalli_peak;
+  uint8_t flags;
+  uint16_t sta_lta_x100;
+  int16_t peak_x, peak_y, peak_z;
+  uint16_t peak_magnitude;
+};
+
+// Number of samples that fit in a frame of at most maxBytes
+size_t bleFrameCapacity(size_t maxBytes);
+
+// Returns the frame length, or 0 if the header plus `count` samples do not
+// fit in maxBytes
+size_t encodeBleFrame(const BleFrameHeader& header, const RawSample* samples, size_t count,
+                      uint8_t* out, size_t maxBytes);
+
+// Returns false for a truncated frame, an unknown version or more samples
+// than maxSamples; count receives the number of samples decoded
+bool decodeBleFrame(const uint8_t* data, size_t length, BleFrameHeader& header,
+                    RawSample* samples, size_t maxSamples, size_t& count);
@@ -0,0 +1,142 @@
+#include "calibrator.h"
+#include <math.h>
+
+void RunningStats::reset() {
+  n = 0;
+  meanValue = 0;
+  meanCompensation = 0;
+  m2 = 0;
+  m2Compensation = 0;
+}
+
+void RunningStats::push(float value) {
+  n++;
+  float delta = value - meanValue;
+
+  // meanValue += delta / n
+  float step = delta / n - meanCompensation;
+  float sum = meanValue + step;
+  meanCompensation = (sum - meanValue) - step;
+  meanValue = sum;
+
+  // m2 += delta * (value - new mean); the product is never negative
+  step = delta * (value - meanValue) - m2Compensation;
+  sum = m2 + step;
+  m2Compensation = (sum - m2) - step;
+  m2 = sum;
+}
+
+float RunningStats::variance() const {
+  if (n < 2 || m2 <= 0) return 0;
+  return m2 / n;
+}
+
+float RunningStats::stddev() const {
+  return sqrtf(variance());
+}
+
+CalibrationConfig defaultCalibrationConfig(float sampleRate, float ms2PerCount) {
+  CalibrationConfig config;
+  config.settle_samples = (uint32_t)(1.0f * sampleRate);
+  config.collect_samples = (uint32_t)(2.0f * sampleRate);
+  config.verify_samples = (uint32_t)(0.5f * sampleRate);
+  config.ms2_per_count = ms2PerCount;
+  config.noise_sigmas = 3.0;           // 99.7% of the noise
+  config.min_noise_threshold = 0.05;   // For very quiet sensors
+  config.max_residual = 0.1;
+  return config;
+}
+
+static int16_t offsetFor(float mean) {
+  float offset = -roundf(mean);
+  if (offset > 32767.0f) return 32767;
+  if (offset < -32768.0f) return -32768;
+  return (int16_t)offset;
+}
+
+Calibrator::Calibrator() : current(CALIBRATION_IDLE), samples(0) {
+  cfg = defaultCalibrationConfig(100.0, ADXL345_MS2_PER_LSB);
+  outcome = CalibrationResult();
+}
+
+void Calibrator::start(const CalibrationConfig& config) {
+  cfg = config;
+  if (cfg.collect_samples < 2) cfg.collect_samples = 2;
+  if (cfg.verify_samples < 1) cfg.verify_samples = 1;
+  for (int i = 0; i < 3; i++) {
+    stats[i].reset();
+    verifySum[i] = 0;
+  }
+  samples = 0;
+  current = cfg.settle_samples > 0 ? CALIBRATION_SETTLING : CALIBRATION_COLLECTING;
+}
+
+bool Calibrator::push(const RawSample& raw) {
+  switch (current) {
+    case CALIBRATION_SETTLING:
+      if (++samples >= cfg.settle_samples) {
+        current = CALIBRATION_COLLECTING;
+        samples = 0;
+      }
+      return false;
+
+    case CALIBRATION_COLLECTING:
+      stats[0].push(raw.x);
+      stats[1].push(raw.y);
+      stats[2].push(raw.z);
+      if (++samples < cfg.collect_samples) return false;
+
+      outcome.mean_x = stats[0].mean();
+      outcome.mean_y = stats[1].mean();
+      outcome.mean_z = stats[2].mean();
+      outcome.offset_x = offsetFor(outcome.mean_x);
+      outcome.offset_y = offsetFor(outcome.mean_y);
+      outcome.offset_z = offsetFor(outcome.mean_z);
+      outcome.std_x = stats[0].stddev() * cfg.ms2_per_count;
+      outcome.std_y = stats[1].stddev() * cfg.ms2_per_count;
+      outcome.std_z = stats[2].stddev() * cfg.ms2_per_count;
+      {
+        float maxStd = outcome.std_x;
+        if (outcome.std_y > maxStd) maxStd = outcome.std_y;
+        if (outcome.std_z > maxStd) maxStd = outcome.std_z;
+        outcome.noise_threshold = cfg.noise_sigmas * maxStd;
+        if (outcome.noise_threshold < cfg.min_noise_threshold) {
+          outcome.noise_threshold = cfg.min_noise_threshold;
+        }
+      }
+      current = CALIBRATION_VERIFYING;
+      samples = 0;
+      return false;
+
+    case CALIBRATION_VERIFYING:
+      verifySum[0] += raw.x + outcome.offset_x;
+      verifySum[1] += raw.y + outcome.offset_y;
+      verifySum[2] += raw.z + outcome.offset_z;
+      if (++samples < cfg.verify_samples) return false;
+
+      outcome.residual_x = (float)verifySum[0] / samples * cfg.ms2_per_count;
+      outcome.residual_y = (float)verifySum[1] / samples * cfg.ms2_per_count;
+      outcome.residual_z = (float)verifySum[2] / samples * cfg.ms2_per_count;
+      outcome.good = fabsf(outcome.residual_x) < cfg.max_residual &&
+                     fabsf(outcome.residual_y) < cfg.max_residual &&
+                     fabsf(outcome.residual_z) < cfg.max_residual;
+      current = CALIBRATION_DONE;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+int Calibrator::progress() const {
+  uint32_t total = cfg.settle_samples + cfg.collect_samples + cfg.verify_samples;
+  uint32_t done;
+  switch (current) {
+    case CALIBRATION_SETTLING:   done = samples; break;
+    case CALIBRATION_COLLECTING: done = cfg.settle_samples + samples; break;
+    case CALIBRATION_VERIFYING:  done = cfg.settle_samples + cfg.collect_samples + samples; break;
+    case CALIBRATION_DONE:       return 100;
+    default:                     return 0;
+  }
+  return (int)(done * 100 / total);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <stdint.h>
+#include "adxl345_fifo.h"
+
+// Online zero-offset and noise calibration, fed one sample at a time from the
+// normal sampling path so nothing else has to stop while it runs.
+//
+// A calibration settles for a moment (the button press or the boot is still
+// ringing through the housing), measures the mean and standard deviation of
+// each axis while the sensor lies still, and then checks that the resulting
+// offsets bring the mean of a fresh set of samples close to zero.
+//
+// The mean and variance are accumulated with Welford's update, with both sums
+// Kahan-compensated. A plain sum of squares in float loses everything to
+// cancellation next to the ~250 count gravity component, and even Welford
+// slowly drifts over thousands of float updates without the compensation.
+
+// Running mean and variance of one channel
+class RunningStats {
+  public:
+    RunningStats() { reset(); }
+
+    void reset();
+    void push(float value);
+
+    uint32_t count() const { return n; }
+    float mean() const { return meanValue; }
+    float variance() const; // Population variance; 0 until two values are seen
+    float stddev() const;
+
+  private:
+    uint32_t n;
+    float meanValue;
+    float meanCompensation; // Kahan: low-order bits lost from meanValue
+    float m2;               // Sum of squared differences from the mean
+    float m2Compensation;
+};
+
+enum CalibrationState {
+  CALIBRATION_IDLE,       // Never started
+  CALIBRATION_SETTLING,   // Discarding samples while the sensor settles
+  CALIBRATION_COLLECTING, // Measuring mean and noise
+  CALIBRATION_VERIFYING,  // Checking the offsets on fresh samples
+  CALIBRATION_DONE        // result() is valid
+};
+
+struct CalibrationConfig {
+  uint32_t settle_samples;
+  uint32_t collect_samples;
+  uint32_t verify_samples;
+  float ms2_per_count;       // Sensor scale
+  float noise_sigmas;        // Noise threshold = this many standard deviations...
+  float min_noise_threshold; // ...but never below this (m/s²)
+  float max_residual;        // Largest calibrated mean per axis that passes verification (m/s²)
+};
+
+// About 1 s settling, 2 s measuring and 0.5 s verifying at any sample rate
+CalibrationConfig defaultCalibrationConfig(float sampleRate, float ms2PerCount);
+
+struct CalibrationResult {
+  int16_t offset_x, offset_y, offset_z; // Added to raw samples (counts)
+  float mean_x, mean_y, mean_z;         // Raw means (counts)
+  float std_x, std_y, std_z;            // Noise per axis (m/s²)
+  float noise_threshold;                // m/s²
+  float residual_x, residual_y, residual_z; // Calibrated means during verification (m/s²)
+  bool good;                            // Every residual is within max_residual
+};
+
+class Calibrator {
+  public:
+    Calibrator();
+
+    // Start (or restart) a calibration
+    void start(const CalibrationConfig& config);
+
+    // Feed one raw sample. Returns true on the sample that completes the
+    // calibration; result() is valid from then on.
+    bool push(const RawSample& raw);
+
+    CalibrationState state() const { return current; }
+    bool active() const { return current != CALIBRATION_IDLE && current != CALIBRATION_DONE; }
+    // 0-100 over all three phases
+    int progress() const;
+    const CalibrationResult& result() const { return outcome; }
+
+  private:
+    CalibrationConfig cfg;
+    CalibrationState current;
+    uint32_t samples;   // Samples seen in the current phase
+    RunningStats stats[3];
+    int32_t verifySum[3]; // Calibrated counts; exact
+    CalibrationResult outcome;
+};
@@ -0,0 +1,28 @@
+#include "chunked_body.h"
+#include <string.h>
+
+ChunkedBody::ChunkedBody() : piece(staging), length(0), offset(0), next(0), done(false) {}
+
+size_t ChunkedBody::fill(uint8_t* buffer, size_t maxLength) {
+  size_t written = 0;
+  while (written < maxLength) {
+    if (offset == length) {
+      if (done) break;
+      const char* text = staging;
+      length = renderPiece(next++, staging, sizeof(staging), &text);
+      if (text == staging && length > sizeof(staging)) length = sizeof(staging);
+      piece = text;
+      offset = 0;
+      if (length == 0) {
+        done = true;
+        break;
+      }
+    }
+    size_t count = length - offset;
+    if (count > maxLength - written) count = maxLength - written;
+    memcpy(buffer + written, piece + offset, count);
+    offset += count;
+    written += count;
+  }
+  return written;
+}
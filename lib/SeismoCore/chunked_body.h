@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// A response body produced piece by piece, for servers that pull chunked
+// responses through a "give me up to N more bytes" callback. Each piece (a
+// table row, a JSON object, a few CSV lines) is rendered whole into a small
+// staging buffer and handed out over as many fills as it takes, so a page of
+// any length is never held in memory at once. Constant text of any length can
+// be passed through without a copy.
+//
+// A body is filled from one task at a time; pieces that read shared state
+// must do their own locking.
+
+#define CHUNKED_PIECE_MAX 512
+
+class ChunkedBody {
+  public:
+    ChunkedBody();
+    virtual ~ChunkedBody() {}
+
+    // Copy up to maxLength bytes of the body into buffer; 0 once it is complete
+    size_t fill(uint8_t* buffer, size_t maxLength);
+
+  protected:
+    // Piece `index` (0, 1, 2...): either written into out (at most size
+    // bytes) or, for constant text, pointed to through *text. Returns its
+    // length; 0 ends the body.
+    virtual size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) = 0;
+
+  private:
+    char staging[CHUNKED_PIECE_MAX];
+    const char* piece;
+    size_t length;
+    size_t offset;
+    uint32_t next;
+    bool done;
+};
@@ -0,0 +1,126 @@
+#include "clock_model.h"
+
+ClockModelConfig defaultClockModelConfig() {
+  ClockModelConfig config;
+  config.window = CLOCK_MODEL_MAX_SYNCS;
+  config.min_drift_span_s = 1800.0; // Two syncs seconds apart would turn jitter into drift
+  config.max_drift_ppm = 500.0;     // Crystals are within 50 ppm; beyond this the fit is wrong
+  config.max_residual_ms = 500.0;
+  return config;
+}
+
+ClockModel::ClockModel() {
+  configure(defaultClockModelConfig());
+}
+
+void ClockModel::configure(const ClockModelConfig& config) {
+  cfg = config;
+  if (cfg.window < 1) cfg.window = 1;
+  if (cfg.window > CLOCK_MODEL_MAX_SYNCS) cfg.window = CLOCK_MODEL_MAX_SYNCS;
+  reset();
+}
+
+void ClockModel::reset() {
+  count = 0;
+  anchorLocal = 0;
+  anchorOffset = 0;
+  drift = 0;
+  suspect = false;
+  suspectLocal = 0;
+  suspectOffset = 0;
+  residual = 0;
+  lastLocal = 0;
+  accepted = 0;
+  rejected = 0;
+  steps = 0;
+}
+
+int64_t ClockModel::toUtc(int64_t local_us) const {
+  if (count == 0) return local_us;
+  int64_t elapsed = local_us - anchorLocal;
+  return local_us + anchorOffset + (int64_t)(elapsed * drift);
+}
+
+bool ClockModel::addSync(int64_t local_us, int64_t utc_us) {
+  int64_t offset = utc_us - local_us;
+  lastLocal = local_us;
+  if (count == 0) {
+    residual = 0;
+    push(local_us, offset);
+    return true;
+  }
+
+  residual = utc_us - toUtc(local_us);
+  int64_t limit = (int64_t)(cfg.max_residual_ms * 1000.0f);
+  if (residual <= limit && residual >= -limit) {
+    suspect = false;
+    push(local_us, offset);
+    return true;
+  }
+
+  // Far off: a step if it agrees with the outlier before it
+  if (suspect) {
+    int64_t predicted = suspectOffset + (int64_t)((local_us - suspectLocal) * drift);
+    int64_t difference = offset - predicted;
+    if (difference <= limit && difference >= -limit) {
+      count = 0;
+      suspect = false;
+      steps++;
+      push(suspectLocal, suspectOffset);
+      push(local_us, offset);
+      return true;
+    }
+  }
+  suspect = true;
+  suspectLocal = local_us;
+  suspectOffset = offset;
+  rejected++;
+  return false;
+}
+
+void ClockModel::push(int64_t local_us, int64_t offset_us) {
+  if (count == cfg.window) {
+    for (uint8_t i = 1; i < count; i++) {
+      locals[i - 1] = locals[i];
+      offsets[i - 1] = offsets[i];
+    }
+    count--;
+  }
+  locals[count] = local_us;
+  offsets[count] = offset_us;
+  count++;
+  accepted++;
+  fit();
+}
+
+// Least-squares line through the kept offsets, relative to the newest sync so
+// the doubles only hold differences
+void ClockModel::fit() {
+  uint8_t newest = count - 1;
+  double meanX = 0, meanY = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    meanX += (double)(locals[i] - locals[newest]);
+    meanY += (double)(offsets[i] - offsets[newest]);
+  }
+  meanX /= count;
+  meanY /= count;
+
+  double span = (double)(locals[newest] - locals[0]) * 1e-6;
+  if (count >= 2 && span >= cfg.min_drift_span_s) {
+    double sxx = 0, sxy = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      double dx = (double)(locals[i] - locals[newest]) - meanX;
+      double dy = (double)(offsets[i] - offsets[newest]) - meanY;
+      sxx += dx * dx;
+      sxy += dx * dy;
+    }
+    drift = sxx > 0 ? sxy / sxx : 0;
+    double limit = cfg.max_drift_ppm * 1e-6;
+    if (drift > limit) drift = limit;
+    if (drift < -limit) drift = -limit;
+  }
+  // Until then the drift stays where it was (0 at first)
+
+  anchorLocal = locals[newest];
+  anchorOffset = offsets[newest] + (int64_t)(meanY - drift * meanX);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+
+// Maps a free-running microsecond counter (esp_timer on the board) to UTC.
+//
+// Every NTP sync contributes a pair (counter, UTC) taken at the same instant.
+// The model fits a straight line through the offsets (UTC - counter) of the
+// last few syncs: the intercept is the offset now, the slope the drift of the
+// counter's crystal against UTC. Fitting a line rather than taking the newest
+// sync averages out the network jitter of single NTP replies, and the drift
+// keeps the mapping accurate between syncs (20 ppm is 72 ms an hour).
+//
+// A sync far off the model is held back as an outlier. If the next one agrees
+// with it the clock really stepped (the counter restarted, or NTP corrected a
+// bad server) and the model starts over from the two of them.
+//
+// The model is not locked; share it between tasks under a lock of your own.
+
+#define CLOCK_MODEL_MAX_SYNCS 8
+
+struct ClockModelConfig {
+  uint8_t window;            // Syncs in the fit, 1 to CLOCK_MODEL_MAX_SYNCS
+  float min_drift_span_s;    // Drift is only refitted once the syncs span this long
+  float max_drift_ppm;       // Fitted drift is clamped to this
+  float max_residual_ms;     // Syncs further than this off the model are outliers
+};
+
+// 8 syncs, drift fitted over at least 30 minutes, 500 ms outlier threshold
+ClockModelConfig defaultClockModelConfig();
+
+class ClockModel {
+  public:
+    ClockModel();
+
+    void configure(const ClockModelConfig& config);
+    // Forget every sync
+    void reset();
+
+    // A sync: the counter read when the UTC time was valid. Returns false if
+    // it was held back as an outlier.
+    bool addSync(int64_t local_us, int64_t utc_us);
+
+    // At least one sync has been accepted
+    bool valid() const { return count > 0; }
+    // UTC microseconds at a counter value; the counter itself until valid()
+    int64_t toUtc(int64_t local_us) const;
+
+    float driftPpm() const { return (float)(drift * 1e6); }
+    // Offset UTC - counter at the newest accepted sync
+    int64_t offsetUs() const { return anchorOffset; }
+    // Newest sync minus the model's prediction just before it
+    int64_t lastResidualUs() const { return residual; }
+    int64_t lastSyncLocalUs() const { return lastLocal; }
+    uint32_t syncCount() const { return accepted; }
+    uint32_t rejectedCount() const { return rejected; }
+    uint32_t stepCount() const { return steps; }
+
+  private:
+    void push(int64_t local_us, int64_t offset_us);
+    void fit();
+
+    ClockModelConfig cfg;
+    int64_t locals[CLOCK_MODEL_MAX_SYNCS];  // Counter at each kept sync, oldest first
+    int64_t offsets[CLOCK_MODEL_MAX_SYNCS]; // UTC - counter at each kept sync
+    uint8_t count;
+    int64_t anchorLocal;   // The fitted line passes through (anchorLocal, anchorOffset)
+    int64_t anchorOffset;
+    double drift;          // Slope of the offset (µs per µs)
+    bool suspect;          // An outlier is held back
+    int64_t suspectLocal;
+    int64_t suspectOffset;
+    int64_t residual;
+    int64_t lastLocal;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t steps;
+};
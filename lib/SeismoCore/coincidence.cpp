@@ -0,0 +1,93 @@
+#include "coincidence.h"
+#include <string.h>
+
+CoincidenceConfig defaultCoincidenceConfig() {
+  CoincidenceConfig config;
+  config.k = 3;
+  config.window_us = 2000000;  // P waves cross a campus well within this
+  config.latency_us = 1000000; // WiFi and retries; the event is declared this much later
+  return config;
+}
+
+CoincidenceTrigger::CoincidenceTrigger() {
+  configure(defaultCoincidenceConfig());
+}
+
+void CoincidenceTrigger::configure(const CoincidenceConfig& config) {
+  cfg = config;
+  if (cfg.k < 1) cfg.k = 1;
+  if (cfg.window_us < 0) cfg.window_us = 0;
+  if (cfg.latency_us < 0) cfg.latency_us = 0;
+  reset();
+}
+
+void CoincidenceTrigger::reset() {
+  head = 0;
+  tail = 0;
+  evaluatedUntil = 0;
+  anyEvaluated = false;
+  events = 0;
+  late = 0;
+  overflows = 0;
+  unmatched = 0;
+}
+
+bool CoincidenceTrigger::add(const StationTrigger& trigger) {
+  if (anyEvaluated && trigger.onset_us < evaluatedUntil) {
+    late++;
+    return false;
+  }
+
+  if (tail == COINCIDENCE_MAX_PENDING) {
+    if (head == 0) {
+      head++; // Full of undecided triggers: lose the oldest
+      overflows++;
+    }
+    memmove(pending, pending + head, (tail - head) * sizeof(StationTrigger));
+    tail -= head;
+    head = 0;
+  }
+
+  // Mostly in order already, so the search ends at once
+  uint32_t i = tail;
+  while (i > head && pending[i - 1].onset_us > trigger.onset_us) i--;
+  memmove(pending + i + 1, pending + i, (tail - i) * sizeof(StationTrigger));
+  pending[i] = trigger;
+  tail++;
+  return true;
+}
+
+bool CoincidenceTrigger::poll(int64_t now_us, CoincidenceEvent& out) {
+  while (head < tail) {
+    const StationTrigger& first = pending[head];
+    int64_t windowEnd = first.onset_us + cfg.window_us;
+    if (windowEnd + cfg.latency_us > now_us) return false;
+
+    // Distinct stations in [first, first + window]
+    uint32_t end = head;
+    out.count = 0;
+    out.max_mercalli = 0;
+    for (; end < tail && pending[end].onset_us <= windowEnd; end++) {
+      const StationTrigger& trigger = pending[end];
+      bool seen = false;
+      for (uint16_t j = 0; j < out.count && !seen; j++) seen = out.triggers[j].station == trigger.station;
+      if (seen || out.count == COINCIDENCE_MAX_STATIONS) continue;
+      out.triggers[out.count++] = trigger;
+      if (trigger.mercalli > out.max_mercalli) out.max_mercalli = trigger.mercalli;
+    }
+
+    anyEvaluated = true;
+    if (out.count >= cfg.k) {
+      out.onset_us = first.onset_us;
+      out.last_us = out.triggers[out.count - 1].onset_us;
+      head = end;
+      evaluatedUntil = windowEnd;
+      events++;
+      return true;
+    }
+    evaluatedUntil = first.onset_us;
+    head++;
+    unmatched++;
+  }
+  return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+
+// Network coincidence trigger: an event is declared when at least k distinct
+// stations trigger within one window.
+//
+// Station triggers arrive out of order (network delay, retransmissions over
+// TCP) and are kept sorted by onset time. A window starts at the earliest
+// pending onset and is evaluated once it has been closed for `latency`, so a
+// late packet still counts if it arrives within that allowance. If k stations
+// fall inside, they form an event and leave the queue; if not, the earliest
+// trigger can never be part of an event any more and is dropped. Triggers
+// arriving after their window was evaluated are counted as late and dropped.
+//
+// All storage is inside the object; the collector keeps one per network.
+
+#define COINCIDENCE_MAX_PENDING  1024 // Triggers waiting for their window to close
+#define COINCIDENCE_MAX_STATIONS 128  // Stations listed per event
+
+struct CoincidenceConfig {
+  uint16_t k;          // Stations needed for an event
+  int64_t window_us;   // Onsets within this span count together
+  int64_t latency_us;  // Extra wait for late packets before a window is evaluated
+};
+
+// 3 stations within 2 s, evaluated 1 s after the window closes
+CoincidenceConfig defaultCoincidenceConfig();
+
+struct StationTrigger {
+  uint32_t station;
+  int64_t onset_us;    // UTC
+  uint8_t mercalli;
+  float sta_lta;
+  float magnitude;     // m/s²
+};
+
+struct CoincidenceEvent {
+  int64_t onset_us;    // Earliest onset
+  int64_t last_us;     // Onset of the last station to join
+  uint16_t count;      // Distinct stations
+  uint8_t max_mercalli;
+  StationTrigger triggers[COINCIDENCE_MAX_STATIONS]; // First trigger of each station, in onset order
+};
+
+class CoincidenceTrigger {
+  public:
+    CoincidenceTrigger();
+
+    void configure(const CoincidenceConfig& config);
+    const CoincidenceConfig& config() const { return cfg; }
+    void reset();
+
+    // Queue a station trigger. False if it was late and dropped; when the
+    // queue is full the oldest pending trigger makes room.
+    bool add(const StationTrigger& trigger);
+
+    // Evaluate the windows that have closed by now_us. Returns true with one
+    // event in `out`; call again until it returns false.
+    bool poll(int64_t now_us, CoincidenceEvent& out);
+
+    uint32_t pendingCount() const { return tail - head; }
+    uint32_t eventCount() const { return events; }
+    uint32_t lateCount() const { return late; }
+    uint32_t overflowCount() const { return overflows; }
+    uint32_t unmatchedCount() const { return unmatched; } // Triggers that joined no event
+
+  private:
+    CoincidenceConfig cfg;
+    StationTrigger pending[COINCIDENCE_MAX_PENDING]; // [head, tail), ascending onset
+    uint32_t head;
+    uint32_t tail;
+    int64_t evaluatedUntil; // Windows starting before this have been decided
+    bool anyEvaluated;
+    uint32_t events;
+    uint32_t late;
+    uint32_t overflows;
+    uint32_t unmatched;
+};
@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// CRC-32 (IEEE 802.3, as in zlib). Bitwise: it protects short records and
+// packets, where a table would cost more flash than it saves time.
+uint32_t crc32(const uint8_t* data, size_t length);
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include "adxl345_fifo.h"
+
+// Block-averaging decimator for raw 3-axis samples. Averaging each block of
+// `factor` samples is a simple anti-alias filter, good enough when the signal
+// of interest is well below the output Nyquist frequency.
+class Decimator {
+  public:
+    Decimator() : factor(1), count(0), sumX(0), sumY(0), sumZ(0) {}
+
+    void setFactor(uint32_t decimation) {
+      factor = decimation < 1 ? 1 : decimation;
+      reset();
+    }
+    uint32_t getFactor() const { return factor; }
+
+    void reset() {
+      count = 0;
+      sumX = sumY = sumZ = 0;
+    }
+
+    // Returns true when a block is complete and `out` holds its average
+    bool push(const RawSample& in, RawSample& out) {
+      sumX += in.x;
+      sumY += in.y;
+      sumZ += in.z;
+      if (++count < factor) return false;
+
+      out.x = average(sumX);
+      out.y = average(sumY);
+      out.z = average(sumZ);
+      reset();
+      return true;
+    }
+
+  private:
+    int16_t average(int32_t sum) const {
+      // Round to nearest, symmetrically around zero
+      int32_t half = (int32_t)(factor / 2);
+      return (int16_t)((sum >= 0 ? sum + half : sum - half) / (int32_t)factor);
+    }
+
+    uint32_t factor;
+    uint32_t count;
+    int32_t sumX, sumY, sumZ;
+};
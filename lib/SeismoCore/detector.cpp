@@ -0,0 +1,227 @@
+#include "detector.h"
+#include "adxl345_fifo.h"
+#include <math.h>
+
+DetectorConfig defaultDetectorConfig(float sampleRate) {
+  DetectorConfig config;
+  config.sample_rate = sampleRate;
+  config.ms2_per_count = ADXL345_MS2_PER_LSB;
+  config.filter = defaultFilterBandConfig();
+  config.warmup_seconds = 2.0;
+  config.noise_threshold = 0.1;
+  config.noise_floor = defaultNoiseFloorConfig();
+  config.min_event_interval_ms = 10000;
+  config.min_log_mercalli = 3;
+  for (int i = 0; i < 11; i++) config.mercalli_thresholds[i] = MERCALLI_THRESHOLDS[i];
+  config.intensity_mode = INTENSITY_THRESHOLDS;
+  config.ground_motion = defaultGroundMotionConfig();
+  config.trigger = defaultStaLtaConfig();
+  return config;
+}
+
+Detector::Detector() : loggingEnabled(true) {
+  configure(defaultDetectorConfig(10.0));
+}
+
+void Detector::configure(const DetectorConfig& config) {
+  cfg = config;
+
+  // Coefficients and warm-up length follow the sample rate
+  designFilterBand(cfg.filter, cfg.sample_rate, bandFilter);
+  warmupSamples = (int)(cfg.warmup_seconds * cfg.sample_rate);
+  if (warmupSamples < 1) warmupSamples = 1;
+
+  // Physical thresholds to counts, once
+  mercalliScale(cfg.mercalli_thresholds, cfg.ms2_per_count, mercalli);
+  cmPerCount = cfg.ms2_per_count * 100.0f;
+  motion.configure(cfg.ground_motion, cfg.sample_rate);
+  setNoiseThreshold(cfg.noise_threshold);
+  StaLtaConfig trigger = cfg.trigger;
+  trigger.min_lta /= cfg.ms2_per_count * cfg.ms2_per_count; // LTA is in counts²
+  baseMinLta = trigger.min_lta;
+
+  for (int i = 0; i < 3; i++) triggers[i].configure(trigger, cfg.sample_rate);
+  noise.configure(cfg.noise_floor, cfg.sample_rate);
+  reset();
+}
+
+void Detector::retune(const DetectorConfig& config) {
+  for (int i = 0; i < 11; i++) cfg.mercalli_thresholds[i] = config.mercalli_thresholds[i];
+  mercalliScale(cfg.mercalli_thresholds, cfg.ms2_per_count, mercalli);
+  cfg.trigger.trigger_on = config.trigger.trigger_on;
+  cfg.trigger.trigger_off = config.trigger.trigger_off;
+  for (int i = 0; i < 3; i++) triggers[i].setRatios(cfg.trigger.trigger_on, cfg.trigger.trigger_off);
+  cfg.min_event_interval_ms = config.min_event_interval_ms;
+  cfg.min_log_mercalli = config.min_log_mercalli;
+  cfg.intensity_mode = config.intensity_mode;
+}
+
+void Detector::setNoiseThreshold(float threshold) {
+  cfg.noise_threshold = threshold;
+  gate = threshold / cfg.ms2_per_count;
+}
+
+void Detector::adaptToNoise() {
+  float threshold = cfg.noise_floor.gate_sigmas * noise.maxSigma() * cfg.ms2_per_count;
+  if (threshold < cfg.noise_floor.min_threshold) threshold = cfg.noise_floor.min_threshold;
+  if (threshold > cfg.noise_floor.max_threshold) threshold = cfg.noise_floor.max_threshold;
+  gate = threshold / cfg.ms2_per_count;
+
+  // A quiet spell cannot pull the LTA below the usual noise, so the noise
+  // returning afterwards does not look like an event
+  for (int i = 0; i < 3; i++) {
+    float power = noise.sigma(i) * noise.sigma(i);
+    triggers[i].setMinLta(power > baseMinLta ? power : baseMinLta);
+  }
+}
+
+float Detector::magnitudeMs2(float squaredCounts) const {
+  return sqrtf(squaredCounts) * cfg.ms2_per_count;
+}
+
+void Detector::reset() {
+  sampleCount = 0;
+  x_sum = y_sum = z_sum = 0;
+  bandFilter.reset();
+  peak.x = peak.y = peak.z = 0;
+  peak.dev_mag_sq = 0;
+  peak.magnitude_sq = 0;
+  peak.mercalli = 0;
+  peak.motion.pga = peak.motion.pgv = peak.motion.pgd = 0;
+  peak.motion.mmi = 1;
+  eventPeak = peak.motion;
+  motion.reset();
+  for (int i = 0; i < 3; i++) triggers[i].reset();
+  resetEventHistory();
+}
+
+void Detector::resetEventHistory() {
+  inEvent = false;
+  eventLogged = false;
+  hasLogged = false;
+  lastEventTime = 0;
+}
+
+// Peaks only rise; the intensity is of the peaks, which need not be simultaneous
+void Detector::trackMotion(MotionPeaks& peaks, float pga, float pgv, float pgd) const {
+  bool rose = false;
+  if (pga > peaks.pga) {
+    peaks.pga = pga;
+    rose = true;
+  }
+  if (pgv > peaks.pgv) {
+    peaks.pgv = pgv;
+    rose = true;
+  }
+  if (pgd > peaks.pgd) peaks.pgd = pgd;
+  if (rose) peaks.mmi = mmiFromGroundMotion(peaks.pga * cmPerCount, peaks.pgv * cmPerCount);
+}
+
+void Detector::update(int32_t x, int32_t y, int32_t z, uint32_t now_ms, DetectorOutput& out) {
+  out.x_dev = out.y_dev = out.z_dev = 0;
+  out.dev_mag_sq = 0;
+  out.mercalli = cfg.intensity_mode == INTENSITY_REGRESSION ? 1 : calculateMercalliSquared(0, mercalli);
+  out.mmi = 1;
+  out.sta_lta = 0;
+  out.triggered = false;
+  out.should_log = false;
+
+  // Initial baseline establishment: average the warm-up samples and start the
+  // filter in steady state at that level, so gravity causes no step response
+  if (sampleCount < warmupSamples) {
+    x_sum += x;
+    y_sum += y;
+    z_sum += z;
+    sampleCount++;
+    if (sampleCount == warmupSamples) {
+      bandFilter.prime((float)x_sum / sampleCount, (float)y_sum / sampleCount, (float)z_sum / sampleCount);
+    }
+    out.baseline_ready = false;
+    return;
+  }
+  out.baseline_ready = true;
+
+  // The high-pass removes gravity, tilt and drift; the low-pass limits the
+  // band the peaks and intensity are measured in
+  float x_filtered = (float)x, y_filtered = (float)y, z_filtered = (float)z;
+  bandFilter.process(x_filtered, y_filtered, z_filtered);
+  // Integrated ungated: the gate's steps would integrate into offsets
+  motion.update(x_filtered, y_filtered, z_filtered);
+
+  float x_deviation = fabsf(x_filtered);
+  float y_deviation = fabsf(y_filtered);
+  float z_deviation = fabsf(z_filtered);
+
+  // The triggers see the ungated signal energy, so they can follow the noise level
+  triggers[0].update(x_deviation * x_deviation);
+  triggers[1].update(y_deviation * y_deviation);
+  triggers[2].update(z_deviation * z_deviation);
+
+  // The noise floor is only measured while nothing is triggered
+  bool quiet = !triggers[0].triggered() && !triggers[1].triggered() && !triggers[2].triggered();
+  if (noise.update(x_deviation, y_deviation, z_deviation, !quiet)) adaptToNoise();
+
+  // Apply noise threshold - ignore small deviations
+  if (x_deviation < gate) x_deviation = 0;
+  if (y_deviation < gate) y_deviation = 0;
+  if (z_deviation < gate) z_deviation = 0;
+
+  // Magnitudes stay squared; the intensity thresholds are squared to match
+  float deviation_sq = x_deviation*x_deviation + y_deviation*y_deviation + z_deviation*z_deviation;
+
+  out.x_dev = x_deviation;
+  out.y_dev = y_deviation;
+  out.z_dev = z_deviation;
+  out.dev_mag_sq = deviation_sq;
+  float pga = x_deviation > y_deviation ? x_deviation : y_deviation;
+  float pgv = motion.horizontalVelocity();
+  out.mmi = mmiFromGroundMotion(pga * cmPerCount, pgv * cmPerCount);
+  if (cfg.intensity_mode == INTENSITY_REGRESSION) out.mercalli = (int)lroundf(out.mmi);
+  else out.mercalli = calculateMercalliSquared(deviation_sq, mercalli);
+
+  // Update peak deviations
+  if (x_deviation > peak.x) peak.x = x_deviation;
+  if (y_deviation > peak.y) peak.y = y_deviation;
+  if (z_deviation > peak.z) peak.z = z_deviation;
+
+  // Update peak deviation magnitude and Mercalli (based on deviation, not raw magnitude)
+  if (deviation_sq > peak.dev_mag_sq) {
+    peak.dev_mag_sq = deviation_sq;
+    peak.mercalli = out.mercalli;
+  }
+  float pgd = motion.horizontalDisplacement();
+  trackMotion(peak.motion, pga, pgv, pgd);
+  if (cfg.intensity_mode == INTENSITY_REGRESSION) peak.mercalli = (int)lroundf(peak.motion.mmi);
+
+  // Still track raw magnitude peak for reference
+  float magnitude_sq = (float)(x*x + y*y + z*z);
+  if (magnitude_sq > peak.magnitude_sq) peak.magnitude_sq = magnitude_sq;
+
+  // An event lasts while any axis is triggered. It is logged once, on the
+  // first triggered sample that reaches min_log_mercalli, so a logged event is
+  // at most one STA window behind the onset that caused the trigger.
+  for (int i = 0; i < 3; i++) {
+    if (triggers[i].ratio() > out.sta_lta) out.sta_lta = triggers[i].ratio();
+    if (triggers[i].triggered()) out.triggered = true;
+  }
+
+  if (!out.triggered) {
+    inEvent = false;
+    return;
+  }
+  if (!inEvent) {
+    inEvent = true;
+    eventLogged = false;
+    eventPeak.pga = eventPeak.pgv = eventPeak.pgd = 0;
+    eventPeak.mmi = 1;
+  }
+  trackMotion(eventPeak, pga, pgv, pgd);
+
+  bool intervalPassed = !hasLogged || (now_ms - lastEventTime >= cfg.min_event_interval_ms);
+  if (loggingEnabled && !eventLogged && intervalPassed && out.mercalli >= cfg.min_log_mercalli) {
+    out.should_log = true;
+    eventLogged = true;
+    hasLogged = true;
+    lastEventTime = now_ms;
+  }
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <stdint.h>
+#include "biquad.h"
+#include "mercalli.h"
+#include "sta_lta.h"
+#include "noise_floor.h"
+#include "ground_motion.h"
+
+// Portable signal-processing core: band-pass filter, noise gate, deviation
+// magnitude, peak tracking and STA/LTA event triggering. No Arduino
+// dependencies, so it runs unchanged on the board and in the native replay tool.
+//
+// Everything runs in sensor counts. Thresholds given in m/s² are converted once
+// in configure(), magnitudes are kept squared, and results are converted to
+// physical units only where they are shown (toMs2() and magnitudeMs2()).
+//
+// The noise gate starts at noise_threshold and then follows the measured
+// background noise (NoiseFloorTracker) unless noise_floor.enabled is false;
+// the same floor keeps each STA/LTA trigger's LTA from dropping below the
+// noise power of its axis.
+//
+// The band-passed signal is also integrated to velocity and displacement
+// (GroundMotion) for peak ground velocity and displacement, and mapped to a
+// fractional intensity by regression (mmiFromGroundMotion()). intensity_mode
+// chooses whether that or the threshold steps drive the integer intensity.
+
+struct DetectorConfig {
+  float sample_rate;              // Hz
+  float ms2_per_count;            // Sensor scale
+  FilterBandConfig filter;        // Band the deviations are measured in
+  float warmup_seconds;           // Baseline averaging before detection starts
+  float noise_threshold;          // Deviations below this are ignored (m/s²), until the noise floor is known
+  NoiseFloorConfig noise_floor;   // Adaptive gate and LTA floor
+  float mercalli_thresholds[11];  // Steps of the intensity scale (m/s²), ascending
+  uint32_t min_event_interval_ms; // Minimum time between logged events
+  int min_log_mercalli;           // Triggers below this intensity are not logged
+  IntensityMode intensity_mode;   // Source of the integer intensity
+  GroundMotionConfig ground_motion;
+  StaLtaConfig trigger;           // Per-axis STA/LTA trigger on the squared deviation
+};
+
+DetectorConfig defaultDetectorConfig(float sampleRate);
+
+// Result of processing one sample
+struct DetectorOutput {
+  float x_dev, y_dev, z_dev; // Band-passed deviations after the noise gate (counts)
+  float dev_mag_sq;          // Squared vector magnitude of the deviations (counts²)
+  int mercalli;              // Intensity of this sample
+  float mmi;                 // Fractional intensity of this sample by regression
+  float sta_lta;             // Highest STA/LTA ratio across the axes
+  bool triggered;            // At least one axis is triggered
+  bool baseline_ready;       // False while the baseline is being established
+  bool should_log;           // This sample should be logged as a seismic event
+};
+
+// Peak horizontal ground motion and the intensity it maps to. Velocity and
+// displacement convert to m/s and m with the same scale as counts to m/s².
+struct MotionPeaks {
+  float pga; // Acceleration after the noise gate (counts)
+  float pgv; // Velocity (counts·s)
+  float pgd; // Displacement (counts·s²)
+  float mmi; // mmiFromGroundMotion() of pga and pgv
+};
+
+// Peak values since the last reset
+struct DetectorPeaks {
+  float x, y, z;             // Peak deviation per axis (counts)
+  float dev_mag_sq;          // Peak squared deviation magnitude (counts²)
+  float magnitude_sq;        // Peak squared raw acceleration magnitude (counts²), for reference
+  int mercalli;              // Intensity of dev_mag_sq, or rounded motion.mmi in regression mode
+  MotionPeaks motion;
+};
+
+class Detector {
+  public:
+    Detector();
+
+    void configure(const DetectorConfig& config);
+    const DetectorConfig& config() const { return cfg; }
+    void setNoiseThreshold(float threshold);
+    // The gate in use (m/s²), adapted or as set
+    float noiseThreshold() const { return gate * cfg.ms2_per_count; }
+    const NoiseFloorTracker& noiseFloor() const { return noise; }
+
+    // Events are only logged while enabled (the board needs a valid clock)
+    void setLoggingEnabled(bool enabled) { loggingEnabled = enabled; }
+    // Takes effect from the next sample; peaks are not recomputed
+    void setIntensityMode(IntensityMode mode) { cfg.intensity_mode = mode; }
+    // Take the tunable thresholds of config (Mercalli steps, trigger ratios,
+    // event interval, logging floor and intensity mode) without touching the
+    // filters, averages or peaks, so detection carries on undisturbed
+    void retune(const DetectorConfig& config);
+
+    // Process one calibrated sample (counts) taken at now_ms
+    void update(int32_t x, int32_t y, int32_t z, uint32_t now_ms, DetectorOutput& out);
+
+    // Presentation-edge conversions
+    float toMs2(float counts) const { return counts * cfg.ms2_per_count; }
+    float magnitudeMs2(float squaredCounts) const;
+
+    const SosFilter3& filter() const { return bandFilter; }
+
+    // Clear peaks and restart baseline establishment
+    void reset();
+
+    // Forget the last logged event so the next one is judged afresh
+    void resetEventHistory();
+
+    // Per-axis trigger state (0 = X, 1 = Y, 2 = Z)
+    const StaLtaTrigger& trigger(int axis) const { return triggers[axis]; }
+    bool eventActive() const { return inEvent; }
+
+    const DetectorPeaks& peaks() const { return peak; }
+    // Ground motion since the current or most recent trigger started
+    const MotionPeaks& eventMotion() const { return eventPeak; }
+    const GroundMotion& groundMotion() const { return motion; }
+    bool baselineReady() const { return sampleCount >= warmupSamples; }
+    int baselineProgress() const { return sampleCount; }
+    int baselineTarget() const { return warmupSamples; }
+
+  private:
+    void adaptToNoise();
+    void trackMotion(MotionPeaks& peaks, float pga, float pgv, float pgd) const;
+
+    DetectorConfig cfg;
+    SosFilter3 bandFilter;
+    MercalliScale mercalli;
+    GroundMotion motion;
+    float cmPerCount;   // Counts to cm/s² (and counts·s to cm/s) for the regression
+    float gate;         // Noise gate in counts
+    float baseMinLta;   // trigger.min_lta in counts²
+    NoiseFloorTracker noise;
+    int warmupSamples;  // warmup_seconds at the sample rate
+    int sampleCount;
+    int32_t x_sum, y_sum, z_sum; // Accumulated during warm-up to prime the filter
+    DetectorPeaks peak;
+    MotionPeaks eventPeak;
+    StaLtaTrigger triggers[3];
+    bool loggingEnabled;
+    bool inEvent;         // Some axis has been triggered since the event started
+    bool eventLogged;     // The current event has already been logged
+    bool hasLogged;       // lastEventTime is valid
+    uint32_t lastEventTime;
+};
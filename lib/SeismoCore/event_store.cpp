@@ -0,0 +1,299 @@
+#include "event_store.h"
+#include "crc32.h"
+#include <math.h>
+#include <string.h>
+
+#define EVENT_RECORD_PAYLOAD (EVENT_RECORD_SIZE - 4)
+
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void putFloat(uint8_t* p, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  put32(p, bits);
+}
+
+static float getFloat(const uint8_t* p) {
+  uint32_t bits = get32(p);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+size_t encodeEventRecord(const StoredEvent& event, uint8_t* out) {
+  put32(out, EVENT_RECORD_MAGIC);
+  put32(out + 4, event.sequence);
+  put32(out + 8, event.timestamp);
+  putFloat(out + 12, event.mercalli);
+  putFloat(out + 16, event.x_peak);
+  putFloat(out + 20, event.y_peak);
+  putFloat(out + 24, event.z_peak);
+  putFloat(out + 28, event.magnitude);
+  float centiHz = event.dominant_hz * 100.0f + 0.5f;
+  put16(out + 32, centiHz <= 0 ? 0 : centiHz >= 65535.0f ? 65535 : (uint16_t)centiHz);
+  put16(out + 34, event.timestamp_ms);
+  putFloat(out + 36, event.jma_intensity);
+  putFloat(out + 40, event.pga);
+  putFloat(out + 44, event.pgv);
+  putFloat(out + 48, event.pgd);
+  putFloat(out + 52, event.mmi);
+  put32(out + 56, event.boot);
+  put32(out + 60, event.flags);
+  put32(out + 64, (uint32_t)(uint64_t)event.onset_us);
+  put32(out + 68, (uint32_t)((uint64_t)event.onset_us >> 32));
+  put32(out + EVENT_RECORD_PAYLOAD, crc32(out, EVENT_RECORD_PAYLOAD));
+  return EVENT_RECORD_SIZE;
+}
+
+size_t eventRecordSize(const uint8_t* data) {
+  uint32_t magic = get32(data);
+  if (magic == EVENT_RECORD_MAGIC) return EVENT_RECORD_SIZE;
+  if (magic == EVENT_RECORD_MAGIC_V3) return EVENT_RECORD_SIZE_V3;
+  if (magic == EVENT_RECORD_MAGIC_V2 || magic == EVENT_RECORD_MAGIC_V1) return EVENT_RECORD_SIZE_V2;
+  return 0;
+}
+
+bool decodeEventRecord(const uint8_t* data, StoredEvent& event) {
+  uint32_t magic = get32(data);
+  size_t size = eventRecordSize(data);
+  if (size == 0) return false;
+  if (get32(data + size - 4) != crc32(data, size - 4)) return false;
+  event.sequence = get32(data + 4);
+  event.timestamp = get32(data + 8);
+  event.mercalli = getFloat(data + 12);
+  event.x_peak = getFloat(data + 16);
+  event.y_peak = getFloat(data + 20);
+  event.z_peak = getFloat(data + 24);
+  event.magnitude = getFloat(data + 28);
+  if (magic == EVENT_RECORD_MAGIC_V1) {
+    event.dominant_hz = getFloat(data + 32);
+    event.timestamp_ms = 0;
+  } else {
+    event.dominant_hz = get16(data + 32) / 100.0f;
+    event.timestamp_ms = get16(data + 34);
+  }
+  if (magic == EVENT_RECORD_MAGIC || magic == EVENT_RECORD_MAGIC_V3) {
+    event.jma_intensity = getFloat(data + 36);
+    event.pga = getFloat(data + 40);
+    event.pgv = getFloat(data + 44);
+    event.pgd = getFloat(data + 48);
+    event.mmi = getFloat(data + 52);
+  } else {
+    event.jma_intensity = event.pga = event.pgv = event.pgd = event.mmi = NAN;
+  }
+  if (magic == EVENT_RECORD_MAGIC) {
+    event.boot = get32(data + 56);
+    event.flags = get32(data + 60);
+    event.onset_us = (int64_t)(get32(data + 64) | ((uint64_t)get32(data + 68) << 32));
+  } else {
+    event.boot = 0;
+    event.flags = 0;
+    event.onset_us = 0;
+  }
+  return true;
+}
+
+EventStore::EventStore(LogStorage& storage)
+  : storage(storage), perSegment(0), maxSegments(0), segments(0), headRecords(0),
+    headSealed(false), records(0), sequence(1), torn(0), errors(0) {}
+
+bool EventStore::begin(uint32_t recordsPerSegment, uint32_t segmentLimit) {
+  if (recordsPerSegment == 0 || segmentLimit < 2 || segmentLimit > EVENT_STORE_MAX_SEGMENTS) {
+    return false;
+  }
+  perSegment = recordsPerSegment;
+  maxSegments = segmentLimit;
+
+  // Only names, sizes and the first magic of each segment are looked at here
+  segments = storage.listSegments(ids, EVENT_STORE_MAX_SEGMENTS);
+  for (uint32_t i = 1; i < segments; i++) {
+    uint32_t id = ids[i];
+    uint32_t j = i;
+    for (; j > 0 && ids[j - 1] > id; j--) ids[j] = ids[j - 1];
+    ids[j] = id;
+  }
+  records = 0;
+  for (uint32_t i = 0; i < segments; i++) {
+    sizes[i] = (uint8_t)firstRecordSize(ids[i]);
+    records += recordsIn(i);
+  }
+  if (!trim(maxSegments)) errors++; // The limit may have been lowered
+
+  headRecords = 0;
+  headSealed = false;
+  torn = 0;
+  if (segments == 0) return true;
+
+  // Walk back from the end of the newest segment to the last valid record;
+  // normally the very first one checked
+  uint32_t head = segments - 1;
+  int32_t size = storage.segmentSize(ids[head]);
+  headRecords = recordsIn(head);
+  if (size < 0 || size % sizes[head] != 0 || sizes[head] != EVENT_RECORD_SIZE) headSealed = true;
+
+  for (int32_t s = (int32_t)segments - 1; s >= 0; s--) {
+    for (int32_t i = (int32_t)recordsIn(s) - 1; i >= 0; i--) {
+      StoredEvent last;
+      if (readRecord(s, i, last)) {
+        if (last.sequence >= sequence) sequence = last.sequence + 1;
+        return true;
+      }
+      torn++;
+      headSealed = true;
+    }
+  }
+  return true;
+}
+
+uint32_t EventStore::recordsIn(uint32_t s) {
+  int32_t size = storage.segmentSize(ids[s]);
+  return size > 0 ? (uint32_t)size / sizes[s] : 0;
+}
+
+// A segment that is empty or starts with a damaged record is taken to be in
+// the current size
+uint32_t EventStore::firstRecordSize(uint32_t segment) {
+  uint8_t magic[4];
+  if (!storage.read(segment, 0, magic, sizeof(magic))) return EVENT_RECORD_SIZE;
+  size_t size = eventRecordSize(magic);
+  return size > 0 ? (uint32_t)size : EVENT_RECORD_SIZE;
+}
+
+bool EventStore::readRecord(uint32_t s, uint32_t index, StoredEvent& event) {
+  uint8_t buffer[EVENT_RECORD_SIZE];
+  if (!storage.read(ids[s], index * sizes[s], buffer, sizes[s])) return false;
+  return eventRecordSize(buffer) == sizes[s] && decodeEventRecord(buffer, event);
+}
+
+// Delete the oldest segments, whole, until at most `limit` are left
+bool EventStore::trim(uint32_t limit) {
+  while (segments > limit) {
+    uint32_t dropped = recordsIn(0);
+    if (!storage.remove(ids[0])) return false;
+    records -= dropped < records ? dropped : records;
+    segments--;
+    memmove(ids, ids + 1, segments * sizeof(ids[0]));
+    memmove(sizes, sizes + 1, segments * sizeof(sizes[0]));
+  }
+  return true;
+}
+
+bool EventStore::startSegment() {
+  if (!trim(maxSegments - 1)) return false;
+
+  ids[segments] = segments > 0 ? ids[segments - 1] + 1 : 1;
+  sizes[segments] = EVENT_RECORD_SIZE;
+  segments++;
+  headRecords = 0;
+  headSealed = false;
+  return true;
+}
+
+bool EventStore::append(StoredEvent& event) {
+  if (perSegment == 0) return false;
+  if (segments == 0 || headSealed || headRecords >= perSegment) {
+    if (!startSegment()) {
+      errors++;
+      return false;
+    }
+  }
+
+  event.sequence = sequence;
+  uint8_t buffer[EVENT_RECORD_SIZE];
+  encodeEventRecord(event, buffer);
+  if (!storage.append(ids[segments - 1], buffer, sizeof(buffer))) {
+    // The segment may now end in a partial record
+    errors++;
+    headSealed = true;
+    return false;
+  }
+
+  sequence++;
+  headRecords++;
+  records++;
+  return true;
+}
+
+size_t EventStore::readLatest(StoredEvent* out, size_t maxEvents) {
+  size_t count = 0;
+  for (int32_t s = (int32_t)segments - 1; s >= 0 && count < maxEvents; s--) {
+    for (int32_t i = (int32_t)recordsIn(s) - 1; i >= 0 && count < maxEvents; i--) {
+      if (readRecord(s, i, out[count])) count++;
+    }
+  }
+  return count;
+}
+
+void EventStore::forEach(StoredEventVisitor visit, void* context) {
+  EventCursor cursor = {0, 0};
+  StoredEvent batch[16];
+  size_t count;
+  while ((count = readNext(cursor, batch, 16)) > 0) {
+    for (size_t i = 0; i < count; i++) visit(batch[i], context);
+  }
+}
+
+size_t EventStore::readNext(EventCursor& cursor, StoredEvent* out, size_t maxEvents) {
+  const uint32_t BATCH = 16;
+  uint8_t buffer[BATCH * EVENT_RECORD_SIZE];
+  if (maxEvents > BATCH) maxEvents = BATCH;
+
+  size_t count = 0;
+  while (count == 0 && maxEvents > 0) {
+    // The first segment at or after the cursor
+    uint32_t s = 0;
+    while (s < segments && ids[s] < cursor.segment) s++;
+    if (s == segments) break;
+    if (ids[s] != cursor.segment) {
+      cursor.segment = ids[s];
+      cursor.record = 0;
+    }
+
+    uint32_t total = recordsIn(s);
+    uint32_t size = sizes[s];
+    uint32_t batch = total > cursor.record ? total - cursor.record : 0;
+    if (batch > maxEvents) batch = maxEvents;
+    if (batch == 0 || !storage.read(ids[s], cursor.record * size, buffer, batch * size)) {
+      cursor.segment++;
+      cursor.record = 0;
+      continue;
+    }
+    for (uint32_t i = 0; i < batch; i++) {
+      const uint8_t* record = buffer + i * size;
+      if (eventRecordSize(record) == size && decodeEventRecord(record, out[count])) count++;
+    }
+    cursor.record += batch;
+  }
+  return count;
+}
+
+bool EventStore::clear() {
+  bool ok = true;
+  for (uint32_t i = 0; i < segments; i++) {
+    if (!storage.remove(ids[i])) ok = false;
+  }
+  segments = 0;
+  records = 0;
+  headRecords = 0;
+  headSealed = false;
+  torn = 0;
+  return ok;
+}
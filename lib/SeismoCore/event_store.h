@@ -0,0 +1,161 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Append-only, log-structured event store.
+//
+// Events are written as fixed-size, CRC-protected records to numbered segment
+// files. A segment is only ever appended to; when it is full the next one is
+// started, and when there are too many segments the oldest is deleted whole.
+// Nothing is rewritten in place, so flash wear is spread over the partition
+// by the file system and a power cut can at worst leave a torn record at the
+// end of the newest segment.
+//
+// begin() reads only the end of the newest segment (and the first magic of
+// each segment, for its record size). If that tail is torn it is left alone
+// (readers skip records whose CRC fails) and appends continue in a fresh
+// segment, so they never land behind garbage.
+//
+// Record layout, little-endian, EVENT_RECORD_SIZE bytes:
+//    0  u32  magic EVENT_RECORD_MAGIC
+//    4  u32  sequence number, +1 per event, never reused
+//    8  u32  timestamp, UTC seconds; 0 with EVENT_UNSYNCED
+//   12  f32  Mercalli intensity
+//   16  f32  x, y, z peak deviation (m/s²), 3 x 4 bytes
+//   28  f32  deviation magnitude (m/s²)
+//   32  u16  dominant frequency (0.01 Hz), 0 if unknown
+//   34  u16  milliseconds of the timestamp
+//   36  f32  JMA instrumental intensity, NaN if unknown
+//   40  f32  PGA (m/s²), PGV (m/s), PGD (m), 3 x 4 bytes, NaN if unknown
+//   52  f32  intensity from PGA/PGV by regression, NaN if unknown
+//   56  u32  boot the event was detected in (station boot counter)
+//   60  u32  flags, EVENT_UNSYNCED
+//   64  i64  onset, microseconds since that boot
+//   72  u32  CRC-32 of bytes 0-71
+//
+// An event detected before the clock was set is written at once, with its
+// boot and onset and EVENT_UNSYNCED; the record is never rewritten, so its
+// UTC time is derived later from the time the boot started.
+//
+// A segment holds records of one size, set by the magic of its first record.
+// Older segments stay readable: EVENT_RECORD_MAGIC_V3 records are
+// EVENT_RECORD_SIZE_V3 bytes, the layout above up to the regression
+// intensity with the CRC at 56. EVENT_RECORD_MAGIC_V2 ones are
+// EVENT_RECORD_SIZE_V2 bytes, up to the milliseconds with the CRC at 36;
+// EVENT_RECORD_MAGIC_V1 ones are the same size with the dominant frequency as
+// f32 at 32 (always 0 in the oldest ones) and no milliseconds. Fields they
+// lack read as 0 (boot, onset, milliseconds) and NaN. After an update the
+// newest segment is in the old size, so appends start a new one.
+
+#define EVENT_RECORD_SIZE          76
+#define EVENT_RECORD_SIZE_V3       60
+#define EVENT_RECORD_SIZE_V2       40
+#define EVENT_RECORD_MAGIC         0x34564553 // "SEV4"
+#define EVENT_RECORD_MAGIC_V3      0x33564553 // "SEV3"
+#define EVENT_RECORD_MAGIC_V2      0x32564553 // "SEV2"
+#define EVENT_RECORD_MAGIC_V1      0x31564553 // "SEV1"
+#define EVENT_STORE_MAX_SEGMENTS   64
+
+#define EVENT_UNSYNCED 0x01 // No UTC time when written
+
+struct StoredEvent {
+  uint32_t sequence;  // Assigned by append()
+  uint32_t timestamp;
+  uint16_t timestamp_ms;
+  float mercalli;
+  float x_peak;
+  float y_peak;
+  float z_peak;
+  float magnitude;
+  float dominant_hz;
+  float jma_intensity;
+  float pga;
+  float pgv;
+  float pgd;
+  float mmi;
+  uint32_t boot;
+  uint32_t flags;
+  int64_t onset_us;
+};
+
+// Segment files; implemented on top of a (flash) file system
+class LogStorage {
+  public:
+    virtual ~LogStorage() {}
+    // Ids of the existing segments in any order; returns how many were found
+    virtual size_t listSegments(uint32_t* ids, size_t maxIds) = 0;
+    // Size in bytes, -1 if the segment does not exist
+    virtual int32_t segmentSize(uint32_t id) = 0;
+    // Append and make durable; creates the segment if needed
+    virtual bool append(uint32_t id, const uint8_t* data, size_t length) = 0;
+    virtual bool read(uint32_t id, uint32_t offset, uint8_t* data, size_t length) = 0;
+    virtual bool remove(uint32_t id) = 0;
+};
+
+typedef void (*StoredEventVisitor)(const StoredEvent& event, void* context);
+
+// Read position for walking the store a batch at a time (EventStore::readNext)
+struct EventCursor {
+  uint32_t segment; // Segment id, 0 before the first read
+  uint32_t record;  // Next record in that segment
+};
+
+class EventStore {
+  public:
+    explicit EventStore(LogStorage& storage);
+
+    // Find the segments and recover the sequence from the newest valid record
+    bool begin(uint32_t recordsPerSegment, uint32_t maxSegments);
+
+    // Assigns event.sequence
+    bool append(StoredEvent& event);
+
+    // Up to maxEvents of the newest valid events, newest first
+    size_t readLatest(StoredEvent* out, size_t maxEvents);
+
+    // Every valid event, oldest first
+    void forEach(StoredEventVisitor visit, void* context);
+
+    // Up to maxEvents valid events from the cursor on, oldest first, moving
+    // the cursor past them; 0 at the end. Appends in between are picked up,
+    // segments dropped in between are skipped. Start from {0, 0}.
+    size_t readNext(EventCursor& cursor, StoredEvent* out, size_t maxEvents);
+
+    // Delete every segment (sequence numbers restart after the next boot)
+    bool clear();
+
+    // Records on storage (torn ones included until their segment is dropped)
+    uint32_t recordCount() const { return records; }
+    uint32_t capacity() const { return perSegment * maxSegments; }
+    uint32_t segmentCount() const { return segments; }
+    uint32_t nextSequence() const { return sequence; }
+    uint32_t tornRecords() const { return torn; }
+    uint32_t errorCount() const { return errors; }
+
+  private:
+    // Both take the position of the segment in ids[]
+    bool readRecord(uint32_t s, uint32_t index, StoredEvent& event);
+    uint32_t recordsIn(uint32_t s);
+    uint32_t firstRecordSize(uint32_t segment);
+    bool trim(uint32_t limit);
+    bool startSegment();
+
+    LogStorage& storage;
+    uint32_t perSegment;
+    uint32_t maxSegments;
+    uint32_t ids[EVENT_STORE_MAX_SEGMENTS]; // Ascending; the last one is the head
+    uint8_t sizes[EVENT_STORE_MAX_SEGMENTS]; // Record size of each
+    uint32_t segments;
+    uint32_t headRecords;  // Records in the head segment
+    bool headSealed;       // The head has a torn tail; start a new segment first
+    uint32_t records;
+    uint32_t sequence;
+    uint32_t torn;
+    uint32_t errors;
+};
+
+size_t encodeEventRecord(const StoredEvent& event, uint8_t* out);
+// Size of the record starting with this magic, 0 if it is not one
+size_t eventRecordSize(const uint8_t* data);
+// False if the magic or CRC does not match; older records are converted
+bool decodeEventRecord(const uint8_t* data, StoredEvent& event);
@@ -0,0 +1,73 @@
+#include "file_log_storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+FileLogStorage::FileLogStorage(const char* path) {
+  strncpy(directory, path, sizeof(directory) - 1);
+  directory[sizeof(directory) - 1] = '\0';
+}
+
+bool FileLogStorage::begin() {
+  struct stat info;
+  if (stat(directory, &info) == 0) return S_ISDIR(info.st_mode);
+  return mkdir(directory, 0755) == 0;
+}
+
+void FileLogStorage::segmentPath(uint32_t id, char* path, size_t size) const {
+  snprintf(path, size, "%s/%08lx.log", directory, (unsigned long)id);
+}
+
+size_t FileLogStorage::listSegments(uint32_t* ids, size_t maxIds) {
+  DIR* dir = opendir(directory);
+  if (!dir) return 0;
+
+  size_t count = 0;
+  struct dirent* entry;
+  while (count < maxIds && (entry = readdir(dir)) != NULL) {
+    const char* name = entry->d_name;
+    char* end;
+    unsigned long id = strtoul(name, &end, 16);
+    if (end != name + 8 || strcmp(end, ".log") != 0 || id == 0) continue;
+    ids[count++] = (uint32_t)id;
+  }
+  closedir(dir);
+  return count;
+}
+
+int32_t FileLogStorage::segmentSize(uint32_t id) {
+  char path[64];
+  segmentPath(id, path, sizeof(path));
+  struct stat info;
+  if (stat(path, &info) != 0) return -1;
+  return (int32_t)info.st_size;
+}
+
+bool FileLogStorage::append(uint32_t id, const uint8_t* data, size_t length) {
+  char path[64];
+  segmentPath(id, path, sizeof(path));
+  FILE* file = fopen(path, "ab");
+  if (!file) return false;
+  // Closing commits the write on LittleFS
+  bool ok = fwrite(data, 1, length, file) == length;
+  if (fclose(file) != 0) ok = false;
+  return ok;
+}
+
+bool FileLogStorage::read(uint32_t id, uint32_t offset, uint8_t* data, size_t length) {
+  char path[64];
+  segmentPath(id, path, sizeof(path));
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  bool ok = fseek(file, offset, SEEK_SET) == 0 && fread(data, 1, length, file) == length;
+  fclose(file);
+  return ok;
+}
+
+bool FileLogStorage::remove(uint32_t id) {
+  char path[64];
+  segmentPath(id, path, sizeof(path));
+  return ::remove(path) == 0;
+}
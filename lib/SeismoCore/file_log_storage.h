@@ -0,0 +1,24 @@
+#pragma once
+#include "event_store.h"
+
+// Segments as files named <8 hex digits>.log in one directory, through the C
+// library. On the board the directory lives on LittleFS (mounted into the VFS
+// at /littlefs); on the host it is an ordinary directory.
+class FileLogStorage : public LogStorage {
+  public:
+    explicit FileLogStorage(const char* directory);
+
+    // Create the directory if it does not exist
+    bool begin();
+
+    size_t listSegments(uint32_t* ids, size_t maxIds);
+    int32_t segmentSize(uint32_t id);
+    bool append(uint32_t id, const uint8_t* data, size_t length);
+    bool read(uint32_t id, uint32_t offset, uint8_t* data, size_t length);
+    bool remove(uint32_t id);
+
+  private:
+    void segmentPath(uint32_t id, char* path, size_t size) const;
+
+    char directory[48];
+};
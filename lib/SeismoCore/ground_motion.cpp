@@ -0,0 +1,45 @@
+#include "ground_motion.h"
+#include <math.h>
+
+GroundMotionConfig defaultGroundMotionConfig() {
+  GroundMotionConfig config;
+  config.highpass_hz = 0.1f; // The detection band's lower edge
+  config.q = 0.7071f;
+  return config;
+}
+
+GroundMotion::GroundMotion() {
+  configure(defaultGroundMotionConfig(), 100.0f);
+}
+
+void GroundMotion::configure(const GroundMotionConfig& config, float sampleRate) {
+  BiquadCoeffs stage = designLeakyIntegrator(config.highpass_hz, sampleRate, config.q);
+  velocityStage.setSections(&stage, 1);
+  displacementStage.setSections(&stage, 1);
+  reset();
+}
+
+void GroundMotion::reset() {
+  velocityStage.reset();
+  displacementStage.reset();
+  for (int axis = 0; axis < 3; axis++) a[axis] = v[axis] = d[axis] = 0;
+}
+
+float GroundMotion::horizontal(const float* axes) {
+  float x = fabsf(axes[0]), y = fabsf(axes[1]);
+  return x > y ? x : y;
+}
+
+void GroundMotion::update(float x, float y, float z) {
+  a[0] = x;
+  a[1] = y;
+  a[2] = z;
+  velocityStage.process(x, y, z);
+  v[0] = x;
+  v[1] = y;
+  v[2] = z;
+  displacementStage.process(x, y, z);
+  d[0] = x;
+  d[1] = y;
+  d[2] = z;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include "biquad.h"
+
+// Ground velocity and displacement from the band-passed acceleration, by
+// drift-controlled streaming integration.
+//
+// Plain integration turns an offset into a ramp and noise into a random walk.
+// Each stage here is a leaky integrator (designLeakyIntegrator()): 1/s above
+// highpass_hz and a second-order Butterworth high-pass below it, so neither
+// velocity nor displacement can wander off. Acceleration -> velocity ->
+// displacement is two biquads per axis, O(1) per sample.
+//
+// Units follow the input: acceleration in counts gives velocity in counts·s
+// and displacement in counts·s², which the count-to-m/s² scale turns into m/s
+// and m. Intensity regressions take the larger horizontal component (X or Y;
+// Z is vertical), hence the horizontal...() accessors.
+
+struct GroundMotionConfig {
+  float highpass_hz; // Corner of each integration stage
+  float q;           // Of each stage; 0.707 is Butterworth
+};
+
+GroundMotionConfig defaultGroundMotionConfig();
+
+class GroundMotion {
+  public:
+    GroundMotion();
+
+    void configure(const GroundMotionConfig& config, float sampleRate);
+    // Zero the integrators
+    void reset();
+
+    // One band-passed acceleration sample (counts)
+    void update(float x, float y, float z);
+
+    float velocity(int axis) const { return v[axis]; }
+    float displacement(int axis) const { return d[axis]; }
+    // Larger horizontal component of the newest sample
+    float horizontalAcceleration() const { return horizontal(a); }
+    float horizontalVelocity() const { return horizontal(v); }
+    float horizontalDisplacement() const { return horizontal(d); }
+
+  private:
+    static float horizontal(const float* axes);
+
+    SosFilter3 velocityStage;
+    SosFilter3 displacementStage;
+    float a[3], v[3], d[3];
+};
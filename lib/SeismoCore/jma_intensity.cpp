@@ -0,0 +1,234 @@
+#include "jma_intensity.h"
+#include <math.h>
+#include <string.h>
+
+// The ideal impulse response is sampled from the weights on a grid this many
+// times finer than the transform, so truncating it to `taps` is the only
+// approximation
+#define JMA_DESIGN_OVERSAMPLE 8
+// Share of the taps on each side left untapered (Tukey window); the low cut
+// needs the long tail of the response more than a smooth cutoff
+#define JMA_TAPER_FLAT 0.3f
+
+float jmaFilterWeight(float hz) {
+  if (hz <= 0) return 0;
+  float y = hz / 10.0f;
+  float y2 = y * y;
+  float highCut = 1 + y2 * (0.694f + y2 * (0.241f + y2 * (0.0557f + y2 * (0.009664f +
+                  y2 * (0.00134f + y2 * 0.000155f)))));
+  float r = hz / 0.5f;
+  float lowCut = 1 - expf(-r * r * r);
+  // sqrt(1 / f) * highCut^-1/2 * sqrt(lowCut)
+  return sqrtf(lowCut / (hz * highCut));
+}
+
+const char* jmaIntensityClass(float intensity) {
+  // Limits in hundredths, so 0.50 is class 1 however it was rounded to float
+  static const int16_t LIMITS[] = { 50, 150, 250, 350, 450, 500, 550, 600, 650 };
+  static const char* const NAMES[] = { "0", "1", "2", "3", "4", "5-", "5+", "6-", "6+", "7" };
+  int32_t hundredths = (int32_t)floorf(intensity * 100.0f + 0.5f);
+  int i = 0;
+  while (i < 9 && hundredths >= LIMITS[i]) i++;
+  return NAMES[i];
+}
+
+JmaConfig defaultJmaConfig(float sampleRate, float ms2PerCount) {
+  JmaConfig config;
+  config.points = 512;
+  config.taps = 413;
+  config.sample_rate = sampleRate;
+  config.gal_per_count = ms2PerCount * 100.0f;
+  config.window_seconds = 60;
+  config.duration_seconds = 0.3f;
+  return config;
+}
+
+uint32_t jmaWindowSamples(const JmaConfig& config) {
+  return (uint32_t)(config.window_seconds * config.sample_rate + 0.5f);
+}
+
+JmaIntensity::JmaIntensity()
+  : history(NULL), data(NULL), zData(NULL), response(NULL), window(NULL), head(0), filled(0),
+    pending(0), windowLength(0), windowHead(0), windowFilled(0), needed(1), binOffset(0),
+    levelBin(0), peakBin(0), blocks(0) {
+  cfg = defaultJmaConfig(100.0f, 0.0390625f);
+  cfg.points = 0;
+  memset(counts, 0, sizeof(counts));
+}
+
+bool JmaIntensity::begin(const JmaConfig& config, RawSample* samples, float* work, uint16_t* windowBuffer) {
+  bool powerOfTwo = config.points >= 16 && (config.points & (config.points - 1)) == 0;
+  uint32_t length = jmaWindowSamples(config);
+  uint32_t duration = (uint32_t)(config.duration_seconds * config.sample_rate + 0.5f);
+  if (!powerOfTwo || config.points > JMA_MAX_POINTS || config.taps % 2 == 0 ||
+      config.taps >= config.points || config.sample_rate <= 0 || config.gal_per_count <= 0 ||
+      duration < 1 || length < duration || length > 65535 || !samples || !work || !windowBuffer ||
+      !fftBegin()) {
+    cfg.points = 0;
+    return false;
+  }
+  cfg = config;
+  history = samples;
+  data = work;
+  zData = work + 2 * cfg.points;
+  response = work + 4 * cfg.points;
+  window = windowBuffer;
+  windowLength = length;
+  needed = duration;
+  // I = log10(a² in gal²) + 0.94, in hundredths above bin 0
+  binOffset = 100.0f * log10f(cfg.gal_per_count * cfg.gal_per_count) + 94.0f - JMA_MIN_HUNDREDTHS;
+  design();
+  reset();
+  return true;
+}
+
+static float taper(uint32_t t, uint32_t half) {
+  float flat = JMA_TAPER_FLAT * (half + 1);
+  if (t <= flat) return 1;
+  return 0.5f + 0.5f * cosf((float)M_PI * (t - flat) / (half + 1 - flat));
+}
+
+// Zero-phase FIR: the ideal impulse response (real and even, as the weights
+// are) cut to `taps` with a Tukey window and corrected to sum to 0, so
+// gravity and any offset are removed exactly. Its transform is real too.
+void JmaIntensity::design() {
+  uint32_t n = cfg.points;
+  uint32_t half = cfg.taps / 2;
+  uint32_t grid = n * JMA_DESIGN_OVERSAMPLE;
+  float* h = zData; // half + 1 coefficients, h[-t] = h[t]
+
+  // h[t] = 1/grid * sum over the grid of W(f) cos(2 pi k t / grid), by rotation
+  for (uint32_t t = 0; t <= half; t++) h[t] = 0;
+  for (uint32_t k = 0; k <= grid / 2; k++) {
+    float weight = jmaFilterWeight(k * cfg.sample_rate / grid) / grid;
+    if (k > 0 && k < grid / 2) weight *= 2; // Negative frequencies
+    if (weight == 0) continue;
+    float step = 2.0f * (float)M_PI * k / grid;
+    float rotateCos = cosf(step), rotateSin = sinf(step);
+    float c = 1, s = 0;
+    for (uint32_t t = 0; t <= half; t++) {
+      h[t] += weight * c;
+      float next = c * rotateCos - s * rotateSin;
+      s = s * rotateCos + c * rotateSin;
+      c = next;
+    }
+  }
+
+  float sum = 0, taperSum = 0;
+  for (uint32_t t = 0; t <= half; t++) {
+    float w = taper(t, half);
+    h[t] *= w;
+    sum += (t == 0 ? 1 : 2) * h[t];
+    taperSum += (t == 0 ? 1 : 2) * w;
+  }
+  for (uint32_t t = 0; t <= half; t++) {
+    h[t] -= sum / taperSum * taper(t, half);
+  }
+
+  // Circularly centred on sample 0
+  for (uint32_t i = 0; i < 2 * n; i++) data[i] = 0;
+  data[0] = h[0];
+  for (uint32_t t = 1; t <= half; t++) data[2 * t] = data[2 * (n - t)] = h[t];
+  fftComplex(data, n);
+  for (uint32_t k = 0; k <= n / 2; k++) response[k] = data[2 * k] / n;
+}
+
+void JmaIntensity::reset() {
+  head = 0;
+  filled = 0;
+  pending = 0;
+  windowHead = 0;
+  windowFilled = 0;
+  memset(counts, 0, sizeof(counts));
+  levelBin = 0;
+  peakBin = 0;
+}
+
+bool JmaIntensity::push(const RawSample& sample) {
+  if (cfg.points == 0) return false;
+  history[head] = sample;
+  if (++head == cfg.points) head = 0;
+  if (filled < cfg.points) filled++;
+  pending++;
+  return filled == cfg.points && pending >= cfg.points - cfg.taps + 1;
+}
+
+void JmaIntensity::add(float magnitudeSq) {
+  int32_t bin = 0;
+  if (magnitudeSq > 0) {
+    float hundredths = 100.0f * log10f(magnitudeSq) + binOffset;
+    if (hundredths >= JMA_INTENSITY_BINS - 1) bin = JMA_INTENSITY_BINS - 1;
+    else if (hundredths > 0) bin = (int32_t)hundredths;
+  }
+  if (windowFilled == windowLength) counts[window[windowHead]]--;
+  else windowFilled++;
+  window[windowHead] = (uint16_t)bin;
+  counts[bin]++;
+  if (++windowHead == windowLength) windowHead = 0;
+}
+
+void JmaIntensity::process() {
+  if (cfg.points == 0 || filled < cfg.points) return;
+  uint32_t n = cfg.points;
+  uint32_t half = cfg.taps / 2;
+  uint32_t hop = n - cfg.taps + 1;
+
+  // The FIR sums to 0, so removing the block mean changes no valid output;
+  // it keeps gravity out of the float arithmetic
+  int32_t sum[3] = { 0, 0, 0 };
+  for (uint32_t i = 0; i < n; i++) {
+    sum[0] += history[i].x;
+    sum[1] += history[i].y;
+    sum[2] += history[i].z;
+  }
+  float mean[3] = { (float)sum[0] / n, (float)sum[1] / n, (float)sum[2] / n };
+
+  // X + iY and Z, oldest sample first
+  for (uint32_t i = 0; i < n; i++) {
+    const RawSample& sample = history[(head + i) % n];
+    data[2 * i] = sample.x - mean[0];
+    data[2 * i + 1] = sample.y - mean[1];
+    zData[2 * i] = sample.z - mean[2];
+    zData[2 * i + 1] = 0;
+  }
+  fftComplex(data, n);
+  fftComplex(zData, n);
+
+  // Multiply by the real response and conjugate: the inverse transform is
+  // then the conjugate of a forward one. A real response filters the real and
+  // imaginary parts independently, so X and Y stay apart.
+  for (uint32_t k = 0; k < n; k++) {
+    float gain = response[k <= n / 2 ? k : n - k];
+    data[2 * k] *= gain;
+    data[2 * k + 1] *= -gain;
+    zData[2 * k] *= gain;
+    zData[2 * k + 1] *= -gain;
+  }
+  fftComplex(data, n);
+  fftComplex(zData, n);
+
+  // Outputs that did not wrap around: the taps fit inside the block. Y comes
+  // out negated (the final conjugate is skipped), which the magnitude ignores.
+  for (uint32_t i = half; i < half + hop; i++) {
+    float x = data[2 * i], y = data[2 * i + 1], z = zData[2 * i];
+    add(x * x + y * y + z * z);
+  }
+  pending = 0;
+  blocks++;
+
+  if (!valid()) return;
+  // Highest bin with at least `needed` samples at or above it
+  uint32_t above = 0;
+  int32_t bin = JMA_INTENSITY_BINS - 1;
+  for (; bin > 0; bin--) {
+    above += counts[bin];
+    if (above >= needed) break;
+  }
+  levelBin = (uint16_t)bin;
+  if (levelBin > peakBin) peakBin = levelBin;
+}
+
+float JmaIntensity::level() const {
+  // Lower edge of the bin: I = 2 log10(a) + 0.94
+  return powf(10.0f, (intensity() - 0.94f) / 2.0f);
+}
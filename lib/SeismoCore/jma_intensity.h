@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "adxl345_fifo.h"
+#include "spectrum.h"
+
+// JMA instrumental seismic intensity of the recent 3-axis signal.
+//
+// The Japan Meteorological Agency's method: each acceleration component is
+// weighted in the frequency domain (period effect 1/sqrt(f), a high cut and a
+// 0.5 Hz low cut), the filtered components are added as a vector, and a is
+// the level that vector magnitude exceeds for a cumulative 0.3 s. The
+// intensity I = 2 log10(a) + 0.94, a in gal, is continuous, and one spike
+// cannot raise it the way it raises calculateMercalli().
+//
+// Streaming: the weights are turned into a zero-phase FIR of `taps` once, and
+// applied by overlap-save FFT convolution. Each time points - taps + 1 new
+// samples have been pushed, one transform of the newest `points` filters that
+// many more samples, taps / 2 samples behind the newest. X and Y share one
+// complex transform, as in SpectrumAnalyzer. Every filtered magnitude enters
+// the window as an intensity bin JMA_INTENSITY_STEP wide and a count per bin
+// follows the window as it slides, so the 0.3 s level is a walk down the bins
+// instead of a sort. Bins truncate to 0.01, as JMA reports intensity.
+//
+// Nothing is allocated: the caller supplies the history, the work buffer and
+// the window.
+
+#define JMA_MAX_POINTS SPECTRUM_MAX_POINTS
+#define JMA_MIN_HUNDREDTHS -300   // Bin 0: intensity -3.00 and below
+#define JMA_INTENSITY_BINS 1300   // Up to 9.99, past the sensor's 16 g
+// Floats of work buffer begin() needs for `points`
+#define JMA_WORK_SIZE(points) (4 * (points) + (points) / 2 + 1)
+
+struct JmaConfig {
+  uint32_t points;        // Power of two, 16 to JMA_MAX_POINTS
+  uint32_t taps;          // Odd and below points; the FIR spans taps / sample_rate
+  float sample_rate;      // Of the pushed samples (Hz)
+  float gal_per_count;    // 1 gal = 1 cm/s²
+  float window_seconds;   // Intensity of the newest this much filtered signal
+  float duration_seconds; // Cumulative time above the level (0.3 s for JMA)
+};
+
+// 512 points and 413 taps (±2 s at 100 Hz): a result every 100 samples, over
+// 60 s like real-time JMA intensity
+JmaConfig defaultJmaConfig(float sampleRate, float ms2PerCount);
+
+// Entries of window buffer begin() needs
+uint32_t jmaWindowSamples(const JmaConfig& config);
+
+// Gain of the JMA filter (period effect, high cut and low cut) at hz
+float jmaFilterWeight(float hz);
+// Intensity class of a JMA intensity: "0" to "4", "5-", "5+", "6-", "6+", "7"
+const char* jmaIntensityClass(float intensity);
+
+class JmaIntensity {
+  public:
+    JmaIntensity();
+
+    // samples: config.points entries; work: JMA_WORK_SIZE(config.points)
+    // floats; window: jmaWindowSamples(config) entries. Designs the filter.
+    // False if the configuration is unusable.
+    bool begin(const JmaConfig& config, RawSample* samples, float* work, uint16_t* window);
+    const JmaConfig& config() const { return cfg; }
+
+    // Forget the history, the window and the peak
+    void reset();
+    // Store a sample; true when a block is due and process() should be called
+    bool push(const RawSample& sample);
+    // Filter the due block into the window and update the intensity
+    void process();
+
+    // The window holds at least duration_seconds of filtered signal
+    bool valid() const { return windowFilled >= needed; }
+    // Of the window; -3.00 or below reads as -3.00
+    float intensity() const { return (JMA_MIN_HUNDREDTHS + (int32_t)levelBin) / 100.0f; }
+    // The level a (gal) behind intensity()
+    float level() const;
+    // Highest intensity() since reset() or resetPeak(); -3.00 if none yet
+    float peak() const { return (JMA_MIN_HUNDREDTHS + (int32_t)peakBin) / 100.0f; }
+    void resetPeak() { peakBin = valid() ? levelBin : 0; }
+
+    // Pushed samples until a sample is reflected in intensity(), at most
+    uint32_t latencySamples() const { return cfg.points - cfg.taps + 1 + cfg.taps / 2; }
+    uint32_t blockCount() const { return blocks; }
+
+  private:
+    void design();
+    void add(float magnitudeSq);
+
+    JmaConfig cfg;
+    RawSample* history;
+    float* data;       // X + iY transform
+    float* zData;      // Z transform
+    float* response;   // Real FIR response for bins 0 to points / 2, 1 / points included
+    uint16_t* window;  // Intensity bins, oldest overwritten first
+    uint32_t head;     // Where the next sample goes (the oldest one once full)
+    uint32_t filled;
+    uint32_t pending;  // Pushed since the last block
+    uint32_t windowLength;
+    uint32_t windowHead;
+    uint32_t windowFilled;
+    uint32_t needed;   // Samples in duration_seconds
+    float binOffset;   // Bin = 100 log10(magnitude² in counts²) + binOffset
+    uint16_t counts[JMA_INTENSITY_BINS];
+    uint16_t levelBin;
+    uint16_t peakBin;
+    uint32_t blocks;
+};
@@ -0,0 +1,159 @@
+#include "json_writer.h"
+#include <math.h>
+
+JsonWriter::JsonWriter(char* buffer, size_t size, JsonSink sink, void* context)
+  : buf(buffer), capacity(size > 0 ? size - 1 : 0), used(0), total(0), sink(sink),
+    context(context), overflow(false), depth(0) {
+  first[0] = true;
+  if (size > 0) buf[0] = '\0';
+}
+
+void JsonWriter::flush() {
+  if (sink && used > 0) {
+    sink(buf, used, context);
+    total += used;
+    used = 0;
+  }
+}
+
+void JsonWriter::put(char c) {
+  if (used == capacity) {
+    if (!sink) {
+      overflow = true;
+      return;
+    }
+    flush();
+  }
+  buf[used++] = c;
+}
+
+void JsonWriter::put(const char* text) {
+  while (*text) put(*text++);
+}
+
+void JsonWriter::putQuoted(const char* text) {
+  static const char hex[] = "0123456789abcdef";
+  put('"');
+  for (; *text; text++) {
+    unsigned char c = (unsigned char)*text;
+    if (c == '"' || c == '\\') {
+      put('\\');
+      put((char)c);
+    } else if (c == '\n') {
+      put("\\n");
+    } else if (c < 0x20) {
+      put("\\u00");
+      put(hex[c >> 4]);
+      put(hex[c & 0x0F]);
+    } else {
+      put((char)c);
+    }
+  }
+  put('"');
+}
+
+void JsonWriter::putUnsigned(uint64_t value) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  while (count > 0) put(digits[--count]);
+}
+
+void JsonWriter::separator(const char* key) {
+  if (!first[depth]) put(',');
+  first[depth] = false;
+  if (key) {
+    putQuoted(key);
+    put(':');
+  }
+}
+
+void JsonWriter::beginObject(const char* key) {
+  if (depth > 0) separator(key);
+  put('{');
+  if (depth < JSON_MAX_DEPTH - 1) depth++;
+  first[depth] = true;
+}
+
+void JsonWriter::endObject() {
+  put('}');
+  if (depth > 0) depth--;
+}
+
+void JsonWriter::beginArray(const char* key) {
+  if (depth > 0) separator(key);
+  put('[');
+  if (depth < JSON_MAX_DEPTH - 1) depth++;
+  first[depth] = true;
+}
+
+void JsonWriter::endArray() {
+  put(']');
+  if (depth > 0) depth--;
+}
+
+void JsonWriter::field(const char* key, long value) {
+  separator(key);
+  if (value < 0) {
+    put('-');
+    putUnsigned((uint64_t)(-(int64_t)value));
+  } else {
+    putUnsigned((uint64_t)value);
+  }
+}
+
+void JsonWriter::field(const char* key, unsigned long value) {
+  separator(key);
+  putUnsigned(value);
+}
+
+void JsonWriter::field(const char* key, float value, int decimals) {
+  // Fixed-point formatting by hand; printf's float path can allocate
+  static const uint64_t scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+  if (decimals < 0) decimals = 0;
+  if (decimals > 6) decimals = 6;
+
+  separator(key);
+  double magnitude = fabs((double)value);
+  if (isnan(value) || isinf(value) || magnitude * scales[decimals] >= 9.0e18) {
+    put("null");
+    return;
+  }
+
+  uint64_t scale = scales[decimals];
+  uint64_t scaled = (uint64_t)(magnitude * scale + 0.5);
+  if (value < 0 && scaled != 0) put('-');
+  putUnsigned(scaled / scale);
+  if (decimals > 0) {
+    put('.');
+    uint64_t fraction = scaled % scale;
+    for (uint64_t digit = scale / 10; digit > 0; digit /= 10) {
+      put((char)('0' + (fraction / digit) % 10));
+    }
+  }
+}
+
+void JsonWriter::field(const char* key, bool value) {
+  separator(key);
+  put(value ? "true" : "false");
+}
+
+void JsonWriter::field(const char* key, const char* value) {
+  separator(key);
+  if (value) putQuoted(value);
+  else put("null");
+}
+
+void JsonWriter::fieldNull(const char* key) {
+  separator(key);
+  put("null");
+}
+
+size_t JsonWriter::finish() {
+  flush();
+  if (!sink) buf[used] = '\0';
+  return length();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// JSON writer over a fixed, caller-provided buffer. Nothing is allocated:
+// numbers are formatted straight into the buffer and, when a sink is given,
+// full buffers are handed to it so output of any length can be streamed in
+// chunks. Without a sink, output that does not fit is truncated and
+// overflowed() reports it.
+//
+// Commas are inserted automatically; keys are only valid inside objects.
+
+typedef void (*JsonSink)(const char* data, size_t length, void* context);
+
+#define JSON_MAX_DEPTH 8
+
+class JsonWriter {
+  public:
+    JsonWriter(char* buffer, size_t size, JsonSink sink = NULL, void* context = NULL);
+
+    void beginObject(const char* key = NULL);
+    void endObject();
+    void beginArray(const char* key = NULL);
+    void endArray();
+
+    // Members of an object (pass key = NULL for array elements)
+    void field(const char* key, long value);
+    void field(const char* key, unsigned long value);
+    void field(const char* key, int value) { field(key, (long)value); }
+    void field(const char* key, unsigned int value) { field(key, (unsigned long)value); }
+    void field(const char* key, float value, int decimals = 2); // NaN/inf become null
+    void field(const char* key, bool value);
+    void field(const char* key, const char* value);           // Escaped; NULL becomes null
+    void fieldNull(const char* key);
+
+    // Send what is buffered to the sink (or terminate the buffer) and return
+    // the number of bytes produced in total
+    size_t finish();
+
+    // Without a sink: the NUL-terminated text, valid after finish()
+    const char* c_str() const { return buf; }
+    size_t length() const { return total + used; }
+    bool overflowed() const { return overflow; }
+
+  private:
+    void separator(const char* key);
+    void put(char c);
+    void put(const char* text);
+    void putQuoted(const char* text);
+    void putUnsigned(uint64_t value);
+    void flush();
+
+    char* buf;
+    size_t capacity; // Usable bytes (one is kept for the terminator)
+    size_t used;
+    size_t total;    // Bytes already handed to the sink
+    JsonSink sink;
+    void* context;
+    bool overflow;
+    int depth;
+    bool first[JSON_MAX_DEPTH];
+};
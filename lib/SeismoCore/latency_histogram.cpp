@@ -0,0 +1,43 @@
+#include "latency_histogram.h"
+
+LatencyHistogram::LatencyHistogram(uint8_t shift) {
+  configure(shift);
+}
+
+void LatencyHistogram::configure(uint8_t smallest) {
+  shift = smallest;
+  reset();
+}
+
+void LatencyHistogram::reset() {
+  for (int i = 0; i <= LATENCY_BUCKETS; i++) counts[i] = 0;
+  total = 0;
+  largest = 0;
+  recorded = 0;
+}
+
+void LatencyHistogram::snapshot(LatencyHistogram& out) const {
+  out.shift = shift;
+  // A record() takes well under a microsecond, so a retry or two settles it;
+  // after that the copy is at most one value out of step
+  for (int attempt = 0; attempt < 4; attempt++) {
+    uint32_t before = recorded;
+    for (int i = 0; i <= LATENCY_BUCKETS; i++) out.counts[i] = counts[i];
+    out.total = total;
+    out.largest = largest;
+    out.recorded = recorded;
+    if (out.recorded == before) break;
+  }
+}
+
+uint32_t LatencyHistogram::quantileBound(float q) const {
+  if (recorded == 0) return 0;
+  uint32_t target = (uint32_t)(q * recorded + 0.5f);
+  if (target < 1) target = 1;
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += counts[i];
+    if (seen >= target) return bound(i) < largest ? bound(i) : largest;
+  }
+  return largest;
+}
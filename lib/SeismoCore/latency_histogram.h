@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+
+// Log-bucketed latency histogram, cheap enough to leave on in production.
+//
+// Bucket i counts values below 2^(shift + i) (and at or above the previous
+// bound); one more bucket takes everything past the last bound. Finding the
+// bucket is a shift and a count-leading-zeros, a single instruction on the
+// ESP32, so record() costs a few dozen cycles with no division or search.
+// Each bucket spans a factor of two, which is coarse for one value but plenty
+// to see where the tail of a stage lies.
+//
+// Units are up to the caller (CPU cycles for stage timings, microseconds for
+// jitter); `shift` picks the smallest bound that matters for them.
+//
+// One task records; others read through snapshot(), which retries if a
+// record() lands in the middle of the copy.
+
+#define LATENCY_BUCKETS 20 // Bounded buckets, plus one for overflow
+
+class LatencyHistogram {
+  public:
+    explicit LatencyHistogram(uint8_t shift = 0);
+
+    // Change the smallest bound; forgets everything recorded
+    void configure(uint8_t shift);
+
+    void record(uint32_t value) {
+      uint32_t scaled = value >> shift;
+      uint32_t bucket = scaled == 0 ? 0 : 32 - __builtin_clz(scaled);
+      if (bucket > LATENCY_BUCKETS) bucket = LATENCY_BUCKETS;
+      counts[bucket]++;
+      total += value;
+      if (value > largest) largest = value;
+      recorded++;
+    }
+
+    void reset();
+    // Consistent copy, safe while another task records
+    void snapshot(LatencyHistogram& out) const;
+
+    // Upper bound of bucket i (i < LATENCY_BUCKETS); the overflow bucket has none
+    uint32_t bound(uint32_t i) const { return (uint32_t)1 << (shift + i); }
+    uint32_t bucketCount(uint32_t i) const { return counts[i]; }
+    uint32_t count() const { return recorded; }
+    uint64_t sum() const { return total; }
+    uint32_t max() const { return largest; }
+    // Upper bound of the bucket holding quantile q (0-1), max() if it is the
+    // overflow bucket; 0 when empty
+    uint32_t quantileBound(float q) const;
+
+  private:
+    uint8_t shift;
+    volatile uint32_t counts[LATENCY_BUCKETS + 1];
+    volatile uint64_t total;
+    volatile uint32_t largest;
+    volatile uint32_t recorded; // Bumped last, so a copy can tell it raced a record()
+};
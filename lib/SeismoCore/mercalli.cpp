@@ -0,0 +1,73 @@
+#include "mercalli.h"
+#include <math.h>
+
+int calculateMercalli(float magnitude) {
+  // Simple linear mapping from magnitude to Mercalli intensity
+  // Adjust the mapping as needed for your specific requirements
+  if (magnitude < MERCALLI_1_THRESHOLD) return 1;
+  else if (magnitude < MERCALLI_2_THRESHOLD) return 2;
+  else if (magnitude < MERCALLI_3_THRESHOLD) return 3;
+  else if (magnitude < MERCALLI_4_THRESHOLD) return 4;
+  else if (magnitude < MERCALLI_5_THRESHOLD) return 5;
+  else if (magnitude < MERCALLI_6_THRESHOLD) return 6;
+  else if (magnitude < MERCALLI_7_THRESHOLD) return 7;
+  else if (magnitude < MERCALLI_8_THRESHOLD) return 8;
+  else if (magnitude < MERCALLI_9_THRESHOLD) return 9;
+  else if (magnitude < MERCALLI_10_THRESHOLD) return 10;
+  else if (magnitude < MERCALLI_11_THRESHOLD) return 11;
+  else return 12; // XII - Extreme
+}
+
+const float MERCALLI_THRESHOLDS[11] = {
+  MERCALLI_1_THRESHOLD, MERCALLI_2_THRESHOLD, MERCALLI_3_THRESHOLD, MERCALLI_4_THRESHOLD,
+  MERCALLI_5_THRESHOLD, MERCALLI_6_THRESHOLD, MERCALLI_7_THRESHOLD, MERCALLI_8_THRESHOLD,
+  MERCALLI_9_THRESHOLD, MERCALLI_10_THRESHOLD, MERCALLI_11_THRESHOLD
+};
+
+void mercalliScale(float ms2PerCount, MercalliScale& scale) {
+  mercalliScale(MERCALLI_THRESHOLDS, ms2PerCount, scale);
+}
+
+void mercalliScale(const float* thresholds, float ms2PerCount, MercalliScale& scale) {
+  for (int i = 0; i < 11; i++) {
+    float counts = thresholds[i] / ms2PerCount;
+    scale.limit_sq[i] = counts * counts;
+  }
+}
+
+int calculateMercalliSquared(float squaredCounts, const MercalliScale& scale) {
+  // Same steps as calculateMercalli; squaring preserves the order of
+  // non-negative magnitudes
+  for (int i = 0; i < 11; i++) {
+    if (squaredCounts < scale.limit_sq[i]) return i + 1;
+  }
+  return 12; // XII - Extreme
+}
+
+// MMI = c1 + c2 log10(Y) up to log10(Y) = t1, c3 + c4 log10(Y) above
+static float worden2012(float motion, float c1, float c2, float c3, float c4, float t1) {
+  if (motion <= 0) return 1.0f;
+  float logMotion = log10f(motion);
+  return logMotion <= t1 ? c1 + c2 * logMotion : c3 + c4 * logMotion;
+}
+
+static float clampMmi(float mmi) {
+  return mmi < 1.0f ? 1.0f : mmi > 10.0f ? 10.0f : mmi;
+}
+
+float mmiFromPga(float pgaCms2) {
+  return clampMmi(worden2012(pgaCms2, 1.78f, 1.55f, -1.60f, 3.70f, 1.57f));
+}
+
+float mmiFromPgv(float pgvCms) {
+  return clampMmi(worden2012(pgvCms, 3.78f, 1.47f, 2.89f, 3.16f, 0.53f));
+}
+
+float mmiFromGroundMotion(float pgaCms2, float pgvCms) {
+  float fromPga = mmiFromPga(pgaCms2);
+  if (fromPga < 5.0f) return fromPga;
+  float fromPgv = mmiFromPgv(pgvCms);
+  if (fromPga >= 7.0f) return fromPgv;
+  float weight = (fromPga - 5.0f) / 2.0f;
+  return (1.0f - weight) * fromPga + weight * fromPgv;
+}
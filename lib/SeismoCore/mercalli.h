@@ -0,0 +1,48 @@
+#pragma once
+
+// Mercalli intensity thresholds (m/s²) - easy to adjust for sensor sensitivity
+const float MERCALLI_1_THRESHOLD = 0.15;  // I - Not felt (accounts for sensor noise)
+const float MERCALLI_2_THRESHOLD = 0.25;  // II - Weak
+const float MERCALLI_3_THRESHOLD = 0.4;   // III - Weak
+const float MERCALLI_4_THRESHOLD = 0.7;   // IV - Light
+const float MERCALLI_5_THRESHOLD = 1.2;   // V - Moderate
+const float MERCALLI_6_THRESHOLD = 2.0;   // VI - Strong
+const float MERCALLI_7_THRESHOLD = 4.0;   // VII - Very strong
+const float MERCALLI_8_THRESHOLD = 8.0;   // VIII - Severe
+const float MERCALLI_9_THRESHOLD = 12.0;  // IX - Violent
+const float MERCALLI_10_THRESHOLD = 16.0; // X - Extreme
+const float MERCALLI_11_THRESHOLD = 20.0; // XI - Extreme
+// XII - Extreme (anything above MERCALLI_11_THRESHOLD)
+
+// The eleven thresholds above in order, the defaults of a configurable scale
+extern const float MERCALLI_THRESHOLDS[11];
+
+// Map a deviation magnitude (m/s²) to a Mercalli intensity (1-12)
+int calculateMercalli(float magnitude);
+
+// The same thresholds squared and expressed in sensor counts, so the intensity
+// of a squared magnitude in counts can be found without a square root
+struct MercalliScale {
+  float limit_sq[11]; // (MERCALLI_n_THRESHOLD / ms2PerCount)^2 for n = 1..11
+};
+
+void mercalliScale(float ms2PerCount, MercalliScale& scale);
+// From any eleven ascending thresholds (m/s²) instead of the constants
+void mercalliScale(const float* thresholds, float ms2PerCount, MercalliScale& scale);
+int calculateMercalliSquared(float squaredCounts, const MercalliScale& scale);
+
+// Fractional Modified Mercalli intensity from peak ground motion, by the
+// conversion of Worden et al. (2012, BSSA 102(1)): larger horizontal
+// component, PGA in cm/s² and PGV in cm/s, each bilinear in log10 of the motion
+float mmiFromPga(float pgaCms2);
+float mmiFromPgv(float pgvCms);
+// Combined as ShakeMap does (Wald et al. 1999): the PGA estimate below V, the
+// PGV estimate above VII and a linear blend in between, weighted by the PGA
+// estimate. Clamped to I-X, the range the regressions were fit over.
+float mmiFromGroundMotion(float pgaCms2, float pgvCms);
+
+// What the integer intensity (events, display, BLE) is based on
+enum IntensityMode {
+  INTENSITY_THRESHOLDS, // The MERCALLI_n_THRESHOLD steps on the deviation magnitude
+  INTENSITY_REGRESSION  // mmiFromGroundMotion() of horizontal PGA and PGV, rounded
+};
@@ -0,0 +1,101 @@
+#include "noise_floor.h"
+#include <math.h>
+
+NoiseFloorConfig defaultNoiseFloorConfig() {
+  NoiseFloorConfig config;
+  config.enabled = true;
+  config.quantile = 0.5;          // Median: robust to the odd footstep
+  config.update_rate = 50.0;      // The band ends at 10 Hz; more adds nothing
+  config.window_seconds = 60.0;
+  config.smoothing = 0.25;        // The floor settles over a few minutes
+  config.holdoff_seconds = 10.0;
+  config.gate_sigmas = 3.0;       // As calibration
+  config.min_threshold = 0.05;
+  config.max_threshold = 0.2;     // Never deaf to intensity II
+  return config;
+}
+
+// z with P(|Z| < z) = quantile for a standard normal Z, by bisection
+static float absNormalQuantile(float quantile) {
+  float low = 0, high = 10;
+  for (int i = 0; i < 40; i++) {
+    float mid = 0.5f * (low + high);
+    if (erff(mid * 0.70710678f) < quantile) low = mid;
+    else high = mid;
+  }
+  return 0.5f * (low + high);
+}
+
+NoiseFloorTracker::NoiseFloorTracker() {
+  configure(defaultNoiseFloorConfig(), 100.0);
+}
+
+void NoiseFloorTracker::configure(const NoiseFloorConfig& config, float sampleRate) {
+  cfg = config;
+  if (cfg.smoothing <= 0 || cfg.smoothing > 1) cfg.smoothing = 1;
+  for (int i = 0; i < 3; i++) estimators[i].configure(cfg.quantile);
+  sigmaPerQuantile = 1.0f / absNormalQuantile(cfg.quantile);
+
+  float valueRate = cfg.update_rate < sampleRate ? cfg.update_rate : sampleRate;
+  stride = valueRate > 0 ? (uint32_t)(sampleRate / valueRate + 0.5f) : 1;
+  if (stride < 1) stride = 1;
+  windowValues = (uint32_t)(cfg.window_seconds * sampleRate / stride);
+  if (windowValues < 5) windowValues = 5;
+  holdoffSamples = (uint32_t)(cfg.holdoff_seconds * sampleRate);
+  reset();
+}
+
+void NoiseFloorTracker::reset() {
+  for (int i = 0; i < 3; i++) {
+    estimators[i].reset();
+    floors[i] = 0;
+  }
+  phase = 0;
+  holdoffLeft = 0;
+  windows = 0;
+}
+
+bool NoiseFloorTracker::update(float x, float y, float z, bool frozen) {
+  if (!cfg.enabled) return false;
+  if (frozen) {
+    holdoffLeft = holdoffSamples > 0 ? holdoffSamples : 1;
+    return false;
+  }
+  if (holdoffLeft > 0) {
+    holdoffLeft--;
+    return false;
+  }
+  if (++phase < stride) return false;
+  phase = 0;
+
+  estimators[0].push(x);
+  estimators[1].push(y);
+  estimators[2].push(z);
+  if (estimators[0].count() < windowValues) return false;
+
+  for (int i = 0; i < 3; i++) {
+    float sigma = estimators[i].value() * sigmaPerQuantile;
+    floors[i] = windows == 0 ? sigma : floors[i] + cfg.smoothing * (sigma - floors[i]);
+    estimators[i].reset();
+  }
+  past[windows % NOISE_FLOOR_HISTORY] = maxSigma();
+  windows++;
+  return true;
+}
+
+float NoiseFloorTracker::maxSigma() const {
+  float sigma = floors[0];
+  if (floors[1] > sigma) sigma = floors[1];
+  if (floors[2] > sigma) sigma = floors[2];
+  return sigma;
+}
+
+int NoiseFloorTracker::windowProgress() const {
+  return (int)(estimators[0].count() * 100 / windowValues);
+}
+
+float NoiseFloorTracker::history(uint32_t index) const {
+  uint32_t count = historyCount();
+  if (index >= count) return 0;
+  return past[(windows - count + index) % NOISE_FLOOR_HISTORY];
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include "p2_quantile.h"
+
+// Rolling estimate of the background noise on each axis, so the noise gate can
+// follow the building (HVAC cycles, traffic, machinery) instead of staying
+// where calibration left it.
+//
+// The absolute band-passed deviations of each axis go into a P² estimator of
+// one quantile, thinned to about update_rate values per second. When a window
+// is complete, the quantile is turned into a standard deviation (assuming
+// Gaussian noise, where the median of |x| is 0.674 sigma), blended into the
+// running floor and the estimator starts over. Memory is constant per axis.
+//
+// Adaptation is frozen while an event is in progress and for holdoff_seconds
+// after it, so shaking never raises the floor it is measured against. Frozen
+// samples do not count towards the window.
+//
+// Everything is in counts; the detector turns the floor into a gate.
+
+#define NOISE_FLOOR_HISTORY 30 // Past window floors kept for reporting
+
+struct NoiseFloorConfig {
+  bool enabled;
+  float quantile;        // Of the absolute deviation, in (0, 1)
+  float update_rate;     // Hz; values fed to the estimators
+  float window_seconds;  // Quiet time per estimate
+  float smoothing;       // Weight of each new window in the floor (0-1]
+  float holdoff_seconds; // Adaptation stays frozen this long after an event
+  float gate_sigmas;     // Gate = this many floor standard deviations...
+  float min_threshold;   // ...kept within these limits (m/s²)
+  float max_threshold;
+};
+
+NoiseFloorConfig defaultNoiseFloorConfig();
+
+class NoiseFloorTracker {
+  public:
+    NoiseFloorTracker();
+
+    void configure(const NoiseFloorConfig& config, float sampleRate);
+    // Forget the floor and the history
+    void reset();
+
+    // Feed one sample's absolute deviations (counts). `frozen` suspends
+    // adaptation. Returns true when a window completed and the floor moved.
+    bool update(float x, float y, float z, bool frozen);
+
+    bool valid() const { return windows > 0; }
+    // Noise standard deviation (counts) per axis (0 = X, 1 = Y, 2 = Z), and the
+    // largest of the three
+    float sigma(int axis) const { return floors[axis]; }
+    float maxSigma() const;
+    bool adapting() const { return holdoffLeft == 0; }
+    uint32_t windowCount() const { return windows; }
+    // Progress of the current window, 0-100
+    int windowProgress() const;
+
+    // maxSigma() after each of the last historyCount() windows, oldest first
+    uint32_t historyCount() const { return windows < NOISE_FLOOR_HISTORY ? windows : NOISE_FLOOR_HISTORY; }
+    float history(uint32_t index) const;
+
+  private:
+    NoiseFloorConfig cfg;
+    P2Quantile estimators[3];
+    float sigmaPerQuantile; // Converts the quantile of |x| into sigma
+    uint32_t stride;        // Samples per estimator value
+    uint32_t windowValues;  // Estimator values per window
+    uint32_t holdoffSamples;
+    uint32_t phase;         // Samples since the last value fed
+    uint32_t holdoffLeft;
+    float floors[3];
+    uint32_t windows;
+    float past[NOISE_FLOOR_HISTORY];
+};
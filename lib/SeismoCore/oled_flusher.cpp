@@ -0,0 +1,105 @@
+#include "oled_flusher.h"
+#include <string.h>
+
+// SSD1306 commands for the address window (horizontal addressing mode)
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR   0x22
+
+OledFlusher::OledFlusher(OledBus& bus)
+  : bus(bus), pendingFrame(false), fullRefresh(true), page(0), column(0), lastColumn(0),
+    spanActive(false), bytes(0), frames(0), errors(0) {
+  memset(pending, 0, sizeof(pending));
+  memset(shown, 0, sizeof(shown));
+}
+
+bool OledFlusher::submit(const uint8_t* frame) {
+  if (busy()) return false;
+  if (!fullRefresh && memcmp(frame, shown, OLED_BUFFER_SIZE) == 0) return true;
+
+  memcpy(pending, frame, OLED_BUFFER_SIZE);
+  page = 0;
+  spanActive = false;
+  pendingFrame.store(true, std::memory_order_release);
+  return true;
+}
+
+void OledFlusher::markShown(const uint8_t* frame) {
+  if (busy()) return;
+  memcpy(shown, frame, OLED_BUFFER_SIZE);
+  fullRefresh = false;
+}
+
+// Find the next page with changes and set the panel's address window to the
+// changed columns. Returns false when the frame is done.
+bool OledFlusher::nextSpan() {
+  for (; page < OLED_PAGES; page++) {
+    const uint8_t* want = pending + page * OLED_WIDTH;
+    const uint8_t* have = shown + page * OLED_WIDTH;
+    int first = 0;
+    int last = OLED_WIDTH - 1;
+    if (!fullRefresh) {
+      while (first < OLED_WIDTH && want[first] == have[first]) first++;
+      if (first == OLED_WIDTH) continue;
+      while (want[last] == have[last]) last--;
+    }
+
+    uint8_t window[] = { SSD1306_COLUMNADDR, (uint8_t)first, (uint8_t)last,
+                         SSD1306_PAGEADDR, (uint8_t)page, (uint8_t)page };
+    if (!bus.sendCommands(window, sizeof(window))) return false;
+    bytes.fetch_add(sizeof(window) + 1, std::memory_order_relaxed);
+
+    column = first;
+    lastColumn = last;
+    spanActive = true;
+    return true;
+  }
+  return false;
+}
+
+size_t OledFlusher::service(size_t maxBytes) {
+  if (!busy()) return 0;
+
+  uint32_t before = bytesSent();
+  size_t budget = maxBytes;
+  bool failed = false;
+
+  while (budget > 0) {
+    if (!spanActive && !nextSpan()) {
+      failed = (page < OLED_PAGES); // Stopped early: the window command failed
+      break;
+    }
+
+    size_t length = lastColumn - column + 1;
+    if (length > OLED_CHUNK_BYTES) length = OLED_CHUNK_BYTES;
+    if (length > budget) length = budget;
+
+    uint8_t* data = pending + page * OLED_WIDTH + column;
+    if (!bus.sendData(data, length)) {
+      failed = true;
+      break;
+    }
+    memcpy(shown + page * OLED_WIDTH + column, data, length);
+    bytes.fetch_add(length + 1, std::memory_order_relaxed);
+    budget -= length;
+
+    column += length;
+    if (column > lastColumn) {
+      spanActive = false;
+      page++;
+    }
+  }
+
+  if (failed) {
+    // The panel is now in an unknown state; resend everything next time
+    errors.fetch_add(1, std::memory_order_relaxed);
+    fullRefresh = true;
+    spanActive = false;
+    pendingFrame.store(false, std::memory_order_release);
+  } else if (!spanActive && page >= OLED_PAGES) {
+    fullRefresh = false;
+    frames.fetch_add(1, std::memory_order_relaxed);
+    pendingFrame.store(false, std::memory_order_release);
+  }
+
+  return bytesSent() - before;
+}
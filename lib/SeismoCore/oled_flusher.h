@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Incremental SSD1306 updates: only the columns that changed on each page are
+// sent to the panel, in short transfers spread over as many service() calls as
+// needed.
+//
+// The renderer task calls submit() with a finished frame; the task that owns
+// the I2C bus calls service() whenever it has time to spare. submit() is only
+// accepted while the previous frame has been sent completely, so the two sides
+// never touch the same buffer at once.
+
+#define OLED_WIDTH        128
+#define OLED_PAGES        8
+#define OLED_BUFFER_SIZE  (OLED_WIDTH * OLED_PAGES)
+#define OLED_CHUNK_BYTES  31 // Data bytes per transfer (plus the control byte)
+
+// One I2C transaction each; implemented with Wire on the board
+class OledBus {
+  public:
+    virtual ~OledBus() {}
+    virtual bool sendCommands(const uint8_t* commands, size_t length) = 0;
+    virtual bool sendData(const uint8_t* data, size_t length) = 0;
+};
+
+class OledFlusher {
+  public:
+    explicit OledFlusher(OledBus& bus);
+
+    // Renderer side. submit() copies the frame (page-major, as produced by
+    // Adafruit_SSD1306::getBuffer()) and returns false while still busy.
+    bool submit(const uint8_t* frame);
+    bool busy() const { return pendingFrame.load(std::memory_order_acquire); }
+
+    // The panel was written directly with this frame (only while not busy)
+    void markShown(const uint8_t* frame);
+    // Panel contents unknown; the next frame is sent in full
+    void invalidate() { fullRefresh = true; }
+
+    // Bus side. Sends at most maxBytes data bytes of the pending frame and
+    // returns the number of bytes handed to the bus, control bytes included.
+    size_t service(size_t maxBytes);
+
+    uint32_t bytesSent() const { return bytes.load(std::memory_order_relaxed); }
+    uint32_t framesSent() const { return frames.load(std::memory_order_relaxed); }
+    uint32_t errorCount() const { return errors.load(std::memory_order_relaxed); }
+
+  private:
+    bool nextSpan();
+
+    OledBus& bus;
+    uint8_t pending[OLED_BUFFER_SIZE]; // Written by submit(), read by service()
+    uint8_t shown[OLED_BUFFER_SIZE];   // What the panel displays (bus side)
+    std::atomic<bool> pendingFrame;
+    bool fullRefresh;
+
+    // Progress through the pending frame
+    int page;          // Page being scanned or sent
+    int column;        // Next column to send
+    int lastColumn;    // Last column of the dirty span
+    bool spanActive;   // Address window set, data still to send
+
+    std::atomic<uint32_t> bytes;
+    std::atomic<uint32_t> frames;
+    std::atomic<uint32_t> errors;
+};
@@ -0,0 +1,94 @@
+#include "p2_quantile.h"
+
+P2Quantile::P2Quantile(float quantile) {
+  configure(quantile);
+}
+
+void P2Quantile::configure(float quantile) {
+  p = quantile;
+  if (p <= 0.0f) p = 0.001f;
+  if (p >= 1.0f) p = 0.999f;
+  reset();
+}
+
+void P2Quantile::reset() {
+  n = 0;
+  for (int i = 0; i < 5; i++) {
+    heights[i] = 0;
+    positions[i] = i + 1;
+  }
+  desired[0] = 1;
+  desired[1] = 1 + 2 * p;
+  desired[2] = 1 + 4 * p;
+  desired[3] = 3 + 2 * p;
+  desired[4] = 5;
+  increments[0] = 0;
+  increments[1] = p / 2;
+  increments[2] = p;
+  increments[3] = (1 + p) / 2;
+  increments[4] = 1;
+}
+
+void P2Quantile::push(float value) {
+  // The first five values are kept sorted and become the markers
+  if (n < 5) {
+    int i = n++;
+    for (; i > 0 && heights[i - 1] > value; i--) heights[i] = heights[i - 1];
+    heights[i] = value;
+    return;
+  }
+  n++;
+
+  // Cell the value falls in; the extremes follow it out
+  int cell;
+  if (value < heights[0]) {
+    heights[0] = value;
+    cell = 0;
+  } else if (value >= heights[4]) {
+    heights[4] = value;
+    cell = 3;
+  } else {
+    cell = 0;
+    while (cell < 3 && value >= heights[cell + 1]) cell++;
+  }
+  for (int i = cell + 1; i < 5; i++) positions[i]++;
+  for (int i = 0; i < 5; i++) desired[i] += increments[i];
+
+  // Move the middle markers at most one position towards where they belong
+  for (int i = 1; i < 4; i++) {
+    float offset = desired[i] - positions[i];
+    if ((offset >= 1 && positions[i + 1] - positions[i] > 1) ||
+        (offset <= -1 && positions[i - 1] - positions[i] < -1)) {
+      int direction = offset > 0 ? 1 : -1;
+      float height = parabolic(i, direction);
+      if (heights[i - 1] < height && height < heights[i + 1]) {
+        heights[i] = height;
+      } else {
+        heights[i] = linear(i, direction);
+      }
+      positions[i] += direction;
+    }
+  }
+}
+
+float P2Quantile::parabolic(int i, int direction) const {
+  float d = (float)direction;
+  float below = (float)(positions[i] - positions[i - 1]);
+  float above = (float)(positions[i + 1] - positions[i]);
+  return heights[i] + d / (positions[i + 1] - positions[i - 1]) *
+         ((below + d) * (heights[i + 1] - heights[i]) / above +
+          (above - d) * (heights[i] - heights[i - 1]) / below);
+}
+
+float P2Quantile::linear(int i, int direction) const {
+  return heights[i] + direction * (heights[i + direction] - heights[i]) /
+         (positions[i + direction] - positions[i]);
+}
+
+float P2Quantile::value() const {
+  if (n == 0) return 0;
+  if (n >= 5) return heights[2];
+  // Few values: the nearest rank of the sorted ones
+  uint32_t rank = (uint32_t)(p * (n - 1) + 0.5f);
+  return heights[rank];
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+// Streaming estimate of one quantile with the P² algorithm (Jain & Chlamtac,
+// 1985). Five markers are kept - the minimum, the maximum, the wanted quantile
+// and two halfway between - and nudged towards their ideal positions with a
+// piecewise-parabolic fit as values arrive. Memory and time per value are
+// constant, however many values are seen.
+class P2Quantile {
+  public:
+    explicit P2Quantile(float quantile = 0.5f);
+
+    // Quantile in (0, 1); forgets everything seen so far
+    void configure(float quantile);
+    void reset();
+    void push(float value);
+
+    uint32_t count() const { return n; }
+    // Current estimate; exact for up to five values, 0 before the first
+    float value() const;
+
+  private:
+    float parabolic(int i, int direction) const;
+    float linear(int i, int direction) const;
+
+    float p;
+    uint32_t n;
+    float heights[5];   // Marker values; the first n are raw values until n reaches 5
+    int32_t positions[5];
+    float desired[5];   // Ideal marker positions
+    float increments[5];
+};
@@ -0,0 +1,52 @@
+#include "sequence_tracker.h"
+
+void SequenceTracker::reset() {
+  top = 0;
+  window = 0;
+  any = false;
+  received = 0;
+  duplicates = 0;
+  reordered = 0;
+  restarts = 0;
+  lost = 0;
+}
+
+SequenceResult SequenceTracker::accept(uint32_t sequence) {
+  int32_t ahead = (int32_t)(sequence - top);
+
+  if (!any || ahead <= -SEQUENCE_WINDOW) {
+    if (any) restarts++;
+    any = true;
+    top = sequence;
+    window = ~0ULL; // Nothing before the first packet is missing
+    received++;
+    return SEQUENCE_RESTART;
+  }
+
+  if (ahead > 0) {
+    if (ahead >= SEQUENCE_WINDOW) {
+      lost += (SEQUENCE_WINDOW - (uint32_t)__builtin_popcountll(window)) + (uint32_t)(ahead - SEQUENCE_WINDOW);
+      window = 1;
+    } else {
+      // Slots shifted past the last bit are final; count the ones never filled
+      uint64_t leaving = window >> (SEQUENCE_WINDOW - ahead);
+      lost += (uint32_t)ahead - (uint32_t)__builtin_popcountll(leaving);
+      window = (window << ahead) | 1;
+    }
+    top = sequence;
+  } else {
+    uint64_t bit = 1ULL << -ahead;
+    if (window & bit) {
+      duplicates++;
+      return SEQUENCE_DUPLICATE;
+    }
+    window |= bit;
+    reordered++;
+  }
+  received++;
+  return SEQUENCE_NEW;
+}
+
+uint32_t SequenceTracker::missingCount() const {
+  return lost + (any ? SEQUENCE_WINDOW - (uint32_t)__builtin_popcountll(window) : 0);
+}
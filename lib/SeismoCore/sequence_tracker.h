@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+
+// Loss accounting for a stream of numbered packets (+1 per packet, wrapping).
+//
+// Sequence numbers are tracked with a 64-packet window, as in IPsec replay
+// protection: a packet is new if it is ahead of the highest seen, or behind it
+// but not yet marked in the window. Duplicates are reported, reordered packets
+// are accepted, and the numbers that never arrived before they slid out of the
+// window are lost. The window starts full, so a packet from before the first
+// one seen counts as a duplicate rather than everything before it as lost.
+// A number far behind the highest means the sender restarted from 0.
+
+enum SequenceResult {
+  SEQUENCE_NEW,       // In order, or reordered within the window
+  SEQUENCE_DUPLICATE, // Seen before; drop it
+  SEQUENCE_RESTART    // First packet, or the sender started over
+};
+
+#define SEQUENCE_WINDOW 64
+
+class SequenceTracker {
+  public:
+    SequenceTracker() { reset(); }
+    void reset();
+
+    SequenceResult accept(uint32_t sequence);
+
+    uint32_t highest() const { return top; }
+    uint32_t receivedCount() const { return received; }
+    uint32_t duplicateCount() const { return duplicates; }
+    uint32_t reorderedCount() const { return reordered; }
+    uint32_t restartCount() const { return restarts; }
+    // Numbers that slid out of the window without arriving
+    uint32_t lostCount() const { return lost; }
+    // lostCount() plus the gaps still open in the window
+    uint32_t missingCount() const;
+
+  private:
+    uint32_t top;
+    uint64_t window;    // Bit i: top - i has been seen
+    bool any;
+    uint32_t received;
+    uint32_t duplicates;
+    uint32_t reordered;
+    uint32_t restarts;
+    uint32_t lost;
+};
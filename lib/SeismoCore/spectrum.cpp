@@ -0,0 +1,236 @@
+#include "spectrum.h"
+#include <math.h>
+
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define SPECTRUM_USE_ESP_DSP 1
+#endif
+#endif
+
+// Twiddle factors for SPECTRUM_MAX_POINTS; smaller transforms stride through them
+static float twiddles[SPECTRUM_MAX_POINTS];
+static bool fftReady = false;
+
+bool fftBegin() {
+  if (fftReady) return true;
+#ifdef SPECTRUM_USE_ESP_DSP
+  if (dsps_fft2r_init_fc32(twiddles, SPECTRUM_MAX_POINTS) != ESP_OK) return false;
+#else
+  // exp(-2 pi i k / N) for k < N/2, as cos, sin pairs
+  for (uint32_t k = 0; k < SPECTRUM_MAX_POINTS / 2; k++) {
+    double angle = -2.0 * M_PI * k / SPECTRUM_MAX_POINTS;
+    twiddles[2 * k] = (float)cos(angle);
+    twiddles[2 * k + 1] = (float)sin(angle);
+  }
+#endif
+  fftReady = true;
+  return true;
+}
+
+const char* fftImplementation() {
+#ifdef SPECTRUM_USE_ESP_DSP
+  return "esp-dsp";
+#else
+  return "portable";
+#endif
+}
+
+void fftComplex(float* data, uint32_t n) {
+#ifdef SPECTRUM_USE_ESP_DSP
+  dsps_fft2r_fc32(data, n);
+  dsps_bit_rev_fc32(data, n);
+#else
+  // Bit-reversed order first, then iterative decimation-in-time butterflies
+  for (uint32_t i = 1, j = 0; i < n; i++) {
+    uint32_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j |= bit;
+    if (i < j) {
+      float re = data[2 * i], im = data[2 * i + 1];
+      data[2 * i] = data[2 * j];
+      data[2 * i + 1] = data[2 * j + 1];
+      data[2 * j] = re;
+      data[2 * j + 1] = im;
+    }
+  }
+
+  for (uint32_t length = 2; length <= n; length <<= 1) {
+    uint32_t half = length / 2;
+    uint32_t stride = SPECTRUM_MAX_POINTS / length;
+    for (uint32_t start = 0; start < n; start += length) {
+      for (uint32_t k = 0; k < half; k++) {
+        float wr = twiddles[2 * k * stride];
+        float wi = twiddles[2 * k * stride + 1];
+        float* a = data + 2 * (start + k);
+        float* b = a + 2 * half;
+        float tr = b[0] * wr - b[1] * wi;
+        float ti = b[0] * wi + b[1] * wr;
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+      }
+    }
+  }
+#endif
+}
+
+SpectrumConfig defaultSpectrumConfig(float sampleRate) {
+  // Building modes, traffic and machinery roughly fall into separate bands
+  static const SpectrumBand BANDS[SPECTRUM_MAX_BANDS] = {
+    { 0.5, 1.0 }, { 1.0, 2.0 }, { 2.0, 5.0 }, { 5.0, 10.0 }, { 10.0, 20.0 }, { 20.0, 1000.0 }
+  };
+  SpectrumConfig config;
+  config.points = 512;
+  config.sample_rate = sampleRate;
+  config.min_hz = 0.5;
+  config.band_count = SPECTRUM_MAX_BANDS;
+  for (int i = 0; i < SPECTRUM_MAX_BANDS; i++) config.bands[i] = BANDS[i];
+  return config;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer() : history(NULL), work(NULL), head(0), filled(0), computed(0) {
+  cfg = defaultSpectrumConfig(100.0);
+  cfg.points = 0;
+}
+
+bool SpectrumAnalyzer::begin(const SpectrumConfig& config, RawSample* samples, float* buffer) {
+  bool powerOfTwo = config.points >= 8 && (config.points & (config.points - 1)) == 0;
+  if (!powerOfTwo || config.points > SPECTRUM_MAX_POINTS || config.sample_rate <= 0 ||
+      config.band_count > SPECTRUM_MAX_BANDS || !samples || !buffer || !fftBegin()) {
+    cfg.points = 0;
+    return false;
+  }
+  cfg = config;
+  history = samples;
+  work = buffer;
+  reset();
+  return true;
+}
+
+void SpectrumAnalyzer::reset() {
+  head = 0;
+  filled = 0;
+}
+
+void SpectrumAnalyzer::push(const RawSample& sample) {
+  if (cfg.points == 0) return;
+  history[head] = sample;
+  if (++head == cfg.points) head = 0;
+  if (filled < cfg.points) filled++;
+}
+
+// Strongest bin from `first` up, refined between bins with a parabola through
+// its neighbours. *peakPower gets the three bins together, which hold
+// practically all of a sinusoid's power under the Hann window.
+float SpectrumAnalyzer::dominant(const float* power, uint32_t first, float* peakPower) const {
+  uint32_t last = cfg.points / 2;
+  uint32_t best = first;
+  for (uint32_t k = first + 1; k <= last; k++) {
+    if (power[k] > power[best]) best = k;
+  }
+
+  float below = best > 0 ? power[best - 1] : 0;
+  float above = best < last ? power[best + 1] : 0;
+  *peakPower = below + power[best] + above;
+  float offset = 0;
+  float curvature = below - 2 * power[best] + above;
+  if (best > 0 && best < last && curvature < 0) offset = 0.5f * (below - above) / curvature;
+  return (best + offset) * cfg.sample_rate / cfg.points;
+}
+
+bool SpectrumAnalyzer::compute(SpectrumResult& out) {
+  if (!ready()) return false;
+  uint32_t n = cfg.points;
+  uint32_t bins = n / 2 + 1;
+  float* data = work;
+  float* power[3] = { work + 2 * n, work + 2 * n + bins, work + 2 * n + 2 * bins };
+
+  int32_t sum[3] = { 0, 0, 0 };
+  for (uint32_t i = 0; i < n; i++) {
+    sum[0] += history[i].x;
+    sum[1] += history[i].y;
+    sum[2] += history[i].z;
+  }
+  float mean[3] = { (float)sum[0] / n, (float)sum[1] / n, (float)sum[2] / n };
+
+  // Periodic Hann window by rotation, so no cosine per sample
+  float step = 2.0f * (float)M_PI / n;
+  float rotateCos = cosf(step), rotateSin = sinf(step);
+  float c = 1, s = 0;
+  // One-sided power: 2|X|² / (N sum(w²)), and sum(w²) = 3N/8 for Hann
+  float scale = 2.0f / (n * 0.375f * n);
+
+  // X + iY, oldest sample first
+  for (uint32_t i = 0; i < n; i++) {
+    const RawSample& sample = history[(head + i) % n];
+    float w = 0.5f - 0.5f * c;
+    data[2 * i] = (sample.x - mean[0]) * w;
+    data[2 * i + 1] = (sample.y - mean[1]) * w;
+    float next = c * rotateCos - s * rotateSin;
+    s = s * rotateCos + c * rotateSin;
+    c = next;
+  }
+  fftComplex(data, n);
+  // X[k] = (Z[k] + conj(Z[N-k])) / 2, Y[k] = (Z[k] - conj(Z[N-k])) / 2i
+  for (uint32_t k = 0; k < bins; k++) {
+    uint32_t mirror = (n - k) % n;
+    float a = data[2 * k], b = data[2 * k + 1];
+    float cr = data[2 * mirror], ci = data[2 * mirror + 1];
+    float binScale = (k == 0 || k == n / 2) ? 0.5f * scale : scale;
+    power[0][k] = 0.25f * ((a + cr) * (a + cr) + (b - ci) * (b - ci)) * binScale;
+    power[1][k] = 0.25f * ((a - cr) * (a - cr) + (b + ci) * (b + ci)) * binScale;
+  }
+
+  // Z alone
+  c = 1;
+  s = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    float w = 0.5f - 0.5f * c;
+    data[2 * i] = (history[(head + i) % n].z - mean[2]) * w;
+    data[2 * i + 1] = 0;
+    float next = c * rotateCos - s * rotateSin;
+    s = s * rotateCos + c * rotateSin;
+    c = next;
+  }
+  fftComplex(data, n);
+  for (uint32_t k = 0; k < bins; k++) {
+    float binScale = (k == 0 || k == n / 2) ? 0.5f * scale : scale;
+    power[2][k] = (data[2 * k] * data[2 * k] + data[2 * k + 1] * data[2 * k + 1]) * binScale;
+  }
+
+  float resolution = cfg.sample_rate / n;
+  uint32_t first = (uint32_t)ceilf(cfg.min_hz / resolution);
+  if (first < 1) first = 1;
+  if (first > n / 2) first = n / 2;
+
+  out.sequence = ++computed;
+  out.points = n;
+  out.sample_rate = cfg.sample_rate;
+  out.resolution_hz = resolution;
+  for (int axis = 0; axis < 3; axis++) {
+    float peak;
+    out.dominant_axis_hz[axis] = dominant(power[axis], first, &peak);
+    out.dominant_rms[axis] = sqrtf(peak);
+
+    float total = 0;
+    float bands[SPECTRUM_MAX_BANDS] = {};
+    for (uint32_t k = first; k < bins; k++) {
+      float p = power[axis][k];
+      float hz = k * resolution;
+      total += p;
+      for (uint8_t band = 0; band < cfg.band_count; band++) {
+        if (hz >= cfg.bands[band].low_hz && hz < cfg.bands[band].high_hz) bands[band] += p;
+      }
+    }
+    out.rms[axis] = sqrtf(total);
+    for (int band = 0; band < SPECTRUM_MAX_BANDS; band++) out.band_rms[axis][band] = sqrtf(bands[band]);
+  }
+
+  // All axes together; Z's power array takes the sum
+  for (uint32_t k = 0; k < bins; k++) power[2][k] += power[0][k] + power[1][k];
+  float peak;
+  out.dominant_hz = dominant(power[2], first, &peak);
+  return true;
+}
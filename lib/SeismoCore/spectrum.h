@@ -0,0 +1,86 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "adxl345_fifo.h"
+
+// Spectrum of the recent 3-axis signal: dominant frequency and RMS per band.
+//
+// Samples are pushed into a circular history as they arrive; compute() removes
+// the mean of each axis, applies a Hann window and transforms the newest
+// `points` samples with a radix-2 FFT. X and Y share one complex transform (as
+// real and imaginary parts) and are separated afterwards, so the three axes
+// cost two FFTs. Powers are scaled so that they sum to the mean square of the
+// signal; band and dominant values are RMS in counts.
+//
+// On the ESP32 the FFT is ESP-DSP's optimised radix-2 when the library is
+// available; elsewhere a portable implementation with the same interface.
+// Nothing is allocated: the caller supplies the history and the work buffer.
+
+#define SPECTRUM_MAX_POINTS 1024
+#define SPECTRUM_MAX_BANDS 6
+// Floats of work buffer compute() needs for `points`
+#define SPECTRUM_WORK_SIZE(points) (2 * (points) + 3 * ((points) / 2 + 1))
+
+// Prepare the FFT tables for up to SPECTRUM_MAX_POINTS; safe to call again
+bool fftBegin();
+// In-place forward FFT of n complex values stored as interleaved re, im; n is
+// a power of two from 4 to SPECTRUM_MAX_POINTS. fftBegin() must have succeeded.
+void fftComplex(float* data, uint32_t n);
+const char* fftImplementation(); // "esp-dsp" or "portable"
+
+struct SpectrumBand {
+  float low_hz;  // Inclusive
+  float high_hz; // Exclusive
+};
+
+struct SpectrumConfig {
+  uint32_t points;    // Power of two, 8 to SPECTRUM_MAX_POINTS
+  float sample_rate;  // Of the pushed samples (Hz)
+  float min_hz;       // Below this is drift and window leakage, left out of the dominant search and the RMS
+  uint8_t band_count;
+  SpectrumBand bands[SPECTRUM_MAX_BANDS];
+};
+
+// 512 points with bands from 0.5 Hz up to Nyquist
+SpectrumConfig defaultSpectrumConfig(float sampleRate);
+
+struct SpectrumResult {
+  uint32_t sequence;             // Spectra computed so far; 0 = no result yet
+  uint32_t points;
+  float sample_rate;
+  float resolution_hz;           // Bin spacing
+  float dominant_hz;             // Strongest frequency of the three axes together
+  float dominant_axis_hz[3];     // Strongest frequency per axis
+  float dominant_rms[3];         // RMS of the dominant peak per axis (counts)
+  float rms[3];                  // RMS from min_hz to Nyquist per axis (counts)
+  float band_rms[3][SPECTRUM_MAX_BANDS];
+};
+
+class SpectrumAnalyzer {
+  public:
+    SpectrumAnalyzer();
+
+    // samples: config.points entries; work: SPECTRUM_WORK_SIZE(config.points)
+    // floats. False if the configuration is unusable.
+    bool begin(const SpectrumConfig& config, RawSample* samples, float* work);
+    const SpectrumConfig& config() const { return cfg; }
+
+    void push(const RawSample& sample);
+    // Forget the history
+    void reset();
+    // A full window has been pushed since the last reset
+    bool ready() const { return cfg.points > 0 && filled >= cfg.points; }
+
+    // Transform the newest `points` samples; false until ready()
+    bool compute(SpectrumResult& out);
+
+  private:
+    float dominant(const float* power, uint32_t first, float* peakPower) const;
+
+    SpectrumConfig cfg;
+    RawSample* history;
+    float* work;
+    uint32_t head;      // Where the next sample goes (the oldest one once full)
+    uint32_t filled;
+    uint32_t computed;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring buffer.
+//
+// Exactly one task may call push() and exactly one task may call pop()/peek().
+// Capacity must be a power of two. When the ring is full, push() drops the new
+// element and counts it, so the producer never waits for the consumer.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+  public:
+    SpscRing() : head(0), tail(0), highWater(0), drops(0) {}
+
+    // Producer side
+    bool push(const T& item) {
+      uint32_t h = head.load(std::memory_order_relaxed);
+      uint32_t t = tail.load(std::memory_order_acquire);
+      uint32_t used = h - t;
+      if (used >= Capacity) {
+        drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      items[h & (Capacity - 1)] = item;
+      head.store(h + 1, std::memory_order_release);
+
+      used++;
+      if (used > highWater.load(std::memory_order_relaxed)) {
+        highWater.store(used, std::memory_order_relaxed);
+      }
+      return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      uint32_t h = head.load(std::memory_order_acquire);
+      if (h == t) return false;
+      item = items[t & (Capacity - 1)];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Pop up to maxItems in one go; returns the number popped
+    size_t pop(T* out, size_t maxItems) {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      uint32_t h = head.load(std::memory_order_acquire);
+      size_t count = h - t;
+      if (count > maxItems) count = maxItems;
+      for (size_t i = 0; i < count; i++) {
+        out[i] = items[(t + i) & (Capacity - 1)];
+      }
+      tail.store(t + (uint32_t)count, std::memory_order_release);
+      return count;
+    }
+
+    // Discard everything currently queued (consumer side)
+    void clear() {
+      tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Either side; the value may be stale by the time it is used
+    size_t size() const {
+      return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static size_t capacity() { return Capacity; }
+
+    // Statistics
+    uint32_t highWaterMark() const { return highWater.load(std::memory_order_relaxed); }
+    uint32_t dropCount() const { return drops.load(std::memory_order_relaxed); }
+
+  private:
+    T items[Capacity];
+    // Free-running indices; unsigned wrap-around keeps head - tail correct
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> highWater;
+    std::atomic<uint32_t> drops;
+};
@@ -0,0 +1,92 @@
+#include "sta_lta.h"
+
+StaLtaConfig defaultStaLtaConfig() {
+  StaLtaConfig config;
+  config.sta_seconds = 0.5;
+  config.lta_seconds = 30.0;
+  config.trigger_on = 4.0;
+  config.trigger_off = 1.5;
+  config.min_lta = 1e-4;           // (0.01 m/s²)²
+  config.max_trigger_seconds = 120.0;
+  config.freeze_lta = true;
+  return config;
+}
+
+StaLtaTrigger::StaLtaTrigger() : triggers(0) {
+  configure(defaultStaLtaConfig(), 100.0);
+}
+
+void StaLtaTrigger::configure(const StaLtaConfig& config, float sampleRate) {
+  cfg = config;
+  float staSamples = cfg.sta_seconds * sampleRate;
+  float ltaSamples = cfg.lta_seconds * sampleRate;
+  if (staSamples < 1) staSamples = 1;
+  if (ltaSamples < staSamples) ltaSamples = staSamples;
+  staCoeff = 1.0f / staSamples;
+  ltaCoeff = 1.0f / ltaSamples;
+  staLength = (uint32_t)staSamples;
+  ltaLength = (uint32_t)ltaSamples;
+
+  // Two STA windows are enough to seed both averages (see update())
+  warmupSamples = (uint32_t)(2 * staSamples);
+  maxTriggerSamples = (uint32_t)(cfg.max_trigger_seconds * sampleRate);
+  reset();
+}
+
+void StaLtaTrigger::reset() {
+  current = STA_LTA_WARMUP;
+  staValue = 0;
+  ltaValue = 0;
+  ratioValue = 0;
+  samples = 0;
+  triggeredSamples = 0;
+  rearmPending = false;
+}
+
+bool StaLtaTrigger::update(float value) {
+  if (samples < 0xFFFFFFFFu) samples++;
+
+  // Until a full window has been seen the averages are plain cumulative means,
+  // which converge much faster than the recursive form started from zero
+  float sc = (samples < staLength) ? 1.0f / samples : staCoeff;
+  float lc = (samples < ltaLength) ? 1.0f / samples : ltaCoeff;
+
+  staValue += (value - staValue) * sc;
+  if (!(cfg.freeze_lta && current == STA_LTA_TRIGGERED)) {
+    ltaValue += (value - ltaValue) * lc;
+  }
+
+  float lta = ltaValue > cfg.min_lta ? ltaValue : cfg.min_lta;
+  ratioValue = staValue / lta;
+
+  switch (current) {
+    case STA_LTA_WARMUP:
+      if (samples >= warmupSamples) current = STA_LTA_IDLE;
+      return false;
+
+    case STA_LTA_IDLE:
+      // After a forced detrigger the ratio must drop before a new trigger
+      if (rearmPending) {
+        if (ratioValue <= cfg.trigger_off) rearmPending = false;
+        return false;
+      }
+      if (ratioValue >= cfg.trigger_on) {
+        current = STA_LTA_TRIGGERED;
+        triggeredSamples = 0;
+        triggers++;
+        return true;
+      }
+      return false;
+
+    case STA_LTA_TRIGGERED:
+      triggeredSamples++;
+      if (ratioValue <= cfg.trigger_off) {
+        current = STA_LTA_IDLE;
+      } else if (maxTriggerSamples > 0 && triggeredSamples >= maxTriggerSamples) {
+        current = STA_LTA_IDLE;
+        rearmPending = true;
+      }
+      return false;
+  }
+  return false;
+}
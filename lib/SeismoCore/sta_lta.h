@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+
+// Short-term-average / long-term-average trigger for one channel.
+//
+// Both averages are recursive (exponentially weighted) running sums of the
+// characteristic function, so each update is O(1) in time and memory no matter
+// how long the windows are. The window lengths are the averaging time
+// constants. The channel triggers when STA/LTA rises above trigger_on and
+// detriggers when it falls below trigger_off.
+
+struct StaLtaConfig {
+  float sta_seconds;         // Short-term window
+  float lta_seconds;         // Long-term window
+  float trigger_on;          // STA/LTA ratio that starts a trigger
+  float trigger_off;         // STA/LTA ratio that ends it (below trigger_on)
+  float min_lta;             // Floor for the LTA so a very quiet sensor cannot trigger on noise
+  float max_trigger_seconds; // Force a detrigger after this long (0 = never)
+  bool freeze_lta;           // Hold the LTA while triggered so long events stay triggered
+};
+
+StaLtaConfig defaultStaLtaConfig();
+
+enum StaLtaState {
+  STA_LTA_WARMUP,    // Averages still settling, no triggers yet
+  STA_LTA_IDLE,
+  STA_LTA_TRIGGERED
+};
+
+class StaLtaTrigger {
+  public:
+    StaLtaTrigger();
+
+    void configure(const StaLtaConfig& config, float sampleRate);
+    void reset();
+    // Change the LTA floor (units of the characteristic function) in place
+    void setMinLta(float minLta) { cfg.min_lta = minLta; }
+    // Change the trigger ratios in place; a running trigger ends at the new trigger_off
+    void setRatios(float triggerOn, float triggerOff) {
+      cfg.trigger_on = triggerOn;
+      cfg.trigger_off = triggerOff;
+    }
+
+    // Feed one value of the characteristic function (e.g. squared deviation).
+    // Returns true on the sample where the channel triggers.
+    bool update(float value);
+
+    StaLtaState state() const { return current; }
+    bool triggered() const { return current == STA_LTA_TRIGGERED; }
+    float sta() const { return staValue; }
+    float lta() const { return ltaValue; }
+    float ratio() const { return ratioValue; }
+    uint32_t triggerCount() const { return triggers; }
+
+  private:
+    StaLtaConfig cfg;
+    float staCoeff;
+    float ltaCoeff;
+    uint32_t staLength;
+    uint32_t ltaLength;
+    uint32_t warmupSamples;
+    uint32_t maxTriggerSamples;
+
+    StaLtaState current;
+    float staValue;
+    float ltaValue;
+    float ratioValue;
+    uint32_t samples;          // Samples seen since reset (saturates)
+    uint32_t triggeredSamples; // Samples spent in the current trigger
+    bool rearmPending;         // Forced detrigger; wait for the ratio to drop
+    uint32_t triggers;
+};
@@ -0,0 +1,455 @@
+#include "station_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char* const INTENSITY_MODE_NAMES[] = { "thresholds", "regression", NULL };
+
+#define STATION_FIELD(field) ((uint16_t)offsetof(StationConfig, field))
+#define THRESHOLD(n, key) \
+  { "mercalli_" #n "_threshold", key, CONFIG_FLOAT, 0, STATION_FIELD(mercalli_thresholds[n - 1]), \
+    0.01f, 160.0f, "m/s2", NULL }
+
+static const ConfigParam PARAMS[CONFIG_PARAM_COUNT] = {
+  THRESHOLD(1, "merc1"), THRESHOLD(2, "merc2"), THRESHOLD(3, "merc3"), THRESHOLD(4, "merc4"),
+  THRESHOLD(5, "merc5"), THRESHOLD(6, "merc6"), THRESHOLD(7, "merc7"), THRESHOLD(8, "merc8"),
+  THRESHOLD(9, "merc9"), THRESHOLD(10, "merc10"), THRESHOLD(11, "merc11"),
+  { "trigger_on", "trig_on", CONFIG_FLOAT, 0, STATION_FIELD(trigger_on), 1.1f, 50.0f, NULL, NULL },
+  { "trigger_off", "trig_off", CONFIG_FLOAT, 0, STATION_FIELD(trigger_off), 0.5f, 50.0f, NULL, NULL },
+  // The firmware holds each event 8 s for its JMA intensity, so not less
+  { "min_event_interval_ms", "event_gap", CONFIG_U32, 0, STATION_FIELD(min_event_interval_ms),
+    8000, 3600000, "ms", NULL },
+  { "min_log_mercalli", "log_mercalli", CONFIG_U32, 0, STATION_FIELD(min_log_mercalli), 1, 12, NULL, NULL },
+  { "intensity_mode", "intensity", CONFIG_ENUM, 0, STATION_FIELD(intensity_mode), 0, 0, NULL,
+    INTENSITY_MODE_NAMES },
+  { "update_interval_ms", "update_ms", CONFIG_U32, 0, STATION_FIELD(update_interval_ms), 20, 1000, "ms", NULL },
+  { "stream_rate_hz", "stream_hz", CONFIG_U32, 0, STATION_FIELD(stream_rate_hz), 10, 50, "Hz", NULL },
+  { "waveform_post_seconds", "wave_post", CONFIG_FLOAT, 0, STATION_FIELD(waveform_post_seconds),
+    0, 20, "s", NULL },
+  { "collector", "collector", CONFIG_STRING, 0, STATION_FIELD(collector), 0, 0, NULL, NULL },
+  { "telemetry", "telemetry", CONFIG_STRING, 0, STATION_FIELD(telemetry), 0, 0, NULL, NULL },
+  { "wifi_ssid", "ssid", CONFIG_STRING, CONFIG_REBOOT, STATION_FIELD(wifi_ssid), 0, 0, NULL, NULL },
+  { "wifi_password", "password", CONFIG_STRING, CONFIG_REBOOT | CONFIG_SECRET, STATION_FIELD(wifi_password),
+    0, 0, NULL, NULL },
+};
+
+StationConfig defaultStationConfig() {
+  StationConfig config;
+  memset(&config, 0, sizeof(config));
+  DetectorConfig detector = defaultDetectorConfig(400.0f);
+  for (int i = 0; i < 11; i++) config.mercalli_thresholds[i] = detector.mercalli_thresholds[i];
+  config.trigger_on = detector.trigger.trigger_on;
+  config.trigger_off = detector.trigger.trigger_off;
+  config.min_event_interval_ms = detector.min_event_interval_ms;
+  config.min_log_mercalli = detector.min_log_mercalli;
+  config.intensity_mode = (uint8_t)detector.intensity_mode;
+  config.update_interval_ms = 100;
+  config.stream_rate_hz = 20;
+  config.waveform_post_seconds = 20;
+  return config;
+}
+
+const ConfigParam& configParam(size_t index) {
+  return PARAMS[index];
+}
+
+const ConfigParam* findConfigParam(const char* name) {
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    if (strcmp(PARAMS[i].name, name) == 0) return &PARAMS[i];
+  }
+  return NULL;
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void* fieldOf(const ConfigParam& param, StationConfig& config) {
+  return (uint8_t*)&config + param.offset;
+}
+
+static const void* fieldOf(const ConfigParam& param, const StationConfig& config) {
+  return (const uint8_t*)&config + param.offset;
+}
+
+static size_t fieldSize(const ConfigParam& param) {
+  if (param.type == CONFIG_STRING) return CONFIG_STRING_SIZE;
+  return param.type == CONFIG_ENUM ? 1 : 4;
+}
+
+static size_t enumCount(const ConfigParam& param) {
+  size_t count = 0;
+  while (param.names[count]) count++;
+  return count;
+}
+
+size_t encodeConfigValue(const ConfigParam& param, const StationConfig& config, uint8_t* out) {
+  const void* field = fieldOf(param, config);
+  out[0] = param.type;
+  switch (param.type) {
+    case CONFIG_FLOAT: {
+      uint32_t bits;
+      memcpy(&bits, field, 4);
+      put32(out + 1, bits);
+      return 5;
+    }
+    case CONFIG_U32:
+      put32(out + 1, *(const uint32_t*)field);
+      return 5;
+    case CONFIG_ENUM:
+      out[1] = *(const uint8_t*)field;
+      return 2;
+    case CONFIG_STRING: {
+      size_t length = strnlen((const char*)field, CONFIG_STRING_SIZE - 1);
+      memcpy(out + 1, field, length);
+      return 1 + length;
+    }
+  }
+  return 0;
+}
+
+bool decodeConfigValue(const ConfigParam& param, const uint8_t* data, size_t length, StationConfig& config) {
+  if (length < 1 || data[0] != param.type) return false;
+  void* field = fieldOf(param, config);
+  switch (param.type) {
+    case CONFIG_FLOAT: {
+      if (length != 5) return false;
+      uint32_t bits = get32(data + 1);
+      float value;
+      memcpy(&value, &bits, 4);
+      if (!isfinite(value) || value < param.min || value > param.max) return false;
+      *(float*)field = value;
+      return true;
+    }
+    case CONFIG_U32: {
+      if (length != 5) return false;
+      uint32_t value = get32(data + 1);
+      if (value < param.min || value > param.max) return false;
+      *(uint32_t*)field = value;
+      return true;
+    }
+    case CONFIG_ENUM:
+      if (length != 2 || data[1] >= enumCount(param)) return false;
+      *(uint8_t*)field = data[1];
+      return true;
+    case CONFIG_STRING:
+      if (length > CONFIG_STRING_SIZE || memchr(data + 1, 0, length - 1)) return false;
+      memcpy(field, data + 1, length - 1);
+      ((char*)field)[length - 1] = 0;
+      return true;
+  }
+  return false;
+}
+
+bool configValueEquals(const ConfigParam& param, const StationConfig& a, const StationConfig& b) {
+  uint8_t encodedA[CONFIG_MAX_VALUE], encodedB[CONFIG_MAX_VALUE];
+  size_t lengthA = encodeConfigValue(param, a, encodedA);
+  size_t lengthB = encodeConfigValue(param, b, encodedB);
+  return lengthA == lengthB && memcmp(encodedA, encodedB, lengthA) == 0;
+}
+
+ConfigSetResult setConfigParam(StationConfig& config, const char* name, const char* text) {
+  const ConfigParam* param = findConfigParam(name);
+  if (!param) return CONFIG_SET_UNKNOWN;
+  void* field = fieldOf(*param, config);
+  char* end = NULL;
+  switch (param->type) {
+    case CONFIG_FLOAT: {
+      float value = strtof(text, &end);
+      if (end == text || *end != 0 || !isfinite(value) || value < param->min || value > param->max) {
+        return CONFIG_SET_INVALID;
+      }
+      *(float*)field = value;
+      return CONFIG_SET_OK;
+    }
+    case CONFIG_U32: {
+      if (*text < '0' || *text > '9') return CONFIG_SET_INVALID;
+      unsigned long value = strtoul(text, &end, 10);
+      if (*end != 0 || value < param->min || value > param->max) return CONFIG_SET_INVALID;
+      *(uint32_t*)field = (uint32_t)value;
+      return CONFIG_SET_OK;
+    }
+    case CONFIG_ENUM:
+      for (size_t i = 0; param->names[i]; i++) {
+        if (strcasecmp(param->names[i], text) == 0) {
+          *(uint8_t*)field = (uint8_t)i;
+          return CONFIG_SET_OK;
+        }
+      }
+      return CONFIG_SET_INVALID;
+    case CONFIG_STRING:
+      if (strlen(text) >= CONFIG_STRING_SIZE) return CONFIG_SET_INVALID;
+      strcpy((char*)field, text);
+      return CONFIG_SET_OK;
+  }
+  return CONFIG_SET_INVALID;
+}
+
+void formatConfigValue(const ConfigParam& param, const StationConfig& config, char* out, size_t size) {
+  const void* field = fieldOf(param, config);
+  switch (param.type) {
+    case CONFIG_FLOAT:
+      snprintf(out, size, "%g", *(const float*)field);
+      return;
+    case CONFIG_U32:
+      snprintf(out, size, "%lu", (unsigned long)*(const uint32_t*)field);
+      return;
+    case CONFIG_ENUM:
+      snprintf(out, size, "%s", param.names[*(const uint8_t*)field]);
+      return;
+    case CONFIG_STRING:
+      if (param.flags & CONFIG_SECRET) snprintf(out, size, "%s", *(const char*)field ? "********" : "");
+      else snprintf(out, size, "%s", (const char*)field);
+      return;
+  }
+  if (size > 0) out[0] = 0;
+}
+
+const char* checkStationConfig(const StationConfig& config) {
+  for (int i = 1; i < 11; i++) {
+    if (config.mercalli_thresholds[i] <= config.mercalli_thresholds[i - 1]) {
+      return "Mercalli thresholds must ascend";
+    }
+  }
+  if (config.trigger_off >= config.trigger_on) return "trigger_off must be below trigger_on";
+  return NULL;
+}
+
+static void writeValueJson(JsonWriter& json, const char* key, const ConfigParam& param,
+                           const StationConfig& config) {
+  const void* field = fieldOf(param, config);
+  switch (param.type) {
+    case CONFIG_FLOAT: json.field(key, *(const float*)field, 3); break;
+    case CONFIG_U32: json.field(key, (unsigned long)*(const uint32_t*)field); break;
+    case CONFIG_ENUM: json.field(key, param.names[*(const uint8_t*)field]); break;
+    case CONFIG_STRING: json.field(key, (const char*)field); break;
+  }
+}
+
+void writeConfigParamJson(JsonWriter& json, const ConfigParam& param, const StationConfig& config) {
+  json.beginObject();
+  json.field("name", param.name);
+  if (param.flags & CONFIG_SECRET) {
+    json.fieldNull("value");
+    json.field("set", *(const char*)fieldOf(param, config) != 0);
+  } else {
+    writeValueJson(json, "value", param, config);
+    writeValueJson(json, "default", param, defaultStationConfig());
+  }
+  if (param.type == CONFIG_FLOAT) {
+    json.field("min", param.min, 3);
+    json.field("max", param.max, 3);
+  } else if (param.type == CONFIG_U32) {
+    json.field("min", (unsigned long)param.min);
+    json.field("max", (unsigned long)param.max);
+  } else if (param.type == CONFIG_ENUM) {
+    json.beginArray("options");
+    for (size_t n = 0; param.names[n]; n++) json.field(NULL, param.names[n]);
+    json.endArray();
+  } else {
+    json.field("max_length", CONFIG_STRING_SIZE - 1);
+  }
+  if (param.unit) json.field("unit", param.unit);
+  json.field("reboot", (param.flags & CONFIG_REBOOT) != 0);
+  json.endObject();
+}
+
+void applyStationConfig(const StationConfig& station, DetectorConfig& detector) {
+  for (int i = 0; i < 11; i++) detector.mercalli_thresholds[i] = station.mercalli_thresholds[i];
+  detector.trigger.trigger_on = station.trigger_on;
+  detector.trigger.trigger_off = station.trigger_off;
+  detector.min_event_interval_ms = station.min_event_interval_ms;
+  detector.min_log_mercalli = (int)station.min_log_mercalli;
+  detector.intensity_mode = (IntensityMode)station.intensity_mode;
+}
+
+size_t encodeCalibration(const StoredCalibration& calibration, uint8_t* out) {
+  int16_t offsets[3] = { calibration.offset_x, calibration.offset_y, calibration.offset_z };
+  out[0] = CONFIG_CALIBRATION;
+  for (int axis = 0; axis < 3; axis++) {
+    out[1 + 2 * axis] = (uint8_t)offsets[axis];
+    out[2 + 2 * axis] = (uint8_t)((uint16_t)offsets[axis] >> 8);
+  }
+  uint32_t bits;
+  memcpy(&bits, &calibration.noise_threshold, 4);
+  put32(out + 7, bits);
+  memcpy(&bits, &calibration.ms2_per_count, 4);
+  put32(out + 11, bits);
+  return CALIBRATION_RECORD_SIZE;
+}
+
+bool decodeCalibration(const uint8_t* data, size_t length, StoredCalibration& calibration) {
+  if (length != CALIBRATION_RECORD_SIZE || data[0] != CONFIG_CALIBRATION) return false;
+  int16_t offsets[3];
+  for (int axis = 0; axis < 3; axis++) {
+    offsets[axis] = (int16_t)(data[1 + 2 * axis] | (data[2 + 2 * axis] << 8));
+    if (offsets[axis] > CALIBRATION_MAX_OFFSET || offsets[axis] < -CALIBRATION_MAX_OFFSET) return false;
+  }
+  float noise, scale;
+  uint32_t bits = get32(data + 7);
+  memcpy(&noise, &bits, 4);
+  bits = get32(data + 11);
+  memcpy(&scale, &bits, 4);
+  if (!isfinite(noise) || noise <= 0 || !isfinite(scale) || scale <= 0) return false;
+
+  calibration.offset_x = offsets[0];
+  calibration.offset_y = offsets[1];
+  calibration.offset_z = offsets[2];
+  calibration.noise_threshold = noise;
+  calibration.ms2_per_count = scale;
+  return true;
+}
+
+bool findClockAnchor(const ClockAnchors& anchors, uint32_t boot, int64_t& utc_us) {
+  for (uint8_t i = 0; i < anchors.count; i++) {
+    if (anchors.boot[i] == boot) {
+      utc_us = anchors.utc_us[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+void addClockAnchor(ClockAnchors& anchors, uint32_t boot, int64_t utc_us) {
+  uint8_t i = 0;
+  while (i < anchors.count && anchors.boot[i] != boot) i++;
+  if (i == CLOCK_ANCHOR_COUNT) {
+    memmove(anchors.boot, anchors.boot + 1, (CLOCK_ANCHOR_COUNT - 1) * sizeof(anchors.boot[0]));
+    memmove(anchors.utc_us, anchors.utc_us + 1, (CLOCK_ANCHOR_COUNT - 1) * sizeof(anchors.utc_us[0]));
+    i = CLOCK_ANCHOR_COUNT - 1;
+  } else if (i == anchors.count) {
+    anchors.count++;
+  }
+  anchors.boot[i] = boot;
+  anchors.utc_us[i] = utc_us;
+}
+
+size_t encodeClockAnchors(const ClockAnchors& anchors, uint8_t* out) {
+  out[0] = CONFIG_CLOCK_ANCHORS;
+  for (uint8_t i = 0; i < anchors.count; i++) {
+    uint8_t* p = out + 1 + 12 * i;
+    uint64_t utc = (uint64_t)anchors.utc_us[i];
+    put32(p, anchors.boot[i]);
+    put32(p + 4, (uint32_t)utc);
+    put32(p + 8, (uint32_t)(utc >> 32));
+  }
+  return 1 + 12 * anchors.count;
+}
+
+bool decodeClockAnchors(const uint8_t* data, size_t length, ClockAnchors& anchors) {
+  if (length < 1 || length > CLOCK_ANCHORS_MAX_SIZE || (length - 1) % 12 != 0 ||
+      data[0] != CONFIG_CLOCK_ANCHORS) {
+    return false;
+  }
+  anchors.count = (uint8_t)((length - 1) / 12);
+  for (uint8_t i = 0; i < anchors.count; i++) {
+    const uint8_t* p = data + 1 + 12 * i;
+    anchors.boot[i] = get32(p);
+    anchors.utc_us[i] = (int64_t)(get32(p + 4) | ((uint64_t)get32(p + 8) << 32));
+  }
+  return true;
+}
+
+ConfigStore::ConfigStore(ConfigStorage& storage) : storage(storage), version(0), writes(0) {
+  stored = defaultStationConfig();
+  memset(dirty, 0, sizeof(dirty));
+}
+
+ConfigLoadResult ConfigStore::load(StationConfig& config, ConfigMigration migrate, void* context) {
+  ConfigLoadResult result = { 0, 0, 0, false };
+  uint8_t data[CONFIG_MAX_VALUE];
+  size_t length = storage.read(CONFIG_SCHEMA_KEY, data, sizeof(data));
+  if (length == 3 && data[0] == CONFIG_U16) result.stored_version = (uint16_t)(data[1] | (data[2] << 8));
+  version = result.stored_version;
+
+  stored = defaultStationConfig();
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    dirty[i] = false;
+    length = storage.read(PARAMS[i].key, data, sizeof(data));
+    if (length == 0) continue;
+    if (decodeConfigValue(PARAMS[i], data, length, stored)) {
+      result.loaded++;
+    } else {
+      result.rejected++;
+      dirty[i] = true;
+    }
+  }
+
+  config = stored;
+  if (version < CONFIG_SCHEMA_VERSION && migrate) {
+    migrate(version, config, context);
+    result.migrated = true;
+  }
+  return result;
+}
+
+int ConfigStore::save(const StationConfig& config) {
+  uint8_t data[CONFIG_MAX_VALUE];
+  int written = 0;
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    if (!dirty[i] && configValueEquals(PARAMS[i], config, stored)) continue;
+    size_t length = encodeConfigValue(PARAMS[i], config, data);
+    if (!storage.write(PARAMS[i].key, data, length)) return -1;
+    memcpy(fieldOf(PARAMS[i], stored), fieldOf(PARAMS[i], config), fieldSize(PARAMS[i]));
+    dirty[i] = false;
+    writes++;
+    written++;
+  }
+  if (version < CONFIG_SCHEMA_VERSION) {
+    data[0] = CONFIG_U16;
+    data[1] = (uint8_t)CONFIG_SCHEMA_VERSION;
+    data[2] = (uint8_t)(CONFIG_SCHEMA_VERSION >> 8);
+    if (!storage.write(CONFIG_SCHEMA_KEY, data, 3)) return -1;
+    version = CONFIG_SCHEMA_VERSION;
+    writes++;
+    written++;
+  }
+  return written;
+}
+
+bool ConfigStore::loadCalibration(StoredCalibration& calibration) {
+  uint8_t data[CONFIG_MAX_VALUE];
+  size_t length = storage.read(CONFIG_CALIBRATION_KEY, data, sizeof(data));
+  return length > 0 && decodeCalibration(data, length, calibration);
+}
+
+bool ConfigStore::saveCalibration(const StoredCalibration& calibration) {
+  uint8_t data[CALIBRATION_RECORD_SIZE];
+  size_t length = encodeCalibration(calibration, data);
+  if (!storage.write(CONFIG_CALIBRATION_KEY, data, length)) return false;
+  writes++;
+  return true;
+}
+
+uint32_t ConfigStore::nextBoot() {
+  uint8_t data[CONFIG_MAX_VALUE];
+  size_t length = storage.read(CONFIG_BOOT_KEY, data, sizeof(data));
+  uint32_t boot = length == 5 && data[0] == CONFIG_U32 ? get32(data + 1) + 1 : 1;
+  data[0] = CONFIG_U32;
+  put32(data + 1, boot);
+  if (storage.write(CONFIG_BOOT_KEY, data, 5)) writes++;
+  return boot;
+}
+
+void ConfigStore::loadClockAnchors(ClockAnchors& anchors) {
+  uint8_t data[CLOCK_ANCHORS_MAX_SIZE];
+  size_t length = storage.read(CONFIG_CLOCK_KEY, data, sizeof(data));
+  if (length == 0 || !decodeClockAnchors(data, length, anchors)) anchors.count = 0;
+}
+
+bool ConfigStore::saveClockAnchors(const ClockAnchors& anchors) {
+  uint8_t data[CLOCK_ANCHORS_MAX_SIZE];
+  size_t length = encodeClockAnchors(anchors, data);
+  if (!storage.write(CONFIG_CLOCK_KEY, data, length)) return false;
+  writes++;
+  return true;
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "detector.h"
+#include "json_writer.h"
+
+// Station settings that can be changed in the field, kept in a key-value
+// store (NVS on the board), one key per parameter.
+//
+// Every key holds a small typed value:
+//    0  u8   type tag (ConfigType)
+//    1  ...  f32 or u32 little-endian, u8 for an enum, the bytes of a string
+// A value of the wrong type, length or range is rejected on load and the
+// default used instead. A missing key reads as its default, so defaults take
+// no flash and a parameter added later needs no migration of its own.
+//
+// The CONFIG_SCHEMA_KEY key (u16, same tag scheme) records the layout. When
+// it is older than CONFIG_SCHEMA_VERSION - 0 if nothing was ever stored -
+// load() hands the result to the caller's migration, and the next save()
+// stores what it changed together with the new version. save() compares with
+// what the store holds and writes only the keys that differ, so an unchanged
+// setting never costs a flash write.
+//
+// The last good calibration is kept under CONFIG_CALIBRATION_KEY in the same
+// scheme, so a station that restarts while the ground is moving (a brown-out
+// in an aftershock sequence) resumes with it instead of having to lie still
+// for a new one. It is not a setting and has no entry in the parameter table.
+//
+// Neither is the boot counter under CONFIG_BOOT_KEY (u32), which numbers the
+// station's boots. Events detected before the clock is set are stored with
+// their boot and the microseconds since it; once NTP syncs, UTC at the start
+// of that boot goes under CONFIG_CLOCK_KEY, for the newest CLOCK_ANCHOR_COUNT
+// such boots, so those events get a UTC time after a restart as well.
+//
+// Schema history:
+//   0  Nothing in NVS: credentials and push targets in EEPROM, thresholds
+//      compiled in
+//   1  This layout
+
+#define CONFIG_SCHEMA_VERSION 1
+#define CONFIG_SCHEMA_KEY     "schema"
+#define CONFIG_MAX_KEY        15  // NVS limit
+#define CONFIG_STRING_SIZE    64  // String buffers, terminator included
+#define CONFIG_MAX_VALUE      (1 + CONFIG_STRING_SIZE)
+#define CONFIG_PARAM_COUNT    23
+#define CONFIG_CALIBRATION_KEY "calibration"
+#define CONFIG_BOOT_KEY       "boot"
+#define CONFIG_CLOCK_KEY      "clock"
+
+enum ConfigType {
+  CONFIG_FLOAT = 1,
+  CONFIG_U32 = 2,
+  CONFIG_ENUM = 3,   // uint8_t, index into the parameter's names
+  CONFIG_STRING = 4,
+  CONFIG_U16 = 5,    // The schema version only
+  CONFIG_CALIBRATION = 6, // StoredCalibration only
+  CONFIG_CLOCK_ANCHORS = 7 // ClockAnchors only
+};
+
+#define CONFIG_REBOOT 0x01 // Takes effect after a restart
+#define CONFIG_SECRET 0x02 // Never reported back
+
+struct StationConfig {
+  float mercalli_thresholds[11];  // MERCALLI_n_THRESHOLD (m/s²), ascending
+  float trigger_on;               // STA/LTA ratios
+  float trigger_off;
+  uint32_t min_event_interval_ms; // Between logged events
+  uint32_t min_log_mercalli;      // Weaker triggers are not logged
+  uint8_t intensity_mode;         // IntensityMode
+  uint32_t update_interval_ms;    // BLE notifications
+  uint32_t stream_rate_hz;        // /stream frames
+  float waveform_post_seconds;    // Post-trigger waveform window
+  char collector[CONFIG_STRING_SIZE]; // "host" or "host:port", empty when off
+  char telemetry[CONFIG_STRING_SIZE];
+  char wifi_ssid[CONFIG_STRING_SIZE]; // Empty: the compiled-in default
+  char wifi_password[CONFIG_STRING_SIZE];
+};
+
+StationConfig defaultStationConfig();
+
+struct ConfigParam {
+  const char* name;         // In /config/params and the SET command
+  const char* key;          // Storage key, at most CONFIG_MAX_KEY characters
+  uint8_t type;             // ConfigType
+  uint8_t flags;            // CONFIG_REBOOT, CONFIG_SECRET
+  uint16_t offset;          // Of the value in StationConfig
+  float min, max;           // Range of a number
+  const char* unit;         // NULL if none
+  const char* const* names; // Values of an enum, NULL-terminated
+};
+
+const ConfigParam& configParam(size_t index);
+// NULL if there is no parameter of that name
+const ConfigParam* findConfigParam(const char* name);
+
+// Typed value of one parameter; at most CONFIG_MAX_VALUE bytes
+size_t encodeConfigValue(const ConfigParam& param, const StationConfig& config, uint8_t* out);
+// False, and config untouched, if the tag, length or range is wrong
+bool decodeConfigValue(const ConfigParam& param, const uint8_t* data, size_t length, StationConfig& config);
+bool configValueEquals(const ConfigParam& param, const StationConfig& a, const StationConfig& b);
+
+enum ConfigSetResult {
+  CONFIG_SET_OK,
+  CONFIG_SET_UNKNOWN, // No such parameter
+  CONFIG_SET_INVALID  // Not a value of its type, or out of range
+};
+
+// Parse text (a number, an enum name in any case, a string) into config
+ConfigSetResult setConfigParam(StationConfig& config, const char* name, const char* text);
+// Value as text; secrets show as "********" when set
+void formatConfigValue(const ConfigParam& param, const StationConfig& config, char* out, size_t size);
+// Checks across parameters (ascending thresholds, trigger_off below
+// trigger_on); NULL if the configuration is consistent, else the problem
+const char* checkStationConfig(const StationConfig& config);
+
+// One element of a params array: name, value and default (a secret only
+// says whether it is set), min and max, the options of an enum or a string's
+// max_length, unit and whether it needs a reboot
+void writeConfigParamJson(JsonWriter& json, const ConfigParam& param, const StationConfig& config);
+
+// The detector's tunable thresholds from the station settings
+void applyStationConfig(const StationConfig& station, DetectorConfig& detector);
+
+// Software calibration as the firmware applies it:
+//    0  u8   CONFIG_CALIBRATION
+//    1  i16  offset x, y, z (counts)
+//    7  f32  noise threshold (m/s²)
+//   11  f32  scale it was measured at (m/s² per count); a different range or
+//            resolution makes the offsets meaningless
+struct StoredCalibration {
+  int16_t offset_x, offset_y, offset_z;
+  float noise_threshold;
+  float ms2_per_count;
+};
+
+#define CALIBRATION_RECORD_SIZE 15
+#define CALIBRATION_MAX_OFFSET  2048 // Counts; more is a fault, not an offset
+
+size_t encodeCalibration(const StoredCalibration& calibration, uint8_t* out);
+// False, and calibration untouched, if the tag, length or a value is wrong
+bool decodeCalibration(const uint8_t* data, size_t length, StoredCalibration& calibration);
+
+// UTC at the start of boots whose clock was set:
+//    0  u8   CONFIG_CLOCK_ANCHORS
+//    1  per anchor, oldest first: u32 boot, i64 UTC microseconds at its start
+#define CLOCK_ANCHOR_COUNT     8
+#define CLOCK_ANCHORS_MAX_SIZE (1 + 12 * CLOCK_ANCHOR_COUNT)
+
+struct ClockAnchors {
+  uint32_t boot[CLOCK_ANCHOR_COUNT];
+  int64_t utc_us[CLOCK_ANCHOR_COUNT];
+  uint8_t count;
+};
+
+// False if the boot has no anchor
+bool findClockAnchor(const ClockAnchors& anchors, uint32_t boot, int64_t& utc_us);
+// Replaces the boot's anchor, or drops the oldest once all are in use
+void addClockAnchor(ClockAnchors& anchors, uint32_t boot, int64_t utc_us);
+size_t encodeClockAnchors(const ClockAnchors& anchors, uint8_t* out);
+// False, and anchors untouched, if the tag or length is wrong
+bool decodeClockAnchors(const uint8_t* data, size_t length, ClockAnchors& anchors);
+
+// Keys and values; implemented on top of NVS (or anything else)
+class ConfigStorage {
+  public:
+    virtual ~ConfigStorage() {}
+    // Bytes read into data, 0 if the key does not exist or does not fit
+    virtual size_t read(const char* key, uint8_t* data, size_t size) = 0;
+    // Store and make durable
+    virtual bool write(const char* key, const uint8_t* data, size_t length) = 0;
+};
+
+// Upgrades a configuration loaded from an older schema in place
+typedef void (*ConfigMigration)(uint16_t fromVersion, StationConfig& config, void* context);
+
+struct ConfigLoadResult {
+  uint16_t stored_version; // 0 if nothing was stored yet
+  uint16_t loaded;         // Keys read
+  uint16_t rejected;       // Keys of the wrong type, length or range; defaults used
+  bool migrated;           // The migration ran; save() stores what it changed
+};
+
+class ConfigStore {
+  public:
+    explicit ConfigStore(ConfigStorage& storage);
+
+    // Defaults overlaid with every stored key; an older schema runs migrate
+    ConfigLoadResult load(StationConfig& config, ConfigMigration migrate = NULL, void* context = NULL);
+    // Write the keys that differ from the store, rejected ones and the schema
+    // version if it is behind. Returns the keys written, or -1 if a write
+    // failed (the keys written before it are saved).
+    int save(const StationConfig& config);
+
+    // The stored calibration; false if there is none or it is invalid
+    bool loadCalibration(StoredCalibration& calibration);
+    bool saveCalibration(const StoredCalibration& calibration);
+
+    // Number of this boot: the stored counter plus one, written back; 1 the
+    // first time. If the write fails the next boot gets the same number.
+    uint32_t nextBoot();
+    // Empty if none are stored or they are invalid
+    void loadClockAnchors(ClockAnchors& anchors);
+    bool saveClockAnchors(const ClockAnchors& anchors);
+
+    uint16_t storedVersion() const { return version; }
+    uint32_t writeCount() const { return writes; }
+
+  private:
+    ConfigStorage& storage;
+    StationConfig stored; // What the storage holds, defaults for missing keys
+    bool dirty[CONFIG_PARAM_COUNT]; // Stored value was rejected; rewrite it
+    uint16_t version;
+    uint32_t writes;
+};
@@ -0,0 +1,78 @@
+#include "telemetry_packet.h"
+#include "crc32.h"
+
+#define TELEMETRY_PACKET_PAYLOAD (TELEMETRY_PACKET_SIZE - 4)
+#define TELEMETRY_SAMPLE_OFFSET  38
+
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  put16(p, (uint16_t)value);
+  put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+size_t encodeTelemetryPacket(const TelemetryPacket& packet, uint8_t* out) {
+  put32(out, TELEMETRY_PACKET_MAGIC);
+  put32(out + 4, packet.station);
+  put32(out + 8, packet.sequence);
+  put32(out + 12, (uint32_t)packet.time_us);
+  put32(out + 16, (uint32_t)((uint64_t)packet.time_us >> 32));
+  put16(out + 20, packet.rate_dhz);
+  put16(out + 22, packet.scale_um);
+  out[24] = packet.mercalli_now;
+  out[25] = packet.mercalli_peak;
+  out[26] = packet.flags;
+  out[27] = 0;
+  put16(out + 28, packet.sta_lta_x100);
+  put16(out + 30, (uint16_t)packet.peak_x);
+  put16(out + 32, (uint16_t)packet.peak_y);
+  put16(out + 34, (uint16_t)packet.peak_z);
+  put16(out + 36, packet.peak_magnitude);
+
+  uint8_t* p = out + TELEMETRY_SAMPLE_OFFSET;
+  for (size_t i = 0; i < TELEMETRY_SAMPLES; i++, p += 6) {
+    put16(p, (uint16_t)packet.samples[i].x);
+    put16(p + 2, (uint16_t)packet.samples[i].y);
+    put16(p + 4, (uint16_t)packet.samples[i].z);
+  }
+  put16(p, 0);
+  put32(out + TELEMETRY_PACKET_PAYLOAD, crc32(out, TELEMETRY_PACKET_PAYLOAD));
+  return TELEMETRY_PACKET_SIZE;
+}
+
+bool decodeTelemetryPacket(const uint8_t* data, size_t length, TelemetryPacket& packet) {
+  if (length != TELEMETRY_PACKET_SIZE || get32(data) != TELEMETRY_PACKET_MAGIC) return false;
+  if (get32(data + TELEMETRY_PACKET_PAYLOAD) != crc32(data, TELEMETRY_PACKET_PAYLOAD)) return false;
+  packet.station = get32(data + 4);
+  packet.sequence = get32(data + 8);
+  packet.time_us = (int64_t)(get32(data + 12) | ((uint64_t)get32(data + 16) << 32));
+  packet.rate_dhz = get16(data + 20);
+  packet.scale_um = get16(data + 22);
+  packet.mercalli_now = data[24];
+  packet.mercalli_peak = data[25];
+  packet.flags = data[26];
+  packet.sta_lta_x100 = get16(data + 28);
+  packet.peak_x = (int16_t)get16(data + 30);
+  packet.peak_y = (int16_t)get16(data + 32);
+  packet.peak_z = (int16_t)get16(data + 34);
+  packet.peak_magnitude = get16(data + 36);
+
+  const uint8_t* p = data + TELEMETRY_SAMPLE_OFFSET;
+  for (size_t i = 0; i < TELEMETRY_SAMPLES; i++, p += 6) {
+    packet.samples[i].x = (int16_t)get16(p);
+    packet.samples[i].y = (int16_t)get16(p + 2);
+    packet.samples[i].z = (int16_t)get16(p + 4);
+  }
+  return true;
+}
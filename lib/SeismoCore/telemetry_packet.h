@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "adxl345_fifo.h"
+
+// Datagram pushed to a telemetry address (unicast or multicast) every
+// TELEMETRY_SAMPLES live samples, 10 a second at 100 Hz. Always
+// TELEMETRY_PACKET_SIZE bytes, little-endian:
+//
+//    0  u32  magic TELEMETRY_PACKET_MAGIC
+//    4  u32  station id (the low four bytes of the MAC)
+//    8  u32  sequence number, +1 per packet; gaps are lost packets
+//   12  i64  time of the first sample: UTC µs when TELEMETRY_TIME_SYNCED is
+//            set, otherwise µs since the station booted
+//   20  u16  sample rate, 0.1 Hz units
+//   22  u16  scale, µm/s² per count
+//   24  u8   current Mercalli intensity
+//   25  u8   peak Mercalli intensity
+//   26  u8   flags (TELEMETRY_*)
+//   27  u8   reserved, 0
+//   28  u16  highest STA/LTA ratio x100, saturated
+//   30  6    peak deviation x, y, z (int16 counts)
+//   36  u16  peak deviation magnitude (counts)
+//   38  6N   samples: int16 x, y, z band-passed deviations in counts
+//   98  u16  reserved, 0
+//  100  u32  CRC-32 of bytes 0-99
+//
+// The status fields are those of a BLE frame (ble_frame.h), so a listener
+// needs no connection and the station no per-listener state.
+
+#define TELEMETRY_SAMPLES       10
+#define TELEMETRY_PACKET_SIZE   104
+#define TELEMETRY_PACKET_MAGIC  0x314C5453 // "STL1"
+#define TELEMETRY_PORT          5684       // Default destination port
+
+// Flags
+#define TELEMETRY_TIME_SYNCED   0x01 // time_us is UTC
+#define TELEMETRY_TRIGGERED     0x02 // Some axis is in the triggered state
+#define TELEMETRY_GAP           0x04 // Samples were dropped before this packet
+
+struct TelemetryPacket {
+  uint32_t station;
+  uint32_t sequence;
+  int64_t time_us;
+  uint16_t rate_dhz;
+  uint16_t scale_um;
+  uint8_t mercalli_now;
+  uint8_t mercalli_peak;
+  uint8_t flags;
+  uint16_t sta_lta_x100;
+  int16_t peak_x, peak_y, peak_z;
+  uint16_t peak_magnitude;
+  RawSample samples[TELEMETRY_SAMPLES];
+};
+
+size_t encodeTelemetryPacket(const TelemetryPacket& packet, uint8_t* out);
+// False if the length, the magic or the CRC is wrong
+bool decodeTelemetryPacket(const uint8_t* data, size_t length, TelemetryPacket& packet);
@@ -0,0 +1,53 @@
+#include "trigger_packet.h"
+#include "crc32.h"
+
+#define TRIGGER_PACKET_PAYLOAD (TRIGGER_PACKET_SIZE - 4)
+
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  put16(p, (uint16_t)value);
+  put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+size_t encodeTriggerPacket(const TriggerPacket& packet, uint8_t* out) {
+  put32(out, TRIGGER_PACKET_MAGIC);
+  put32(out + 4, packet.station);
+  put32(out + 8, packet.sequence);
+  out[12] = packet.type;
+  out[13] = packet.flags;
+  out[14] = packet.mercalli;
+  out[15] = 0;
+  put32(out + 16, (uint32_t)packet.time_us);
+  put32(out + 20, (uint32_t)((uint64_t)packet.time_us >> 32));
+  put16(out + 24, packet.sta_lta_x100);
+  put16(out + 26, packet.magnitude_mm);
+  put32(out + TRIGGER_PACKET_PAYLOAD, crc32(out, TRIGGER_PACKET_PAYLOAD));
+  return TRIGGER_PACKET_SIZE;
+}
+
+bool decodeTriggerPacket(const uint8_t* data, size_t length, TriggerPacket& packet) {
+  if (length < TRIGGER_PACKET_SIZE || get32(data) != TRIGGER_PACKET_MAGIC) return false;
+  if (get32(data + TRIGGER_PACKET_PAYLOAD) != crc32(data, TRIGGER_PACKET_PAYLOAD)) return false;
+  if (data[12] > TRIGGER_PACKET_OFF) return false;
+  packet.station = get32(data + 4);
+  packet.sequence = get32(data + 8);
+  packet.type = data[12];
+  packet.flags = data[13];
+  packet.mercalli = data[14];
+  packet.time_us = (int64_t)(get32(data + 16) | ((uint64_t)get32(data + 20) << 32));
+  packet.sta_lta_x100 = get16(data + 24);
+  packet.magnitude_mm = get16(data + 26);
+  return true;
+}
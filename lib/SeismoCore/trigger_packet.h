@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Datagram a station sends to a collector when its STA/LTA trigger turns on
+// or off, plus a heartbeat every few seconds so the collector knows which
+// stations are listening. Little-endian, TRIGGER_PACKET_SIZE bytes:
+//
+//    0  u32  magic TRIGGER_PACKET_MAGIC
+//    4  u32  station id (the low four bytes of the MAC)
+//    8  u32  sequence number, +1 per packet; gaps are lost packets
+//   12  u8   type (TRIGGER_PACKET_*)
+//   13  u8   flags (TRIGGER_FLAG_*)
+//   14  u8   Mercalli intensity at the time
+//   15  u8   reserved, 0
+//   16  i64  time: UTC microseconds when TRIGGER_FLAG_TIME_SYNCED is set,
+//            otherwise microseconds since the station booted. The onset
+//            for TRIGGER_PACKET_ON, the release for _OFF, the send time
+//            for heartbeats.
+//   24  u16  highest STA/LTA ratio x100, saturated
+//   26  u16  deviation magnitude, mm/s², saturated
+//   28  u32  CRC-32 of bytes 0-27
+//
+// The same records can be sent back to back over a TCP stream.
+
+#define TRIGGER_PACKET_SIZE   32
+#define TRIGGER_PACKET_MAGIC  0x31505453 // "STP1"
+#define TRIGGER_PORT          5683       // Default collector port, UDP and TCP
+
+enum TriggerPacketType {
+  TRIGGER_PACKET_HEARTBEAT = 0,
+  TRIGGER_PACKET_ON = 1,
+  TRIGGER_PACKET_OFF = 2
+};
+
+#define TRIGGER_FLAG_TIME_SYNCED 0x01 // time is UTC
+
+struct TriggerPacket {
+  uint32_t station;
+  uint32_t sequence;
+  uint8_t type;
+  uint8_t flags;
+  uint8_t mercalli;
+  int64_t time_us;
+  uint16_t sta_lta_x100;
+  uint16_t magnitude_mm;
+};
+
+size_t encodeTriggerPacket(const TriggerPacket& packet, uint8_t* out);
+// False if the magic, the CRC or the type is wrong
+bool decodeTriggerPacket(const uint8_t* data, size_t length, TriggerPacket& packet);
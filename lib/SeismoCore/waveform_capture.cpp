@@ -0,0 +1,173 @@
+#include "waveform_capture.h"
+#include <string.h>
+
+WaveformCapture::WaveformCapture()
+  : preBuffer(NULL), preCapacity(0), preHead(0), preFilled(0), storage(NULL),
+    slotCapacity(0), slots(0), rate(0), preSamples(0), postSamples(0), nextId(1), drops(0) {
+  for (int i = 0; i < WAVEFORM_MAX_SLOTS; i++) {
+    slot[i].state.store(WAVEFORM_FREE, std::memory_order_relaxed);
+    slot[i].id.store(0, std::memory_order_relaxed);
+    slot[i].remaining = 0;
+    memset(&slot[i].info, 0, sizeof(slot[i].info));
+  }
+}
+
+bool WaveformCapture::begin(RawSample* pre, uint32_t preCap,
+                            RawSample* slotStorage, uint32_t slotCap, int count) {
+  if (!pre || !slotStorage || preCap == 0 || slotCap < preCap) return false;
+  if (count < 1 || count > WAVEFORM_MAX_SLOTS) return false;
+
+  preBuffer = pre;
+  preCapacity = preCap;
+  storage = slotStorage;
+  slotCapacity = slotCap;
+  slots = count;
+  for (int i = 0; i < slots; i++) {
+    slot[i].state.store(WAVEFORM_FREE, std::memory_order_relaxed);
+    slot[i].id.store(0, std::memory_order_relaxed);
+  }
+  configure(rate, preCapacity, slotCapacity - preCapacity);
+  return true;
+}
+
+void WaveformCapture::configure(float sampleRate, uint32_t pre, uint32_t post) {
+  // Anything still recording belongs to the old configuration
+  for (int i = 0; i < slots; i++) {
+    if (slot[i].state.load(std::memory_order_relaxed) == WAVEFORM_RECORDING) finish(slot[i]);
+  }
+
+  rate = sampleRate;
+  preSamples = pre < preCapacity ? pre : preCapacity;
+  if (preSamples < 1) preSamples = 1;
+  preHead = 0;
+  preFilled = 0;
+  setPostTrigger(post);
+}
+
+void WaveformCapture::setPostTrigger(uint32_t post) {
+  uint32_t limit = slotCapacity - preSamples;
+  postSamples.store(post < limit ? post : limit, std::memory_order_relaxed);
+}
+
+void WaveformCapture::push(const RawSample& sample) {
+  if (!storage) return;
+
+  preBuffer[preHead] = sample;
+  preHead = (preHead + 1) % preCapacity;
+  if (preFilled < preSamples) preFilled++;
+
+  for (int i = 0; i < slots; i++) {
+    Slot& s = slot[i];
+    if (s.state.load(std::memory_order_relaxed) != WAVEFORM_RECORDING) continue;
+    storage[i * slotCapacity + s.info.sample_count++] = sample;
+    if (--s.remaining == 0) finish(s);
+  }
+}
+
+uint32_t WaveformCapture::trigger(uint32_t now_ms, uint32_t timestamp, int mercalli,
+                                  const WaveformCalibration& calibration) {
+  if (!storage) return 0;
+
+  // Take a free slot, otherwise recycle the oldest completed capture that
+  // nobody is reading. The compare-exchange loses to a consumer pinning the
+  // same slot, in which case the next oldest is tried.
+  int chosen = -1;
+  for (int i = 0; i < slots && chosen < 0; i++) {
+    if (slot[i].state.load(std::memory_order_relaxed) == WAVEFORM_FREE) {
+      slot[i].state.store(WAVEFORM_RECORDING, std::memory_order_relaxed);
+      chosen = i;
+    }
+  }
+  uint32_t skipMask = 0;
+  while (chosen < 0) {
+    int oldest = -1;
+    for (int i = 0; i < slots; i++) {
+      if (skipMask & (1u << i)) continue;
+      if (slot[i].state.load(std::memory_order_relaxed) != WAVEFORM_COMPLETE) continue;
+      if (oldest < 0 || slot[i].info.id < slot[oldest].info.id) oldest = i;
+    }
+    if (oldest < 0) {
+      drops.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    uint8_t expected = WAVEFORM_COMPLETE;
+    if (slot[oldest].state.compare_exchange_strong(expected, WAVEFORM_RECORDING,
+                                                   std::memory_order_acquire)) {
+      chosen = oldest;
+    } else {
+      skipMask |= 1u << oldest;
+    }
+  }
+
+  Slot& s = slot[chosen];
+  s.id.store(0, std::memory_order_relaxed);
+
+  // Copy the pre-trigger window, oldest sample first
+  RawSample* out = storage + chosen * slotCapacity;
+  uint32_t start = (preHead + preCapacity - preFilled) % preCapacity;
+  uint32_t first = preCapacity - start;
+  if (first > preFilled) first = preFilled;
+  memcpy(out, preBuffer + start, first * sizeof(RawSample));
+  memcpy(out + first, preBuffer, (preFilled - first) * sizeof(RawSample));
+
+  s.info.id = nextId++;
+  s.info.trigger_ms = now_ms;
+  s.info.timestamp = timestamp;
+  s.info.sample_rate = rate;
+  s.info.pre_samples = preFilled;
+  s.info.sample_count = preFilled;
+  s.info.mercalli = mercalli;
+  s.info.calibration = calibration;
+  s.remaining = postSamples.load(std::memory_order_relaxed);
+  if (s.remaining == 0) finish(s);
+  return s.info.id;
+}
+
+void WaveformCapture::finish(Slot& s) {
+  s.remaining = 0;
+  s.id.store(s.info.id, std::memory_order_relaxed);
+  s.state.store(WAVEFORM_COMPLETE, std::memory_order_release);
+}
+
+bool WaveformCapture::available(uint32_t id) const {
+  if (id == 0) return false;
+  for (int i = 0; i < slots; i++) {
+    if (slot[i].id.load(std::memory_order_relaxed) != id) continue;
+    uint8_t state = slot[i].state.load(std::memory_order_relaxed);
+    return state == WAVEFORM_COMPLETE || state == WAVEFORM_READING;
+  }
+  return false;
+}
+
+bool WaveformCapture::acquire(uint32_t id, WaveformInfo& info, const RawSample*& samples) {
+  if (id == 0) return false;
+  for (int i = 0; i < slots; i++) {
+    Slot& s = slot[i];
+    if (s.id.load(std::memory_order_relaxed) != id) continue;
+
+    uint8_t expected = WAVEFORM_COMPLETE;
+    if (!s.state.compare_exchange_strong(expected, WAVEFORM_READING, std::memory_order_acquire)) {
+      return false;
+    }
+    // The slot may have been recycled between the id check and the pin
+    if (s.id.load(std::memory_order_relaxed) != id) {
+      s.state.store(WAVEFORM_COMPLETE, std::memory_order_release);
+      return false;
+    }
+    info = s.info;
+    samples = storage + i * slotCapacity;
+    return true;
+  }
+  return false;
+}
+
+void WaveformCapture::release(uint32_t id) {
+  for (int i = 0; i < slots; i++) {
+    Slot& s = slot[i];
+    if (s.id.load(std::memory_order_relaxed) == id &&
+        s.state.load(std::memory_order_relaxed) == WAVEFORM_READING) {
+      s.state.store(WAVEFORM_COMPLETE, std::memory_order_release);
+      return;
+    }
+  }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "adxl345_fifo.h"
+
+// Pre-trigger / post-trigger waveform capture into a fixed pool of slots.
+//
+// The producer (the acquisition task) feeds every sample to push(); the newest
+// pre-trigger samples are kept in a circular buffer. trigger() copies that
+// buffer into a slot, which then keeps filling with post-trigger samples until
+// it is complete. All sample storage is supplied once by the caller, so no
+// memory is allocated per event.
+//
+// A consumer reads a completed capture by pinning it with acquire() and
+// unpinning it with release(). A pinned slot is never recycled; if every slot
+// is pinned or still recording when a trigger arrives, that capture is dropped
+// and counted. Only one consumer may read a given slot at a time.
+
+#define WAVEFORM_MAX_SLOTS 8
+
+enum WaveformSlotState {
+  WAVEFORM_FREE,
+  WAVEFORM_RECORDING, // Filling with post-trigger samples (producer only)
+  WAVEFORM_COMPLETE,
+  WAVEFORM_READING    // Pinned by a consumer
+};
+
+// How the stored counts convert to m/s²: (count + offset) * ms2_per_count
+struct WaveformCalibration {
+  int16_t offset_x, offset_y, offset_z;
+  float ms2_per_count;
+};
+
+struct WaveformInfo {
+  uint32_t id;           // Capture number, starting at 1 (0 = none)
+  uint32_t trigger_ms;   // Producer clock at the trigger
+  uint32_t timestamp;    // Wall-clock seconds at the trigger, 0 if unknown
+  float sample_rate;     // Rate of the stored samples (Hz)
+  uint32_t pre_samples;  // Samples before the trigger, including the trigger sample
+  uint32_t sample_count; // Samples stored in total
+  int mercalli;          // Intensity that caused the capture
+  WaveformCalibration calibration; // In use at the trigger
+};
+
+class WaveformCapture {
+  public:
+    WaveformCapture();
+
+    // Attach storage: a pre-trigger ring of preCapacity samples and slotCount
+    // slots of slotCapacity samples each (slotStorage holds slotCount *
+    // slotCapacity samples). Returns false if the layout is unusable.
+    bool begin(RawSample* preBuffer, uint32_t preCapacity,
+               RawSample* slotStorage, uint32_t slotCapacity, int slotCount);
+
+    // Producer side. configure() sets the stored sample rate and the window
+    // lengths, clamped to the storage; captures in progress are finished early.
+    void configure(float sampleRate, uint32_t preSamples, uint32_t postSamples);
+    void push(const RawSample& sample);
+    // Freeze the pre-trigger buffer into a slot; returns the capture id or 0
+    uint32_t trigger(uint32_t now_ms, uint32_t timestamp, int mercalli,
+                     const WaveformCalibration& calibration);
+
+    // May be called from any task; applies from the next trigger on
+    void setPostTrigger(uint32_t postSamples);
+    uint32_t postTrigger() const { return postSamples.load(std::memory_order_relaxed); }
+    uint32_t preTrigger() const { return preSamples; }
+    uint32_t maxPostTrigger() const { return slotCapacity - preSamples; }
+
+    // Consumer side
+    bool available(uint32_t id) const;
+    bool acquire(uint32_t id, WaveformInfo& info, const RawSample*& samples);
+    void release(uint32_t id);
+
+    int slotCount() const { return slots; }
+    uint32_t captureCount() const { return nextId - 1; }
+    uint32_t dropCount() const { return drops.load(std::memory_order_relaxed); }
+
+  private:
+    struct Slot {
+      std::atomic<uint8_t> state;
+      std::atomic<uint32_t> id;
+      WaveformInfo info;
+      uint32_t remaining; // Post-trigger samples still to record
+    };
+
+    void finish(Slot& slot);
+
+    RawSample* preBuffer;
+    uint32_t preCapacity;
+    uint32_t preHead;   // Next write position
+    uint32_t preFilled; // Valid samples in the ring (saturates at preSamples)
+    RawSample* storage;
+    uint32_t slotCapacity;
+    int slots;
+
+    float rate;
+    uint32_t preSamples;
+    std::atomic<uint32_t> postSamples;
+    uint32_t nextId;
+    std::atomic<uint32_t> drops;
+    Slot slot[WAVEFORM_MAX_SLOTS];
+};
@@ -1,169 +1,183 @@
 #pragma once
+// Generated by tools/embed_web_assets.py from src/ble_viewer.html - do not edit.
+// 8532 bytes, 2783 gzipped.
 #include <Arduino.h>
 
-const char HTML_PAGE[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<title>BLE Seismometer</title>
-<meta name="viewport" content="width=device-width, initial-scale=1">
-<style>
-  body { font-family: Arial, sans-serif; background-color: #121212; color: #e0e0e0; text-align: center; margin: 0; padding: 10px; }
-  h1 { color: #e0e0e0; }
-  .container { max-width: 800px; margin: auto; padding: 20px; background-color: #1e1e1e; border-radius: 10px; box-shadow: 0 0 10px rgba(0,0,0,0.5); }
-  .grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 20px; margin-top: 20px; }
-  .card { background-color: #2c2c2c; padding: 20px; border-radius: 8px; }
-  .card h2 { margin-top: 0; color: #e0e0e0; font-size: 1.2em; }
-  .mercalli-peak { font-size: 4em; color: #cf6679; font-weight: bold; }
-  .mercalli-now { font-size: 2em; color: #e0e0e0; }
-  .peak-values p, .current-values p { margin: 5px 0; font-size: 1.1em; }
-  .peak-values span, .current-values span { font-weight: bold; color: #f2f2f2; }
-  button { background-color: #bb86fc; color: #121212; border: none; padding: 15px 30px; font-size: 1em; border-radius: 5px; cursor: pointer; margin-top: 20px; width: 90%; }
-  button:hover { background-color: #3700b3; color: #ffffff; }
-  button:disabled { background-color: #444; color: #888; cursor: not-allowed; }
-  .footer { margin-top: 20px; font-size: 0.8em; color: #888; }
-  #status { margin-top: 15px; font-weight: bold; color: #f2f2f2; }
-</style>
-</head>
-<body>
-  <div class="container">
-    <h1>Mercalli Seismometer</h1>
-    <p id="status">Disconnected</p>
-    <button id="connectButton">Connect to Seismometer</button>
-    <button id="resetButton" disabled>Reset Peak Values</button>
-    
-    <div class="grid">
-      <div class="card mercalli">
-        <h2>PEAK MERCALLI</h2>
-        <p class="mercalli-peak" id="mercalli-peak">0</p>
-      </div>
-      <div class="card mercalli">
-        <h2>CURRENT MERCALLI</h2>
-        <p class="mercalli-now" id="mercalli-now">0</p>
-      </div>
-    </div>
-    <div class="grid">
-      <div class="card peak-values">
-        <h2>Peak Deviations (m/s<sup>2</sup>)</h2>
-        <p>X: <span id="x-peak">0.000</span></p>
-        <p>Y: <span id="y-peak">0.000</span></p>
-        <p>Z: <span id="z-peak">0.000</span></p>
-        <p>Mag: <span id="dev-mag-peak">0.000</span></p>
-      </div>
-      <div class="card current-values">
-        <h2>Current Deviations (m/s<sup>2</sup>)</h2>
-        <p>X: <span id="x-now">0.000</span></p>
-        <p>Y: <span id="y-now">0.000</span></p>
-        <p>Z: <span id="z-now">0.000</span></p>
-        <p>Mag: <span id="dev-mag-now">0.000</span></p>
-      </div>
-    </div>
-    <div class="footer">
-      <p>(c) 2025 John Schop</p>
-    </div>
-  </div>
-
-<script>
-  const SERVICE_UUID = "4fafc201-1fb5-459e-8fcc-c5c9c331914b";
-  const DATA_CHARACTERISTIC_UUID = "beb5483e-36e1-4688-b7f5-ea07361b26a8";
-  const RESET_CHARACTERISTIC_UUID = "ec0e0001-36e1-4688-b7f5-ea07361b26a8";
-
-  let bleDevice;
-  let resetCharacteristic;
-  const connectButton = document.getElementById('connectButton');
-  const resetButton = document.getElementById('resetButton');
-  const statusDisplay = document.getElementById('status');
-
-  connectButton.addEventListener('click', connectToDevice);
-  resetButton.addEventListener('click', resetPeaks);
-
-  function connectToDevice() {
-    if (!navigator.bluetooth) {
-      alert('Web Bluetooth API is not available in this browser. Please use Chrome on Android, Mac, or Windows.');
-      return;
-    }
-    
-    statusDisplay.innerText = 'Scanning...';
-    navigator.bluetooth.requestDevice({
-      filters: [{ services: [SERVICE_UUID] }],
-      optionalServices: [SERVICE_UUID]
-    })
-    .then(device => {
-      statusDisplay.innerText = 'Connecting...';
-      bleDevice = device;
-      bleDevice.addEventListener('gattserverdisconnected', onDisconnected);
-      return device.gatt.connect();
-    })
-    .then(server => {
-      statusDisplay.innerText = 'Getting Service...';
-      return server.getPrimaryService(SERVICE_UUID);
-    })
-    .then(service => {
-      statusDisplay.innerText = 'Getting Characteristics...';
-      return Promise.all([
-        service.getCharacteristic(DATA_CHARACTERISTIC_UUID),
-        service.getCharacteristic(RESET_CHARACTERISTIC_UUID)
-      ]);
-    })
-    .then(characteristics => {
-      const dataCharacteristic = characteristics[0];
-      resetCharacteristic = characteristics[1];
-      
-      statusDisplay.innerText = 'Subscribing to Data...';
-      dataCharacteristic.startNotifications();
-      dataCharacteristic.addEventListener('characteristicvaluechanged', handleData);
-      
-      statusDisplay.innerText = 'Connected';
-      connectButton.disabled = true;
-      resetButton.disabled = false;
-    })
-    .catch(error => {
-      statusDisplay.innerText = `Error: ${error.name}`;
-      console.error(error);
-    });
-  }
-
-  function onDisconnected() {
-    statusDisplay.innerText = 'Disconnected';
-    connectButton.disabled = false;
-    resetButton.disabled = true;
-    bleDevice = null;
-    resetCharacteristic = null;
-  }
-
-  function handleData(event) {
-    const value = event.target.value;
-    const decoder = new TextDecoder('utf-8');
-    const jsonString = decoder.decode(value);
-    const data = JSON.parse(jsonString);
-
-    document.getElementById('mercalli-peak').innerText = data.mercalli_peak;
-    document.getElementById('mercalli-now').innerText = data.mercalli_now;
-    document.getElementById('x-peak').innerText = data.x_peak.toFixed(3);
-    document.getElementById('y-peak').innerText = data.y_peak.toFixed(3);
-    document.getElementById('z-peak').innerText = data.z_peak.toFixed(3);
-    document.getElementById('dev-mag-peak').innerText = data.dev_mag_peak.toFixed(3);
-    document.getElementById('x-now').innerText = data.x_now.toFixed(3);
-    document.getElementById('y-now').innerText = data.y_now.toFixed(3);
-    document.getElementById('z-now').innerText = data.z_now.toFixed(3);
-    document.getElementById('dev-mag-now').innerText = data.dev_mag_now.toFixed(3);
-  }
-
-  function resetPeaks() {
-    if (!resetCharacteristic) {
-      return;
-    }
-    // Write a single byte to trigger the reset
-    const buffer = new Uint8Array([1]);
-    resetCharacteristic.writeValue(buffer)
-      .then(() => {
-        console.log('Reset command sent.');
-      })
-      .catch(error => {
-        console.error('Error sending reset command:', error);
-      });
-  }
-</script>
-</body>
-</html>
-)rawliteral";
+const char BLE_HTML_PAGE_ETAG[] = "\"93c533611f53a7d9\"";
+const size_t BLE_HTML_PAGE_GZ_LEN = 2783;
+const uint8_t BLE_HTML_PAGE_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x5a, 0xfd, 0x76, 0xda, 0xb8,
+  0x12, 0xff, 0xbf, 0x4f, 0xa1, 0xb2, 0x7b, 0x8b, 0xd9, 0x82, 0xf9, 0xc8, 0x47, 0x29, 0x21, 0xec,
+  0xa1, 0x09, 0x6d, 0x73, 0x6f, 0xd2, 0xe6, 0x40, 0xba, 0xbb, 0x6d, 0x4f, 0x4f, 0x2b, 0x6c, 0x19,
+  0x74, 0x6a, 0x6c, 0xae, 0x2c, 0x92, 0x90, 0x6e, 0x5e, 0xea, 0x3e, 0xc2, 0x7d, 0xb2, 0x3b, 0x23,
+  0xf9, 0x43, 0xb6, 0x81, 0x64, 0xf7, 0xc6, 0x67, 0x0b, 0x96, 0x66, 0x7e, 0x9a, 0x19, 0xcd, 0x8c,
+  0x66, 0xc4, 0x3e, 0xe9, 0x3f, 0x3d, 0x7d, 0x7f, 0x72, 0xf5, 0xf1, 0x72, 0x44, 0xe6, 0x72, 0xe1,
+  0x0f, 0x9e, 0xf4, 0x93, 0x0f, 0x46, 0x5d, 0xf8, 0x90, 0x5c, 0xfa, 0x6c, 0xf0, 0xea, 0x7c, 0x44,
+  0x26, 0x8c, 0x47, 0x8b, 0x70, 0xc1, 0x24, 0x13, 0xfd, 0xa6, 0x1e, 0x7e, 0xd2, 0x87, 0x57, 0x4a,
+  0x02, 0xba, 0x60, 0xc7, 0x95, 0x6b, 0xce, 0x6e, 0x96, 0xa1, 0x90, 0x15, 0xe2, 0x84, 0x81, 0x64,
+  0x81, 0x3c, 0xae, 0xdc, 0x70, 0x57, 0xce, 0x8f, 0x5d, 0x76, 0xcd, 0x1d, 0xd6, 0x50, 0x2f, 0x75,
+  0xc2, 0x03, 0x2e, 0x39, 0xf5, 0x1b, 0x91, 0x43, 0x7d, 0x76, 0xdc, 0xae, 0x00, 0x48, 0x24, 0xd7,
+  0x08, 0x46, 0xc8, 0x34, 0x74, 0xd7, 0xe4, 0x07, 0xf1, 0x80, 0xbf, 0xe1, 0xd1, 0x05, 0xf7, 0xd7,
+  0x3d, 0x32, 0x14, 0x40, 0x5d, 0x27, 0x11, 0x0d, 0xa2, 0x46, 0xc4, 0x04, 0xf7, 0x8e, 0xc8, 0x94,
+  0x3a, 0xdf, 0x67, 0x22, 0x5c, 0x05, 0x6e, 0xc3, 0x09, 0xfd, 0x50, 0xf4, 0xc8, 0x4f, 0xed, 0x0e,
+  0x3e, 0x47, 0x24, 0x79, 0x67, 0x2d, 0x7c, 0x8e, 0x88, 0x64, 0xb7, 0xb2, 0x41, 0x7d, 0x3e, 0x0b,
+  0x7a, 0xc4, 0x01, 0x99, 0x98, 0x38, 0x22, 0x0b, 0x2a, 0x66, 0x1c, 0xde, 0x61, 0x7a, 0x49, 0x5d,
+  0x97, 0x07, 0xb3, 0x1e, 0x69, 0xb7, 0x96, 0xb7, 0x47, 0xe4, 0x1e, 0x64, 0x98, 0xb7, 0x41, 0x82,
+  0x22, 0x0c, 0x4e, 0xd8, 0xa8, 0x16, 0xe5, 0x01, 0x13, 0x40, 0xb0, 0xa0, 0xb7, 0x5a, 0xa1, 0x1e,
+  0xe9, 0xb6, 0x14, 0x6f, 0x82, 0x4a, 0x57, 0x32, 0x34, 0x80, 0x3b, 0x6a, 0x72, 0x93, 0xc4, 0x0c,
+  0x1f, 0x98, 0x0a, 0x85, 0xcb, 0x44, 0x43, 0x50, 0x97, 0xaf, 0xa2, 0x44, 0x90, 0x69, 0x78, 0xdb,
+  0x88, 0xe6, 0xd4, 0x0d, 0x6f, 0x40, 0x4c, 0x78, 0x70, 0x94, 0x88, 0xd9, 0x94, 0x5a, 0xad, 0xba,
+  0x7a, 0xec, 0x83, 0x5a, 0x2c, 0xd5, 0x4c, 0x70, 0x17, 0x04, 0x72, 0x79, 0xb4, 0xf4, 0x29, 0xd8,
+  0x0b, 0xdf, 0x8f, 0xd4, 0xbf, 0x0d, 0xc9, 0x16, 0x30, 0x26, 0x19, 0xae, 0xb9, 0x5a, 0x04, 0x80,
+  0x2e, 0xd8, 0x92, 0x51, 0x69, 0xa1, 0x8c, 0x0d, 0x8f, 0xcb, 0x3a, 0x59, 0xf0, 0x00, 0x54, 0xb1,
+  0x3a, 0xa8, 0x43, 0x9d, 0xb4, 0x3d, 0x51, 0x03, 0xdc, 0x19, 0x5d, 0x26, 0x82, 0x6b, 0xad, 0x1a,
+  0x32, 0x4c, 0x47, 0xb4, 0x29, 0xa8, 0xc0, 0x45, 0x37, 0xa8, 0xd5, 0x71, 0xf0, 0x29, 0x1b, 0x20,
+  0xaf, 0x65, 0x37, 0x8f, 0x34, 0xef, 0x28, 0x93, 0x66, 0x4b, 0xb5, 0xca, 0x3b, 0xa9, 0x9c, 0x22,
+  0xe2, 0x77, 0x0c, 0x6c, 0x64, 0x77, 0xd8, 0x22, 0xe6, 0x5f, 0x30, 0x01, 0x8e, 0xe4, 0xf3, 0x06,
+  0x28, 0xf6, 0x3d, 0xf1, 0x1d, 0x4d, 0xb6, 0x8f, 0x44, 0x09, 0x8c, 0xe3, 0x1d, 0x1e, 0xbe, 0x78,
+  0x19, 0xc3, 0xdc, 0x30, 0x3e, 0x9b, 0xcb, 0x1e, 0x48, 0xe5, 0xbb, 0x45, 0x9c, 0x20, 0xbc, 0xc9,
+  0xc3, 0x74, 0x4c, 0x98, 0x9c, 0x43, 0xe0, 0x92, 0x8d, 0x6b, 0xea, 0xaf, 0x58, 0x44, 0x96, 0x75,
+  0xd0, 0x65, 0x25, 0x04, 0xf8, 0x58, 0x3a, 0x94, 0x2a, 0xd5, 0x23, 0x07, 0xb0, 0x7f, 0x45, 0x25,
+  0xda, 0xa9, 0x12, 0x26, 0x50, 0xb4, 0xa4, 0x41, 0x19, 0x0b, 0x47, 0x13, 0xb1, 0xf2, 0xd2, 0x27,
+  0x92, 0x79, 0x1d, 0x7c, 0x34, 0xe0, 0x74, 0x25, 0x65, 0x18, 0x6c, 0xde, 0xa0, 0xe9, 0xb4, 0x7b,
+  0xe8, 0x39, 0x19, 0x5f, 0x12, 0x39, 0x7a, 0x87, 0x7a, 0x24, 0x08, 0x03, 0x66, 0x06, 0x06, 0x4a,
+  0xbe, 0xa7, 0xf6, 0xd0, 0x14, 0x1e, 0x45, 0x2f, 0xec, 0xe9, 0x01, 0xd2, 0x80, 0xd8, 0x11, 0xc2,
+  0x2e, 0x43, 0x6e, 0x06, 0x9b, 0xe9, 0x40, 0x71, 0xd8, 0xbc, 0x6c, 0xfd, 0xc3, 0x14, 0xb6, 0x37,
+  0x0f, 0xaf, 0x55, 0x64, 0x6d, 0x10, 0x79, 0xef, 0x45, 0xab, 0x35, 0xdd, 0x33, 0x54, 0x55, 0x7f,
+  0x39, 0x6e, 0x70, 0x7f, 0x3a, 0xf5, 0xd9, 0x16, 0xa7, 0xdc, 0xdf, 0xdf, 0xcf, 0xb8, 0xbb, 0xdd,
+  0x6e, 0x26, 0x67, 0x10, 0x62, 0x7a, 0xf0, 0xc3, 0x1b, 0x96, 0x38, 0x82, 0x17, 0x86, 0x32, 0x0e,
+  0xf1, 0xa2, 0xe4, 0x86, 0x01, 0x5a, 0x76, 0xd7, 0x74, 0x0b, 0x85, 0x89, 0xec, 0x3f, 0x45, 0x92,
+  0xca, 0x55, 0x54, 0x60, 0x6f, 0x1f, 0xa4, 0xec, 0x0f, 0x6f, 0x1e, 0x40, 0x08, 0x46, 0x17, 0x79,
+  0x27, 0xdc, 0xbc, 0x5e, 0xbf, 0x19, 0xa7, 0xce, 0x7e, 0x33, 0x4e, 0xd7, 0x98, 0x41, 0x31, 0x93,
+  0xf6, 0x5d, 0x7e, 0x4d, 0x1c, 0x9f, 0x46, 0xd1, 0x71, 0x25, 0xcd, 0x5b, 0x15, 0x9c, 0x81, 0xb9,
+  0x79, 0x7b, 0x70, 0x11, 0xbb, 0x7b, 0x3e, 0xab, 0xc3, 0x84, 0xa6, 0x58, 0x12, 0xee, 0x1e, 0x57,
+  0xb4, 0x2e, 0x95, 0xc1, 0x29, 0x8f, 0x00, 0x23, 0x60, 0x8e, 0x64, 0x6e, 0xbf, 0xb9, 0x2c, 0xd0,
+  0xa0, 0xb0, 0x95, 0x41, 0x36, 0x1e, 0x3b, 0x1f, 0x4e, 0xc6, 0x5c, 0xaf, 0xd4, 0x48, 0x65, 0x70,
+  0xa2, 0x5f, 0x89, 0x0c, 0xf3, 0xcb, 0x6a, 0x8e, 0x32, 0xbb, 0x60, 0x11, 0x4b, 0x98, 0x49, 0xb2,
+  0xc3, 0x83, 0x31, 0x8e, 0x92, 0x4b, 0x0c, 0xf7, 0xdf, 0x54, 0x70, 0xe4, 0x01, 0x34, 0x8a, 0xa1,
+  0x3e, 0xa6, 0xc2, 0x58, 0xf3, 0x82, 0x5d, 0x30, 0xf5, 0x24, 0x71, 0x9f, 0x52, 0xa0, 0x7d, 0x3a,
+  0x83, 0xcb, 0xd1, 0xf0, 0x5f, 0xe4, 0x62, 0x34, 0x3e, 0x19, 0x9e, 0x9f, 0x9f, 0x81, 0x61, 0x3a,
+  0xc6, 0xf4, 0x32, 0x01, 0xc8, 0xe5, 0x9e, 0x8a, 0x12, 0x39, 0x3f, 0x34, 0x68, 0xa5, 0x66, 0x01,
+  0xbe, 0x26, 0xac, 0xfd, 0x57, 0xe5, 0x38, 0xf9, 0x30, 0x1e, 0x8f, 0xde, 0x5d, 0x3d, 0x5e, 0x14,
+  0x48, 0x5f, 0x05, 0x49, 0x70, 0x64, 0x9b, 0x20, 0xe6, 0xd7, 0x47, 0x9b, 0xcc, 0xc8, 0x56, 0x45,
+  0xab, 0xe1, 0xa6, 0x9c, 0xc2, 0x71, 0x4f, 0x25, 0x0f, 0x83, 0x88, 0x58, 0x8b, 0x66, 0xd4, 0x8f,
+  0x56, 0xcb, 0x41, 0x07, 0x3c, 0x15, 0x3e, 0x6a, 0x45, 0xf1, 0x07, 0x7f, 0xf4, 0x48, 0x5f, 0xe5,
+  0x36, 0x14, 0xf9, 0x36, 0xb1, 0x9a, 0xdd, 0x6a, 0x81, 0xc0, 0x38, 0x3e, 0x30, 0xe4, 0x56, 0x0c,
+  0x1f, 0x4d, 0x86, 0xf5, 0x23, 0x18, 0x3e, 0x99, 0x0c, 0x77, 0x8f, 0x60, 0xb8, 0xa0, 0x33, 0x93,
+  0x05, 0xaa, 0x97, 0xc6, 0x82, 0xce, 0x76, 0x33, 0xee, 0xde, 0xdb, 0x7c, 0x2e, 0x2f, 0xee, 0xb0,
+  0x9e, 0xfc, 0xbf, 0xcc, 0xa6, 0xb7, 0xf8, 0xf1, 0x56, 0x7b, 0x90, 0xbe, 0x60, 0xb4, 0x07, 0xe9,
+  0xb7, 0xd8, 0x6c, 0x17, 0xdf, 0xc3, 0x5e, 0xa8, 0x33, 0x71, 0xe6, 0x87, 0xcb, 0x81, 0xe5, 0xd4,
+  0x20, 0x15, 0x77, 0x0e, 0xc8, 0x3f, 0xc3, 0x79, 0x40, 0x26, 0xce, 0x3c, 0x5c, 0x66, 0x79, 0x27,
+  0x01, 0x89, 0xbf, 0x40, 0x59, 0xe9, 0x08, 0xbe, 0x94, 0x38, 0x04, 0x79, 0x28, 0x92, 0x64, 0x32,
+  0x1a, 0xff, 0x76, 0x76, 0x32, 0xfa, 0xfa, 0xe1, 0xc3, 0xd9, 0x29, 0x39, 0x26, 0x95, 0x7d, 0x8f,
+  0x7a, 0x4e, 0xa7, 0xd5, 0x6e, 0xb4, 0xbd, 0xe9, 0x41, 0x63, 0xff, 0xe0, 0x25, 0x6b, 0x74, 0x3d,
+  0xc7, 0x69, 0x38, 0x07, 0xce, 0x4b, 0x67, 0x6f, 0xaf, 0xfd, 0xb2, 0xbd, 0x3f, 0xad, 0x1c, 0xa5,
+  0xec, 0xa7, 0xc3, 0xab, 0xe1, 0xd7, 0x93, 0xb7, 0xc3, 0xf1, 0xf0, 0xe4, 0x6a, 0x34, 0x3e, 0x9b,
+  0x5c, 0x9d, 0x9d, 0xa4, 0x50, 0x53, 0x36, 0x3d, 0xd8, 0xef, 0xee, 0xb1, 0xc6, 0xde, 0x21, 0x6b,
+  0x37, 0xf6, 0x0f, 0xbb, 0xdd, 0xc6, 0xf4, 0x85, 0x77, 0xd0, 0x60, 0xb4, 0xf5, 0x62, 0xef, 0xb0,
+  0x3d, 0xed, 0x1c, 0xd2, 0xae, 0x01, 0x35, 0x1e, 0x4d, 0x46, 0x57, 0xdb, 0xb0, 0x98, 0x03, 0x15,
+  0x46, 0x0b, 0xc4, 0xda, 0x8d, 0x05, 0x60, 0xcd, 0x26, 0x79, 0xc5, 0x03, 0x2a, 0xd6, 0xc4, 0xa5,
+  0x50, 0x86, 0x7b, 0x02, 0xea, 0xf0, 0xa8, 0x4e, 0x7c, 0x2e, 0xa1, 0x38, 0x6f, 0xb0, 0xc0, 0xe5,
+  0x34, 0x38, 0x22, 0x50, 0x15, 0x86, 0x2b, 0x09, 0x75, 0x37, 0x4c, 0x4c, 0x9b, 0x3a, 0xf1, 0x9e,
+  0x84, 0x82, 0x35, 0x21, 0x9b, 0x7e, 0x55, 0x3c, 0xf6, 0x3c, 0x95, 0xec, 0xf5, 0x78, 0x78, 0x31,
+  0xfa, 0xfa, 0xdb, 0x68, 0x3c, 0x39, 0x7b, 0xff, 0x0e, 0xa4, 0x69, 0x1f, 0x15, 0xa6, 0xde, 0x8e,
+  0x86, 0xa7, 0xa3, 0xf1, 0xd7, 0xc9, 0xd9, 0xa7, 0x11, 0x4c, 0x77, 0x0e, 0x8b, 0xf3, 0x93, 0xe1,
+  0xc5, 0xe5, 0xf9, 0x28, 0x99, 0x37, 0xa7, 0xcf, 0x87, 0x6f, 0xbe, 0x5e, 0x8d, 0xcf, 0xde, 0xbc,
+  0x19, 0x8d, 0x47, 0xa8, 0x68, 0xeb, 0xb6, 0xa5, 0xd0, 0x7d, 0xc8, 0xe6, 0xb0, 0xe1, 0x72, 0xc2,
+  0xfe, 0xbd, 0x62, 0x81, 0xc3, 0x60, 0x2a, 0x58, 0xf9, 0x7e, 0x3a, 0x15, 0x46, 0xf2, 0xb5, 0xd2,
+  0x0c, 0x79, 0x94, 0xde, 0x38, 0x0c, 0xc2, 0x9f, 0xaa, 0xbe, 0x22, 0xa1, 0x53, 0x87, 0xc5, 0xc9,
+  0x9c, 0x0a, 0x0a, 0xc7, 0x94, 0xe0, 0x91, 0xe4, 0x4e, 0xb6, 0x78, 0xee, 0x20, 0x02, 0x1c, 0x37,
+  0x74, 0x56, 0x0b, 0x88, 0x3a, 0x7b, 0xc6, 0xe4, 0xc8, 0x67, 0xf8, 0xf5, 0xd5, 0xfa, 0xcc, 0xb5,
+  0xaa, 0x39, 0xc2, 0x6a, 0x2d, 0x43, 0x30, 0xce, 0xa2, 0x5d, 0xfc, 0x06, 0x99, 0xc9, 0xad, 0x4f,
+  0xd2, 0x53, 0x5d, 0xa3, 0xef, 0xe2, 0xd7, 0x84, 0xc8, 0xaa, 0x79, 0x33, 0x61, 0x6c, 0xa8, 0xc8,
+  0x46, 0xd7, 0x40, 0x78, 0x0e, 0xba, 0x31, 0x38, 0xcd, 0x41, 0x58, 0x9f, 0x3b, 0xdf, 0xab, 0xf5,
+  0x84, 0xee, 0x2a, 0xd4, 0x16, 0x51, 0xeb, 0x1a, 0x82, 0xec, 0xe0, 0x54, 0x54, 0x98, 0xb5, 0x23,
+  0xbd, 0xa2, 0xb7, 0x0a, 0x1c, 0xcc, 0x41, 0x45, 0x48, 0xab, 0x46, 0x7e, 0xa8, 0x28, 0xe3, 0x1e,
+  0xb1, 0x9e, 0x06, 0xf4, 0x9a, 0xcf, 0xa8, 0x0c, 0x85, 0x3d, 0x85, 0x84, 0x26, 0x21, 0x4c, 0xe7,
+  0xc9, 0x3c, 0x21, 0xd0, 0xd5, 0x09, 0x69, 0x55, 0x7f, 0x67, 0x53, 0xf2, 0x2a, 0x99, 0x25, 0xc3,
+  0xcb, 0x33, 0xc2, 0x23, 0xac, 0xb6, 0x08, 0xbd, 0xa6, 0xdc, 0xc7, 0x93, 0x1c, 0x3d, 0x52, 0xce,
+  0x61, 0x74, 0x2a, 0xc2, 0x1b, 0xe8, 0xec, 0x6c, 0x72, 0xe9, 0x33, 0x1a, 0x31, 0xb2, 0x82, 0xff,
+  0x4e, 0xe6, 0x02, 0xaa, 0x03, 0x02, 0x92, 0x0c, 0x03, 0x57, 0x84, 0xdc, 0xad, 0x93, 0x0b, 0xea,
+  0xd4, 0x49, 0x28, 0xc8, 0xef, 0x3c, 0x80, 0xbe, 0x28, 0xb2, 0xb5, 0x7d, 0xf1, 0x4f, 0x30, 0xb9,
+  0x12, 0x81, 0x7e, 0xbb, 0xcf, 0x8a, 0x80, 0x9c, 0xd1, 0x6d, 0x0e, 0x0a, 0x89, 0x2b, 0x68, 0x07,
+  0xc1, 0xfc, 0xd5, 0x89, 0x43, 0x83, 0x00, 0xea, 0x5b, 0xdb, 0xb6, 0xab, 0x9a, 0x6f, 0x83, 0x4e,
+  0xb6, 0x40, 0x8f, 0x8c, 0x64, 0x6c, 0x82, 0x44, 0x41, 0x8f, 0xfb, 0xe0, 0x60, 0x50, 0xf0, 0x7e,
+  0xfe, 0x41, 0x40, 0x6c, 0x9c, 0xc3, 0x17, 0x33, 0xbb, 0x7c, 0x21, 0xf7, 0x5f, 0xea, 0x31, 0x79,
+  0xb8, 0x44, 0x83, 0x52, 0x7f, 0xb2, 0x85, 0x54, 0x4b, 0x5d, 0x53, 0x1f, 0xb6, 0x9c, 0xb3, 0xc0,
+  0xd2, 0xfd, 0x32, 0x39, 0x1e, 0xa4, 0x36, 0xdd, 0xa1, 0x49, 0x5c, 0x53, 0xe5, 0x74, 0x21, 0x59,
+  0x74, 0xa0, 0xaf, 0xa5, 0x61, 0x92, 0x9b, 0xd9, 0xe0, 0x15, 0xa0, 0xbf, 0x44, 0x8d, 0x98, 0x70,
+  0x8d, 0x8a, 0x0f, 0xdc, 0x24, 0x0c, 0xcc, 0x12, 0xb0, 0x60, 0xf7, 0x78, 0x01, 0x1b, 0xb9, 0xed,
+  0x98, 0xc8, 0x8a, 0x69, 0x72, 0x7a, 0x69, 0xe8, 0x47, 0xea, 0xf5, 0x86, 0x49, 0x54, 0x8a, 0xc4,
+  0x66, 0x33, 0x95, 0x8b, 0x97, 0xd5, 0x70, 0x18, 0x41, 0x97, 0x82, 0x43, 0xb5, 0xbd, 0x8e, 0x49,
+  0x2d, 0xd3, 0xbc, 0xdb, 0xe4, 0x78, 0xbc, 0x81, 0x13, 0x41, 0xf2, 0xa9, 0x25, 0xda, 0x20, 0xd0,
+  0x25, 0xb8, 0x2c, 0x8f, 0xc0, 0xb0, 0xbe, 0x6f, 0x7d, 0x4e, 0x4f, 0xc7, 0x78, 0x35, 0x94, 0x33,
+  0x0f, 0x61, 0x6d, 0x3b, 0x50, 0x6a, 0xf5, 0x47, 0x30, 0x6f, 0x3d, 0x42, 0x6a, 0x31, 0xf3, 0x97,
+  0x4d, 0xaa, 0x3b, 0x79, 0x25, 0x4c, 0x13, 0xe8, 0x44, 0x85, 0x07, 0x49, 0x7e, 0x25, 0xb0, 0x41,
+  0x81, 0xeb, 0x73, 0xeb, 0x4b, 0xa6, 0x79, 0x29, 0xe9, 0x6e, 0xa0, 0x6f, 0xa7, 0xf4, 0x0f, 0x9b,
+  0x7b, 0xb2, 0x9a, 0xe2, 0xb9, 0x3d, 0x45, 0x93, 0x43, 0x9f, 0x70, 0x0a, 0xf2, 0x98, 0xa6, 0x2e,
+  0xcb, 0x67, 0x03, 0x98, 0x90, 0xef, 0x42, 0xc9, 0x3d, 0xee, 0xe8, 0x02, 0xca, 0xaa, 0xed, 0x20,
+  0xdf, 0x90, 0x0c, 0x73, 0x04, 0xaa, 0x48, 0x83, 0xa1, 0x60, 0xa6, 0x5c, 0x1f, 0xbe, 0xb8, 0x10,
+  0x32, 0x80, 0x53, 0x7b, 0xbc, 0x12, 0x27, 0x69, 0xec, 0x1c, 0x65, 0xd6, 0x35, 0x52, 0x79, 0xda,
+  0xad, 0x1e, 0x13, 0x29, 0x56, 0x2c, 0x67, 0xcd, 0x32, 0x89, 0x47, 0xfd, 0x88, 0xe5, 0x37, 0x13,
+  0x14, 0x75, 0xe6, 0x16, 0x13, 0x22, 0x7c, 0x64, 0x3c, 0x7d, 0x1b, 0x21, 0x6d, 0x8f, 0xfc, 0xfc,
+  0x43, 0x31, 0xd9, 0x78, 0x65, 0x77, 0xff, 0xcd, 0x90, 0x2e, 0x0a, 0x7d, 0x66, 0xab, 0x39, 0x0d,
+  0x9b, 0x7a, 0x0f, 0x7e, 0xde, 0xe7, 0xce, 0x86, 0x7c, 0x36, 0x48, 0x8f, 0x86, 0x1d, 0xf6, 0x30,
+  0xe9, 0x63, 0x93, 0x6c, 0x35, 0x88, 0xa1, 0xed, 0x16, 0x7b, 0x64, 0x26, 0x33, 0xd3, 0x5c, 0x52,
+  0x33, 0x6c, 0x73, 0xca, 0x6c, 0x7e, 0x4b, 0xb1, 0x41, 0x4a, 0xa5, 0x46, 0x51, 0x71, 0x97, 0x39,
+  0xa1, 0xcb, 0x14, 0x85, 0x85, 0xb7, 0x9d, 0xe6, 0xa1, 0x88, 0xef, 0xf6, 0x74, 0x2d, 0xd9, 0x39,
+  0x0b, 0x66, 0x70, 0xe2, 0xf5, 0x37, 0xd4, 0x4b, 0x7f, 0xfe, 0x49, 0x14, 0x19, 0x44, 0xf3, 0x07,
+  0x1e, 0xc8, 0xae, 0xd5, 0xaa, 0x91, 0xa7, 0xc7, 0xc7, 0xf9, 0xa2, 0xab, 0x96, 0xa4, 0x93, 0x4c,
+  0xae, 0xa4, 0x86, 0x59, 0x05, 0x68, 0xcd, 0x3c, 0x44, 0x3b, 0xde, 0xa8, 0xc7, 0xca, 0xf0, 0x3c,
+  0xc6, 0xf9, 0xa5, 0x5c, 0xaf, 0x6d, 0x5d, 0x59, 0x45, 0x58, 0xb2, 0x32, 0xe2, 0xbf, 0xf7, 0x3c,
+  0xec, 0xc1, 0x9f, 0x97, 0xf1, 0x93, 0x1d, 0x50, 0x38, 0xa9, 0x5b, 0xc6, 0xc6, 0xee, 0xe5, 0x64,
+  0x6f, 0x1f, 0x5a, 0x9d, 0xba, 0xda, 0xcc, 0x34, 0xe1, 0x49, 0xbe, 0x60, 0x17, 0x51, 0x9e, 0x6c,
+  0xaf, 0x63, 0xed, 0x17, 0xc8, 0x22, 0xba, 0x58, 0xfa, 0x6c, 0x4c, 0x65, 0x19, 0xb1, 0x1b, 0x93,
+  0x92, 0x26, 0x69, 0xb7, 0x52, 0x7a, 0xbc, 0x6a, 0x2e, 0x91, 0xc2, 0x7c, 0x46, 0xcb, 0x0e, 0xeb,
+  0xaa, 0x9e, 0x86, 0xce, 0xeb, 0xbf, 0xff, 0x81, 0x0e, 0x57, 0x68, 0x33, 0xc5, 0x00, 0x49, 0x2f,
+  0xfd, 0x0e, 0xef, 0x63, 0x0b, 0xf6, 0xef, 0xa4, 0x62, 0x25, 0x54, 0x58, 0x4f, 0x95, 0xc8, 0xf6,
+  0x52, 0x32, 0xcf, 0xa7, 0xb3, 0xa8, 0x34, 0xbf, 0x9f, 0x69, 0x27, 0xe9, 0xb9, 0xa4, 0x65, 0x71,
+  0x0f, 0x4d, 0xd5, 0x52, 0xdd, 0xb0, 0x2d, 0xfd, 0x23, 0x23, 0x3e, 0xd3, 0xb4, 0xdd, 0x82, 0xc5,
+  0x90, 0xea, 0x63, 0x91, 0xaa, 0xd3, 0xda, 0x40, 0xf5, 0xa9, 0x44, 0xd5, 0xd9, 0x40, 0x05, 0xfd,
+  0x5e, 0xc0, 0xe5, 0xca, 0xdd, 0xb0, 0xa5, 0xc5, 0xcd, 0x02, 0xa3, 0x9e, 0xe1, 0x55, 0x20, 0xd4,
+  0x76, 0xd7, 0x10, 0xbe, 0xb7, 0x75, 0xb2, 0xae, 0x93, 0x3b, 0x6d, 0xde, 0xc8, 0x26, 0x57, 0x73,
+  0x06, 0xdf, 0x97, 0x6b, 0xf2, 0x9d, 0xb1, 0x65, 0x04, 0x05, 0x21, 0x23, 0x54, 0x08, 0x28, 0x92,
+  0xd5, 0xa5, 0x3d, 0xde, 0xca, 0xc9, 0xf5, 0x92, 0xb9, 0x19, 0x98, 0x9a, 0x8d, 0xe0, 0x83, 0x91,
+  0x39, 0xc4, 0x6b, 0xdc, 0xe6, 0xd4, 0xc9, 0xcd, 0x9c, 0x3b, 0x73, 0x2c, 0x32, 0x73, 0xed, 0x0f,
+  0x56, 0x90, 0x0c, 0xca, 0x84, 0x75, 0x52, 0x65, 0x12, 0xbc, 0x11, 0xf7, 0x42, 0xb1, 0xb0, 0x73,
+  0xce, 0x04, 0x1b, 0x12, 0xb0, 0x1b, 0xa2, 0x54, 0x1e, 0xe2, 0x0a, 0x71, 0x30, 0xad, 0x3c, 0x0f,
+  0x6a, 0x8c, 0xc8, 0xc7, 0xba, 0x42, 0x85, 0x41, 0x3d, 0x8e, 0x86, 0x5d, 0x71, 0xa4, 0x93, 0xf4,
+  0x7d, 0x39, 0x81, 0x64, 0x87, 0x89, 0xc5, 0xf0, 0x0c, 0x4a, 0x12, 0x88, 0x0e, 0x33, 0xd5, 0x8b,
+  0xa9, 0x82, 0x2d, 0x4b, 0x33, 0x8a, 0xcc, 0x86, 0x15, 0xc1, 0xc2, 0xb6, 0x3a, 0x9a, 0x8c, 0x78,
+  0x7f, 0xaa, 0x38, 0x6a, 0x69, 0xfd, 0x9b, 0x4e, 0xe4, 0x32, 0x1c, 0x66, 0x18, 0x8c, 0x68, 0xf2,
+  0xec, 0x99, 0x5e, 0xc2, 0x8e, 0xcc, 0x29, 0x2b, 0x4f, 0xfd, 0x9c, 0xb4, 0x6b, 0xe4, 0x19, 0x34,
+  0x67, 0xaf, 0xe1, 0xaf, 0x56, 0x33, 0x72, 0xe2, 0xf3, 0xe7, 0x1b, 0xd3, 0x67, 0x1e, 0x32, 0x16,
+  0x22, 0xce, 0x1b, 0x18, 0x77, 0x19, 0x09, 0xbe, 0x69, 0x88, 0xad, 0xed, 0x4f, 0xee, 0xfa, 0xac,
+  0x5a, 0xcb, 0x9d, 0x22, 0x1a, 0xc5, 0x0c, 0xb2, 0xc7, 0x82, 0x05, 0xe1, 0xcd, 0x4e, 0x2c, 0x08,
+  0xeb, 0x07, 0xa0, 0x6e, 0x37, 0x09, 0x64, 0x69, 0x14, 0x15, 0x81, 0xe0, 0x07, 0x4a, 0xbf, 0x9a,
+  0x2d, 0xc3, 0xd7, 0xfc, 0x16, 0x8e, 0xc5, 0xbd, 0xda, 0x03, 0x98, 0xeb, 0x07, 0x30, 0x3f, 0xfe,
+  0x0d, 0xcc, 0xbb, 0x07, 0x30, 0x3f, 0xfd, 0x0d, 0x4c, 0xf3, 0x02, 0x6c, 0x3b, 0x72, 0x9a, 0x11,
+  0x36, 0xaf, 0xf0, 0x24, 0x8e, 0xde, 0xe4, 0xb6, 0x2b, 0xfe, 0x59, 0x03, 0xa3, 0x18, 0x43, 0x1e,
+  0x62, 0x8f, 0xa1, 0xc3, 0xa8, 0x58, 0xd4, 0x8d, 0x21, 0xd3, 0x9b, 0xb4, 0xe1, 0x00, 0x8c, 0xdd,
+  0x49, 0xc7, 0xad, 0xed, 0xeb, 0xb3, 0xae, 0x49, 0xf6, 0xb2, 0xc0, 0xd0, 0x94, 0x03, 0xd2, 0xaa,
+  0x15, 0xca, 0x5b, 0x8e, 0x42, 0xeb, 0xd9, 0x06, 0x3a, 0xfa, 0x2f, 0x09, 0x57, 0x42, 0x70, 0x5b,
+  0xc4, 0xff, 0xcc, 0xbf, 0x24, 0x1a, 0xe5, 0x29, 0xd7, 0x65, 0x4a, 0x0c, 0x9e, 0x2d, 0xd4, 0x77,
+  0x1b, 0xa9, 0x3b, 0x25, 0xea, 0x1d, 0x1e, 0x58, 0xf6, 0xe2, 0xdb, 0xd2, 0x26, 0xee, 0x74, 0xb7,
+  0x32, 0xc0, 0xfa, 0xaf, 0x00, 0xdc, 0x6d, 0x00, 0xb8, 0xfb, 0x2b, 0x00, 0xc6, 0xad, 0x60, 0x01,
+  0xe6, 0x82, 0x42, 0xb7, 0x3d, 0x5f, 0x2f, 0x43, 0x69, 0xc5, 0xe7, 0x43, 0xd9, 0x3f, 0xef, 0x9f,
+  0xec, 0x76, 0x53, 0xfd, 0x43, 0x44, 0x1e, 0x38, 0x96, 0xe8, 0xdb, 0xcf, 0x3f, 0x4c, 0xdb, 0x63,
+  0xe1, 0x70, 0x4f, 0xde, 0xde, 0xd5, 0xa1, 0x1a, 0x56, 0xbe, 0x70, 0x9f, 0x1c, 0x02, 0x4d, 0x45,
+  0x56, 0x27, 0x93, 0xab, 0x61, 0xf3, 0xfc, 0x6a, 0x48, 0x52, 0x3e, 0x75, 0x24, 0xa7, 0x22, 0xb5,
+  0x6b, 0xf7, 0xdf, 0xc8, 0xf3, 0x18, 0xdc, 0x8a, 0x83, 0x40, 0x1d, 0xeb, 0x90, 0x39, 0xf3, 0xf7,
+  0x5c, 0x35, 0xf2, 0x2b, 0xa9, 0x12, 0x4b, 0x0a, 0x3e, 0x9b, 0x31, 0x01, 0xbd, 0x73, 0x95, 0xf4,
+  0x48, 0xb5, 0x5a, 0xcb, 0xd8, 0x8d, 0xa2, 0x13, 0x1c, 0x16, 0xc8, 0xbf, 0xa1, 0x5c, 0xd9, 0xe8,
+  0x7d, 0x7c, 0xaf, 0xa7, 0x32, 0xf1, 0x37, 0xcd, 0x5d, 0x3e, 0x59, 0xb2, 0x8b, 0x9c, 0xfc, 0x55,
+  0xcd, 0x86, 0x5a, 0x38, 0x8b, 0x89, 0xf2, 0xbd, 0x09, 0x44, 0xe8, 0xef, 0x82, 0x4b, 0x38, 0x83,
+  0x49, 0x04, 0x1d, 0x18, 0xc4, 0x22, 0x96, 0x7b, 0xd8, 0x88, 0xc5, 0x1a, 0xa8, 0xc0, 0x54, 0xa0,
+  0x46, 0x60, 0xea, 0x53, 0x12, 0x4b, 0x69, 0x38, 0x42, 0x55, 0x3d, 0xa3, 0x8f, 0x50, 0x68, 0xfc,
+  0x6a, 0x5b, 0x4b, 0x72, 0xfb, 0x06, 0x17, 0x52, 0xbf, 0xe0, 0x58, 0x1a, 0x20, 0xe9, 0x5c, 0x75,
+  0xab, 0x0a, 0x7a, 0x18, 0x9d, 0x4d, 0xd6, 0xa3, 0xf8, 0xe1, 0xcc, 0xaa, 0xea, 0xdf, 0x80, 0x9c,
+  0x70, 0xb1, 0x80, 0x13, 0x15, 0xea, 0x4b, 0xf0, 0x87, 0xec, 0x3a, 0xe8, 0x3e, 0x05, 0xda, 0xd2,
+  0x26, 0x15, 0x1b, 0x9e, 0xaa, 0x6a, 0x8e, 0x10, 0x06, 0x7f, 0xf3, 0xd4, 0xc2, 0x26, 0xe0, 0x3d,
+  0xe8, 0x01, 0xcd, 0x86, 0x28, 0x6b, 0x89, 0xfa, 0xcd, 0xe4, 0x82, 0xb9, 0xdf, 0xd4, 0x3f, 0xbb,
+  0xf5, 0x9b, 0xfa, 0xff, 0x9d, 0xf8, 0x1f, 0x88, 0x39, 0x99, 0x98, 0x54, 0x21, 0x00, 0x00,
+};
@@ -0,0 +1,490 @@
+// Collector for a network of seismometers.
+//
+// Stations send TriggerPackets (lib/SeismoCore/trigger_packet.h) over UDP or
+// TCP when their STA/LTA trigger turns on or off, and a heartbeat every few
+// seconds. The collector maps every onset to UTC, runs a k-of-n coincidence
+// trigger over all stations and appends the network events it declares to an
+// indexed event file. One thread and one epoll loop serve every station;
+// datagrams are read in batches with recvmmsg.
+//
+// Build and run with PlatformIO:
+//   pio run -e collector
+//   .pio/build/collector/program --db /var/lib/seismo -k 3 --window 2000
+//   .pio/build/collector/program --simulate 100      # self-test on localhost
+//   .pio/build/collector/program --db /var/lib/seismo --query 1760000000 1760100000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unordered_map>
+#include <vector>
+#include <coincidence.h>
+#include <trigger_packet.h>
+#include "event_db.h"
+#include "simulator.h"
+#include "station_table.h"
+
+#define UDP_BATCH 64
+
+struct CollectorOptions {
+  uint16_t port;
+  const char* db;
+  CoincidenceConfig coincidence;
+  float active_s;
+  float stats_s;
+  bool quiet;
+  bool query;
+  double query_from;
+  double query_to;
+  uint16_t simulate;   // Simulated stations, 0 for none
+  SimulatorConfig sim;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static int64_t utcNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static double cpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static void formatUtc(int64_t utc_us, char* out, size_t size) {
+  time_t seconds = (time_t)(utc_us / 1000000);
+  struct tm parts;
+  gmtime_r(&seconds, &parts);
+  size_t n = strftime(out, size, "%Y-%m-%d %H:%M:%S", &parts);
+  snprintf(out + n, size - n, ".%03d", (int)(utc_us % 1000000 / 1000));
+}
+
+static bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+class Collector {
+  public:
+    Collector(const CollectorOptions& options, EventDb& db)
+      : options(options), db(db), stations((int64_t)(options.active_s * 1e6)),
+        epollFd(-1), udpFd(-1), listenFd(-1), packets(0), invalid(0) {
+      trigger.configure(options.coincidence);
+    }
+
+    ~Collector() {
+      for (std::unordered_map<int, TcpClient>::iterator it = clients.begin(); it != clients.end(); ++it) {
+        close(it->first);
+      }
+      if (udpFd >= 0) close(udpFd);
+      if (listenFd >= 0) close(listenFd);
+      if (epollFd >= 0) close(epollFd);
+    }
+
+    // Bind UDP and TCP on the port, all interfaces
+    bool listen(uint16_t port) {
+      epollFd = epoll_create1(0);
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+      int one = 1;
+
+      udpFd = socket(AF_INET, SOCK_DGRAM, 0);
+      int buffer = 4 << 20; // Rides out bursts while an event is written
+      setsockopt(udpFd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+      if (udpFd < 0 || bind(udpFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || !setNonBlocking(udpFd)) {
+        perror("UDP socket");
+        return false;
+      }
+
+      listenFd = socket(AF_INET, SOCK_STREAM, 0);
+      setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (listenFd < 0 || bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+          ::listen(listenFd, 128) != 0 || !setNonBlocking(listenFd)) {
+        perror("TCP socket");
+        return false;
+      }
+      return watch(udpFd) && watch(listenFd);
+    }
+
+    bool watch(int fd) {
+      struct epoll_event ev;
+      memset(&ev, 0, sizeof(ev));
+      ev.events = EPOLLIN;
+      ev.data.fd = fd;
+      return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    // Serve until a signal, or until `deadline` (UTC µs, 0 for none). extraFd
+    // is watched too; run() returns when it becomes readable.
+    bool run(int64_t deadline, int extraFd) {
+      if (extraFd >= 0) watch(extraFd);
+      int64_t lastStats = utcNow();
+      struct epoll_event events[64];
+
+      while (!stopRequested) {
+        int n = epoll_wait(epollFd, events, 64, 100); // Windows are evaluated at least every 100 ms
+        if (n < 0 && errno != EINTR) return false;
+        for (int i = 0; i < n; i++) {
+          int fd = events[i].data.fd;
+          if (fd == udpFd) readDatagrams();
+          else if (fd == listenFd) acceptClients();
+          else if (fd == extraFd) return true;
+          else readStream(fd);
+        }
+
+        int64_t now = utcNow();
+        declareEvents(now);
+        if (deadline && now >= deadline) return true;
+        if (options.stats_s > 0 && now - lastStats >= options.stats_s * 1e6) {
+          printStats(now);
+          lastStats = now;
+        }
+      }
+      return true;
+    }
+
+    // Evaluate the windows that have closed and store their events
+    void declareEvents(int64_t now) {
+      while (trigger.poll(now, event)) {
+        uint16_t active = stations.activeCount(now);
+        if (!db.append(event, active)) fprintf(stderr, "Cannot store event: %s\n", strerror(errno));
+        if (!options.quiet) {
+          char onset[32];
+          formatUtc(event.onset_us, onset, sizeof(onset));
+          printf("EVENT %s UTC  %u of %u stations in %.3f s  Mercalli %u\n", onset, event.count, active,
+                 (event.last_us - event.onset_us) / 1e6, event.max_mercalli);
+          fflush(stdout);
+        }
+      }
+    }
+
+    void printStats(int64_t now) {
+      uint32_t lost = 0, duplicates = 0;
+      for (std::unordered_map<uint32_t, StationState>::const_iterator it = stations.all().begin();
+           it != stations.all().end(); ++it) {
+        lost += it->second.sequence.lostCount();
+        duplicates += it->second.sequence.duplicateCount();
+      }
+      printf("Stations %u (%u active, %u on TCP)  packets %llu  invalid %u  duplicates %u  lost %u  "
+             "pending %u  late %u  events %u\n",
+             (unsigned)stations.size(), stations.activeCount(now), (unsigned)clients.size(),
+             (unsigned long long)packets, invalid, duplicates, lost, trigger.pendingCount(),
+             trigger.lateCount(), trigger.eventCount());
+      fflush(stdout);
+    }
+
+    uint64_t packetCount() const { return packets; }
+    uint32_t invalidCount() const { return invalid; }
+    const StationTable& stationTable() const { return stations; }
+    const CoincidenceTrigger& coincidence() const { return trigger; }
+
+  private:
+    struct TcpClient {
+      uint8_t partial[TRIGGER_PACKET_SIZE]; // A record split across reads
+      size_t fill;
+    };
+
+    void handle(const uint8_t* data, size_t length, int64_t arrival) {
+      TriggerPacket packet;
+      if (length != TRIGGER_PACKET_SIZE || !decodeTriggerPacket(data, length, packet)) {
+        invalid++;
+        return;
+      }
+      packets++;
+      int64_t utc;
+      if (!stations.accept(packet, arrival, utc) || packet.type != TRIGGER_PACKET_ON) return;
+
+      StationTrigger station;
+      station.station = packet.station;
+      station.onset_us = utc;
+      station.mercalli = packet.mercalli;
+      station.sta_lta = packet.sta_lta_x100 / 100.0f;
+      station.magnitude = packet.magnitude_mm / 1000.0f;
+      trigger.add(station);
+    }
+
+    void readDatagrams() {
+      static uint8_t buffers[UDP_BATCH][TRIGGER_PACKET_SIZE + 1]; // One spare byte shows oversized datagrams
+      struct mmsghdr messages[UDP_BATCH];
+      struct iovec vectors[UDP_BATCH];
+      for (int i = 0; i < UDP_BATCH; i++) {
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = sizeof(buffers[i]);
+        memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      int received;
+      while ((received = recvmmsg(udpFd, messages, UDP_BATCH, MSG_DONTWAIT, NULL)) > 0) {
+        int64_t arrival = utcNow();
+        for (int i = 0; i < received; i++) handle(buffers[i], messages[i].msg_len, arrival);
+        if (received < UDP_BATCH) break;
+      }
+    }
+
+    void acceptClients() {
+      int fd;
+      while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+        if (!setNonBlocking(fd) || !watch(fd)) {
+          close(fd);
+          continue;
+        }
+        clients[fd].fill = 0;
+      }
+    }
+
+    void readStream(int fd) {
+      TcpClient& client = clients[fd];
+      uint8_t buffer[4096];
+      ssize_t n;
+      while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        int64_t arrival = utcNow();
+        const uint8_t* p = buffer;
+        const uint8_t* end = buffer + n;
+        if (client.fill > 0) {
+          size_t take = TRIGGER_PACKET_SIZE - client.fill;
+          if (take > (size_t)n) take = n;
+          memcpy(client.partial + client.fill, p, take);
+          client.fill += take;
+          p += take;
+          if (client.fill < TRIGGER_PACKET_SIZE) continue;
+          if (!decodeAligned(client.partial, arrival)) return dropClient(fd);
+          client.fill = 0;
+        }
+        for (; end - p >= TRIGGER_PACKET_SIZE; p += TRIGGER_PACKET_SIZE) {
+          if (!decodeAligned(p, arrival)) return dropClient(fd);
+        }
+        client.fill = end - p;
+        memcpy(client.partial, p, client.fill);
+      }
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) dropClient(fd);
+    }
+
+    // A bad record in a stream means it is out of step; the station reconnects
+    bool decodeAligned(const uint8_t* record, int64_t arrival) {
+      uint32_t before = invalid;
+      handle(record, TRIGGER_PACKET_SIZE, arrival);
+      return invalid == before;
+    }
+
+    void dropClient(int fd) {
+      epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+      close(fd);
+      clients.erase(fd);
+    }
+
+    const CollectorOptions& options;
+    EventDb& db;
+    StationTable stations;
+    CoincidenceTrigger trigger;
+    CoincidenceEvent event;
+    int epollFd;
+    int udpFd;
+    int listenFd;
+    std::unordered_map<int, TcpClient> clients;
+    uint64_t packets;
+    uint32_t invalid;
+};
+
+static void printUsage(const char* program) {
+  printf("Usage: %s [options]\n", program);
+  printf("  --port N          UDP and TCP port (default %d)\n", TRIGGER_PORT);
+  printf("  --db DIR          Event database directory (default collector-db)\n");
+  printf("  -k N              Stations needed for an event (default 3)\n");
+  printf("  --window MS       Coincidence window (default 2000)\n");
+  printf("  --latency MS      Wait for late packets after a window closes (default 1000)\n");
+  printf("  --active S        A station counts as active this long after its last packet (default 30)\n");
+  printf("  --stats S         Print counters every S seconds (default 10, 0 for never)\n");
+  printf("  --quiet           Do not print events as they are declared\n");
+  printf("  --query FROM TO   Print the stored events with onset in [FROM, TO), UTC seconds\n");
+  printf("  --simulate N      Self-test: N simulated stations on localhost, database in a\n");
+  printf("                    temporary directory unless --db is given\n");
+  printf("  --duration S      Simulation length (default 60)\n");
+  printf("  --heartbeat S     Simulated heartbeat interval (default 1)\n");
+  printf("  --loss P          Simulated UDP loss, 0 to 1 (default 0.01)\n");
+  printf("  --tcp P           Share of simulated stations on TCP (default 0.1)\n");
+  printf("  --unsynced P      Share of simulated stations without NTP (default 0.2)\n");
+}
+
+static bool parseOptions(int argc, char** argv, CollectorOptions& options) {
+  options.port = TRIGGER_PORT;
+  options.db = NULL;
+  options.coincidence = defaultCoincidenceConfig();
+  options.active_s = 30;
+  options.stats_s = 10;
+  options.quiet = false;
+  options.query = false;
+  options.query_from = 0;
+  options.query_to = 0;
+  options.simulate = 0;
+  options.sim = defaultSimulatorConfig();
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--port") && hasValue) options.port = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--db") && hasValue) options.db = argv[++i];
+    else if (!strcmp(arg, "-k") && hasValue) options.coincidence.k = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--window") && hasValue) options.coincidence.window_us = (int64_t)(atof(argv[++i]) * 1000);
+    else if (!strcmp(arg, "--latency") && hasValue) options.coincidence.latency_us = (int64_t)(atof(argv[++i]) * 1000);
+    else if (!strcmp(arg, "--active") && hasValue) options.active_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--stats") && hasValue) options.stats_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--quiet")) options.quiet = true;
+    else if (!strcmp(arg, "--query") && i + 2 < argc) {
+      options.query = true;
+      options.query_from = atof(argv[++i]);
+      options.query_to = atof(argv[++i]);
+    }
+    else if (!strcmp(arg, "--simulate") && hasValue) options.simulate = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--duration") && hasValue) options.sim.duration_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--heartbeat") && hasValue) options.sim.heartbeat_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--loss") && hasValue) options.sim.loss = atof(argv[++i]);
+    else if (!strcmp(arg, "--tcp") && hasValue) options.sim.tcp_share = atof(argv[++i]);
+    else if (!strcmp(arg, "--unsynced") && hasValue) options.sim.unsynced_share = atof(argv[++i]);
+    else return false;
+  }
+  if (options.simulate) {
+    options.sim.stations = options.simulate;
+    options.sim.port = options.port;
+  }
+  return options.coincidence.k > 0;
+}
+
+static int runQuery(EventDb& db, const CollectorOptions& options) {
+  std::vector<NetworkEvent> events;
+  db.query((int64_t)(options.query_from * 1e6), (int64_t)(options.query_to * 1e6), events);
+  for (size_t i = 0; i < events.size(); i++) {
+    const NetworkEvent& e = events[i];
+    char onset[32];
+    formatUtc(e.onset_us, onset, sizeof(onset));
+    printf("#%u %s UTC  %u of %u stations in %.3f s  Mercalli %u\n", e.sequence, onset,
+           (unsigned)e.members.size(), e.active, e.duration_us / 1e6, e.max_mercalli);
+    for (size_t j = 0; j < e.members.size(); j++) {
+      const NetworkEventMember& m = e.members[j];
+      printf("  %08x  +%.3f s  STA/LTA %.2f  %.3f m/s2  Mercalli %u\n", m.station, m.offset_us / 1e6,
+             m.sta_lta, m.magnitude, m.mercalli);
+    }
+  }
+  printf("%u events\n", (unsigned)events.size());
+  return 0;
+}
+
+// Run the collector against simulated stations in a child process and check
+// that it declared every simulated earthquake and nothing else
+static int runSimulation(Collector& collector, EventDb& db, const CollectorOptions& options) {
+  int reportPipe[2];
+  if (pipe(reportPipe) != 0) return 1;
+  uint32_t eventsBefore = db.eventCount();
+  int64_t started = utcNow();
+  double cpuStarted = cpuSeconds();
+
+  pid_t child = fork();
+  if (child == 0) {
+    close(reportPipe[0]);
+    SimulatorReport report = runSimulator(options.sim, options.coincidence.k);
+    ssize_t written = write(reportPipe[1], &report, sizeof(report));
+    _exit(written == (ssize_t)sizeof(report) ? 0 : 1);
+  }
+  close(reportPipe[1]);
+  if (child < 0) return 1;
+
+  // Serve until the stations are done, then until their last windows close
+  collector.run(0, reportPipe[0]);
+  SimulatorReport report;
+  memset(&report, 0, sizeof(report));
+  bool reported = read(reportPipe[0], &report, sizeof(report)) == (ssize_t)sizeof(report);
+  close(reportPipe[0]);
+  waitpid(child, NULL, 0);
+  const CoincidenceConfig& c = options.coincidence;
+  collector.run(utcNow() + c.window_us + c.latency_us + 200000, -1);
+
+  double wall = (utcNow() - started) / 1e6;
+  double cpu = cpuSeconds() - cpuStarted;
+  uint32_t lost = 0, duplicates = 0, unsynced = 0;
+  for (std::unordered_map<uint32_t, StationState>::const_iterator it = collector.stationTable().all().begin();
+       it != collector.stationTable().all().end(); ++it) {
+    lost += it->second.sequence.missingCount();
+    duplicates += it->second.sequence.duplicateCount();
+    if (!it->second.synced) unsynced++;
+  }
+  std::vector<NetworkEvent> stored;
+  db.query(started - c.window_us, INT64_MAX, stored);
+  uint32_t declared = db.eventCount() - eventsBefore;
+
+  printf("Stations:        %u simulated, %u seen (%u unsynced), %u connect errors\n", options.simulate,
+         (unsigned)collector.stationTable().size(), unsynced, report.connect_errors);
+  printf("Packets:         %u sent, %llu received (%.0f/s), %u invalid, %u duplicates\n", report.packets,
+         (unsigned long long)collector.packetCount(), collector.packetCount() / wall,
+         collector.invalidCount(), duplicates);
+  printf("Loss:            %u dropped on purpose, %u counted lost from sequence gaps\n", report.dropped, lost);
+  printf("Collector CPU:   %.3f s in %.1f s (%.2f%% of one core)\n", cpu, wall, cpu / wall * 100);
+  printf("Triggers:        %u late, %u overflowed, %u joined no event, %u false triggers sent\n",
+         collector.coincidence().lateCount(), collector.coincidence().overflowCount(),
+         collector.coincidence().unmatchedCount(), report.false_triggers);
+  printf("Earthquakes:     %u simulated, %u events declared, %u read back from the database\n",
+         report.earthquakes, declared, (unsigned)stored.size());
+
+  bool ok = reported && report.connect_errors == 0 && declared == report.earthquakes &&
+            stored.size() == declared && collector.invalidCount() == 0 && lost <= report.dropped;
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  CollectorOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  char tempDir[] = "/tmp/seismo-collector-XXXXXX";
+  const char* dbDir = options.db ? options.db : "collector-db";
+  if (options.simulate && !options.db) {
+    if (!mkdtemp(tempDir)) return 1;
+    dbDir = tempDir;
+  }
+
+  EventDb db;
+  if (!db.open(dbDir)) {
+    fprintf(stderr, "Cannot open the event database in %s\n", dbDir);
+    return 1;
+  }
+  if (db.corruptRecords()) fprintf(stderr, "Skipped %u corrupt records\n", db.corruptRecords());
+  if (options.query) return runQuery(db, options);
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  Collector collector(options, db);
+  if (!collector.listen(options.port)) return 1;
+  printf("Listening on UDP and TCP port %u; %u events in %s; %u of n stations within %.1f s\n",
+         options.port, db.eventCount(), dbDir, options.coincidence.k, options.coincidence.window_us / 1e6);
+  fflush(stdout);
+
+  if (options.simulate) return runSimulation(collector, db, options);
+  return collector.run(0, -1) ? 0 : 1;
+}
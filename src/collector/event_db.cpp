@@ -0,0 +1,193 @@
+#include "event_db.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <crc32.h>
+
+#define EVENT_HEADER_MAGIC 0x3156454E // "NEV1"
+#define EVENT_MEMBER_MAGIC 0x314D454E // "NEM1"
+#define EVENT_DB_PAYLOAD   (EVENT_DB_RECORD_SIZE - 4)
+
+static void put16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+  put16(p, (uint16_t)value);
+  put16(p + 2, (uint16_t)(value >> 16));
+}
+
+static void put64(uint8_t* p, uint64_t value) {
+  put32(p, (uint32_t)value);
+  put32(p + 4, (uint32_t)(value >> 32));
+}
+
+static void putFloat(uint8_t* p, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  put32(p, bits);
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint64_t get64(const uint8_t* p) {
+  return get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+static float getFloat(const uint8_t* p) {
+  uint32_t bits = get32(p);
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static void seal(uint8_t* record) {
+  put32(record + EVENT_DB_PAYLOAD, crc32(record, EVENT_DB_PAYLOAD));
+}
+
+static bool intact(const uint8_t* record) {
+  return get32(record + EVENT_DB_PAYLOAD) == crc32(record, EVENT_DB_PAYLOAD);
+}
+
+EventDb::EventDb() : file(NULL), sequence(1), corrupt(0) {}
+
+EventDb::~EventDb() {
+  close();
+}
+
+bool EventDb::open(const char* directory) {
+  close();
+  struct stat info;
+  if (stat(directory, &info) != 0 && mkdir(directory, 0755) != 0) return false;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/events.dat", directory);
+  file = fopen(path, "a+b");
+  if (!file) return false;
+
+  // Index every intact header; keep the end of the last intact record
+  uint8_t record[EVENT_DB_RECORD_SIZE];
+  long offset = 0;
+  long validEnd = 0;
+  fseek(file, 0, SEEK_SET);
+  while (fread(record, 1, EVENT_DB_RECORD_SIZE, file) == EVENT_DB_RECORD_SIZE) {
+    if (!intact(record)) {
+      corrupt++;
+    } else {
+      validEnd = offset + EVENT_DB_RECORD_SIZE;
+      if (get32(record) == EVENT_HEADER_MAGIC) {
+        IndexEntry entry = { (int64_t)get64(record + 8), offset };
+        index.push_back(entry);
+        uint32_t seen = get32(record + 4);
+        if (seen >= sequence) sequence = seen + 1;
+      }
+    }
+    offset += EVENT_DB_RECORD_SIZE;
+  }
+  // Events are appended as they are declared, nearly in onset order
+  std::stable_sort(index.begin(), index.end(), byOnset);
+
+  // A torn or corrupt tail would misalign every later append
+  if (offset != validEnd || ftell(file) != validEnd) {
+    fflush(file);
+    if (ftruncate(fileno(file), validEnd) != 0) return false;
+  }
+  return true;
+}
+
+void EventDb::close() {
+  if (file) fclose(file);
+  file = NULL;
+  index.clear();
+  sequence = 1;
+  corrupt = 0;
+}
+
+bool EventDb::append(const CoincidenceEvent& event, uint16_t activeStations) {
+  if (!file) return false;
+  fseek(file, 0, SEEK_END);
+  long offset = ftell(file);
+
+  uint8_t record[EVENT_DB_RECORD_SIZE];
+  memset(record, 0, sizeof(record));
+  put32(record, EVENT_HEADER_MAGIC);
+  put32(record + 4, sequence);
+  put64(record + 8, (uint64_t)event.onset_us);
+  put32(record + 16, (uint32_t)(event.last_us - event.onset_us));
+  put16(record + 20, event.count);
+  put16(record + 22, activeStations);
+  record[24] = event.max_mercalli;
+  seal(record);
+  bool ok = fwrite(record, 1, sizeof(record), file) == sizeof(record);
+
+  for (uint16_t i = 0; i < event.count && ok; i++) {
+    const StationTrigger& trigger = event.triggers[i];
+    memset(record, 0, sizeof(record));
+    put32(record, EVENT_MEMBER_MAGIC);
+    put32(record + 4, sequence);
+    put32(record + 8, trigger.station);
+    put32(record + 12, (uint32_t)(int32_t)(trigger.onset_us - event.onset_us));
+    putFloat(record + 16, trigger.sta_lta);
+    putFloat(record + 20, trigger.magnitude);
+    record[24] = trigger.mercalli;
+    seal(record);
+    ok = fwrite(record, 1, sizeof(record), file) == sizeof(record);
+  }
+  if (fflush(file) != 0 || !ok) return false;
+
+  // Usually the newest onset, so this inserts at the end
+  IndexEntry entry = { event.onset_us, offset };
+  index.insert(std::upper_bound(index.begin(), index.end(), entry, byOnset), entry);
+  sequence++;
+  return true;
+}
+
+bool EventDb::readEvent(long offset, NetworkEvent& out) {
+  uint8_t record[EVENT_DB_RECORD_SIZE];
+  if (fseek(file, offset, SEEK_SET) != 0 || fread(record, 1, sizeof(record), file) != sizeof(record) ||
+      !intact(record) || get32(record) != EVENT_HEADER_MAGIC) {
+    return false;
+  }
+  out.sequence = get32(record + 4);
+  out.onset_us = (int64_t)get64(record + 8);
+  out.duration_us = get32(record + 16);
+  uint16_t count = get16(record + 20);
+  out.active = get16(record + 22);
+  out.max_mercalli = record[24];
+  out.members.clear();
+
+  for (uint16_t i = 0; i < count; i++) {
+    if (fread(record, 1, sizeof(record), file) != sizeof(record)) break;
+    if (!intact(record) || get32(record) != EVENT_MEMBER_MAGIC || get32(record + 4) != out.sequence) break;
+    NetworkEventMember member;
+    member.station = get32(record + 8);
+    member.offset_us = (int32_t)get32(record + 12);
+    member.sta_lta = getFloat(record + 16);
+    member.magnitude = getFloat(record + 20);
+    member.mercalli = record[24];
+    out.members.push_back(member);
+  }
+  return true;
+}
+
+size_t EventDb::query(int64_t from_us, int64_t to_us, std::vector<NetworkEvent>& out) {
+  if (!file) return 0;
+  IndexEntry key = { from_us, 0 };
+  size_t found = 0;
+  for (std::vector<IndexEntry>::iterator it = std::lower_bound(index.begin(), index.end(), key, byOnset);
+       it != index.end() && it->onset_us < to_us; ++it) {
+    NetworkEvent event;
+    if (!readEvent(it->offset, event)) continue;
+    out.push_back(event);
+    found++;
+  }
+  return found;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <coincidence.h>
+
+// Network events on disk: one append-only file of fixed-size, CRC-checked
+// records, indexed in memory by onset time.
+//
+// An event is a header record followed by one member record per station.
+// Both are EVENT_DB_RECORD_SIZE bytes, little-endian:
+//
+//   header                          member
+//    0  u32  magic "NEV1"            0  u32  magic "NEM1"
+//    4  u32  event sequence          4  u32  event sequence
+//    8  i64  onset, UTC µs           8  u32  station id
+//   16  u32  last onset - onset µs  12  i32  station onset - event onset µs
+//   20  u16  stations triggered     16  f32  STA/LTA
+//   22  u16  stations active        20  f32  deviation magnitude (m/s²)
+//   24  u8   highest Mercalli       24  u8   Mercalli
+//   25  3    reserved               25  3    reserved
+//   28  u32  CRC-32 of 0-27         28  u32  CRC-32 of 0-27
+//
+// open() scans the file once to build the index and cuts off a torn tail left
+// by a crash, so appends always start on a record boundary.
+
+#define EVENT_DB_RECORD_SIZE 32
+
+struct NetworkEventMember {
+  uint32_t station;
+  int32_t offset_us;
+  float sta_lta;
+  float magnitude;
+  uint8_t mercalli;
+};
+
+struct NetworkEvent {
+  uint32_t sequence;
+  int64_t onset_us;
+  uint32_t duration_us;
+  uint16_t active;
+  uint8_t max_mercalli;
+  std::vector<NetworkEventMember> members;
+};
+
+class EventDb {
+  public:
+    EventDb();
+    ~EventDb();
+
+    // Create the directory if needed, then open and index events.dat in it
+    bool open(const char* directory);
+    void close();
+
+    bool append(const CoincidenceEvent& event, uint16_t activeStations);
+
+    // Events with onset in [from_us, to_us), oldest first
+    size_t query(int64_t from_us, int64_t to_us, std::vector<NetworkEvent>& out);
+
+    uint32_t eventCount() const { return (uint32_t)index.size(); }
+    uint32_t nextSequence() const { return sequence; }
+    uint32_t corruptRecords() const { return corrupt; }
+
+  private:
+    struct IndexEntry {
+      int64_t onset_us;
+      long offset;      // Of the header record
+    };
+
+    static bool byOnset(const IndexEntry& a, const IndexEntry& b) { return a.onset_us < b.onset_us; }
+    bool readEvent(long offset, NetworkEvent& out);
+
+    FILE* file;
+    std::vector<IndexEntry> index; // Ascending onset
+    uint32_t sequence;
+    uint32_t corrupt;
+};
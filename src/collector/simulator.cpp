@@ -0,0 +1,209 @@
+#include "simulator.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <queue>
+#include <vector>
+#include <trigger_packet.h>
+
+SimulatorConfig defaultSimulatorConfig() {
+  SimulatorConfig config;
+  config.stations = 100;
+  config.port = TRIGGER_PORT;
+  config.duration_s = 60;
+  config.heartbeat_s = 1;
+  config.event_interval_s = 10;
+  config.event_share = 0.6f;
+  config.event_spread_s = 0.5f;
+  config.false_per_hour = 2;
+  config.tcp_share = 0.1f;
+  config.unsynced_share = 0.2f;
+  config.loss = 0.01f;
+  config.seed = 1;
+  return config;
+}
+
+static int64_t utcNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+struct SimStation {
+  uint32_t id;
+  int fd;
+  bool tcp;
+  int64_t boot_us;     // UTC at which an unsynced station booted, 0 if synced
+  uint32_t sequence;
+};
+
+struct SimSend {
+  int64_t at_us;
+  uint16_t station;
+  uint8_t type;
+  int64_t onset_us;    // UTC, for ON and OFF
+  bool operator<(const SimSend& other) const { return at_us > other.at_us; } // Earliest first
+};
+
+class Rng {
+  public:
+    explicit Rng(uint32_t seed) : state(seed ? seed : 1) {}
+    uint32_t next() {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state;
+    }
+    float uniform() { return (next() >> 8) / 16777216.0f; }
+
+  private:
+    uint32_t state;
+};
+
+static int openStation(bool tcp, uint16_t port) {
+  int fd = socket(AF_INET, tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  if (tcp) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  return fd;
+}
+
+SimulatorReport runSimulator(const SimulatorConfig& config, uint16_t k) {
+  SimulatorReport report;
+  memset(&report, 0, sizeof(report));
+  Rng rng(config.seed);
+  int64_t start = utcNow();
+  int64_t end = start + (int64_t)(config.duration_s * 1e6);
+  int64_t heartbeat = (int64_t)(config.heartbeat_s * 1e6);
+  int64_t spread = (int64_t)(config.event_spread_s * 1e6);
+  const int64_t TRIGGER_LENGTH = 2000000;
+  // No false triggers this close to an earthquake, where one could start a
+  // window that splits the earthquake's triggers into two events
+  const int64_t QUIET = 3000000 + spread;
+
+  std::vector<SimStation> stations(config.stations);
+  std::priority_queue<SimSend> queue;
+  for (uint16_t i = 0; i < config.stations; i++) {
+    SimStation& s = stations[i];
+    s.id = 0xC0DE0000u + i;
+    s.tcp = rng.uniform() < config.tcp_share;
+    s.boot_us = rng.uniform() < config.unsynced_share ? start - 1000000 - (int64_t)(rng.next() % 3600000000u) : 0;
+    s.sequence = rng.next() % 1000;
+    s.fd = openStation(s.tcp, config.port);
+    if (s.fd < 0) report.connect_errors++;
+
+    // Heartbeats in random phase, so they do not all arrive together
+    SimSend first = { start + (int64_t)(rng.uniform() * heartbeat), i, TRIGGER_PACKET_HEARTBEAT, 0 };
+    queue.push(first);
+  }
+
+  // Earthquakes, each reaching a random share of the stations
+  int64_t interval = (int64_t)(config.event_interval_s * 1e6);
+  for (int64_t quake = start + interval; interval > 0 && quake + spread + TRIGGER_LENGTH < end; quake += interval) {
+    for (uint16_t i = 0; i < config.stations; i++) {
+      if (rng.uniform() >= config.event_share) continue;
+      int64_t onset = quake + (int64_t)(rng.uniform() * spread);
+      int64_t detected = onset + 50000 + rng.next() % 250000;
+      SimSend on = { detected, i, TRIGGER_PACKET_ON, onset };
+      SimSend off = { detected + TRIGGER_LENGTH, i, TRIGGER_PACKET_OFF, onset + TRIGGER_LENGTH };
+      queue.push(on);
+      queue.push(off);
+    }
+  }
+
+  // False triggers, away from the earthquakes
+  double falseChance = config.false_per_hour / 3600.0 * config.duration_s;
+  for (uint16_t i = 0; i < config.stations; i++) {
+    if (rng.uniform() >= falseChance) continue;
+    int64_t onset = start + (int64_t)(rng.uniform() * (end - start - TRIGGER_LENGTH));
+    int64_t phase = interval > 0 ? (onset - start) % interval : interval;
+    if (interval > 0 && (phase < QUIET || phase > interval - QUIET)) continue;
+    SimSend on = { onset + 100000, i, TRIGGER_PACKET_ON, onset };
+    SimSend off = { onset + 100000 + TRIGGER_LENGTH, i, TRIGGER_PACKET_OFF, onset + TRIGGER_LENGTH };
+    queue.push(on);
+    queue.push(off);
+    report.false_triggers++;
+  }
+
+  // ON packets sent per earthquake; one that lost too many to the dropped
+  // packets is not expected to be declared
+  std::vector<uint16_t> quakeSent;
+  if (interval > 0) quakeSent.resize((size_t)((end - start) / interval) + 1, 0);
+
+  uint8_t buffer[TRIGGER_PACKET_SIZE];
+  while (!queue.empty()) {
+    SimSend due = queue.top();
+    if (due.at_us >= end) break;
+    int64_t now = utcNow();
+    if (due.at_us > now) {
+      int64_t wait = due.at_us - now;
+      struct timespec ts = { (time_t)(wait / 1000000), (long)(wait % 1000000) * 1000 };
+      nanosleep(&ts, NULL);
+      continue;
+    }
+    queue.pop();
+
+    SimStation& s = stations[due.station];
+    TriggerPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.station = s.id;
+    packet.sequence = s.sequence++;
+    packet.type = due.type;
+    int64_t utc = due.type == TRIGGER_PACKET_HEARTBEAT ? now : due.onset_us;
+    packet.flags = s.boot_us ? 0 : TRIGGER_FLAG_TIME_SYNCED;
+    packet.time_us = s.boot_us ? utc - s.boot_us : utc;
+    if (due.type == TRIGGER_PACKET_ON) {
+      packet.mercalli = 3 + rng.next() % 3;
+      packet.sta_lta_x100 = 400 + rng.next() % 600;
+      packet.magnitude_mm = 50 + rng.next() % 500;
+    }
+
+    if (due.type == TRIGGER_PACKET_HEARTBEAT) {
+      SimSend next = { due.at_us + heartbeat, due.station, TRIGGER_PACKET_HEARTBEAT, 0 };
+      queue.push(next);
+    }
+
+    if (s.fd < 0 || (!s.tcp && rng.uniform() < config.loss)) {
+      report.dropped++;
+      continue;
+    }
+    encodeTriggerPacket(packet, buffer);
+    if (send(s.fd, buffer, sizeof(buffer), MSG_NOSIGNAL) == (ssize_t)sizeof(buffer)) {
+      report.packets++;
+      if (due.type == TRIGGER_PACKET_ON && interval > 0) {
+        int64_t sinceStart = due.onset_us - start;
+        int64_t nearest = (sinceStart + interval / 2) / interval;
+        if (sinceStart - nearest * interval >= 0 && sinceStart - nearest * interval <= spread) {
+          quakeSent[nearest]++;
+        }
+      }
+    } else {
+      report.dropped++;
+    }
+  }
+
+  for (size_t i = 0; i < quakeSent.size(); i++) {
+    if (quakeSent[i] >= k) report.earthquakes++;
+  }
+
+  for (size_t i = 0; i < stations.size(); i++) {
+    if (stations[i].fd >= 0) close(stations[i].fd);
+  }
+  return report;
+}
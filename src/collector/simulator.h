@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// Simulated stations for testing the collector on one machine.
+//
+// Each station has its own socket to 127.0.0.1 (UDP, or TCP for a share of
+// them) and sends heartbeats, rare false triggers and, every event_interval,
+// an "earthquake": a share of the stations trigger within a spread that fits
+// the coincidence window, each reporting its onset a little after the fact as
+// a real detector would. Some stations have no NTP and stamp packets with
+// their boot clock, which the collector has to map to UTC itself. UDP packets
+// can be dropped on purpose to exercise loss accounting.
+
+struct SimulatorConfig {
+  uint16_t stations;
+  uint16_t port;
+  float duration_s;
+  float heartbeat_s;
+  float event_interval_s;
+  float event_share;       // Stations triggered by each earthquake
+  float event_spread_s;    // Onsets spread over this span
+  float false_per_hour;    // False triggers per station per hour
+  float tcp_share;         // Stations that send over TCP
+  float unsynced_share;    // Stations stamping with their boot clock
+  float loss;              // Chance that a UDP packet is not sent
+  uint32_t seed;
+};
+
+// 100 stations for 60 s: heartbeat every second, an earthquake every 10 s
+// reaching 60% of them, 2 false triggers per station-hour, 10% over TCP,
+// 20% unsynced, 1% UDP loss
+SimulatorConfig defaultSimulatorConfig();
+
+struct SimulatorReport {
+  uint32_t packets;        // Sent
+  uint32_t dropped;        // Skipped on purpose (sequence numbers still used)
+  uint32_t earthquakes;    // Times k or more stations triggered together and got through
+  uint32_t false_triggers;
+  uint32_t connect_errors;
+};
+
+// Run the stations until duration_s has passed. Blocks; the collector runs
+// the simulator in a child process.
+SimulatorReport runSimulator(const SimulatorConfig& config, uint16_t k);
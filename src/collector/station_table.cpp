@@ -0,0 +1,61 @@
+#include "station_table.h"
+
+// The boot offset is allowed to creep up by this much per µs between packets,
+// so the minimum follows a drifting station crystal instead of sticking to
+// one lucky early packet
+#define BOOT_OFFSET_RELAX 50e-6
+
+bool StationTable::accept(const TriggerPacket& packet, int64_t arrival_us, int64_t& utc_us) {
+  std::unordered_map<uint32_t, StationState>::iterator it = stations.find(packet.station);
+  if (it == stations.end()) {
+    StationState fresh = StationState();
+    fresh.id = packet.station;
+    it = stations.insert(std::make_pair(packet.station, fresh)).first;
+  }
+  StationState& s = it->second;
+
+  switch (s.sequence.accept(packet.sequence)) {
+    case SEQUENCE_DUPLICATE:
+      return false;
+    case SEQUENCE_RESTART:
+      // A restarted station has a new boot clock
+      s.boot_offset_valid = false;
+      s.triggered = false;
+      break;
+    case SEQUENCE_NEW:
+      break;
+  }
+
+  s.synced = (packet.flags & TRIGGER_FLAG_TIME_SYNCED) != 0;
+  if (s.synced) {
+    utc_us = packet.time_us;
+  } else {
+    int64_t offset = arrival_us - packet.time_us;
+    if (s.boot_offset_valid) {
+      int64_t relaxed = s.boot_offset_us + (int64_t)((arrival_us - s.last_heard_us) * BOOT_OFFSET_RELAX);
+      s.boot_offset_us = offset < relaxed ? offset : relaxed;
+    } else {
+      s.boot_offset_us = offset;
+      s.boot_offset_valid = true;
+    }
+    utc_us = packet.time_us + s.boot_offset_us;
+  }
+  s.last_heard_us = arrival_us;
+
+  if (packet.type == TRIGGER_PACKET_ON) {
+    s.triggered = true;
+    s.triggers++;
+  } else if (packet.type == TRIGGER_PACKET_OFF) {
+    s.triggered = false;
+  }
+  return true;
+}
+
+uint16_t StationTable::activeCount(int64_t now_us) const {
+  uint32_t active = 0;
+  for (std::unordered_map<uint32_t, StationState>::const_iterator it = stations.begin();
+       it != stations.end(); ++it) {
+    if (now_us - it->second.last_heard_us <= timeout) active++;
+  }
+  return active > 65535 ? 65535 : (uint16_t)active;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <unordered_map>
+#include <sequence_tracker.h>
+#include <trigger_packet.h>
+
+// What the collector knows about each station that has sent it a packet.
+//
+// Duplicates (a TCP reconnect resending, a UDP packet sent twice) are dropped
+// and losses counted by a SequenceTracker per station.
+//
+// Stations without NTP time send their boot clock. Its offset to UTC is
+// estimated as the smallest (arrival - station time) seen: the network only
+// ever adds delay, so the minimum is the tightest bound.
+
+struct StationState {
+  uint32_t id;
+  SequenceTracker sequence;
+  int64_t boot_offset_us;   // Arrival UTC - station boot time, minimum seen
+  bool boot_offset_valid;
+  int64_t last_heard_us;    // Collector UTC of the newest packet
+  bool synced;              // Newest packet carried UTC
+  bool triggered;           // Between an ON and its OFF
+  uint32_t triggers;
+};
+
+class StationTable {
+  public:
+    explicit StationTable(int64_t activeTimeout_us) : timeout(activeTimeout_us) {}
+
+    // Account for a packet that arrived at arrival_us (collector UTC). False
+    // if it is a duplicate; otherwise utc_us is the packet time in UTC.
+    bool accept(const TriggerPacket& packet, int64_t arrival_us, int64_t& utc_us);
+
+    // Stations heard within the active timeout of now_us: the n of "k of n"
+    uint16_t activeCount(int64_t now_us) const;
+
+    size_t size() const { return stations.size(); }
+    const std::unordered_map<uint32_t, StationState>& all() const { return stations; }
+
+  private:
+    int64_t timeout;
+    std::unordered_map<uint32_t, StationState> stations;
+};
@@ -4,52 +4,177 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <WiFiUdp.h>
+#include <ESPAsyncWebServer.h>
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEServer.h>
 #include <BLE2902.h>
 #include <EEPROM.h>
+#include <Preferences.h>
+#include <LittleFS.h>
 #include <time.h>
+#include <sys/time.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+#include <memory>
+#include <adxl345_fifo.h>
+#include <spsc_ring.h>
+#include <detector.h>
+#include <calibrator.h>
+#include <spectrum.h>
+#include <jma_intensity.h>
+#include <station_config.h>
+#include <clock_model.h>
+#include <latency_histogram.h>
+#include <mercalli.h>
+#include <decimator.h>
+#include <waveform_capture.h>
+#include <oled_flusher.h>
+#include <json_writer.h>
+#include <ble_frame.h>
+#include <chunked_body.h>
+#include <event_store.h>
+#include <file_log_storage.h>
+#include <trigger_packet.h>
+#include <telemetry_packet.h>
 #include "ble_viewer.h"
 #include "wifi_viewer.h"
 
-// WiFi credentials - Can be updated via Serial or Access Point
+// WiFi credentials - Can be updated via Serial or Access Point (stored in
+// the station settings below, which take precedence when set)
 String ssid = "YOUR_SSID_HERE"; // Set your WiFi SSID here
 String password = "YOUR_PASSWORD_HERE"; // Set your WiFi password here
 
-// EEPROM settings for WiFi credentials
-#define EEPROM_SIZE 128
+// Station settings (lib/SeismoCore/station_config.h) - thresholds, intervals,
+// push targets and WiFi credentials, one NVS key each. The web API
+// (/config/params) and serial commands edit stationConfig; loop() writes the
+// keys that changed and applies the new values in place. The detector is
+// retuned between two FIFO drains, so nothing restarts and no sample is lost
+// (the 32-entry FIFO also covers the flash cache stall of a key write).
+#define CONFIG_NAMESPACE "seismo"
+class NvsConfigStorage : public ConfigStorage {
+  public:
+    bool begin() { return preferences.begin(CONFIG_NAMESPACE, false); }
+    size_t read(const char* key, uint8_t* data, size_t size) {
+      if (!preferences.isKey(key)) return 0;
+      return preferences.getBytes(key, data, size);
+    }
+    bool write(const char* key, const uint8_t* data, size_t length) {
+      return preferences.putBytes(key, data, length) == length;
+    }
+  private:
+    Preferences preferences;
+};
+NvsConfigStorage configStorage;
+ConfigStore configStore(configStorage);
+bool configStorageReady = false;
+StationConfig stationConfig;          // Under webStateMutex
+uint32_t stationConfigRevision = 0;   // Under webStateMutex, +1 per change
+StationConfig appliedConfig;          // In effect; owned by loop()
+uint32_t appliedConfigRevision = 0;
+
+// Where settings were kept before NVS (schema 0); read once to migrate them
+#define EEPROM_SIZE 256
 #define SSID_ADDR 0
-#define SSID_LEN  64
 #define PASS_ADDR 64
-#define PASS_LEN  64
+#define COLLECTOR_ADDR 128 // "host" or "host:port" of the network collector
+#define TELEMETRY_ADDR 192 // "host" or "host:port" telemetry is pushed to
+#define EEPROM_STRING_LEN 64
 
-// NTP Time configuration
+// NTP Time configuration - SNTP runs in the background; every sync is paired
+// with the esp_timer microsecond counter and fed to clockModel, which maps
+// sample timestamps to UTC (offset plus crystal drift)
 const char* ntpServer1 = "pool.ntp.org";
 const char* ntpServer2 = "time.nist.gov";
 const char* ntpServer3 = "time.google.com";
 const long gmtOffset_sec = 0;  // UTC time
 const int daylightOffset_sec = 0;
-bool timeInitialized = false;
+const uint32_t NTP_SYNC_INTERVAL = 15 * 60 * 1000UL; // ms; the drift fit wants several syncs an hour
+volatile bool timeInitialized = false; // clockModel has a sync
+ClockModel clockModel;
+portMUX_TYPE clockLock = portMUX_INITIALIZER_UNLOCKED; // Guards clockModel (SNTP callback vs. readers)
 
 // Event logging configuration
 #define MAX_EVENTS 50  // Maximum number of events to store
 struct SeismicEvent {
-  time_t timestamp;
+  time_t timestamp;     // Onset, UTC seconds (0 while unknown)...
+  uint16_t timestamp_ms; // ...and milliseconds
+  uint32_t boot;        // Boot it was detected in (bootNumber then)...
+  int64_t onset_us;     // ...and esp_timer at the onset in that boot
   float mercalli;
   float x_peak;
   float y_peak;
   float z_peak;
   float magnitude;
+  float dominant_hz;    // Strongest frequency around the trigger, 0 if unknown
+  float jma_intensity;  // Highest JMA intensity while the event was held, NAN if unknown
+  float pga;            // Peak horizontal ground motion while triggered (m/s², m/s, m)...
+  float pgv;
+  float pgd;
+  float mmi;            // ...and its intensity by regression; NAN if unknown
+  uint32_t waveform_id; // Captured waveform, 0 if none was stored
 };
 
 SeismicEvent eventLog[MAX_EVENTS];
 int eventCount = 0;
 int eventIndex = 0;  // Circular buffer index
-float lastLoggedMercalli = 0;
-unsigned long lastEventTime = 0;
-const unsigned long MIN_EVENT_INTERVAL = 10000;  // Minimum 10 seconds between logged events
+volatile uint32_t eventLogRevision = 0; // Changes whenever the log does
+
+// Every event is also appended to a log on flash (LittleFS on the spiffs
+// partition) so a power cut does not lose it; eventLog above keeps the newest
+// MAX_EVENTS for the web pages and is refilled from flash at boot. Events
+// detected before the first NTP sync are written at once with their boot and
+// onset; UTC follows from clockAnchors, the time each boot started.
+#define EVENT_STORE_DIR "/littlefs/events"
+#define EVENT_SEGMENT_RECORDS 512 // 38 KB per segment
+#define EVENT_SEGMENTS 16         // 8192 events, 608 KB of the partition
+FileLogStorage eventStorage(EVENT_STORE_DIR);
+EventStore eventStore(eventStorage);
+bool eventStoreReady = false;
+uint32_t bootNumber = 0;        // From the NVS boot counter; 0 without NVS
+ClockAnchors clockAnchors;      // Under webStateMutex
+bool unsyncedEventsStored = false; // This boot wrote events without a time
+
+// UDP destinations set by serial command or /config/params ("host" or
+// "host:port", station settings collector and telemetry) and resolved once
+// WiFi is up
+const uint32_t PUSH_RESOLVE_INTERVAL = 30000; // ms between DNS retries
+struct PushTarget {
+  uint16_t default_port;
+  String host;                // Empty: off
+  uint16_t port;
+  IPAddress ip;
+  bool resolved;
+  unsigned long last_resolve; // millis() of the last attempt, 0 = none
+  uint32_t sent;
+  uint32_t errors;
+};
+uint32_t stationId = 0;       // Low four bytes of the MAC, in every datagram
+
+// Network collector - when one is configured, every STA/LTA trigger on and
+// off, and a heartbeat, go to it as a TriggerPacket over UDP. The collector
+// (src/collector) declares an event when enough stations trigger together.
+const uint32_t COLLECTOR_HEARTBEAT_INTERVAL = 5000; // ms
+PushTarget collectorTarget = { TRIGGER_PORT, "", TRIGGER_PORT, IPAddress(), false, 0, 0, 0 };
+WiFiUDP collectorUdp;
+uint32_t collectorSequence = 0;
+bool collectorTriggered = false; // Trigger state last reported
+float collectorPeakStaLta = 0;   // Highest during the current trigger
+float collectorPeakMagnitude = 0;
+uint8_t collectorPeakMercalli = 0;
+
+// Telemetry push - every TELEMETRY_SAMPLES live samples (10 packets a second)
+// go out as one fixed-size TelemetryPacket to a unicast or multicast address.
+// Any number of listeners can receive them at no cost to the station; they
+// find lost packets from the sequence numbers (reference receiver:
+// src/telemetry).
+PushTarget telemetryTarget = { TELEMETRY_PORT, "", TELEMETRY_PORT, IPAddress(), false, 0, 0, 0 };
+WiFiUDP telemetryUdp;
+TelemetryPacket telemetryPacket;
+size_t telemetrySampleCount = 0;
+uint32_t telemetryRingDrops = 0;      // sampleRing.dropCount() at the last packet
+uint32_t telemetrySequence = 0;
 
 // Display configuration
 #define SCREEN_WIDTH 128
@@ -69,11 +194,6 @@ const char* BASELINE_STATUS = "Baseline";
 const char* SETUP_STATUS = "Setup";
 const char* CALIBRATING_MESSAGE = "CALIBRATING...";
 const char* KEEP_STILL_MESSAGE = "Keep device STILL";
-const char* CALIBRATION_HEADER = "CALIBRATION";
-const char* COMPLETE_MESSAGE = "COMPLETE";
-const char* WARNING_MESSAGE = "WARNING!";
-const char* CALIBRATION_ISSUE = "Calibration issue";
-const char* FAILED_MESSAGE = "FAILED!";
 const char* ADXL345_ERROR = "ADXL345 ERROR!";
 
 // Axis and formatting labels
@@ -81,25 +201,47 @@ const char* X_LABEL = "X: ";
 const char* Y_LABEL = "Y: ";
 const char* Z_LABEL = "Z: ";
 const char* PROGRESS_LABEL = "Progress: ";
-const char* TIME_LEFT_LABEL = "Time left: ";
-const char* NOISE_LABEL = "Noise: ";
-
-// Mercalli intensity thresholds (m/s²) - easy to adjust for sensor sensitivity
-const float MERCALLI_1_THRESHOLD = 0.15;  // I - Not felt (accounts for sensor noise)
-const float MERCALLI_2_THRESHOLD = 0.25;  // II - Weak
-const float MERCALLI_3_THRESHOLD = 0.4;   // III - Weak
-const float MERCALLI_4_THRESHOLD = 0.7;   // IV - Light
-const float MERCALLI_5_THRESHOLD = 1.2;   // V - Moderate
-const float MERCALLI_6_THRESHOLD = 2.0;   // VI - Strong
-const float MERCALLI_7_THRESHOLD = 4.0;   // VII - Very strong
-const float MERCALLI_8_THRESHOLD = 8.0;   // VIII - Severe
-const float MERCALLI_9_THRESHOLD = 12.0;  // IX - Violent
-const float MERCALLI_10_THRESHOLD = 16.0; // X - Extreme
-const float MERCALLI_11_THRESHOLD = 20.0; // XI - Extreme
-// XII - Extreme (anything above MERCALLI_11_THRESHOLD)
-
-// Web server
-WebServer server(80);
+const char* IP_LABEL = "IP: ";
+
+// Web server - handlers run in the async_tcp task, next to loop(), and any
+// number of connections are served side by side. Pages of unbounded length
+// are rendered piece by piece (ChunkedBody) as the connection takes them.
+AsyncWebServer server(80);
+
+// WiFi comes up in the background after sampling has started: setup() starts
+// the connection and loop() waits for it, falling back to the access point
+// after WIFI_CONNECT_TIMEOUT. The web server and NTP start once either is up.
+enum NetworkState {
+  NETWORK_OFF,
+  NETWORK_CONNECTING,
+  NETWORK_CONNECTED,
+  NETWORK_ACCESS_POINT
+};
+const unsigned long WIFI_CONNECT_TIMEOUT = 10000; // ms
+NetworkState networkState = NETWORK_OFF;          // Owned by loop()
+unsigned long wifiConnectStart = 0;
+
+// What loop() owns and the handlers read: the event log, the event store,
+// latestSample and the WiFi scan cache, plus the acquisition task's
+// detectorSnapshot. Held only for short copies, never across a send.
+SemaphoreHandle_t webStateMutex = NULL;
+
+// WiFi networks for /config, scanned in the background by loop(). A request
+// for the page schedules a new scan when the cached one is older than
+// WIFI_SCAN_MAX_AGE; the page itself never waits for one.
+#define WIFI_SCAN_MAX_NETWORKS 20
+#define WIFI_SCAN_MAX_AGE 30000UL // ms
+struct WifiNetwork {
+  char ssid[33];
+  int32_t rssi;
+  bool open;
+};
+WifiNetwork wifiNetworks[WIFI_SCAN_MAX_NETWORKS];
+int wifiNetworkCount = 0;
+unsigned long wifiScanTime = 0;       // millis() of the cached results
+bool wifiScanValid = false;
+volatile bool wifiScanWanted = false; // Set by /config, cleared when the scan starts
+volatile unsigned long restartAt = 0; // millis() of a pending restart, 0 = none
 
 // BLE Server
 #define SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
@@ -109,69 +251,440 @@ BLEServer* pServer = NULL;
 BLECharacteristic* pDataCharacteristic = NULL;
 bool deviceConnected = false;
 
-// Create display object
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// Live data for BLE and /stream - loop() decimates the band-passed deviations
+// once and hands them to both
+#define LIVE_SAMPLE_RATE 100         // Hz; the detection band ends at 10 Hz
+Decimator liveDecimator;
+float liveSampleRate = LIVE_SAMPLE_RATE;
+
+// BLE streaming - binary frames (lib/SeismoCore/ble_frame.h) sized to the
+// negotiated MTU
+#define BLE_SAMPLE_BUFFER 256        // ~2.5 s waiting for the link
+#define BLE_MAX_FRAMES_PER_UPDATE 4
+RawSample bleSamples[BLE_SAMPLE_BUFFER];
+size_t bleSampleCount = 0;
+uint32_t bleFirstSampleMs = 0;       // Time of bleSamples[0]
+bool bleGap = false;                 // Samples were dropped since the last frame
+uint16_t bleSequence = 0;
+uint32_t bleFramesSent = 0;
+uint16_t blePeerMtu = 0;
+uint8_t bleFrame[BLE_FRAME_MAX_SIZE];
+
+// Live stream (/stream) - Server-Sent Events to up to STREAM_MAX_CLIENTS
+// browsers. loop() publishes a frame every 1/streamRateHz s with the samples
+// since the previous one. Each client has its own short queue
+// (SSE_MAX_QUEUED_MESSAGES, platformio.ini); a client that falls behind
+// loses frames instead of holding up loop() or the other clients.
+#define STREAM_MAX_CLIENTS 8
+#define STREAM_FRAME_MAX 768
+#define STREAM_SAMPLE_BUFFER 25      // Keeps a frame well under STREAM_FRAME_MAX
+
+AsyncEventSource liveStream("/stream");
+uint32_t streamFramesPublished = 0;
+int streamRateHz = 20; // Station setting stream_rate_hz
+RawSample streamSamples[STREAM_SAMPLE_BUFFER];
+size_t streamSampleCount = 0;
+uint32_t streamFirstSampleMs = 0;    // Time of streamSamples[0]
+bool streamGap = false;              // Samples were dropped since the last frame
+
+// Spectrum (/spectrum) - loop() block-averages the raw samples it consumes to
+// SPECTRUM_RATE and transforms the newest SPECTRUM_POINTS every
+// SPECTRUM_INTERVAL. It runs at loop() priority, so acquisition preempts it.
+// A new event is held back SPECTRUM_EVENT_DELAY (half a window) before it is
+// stored, so its dominant frequency comes from the shaking, not the noise before.
+#define SPECTRUM_RATE 100
+#define SPECTRUM_POINTS 512                            // 5.12 s, 0.2 Hz bins
+const unsigned long SPECTRUM_INTERVAL = 1000;          // ms
+const unsigned long SPECTRUM_EVENT_DELAY = 2560;       // ms
+Decimator spectrumDecimator;
+RawSample spectrumSamples[SPECTRUM_POINTS];
+float spectrumWork[SPECTRUM_WORK_SIZE(SPECTRUM_POINTS)];
+SpectrumAnalyzer spectrum;
+SpectrumResult spectrumResult = {};  // Newest result, under webStateMutex
+unsigned long spectrumTime = 0;      // millis() of spectrumResult
+uint32_t spectrumCycles = 0;         // CPU cycles of the last compute
+SeismicEvent pendingEvent;           // Waiting for SPECTRUM_EVENT_DELAY and JMA_EVENT_DELAY
+bool eventPending = false;
+bool eventSpectrumDone = false;      // pendingEvent.dominant_hz is filled in
+unsigned long eventPendingSince = 0;
+
+// JMA instrumental intensity - the spectrum's 100 Hz stream also goes through
+// the JMA filter, a block per second, in loop(). Its result trails the signal
+// by up to ~3 s, so an event is stored JMA_EVENT_DELAY after it was detected,
+// with the highest intensity seen since then.
+#define JMA_POINTS 512                                 // With 413 taps, a block of 100 samples
+#define JMA_WINDOW_SAMPLES (60 * SPECTRUM_RATE)
+const unsigned long JMA_EVENT_DELAY = 8000;            // ms, up to min_event_interval_ms
+RawSample jmaSamples[JMA_POINTS];
+float jmaWork[JMA_WORK_SIZE(JMA_POINTS)];
+uint16_t jmaWindow[JMA_WINDOW_SAMPLES];
+JmaIntensity jma;
+float jmaIntensityNow = NAN;         // Of the last minute, under webStateMutex
+float jmaIntensityPeak = NAN;        // Since the last peak reset
+float jmaLevelGal = 0;
+uint32_t jmaCycles = 0;              // CPU cycles of the last block
+float eventJmaIntensity = NAN;       // Highest while pendingEvent is held
+volatile bool jmaResetRequested = false; // Set by any task, handled by loop()
+volatile bool resetScreenRequested = false; // Set with a peak reset, drawn by loop()
+
+// Create display object (keep the bus at 400 kHz after transfers so FIFO reads stay fast)
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET, 400000UL, 400000UL);
+
+// Display transfers - loop() renders into the display buffer and submits a frame
+// at most every DISPLAY_REFRESH_INTERVAL; the acquisition task sends only the
+// changed columns, in short transfers right after each FIFO drain, so the
+// display can never hold the bus when a sensor read is due
+class WireOledBus : public OledBus {
+  public:
+    bool sendCommands(const uint8_t* commands, size_t length) {
+      return send(0x00, commands, length);
+    }
+
+    bool sendData(const uint8_t* data, size_t length) {
+      return send(0x40, data, length);
+    }
+
+  private:
+    bool send(uint8_t control, const uint8_t* bytes, size_t length) {
+      Wire.beginTransmission(SCREEN_ADDRESS);
+      Wire.write(control);
+      Wire.write(bytes, length);
+      return Wire.endTransmission() == 0;
+    }
+};
+
+WireOledBus oledBus;
+OledFlusher oledFlusher(oledBus);
+const unsigned long DISPLAY_REFRESH_INTERVAL = 200; // ms, independent of the sample rate
+const unsigned long DISPLAY_HOLD_TIME = 2000;        // ms a one-off screen (splash, AP details) stays up
+const unsigned long RESET_HOLD_TIME = 400;           // ms the reset confirmation stays up
+unsigned long displayHoldStart = 0;                  // millis() it was shown, 0 = none
+unsigned long displayHoldTime = DISPLAY_HOLD_TIME;   // ms the current one stays up
+const size_t DISPLAY_BYTES_PER_PASS = 128;           // ~3.5 ms of bus time at 400 kHz
+volatile uint32_t displayTransferMicros = 0;         // Accumulated by the acquisition task
+float displayBytesPerSecond = 0;                     // Measured over the last second
+float displayTransferMsPerSecond = 0;
+
+// A text field that is only redrawn when its text changes
+struct DisplayField {
+  int16_t x, y;
+  uint8_t size;  // Text size
+  uint8_t chars; // Width in characters, cleared before redrawing
+  char text[12]; // What is on screen now
+};
+
+enum DisplayLayout { DISPLAY_LAYOUT_NONE, DISPLAY_LAYOUT_CALIBRATION, DISPLAY_LAYOUT_BASELINE, DISPLAY_LAYOUT_PEAKS };
+DisplayLayout displayLayout = DISPLAY_LAYOUT_NONE; // NONE after any one-off screen
+
+DisplayField peakXField = { 18, 15, 2, 5, "" };
+DisplayField peakYField = { 18, 32, 2, 5, "" };
+DisplayField peakZField = { 18, 49, 2, 5, "" };
+DisplayField mercalliPeakField = { 90, 25, 3, 2, "" };
+DisplayField mercalliNowField = { 110, 50, 1, 3, "" };
+DisplayField progressField = { 80, 45, 1, 8, "" };
+DisplayField calibrationField = { 60, 35, 1, 4, "" };
 
 // Create ADXL345 object
 Adafruit_ADXL345_Unified accel = Adafruit_ADXL345_Unified(12345);
 
+// Register access for the FIFO acquisition path
+#define ADXL345_I2C_ADDRESS 0x53
+#define ADXL345_REG_OFSX 0x1E // OFSX, OFSY, OFSZ: hardware offsets, kept at 0
+#define ADXL345_REG_OFSZ 0x20
+class WireAdxl345Bus : public Adxl345Bus {
+  public:
+    bool writeRegister(uint8_t reg, uint8_t value) {
+      Wire.beginTransmission(ADXL345_I2C_ADDRESS);
+      Wire.write(reg);
+      Wire.write(value);
+      return Wire.endTransmission() == 0;
+    }
+
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+      Wire.beginTransmission(ADXL345_I2C_ADDRESS);
+      Wire.write(reg);
+      if (Wire.endTransmission(false) != 0) return false;
+      if (Wire.requestFrom((uint8_t)ADXL345_I2C_ADDRESS, (uint8_t)length) != length) return false;
+      for (size_t i = 0; i < length; i++) buffer[i] = Wire.read();
+      return true;
+    }
+};
+
+WireAdxl345Bus accelBus;
+Adxl345Fifo accelFifo(accelBus);
+RawSample fifoBuffer[ADXL345_FIFO_DEPTH];
+
+// Acquisition configuration - the FIFO is drained every loop, so the loop only
+// has to come around once per watermark period (40 ms at 400 Hz)
+const Adxl345Rate ACQUISITION_RATE = ADXL345_ODR_400_HZ;
+const uint8_t FIFO_WATERMARK = 16;
+
+// Acquisition task - owns the sensor, the filter and event detection. It runs
+// pinned to the app core above loop() so networking and UI can never stall it.
+const TickType_t ACQUISITION_PERIOD = pdMS_TO_TICKS(10);
+const uint32_t ACQUISITION_STACK_SIZE = 4096;
+const UBaseType_t ACQUISITION_PRIORITY = 5; // loop() runs at priority 1
+TaskHandle_t acquisitionTaskHandle = NULL;
+SemaphoreHandle_t acquisitionMutex = NULL; // Held while draining; taken to stop/start the FIFO
+
+// Samples published by the acquisition task for the UI and network consumers
+// (counts throughout; converted to m/s² only for display and JSON)
+struct ProcessedSample {
+  RawSample raw;             // Counts as read from the FIFO
+  RawSample dev;             // Band-passed deviations after the noise gate, rounded to counts
+  uint8_t mercalli;
+  bool triggered;            // Some axis is in the triggered state
+  float sta_lta;             // Highest per-axis STA/LTA ratio
+  float mmi;                 // Fractional intensity by regression
+  int64_t time_us;           // esp_timer when the sensor took the sample
+};
+SpscRing<ProcessedSample, 512> sampleRing; // ~1.3 s at 400 Hz
+SpscRing<SeismicEvent, 8> eventRing;       // Detected events waiting to be logged
+ProcessedSample latestSample = {};         // Newest sample seen by loop()
+
+// Event waveforms - raw counts are block-averaged down to WAVEFORM_RATE and the
+// last WAVEFORM_PRE_SECONDS are kept; a logged event freezes them together with
+// the post-trigger window into one of WAVEFORM_SLOTS slots (oldest reused first)
+const float WAVEFORM_RATE = 100.0;
+const float WAVEFORM_PRE_SECONDS = 10.0;
+#define WAVEFORM_SLOTS 3
+#define WAVEFORM_PRE_SAMPLES 1000   // WAVEFORM_PRE_SECONDS at WAVEFORM_RATE
+#define WAVEFORM_SLOT_SAMPLES 3000  // Pre plus the longest post window (20 s)
+float waveform_post_seconds = 20.0; // Station setting waveform_post_seconds
+RawSample waveformPreBuffer[WAVEFORM_PRE_SAMPLES];
+RawSample waveformStorage[WAVEFORM_SLOTS * WAVEFORM_SLOT_SAMPLES]; // 54 KB, allocated once
+WaveformCapture waveform;
+Decimator waveformDecimator;
+
 // Variables for seismometer data
-float x_accel, y_accel, z_accel;
-float magnitude;
 unsigned long lastUpdate = 0;
-const unsigned long updateInterval = 100; // Update every 100ms
+unsigned long updateInterval = 100; // ms between BLE notifications, station setting update_interval_ms
+
+// Band-pass filter, noise gate, peak tracking and event decisions (owned by the acquisition task)
+Detector detector;
+volatile bool resetRequested = false; // Set by any task, handled by the acquisition task
+volatile bool eventHistoryResetRequested = false;
+
+// Ground motion of the newest logged event, gathered by the acquisition task
+// for as long as the detector stays triggered and picked up by loop() when
+// the event is stored. A new trigger would restart the detector's own event
+// peaks, so they are folded in here instead.
+MotionPeaks loggedEventMotion = {};
+portMUX_TYPE eventMotionLock = portMUX_INITIALIZER_UNLOCKED;
+
+// CPU cycles spent in detector.update() per sample, written by the acquisition task
+volatile float detectorCyclesAvg = 0;  // Exponential average over ~64 samples
+volatile uint32_t detectorCyclesMax = 0;
+
+// Where the time goes: CPU cycles per call of each stage, recorded by the task
+// that runs it and exported on /metrics. Timings include any preemption.
+enum Stage {
+  STAGE_SENSOR_READ,   // FIFO drain (acquisition task)
+  STAGE_DETECTION,     // detector.update(), per sample (acquisition task)
+  STAGE_DISPLAY_FLUSH, // OLED transfer slice (acquisition task)
+  STAGE_DISPLAY_DRAW,  // updateDisplay() (loop)
+  STAGE_BLE_NOTIFY,    // sendBleFrames() (loop)
+  STAGE_SERIAL,        // checkForSerialCommand() (loop)
+  STAGE_SPECTRUM,      // updateSpectrum() (loop)
+  STAGE_JMA,           // updateJmaIntensity(), per block (loop)
+  STAGE_HTTP,          // Route handlers (async_tcp task); chunked bodies render later
+  STAGE_COUNT
+};
+const char* const STAGE_NAMES[STAGE_COUNT] = {
+  "sensor_read", "detection", "display_flush", "display_draw",
+  "ble_notify", "serial_command", "spectrum", "jma_intensity", "http_handler"
+};
+const uint8_t CYCLE_HISTOGRAM_SHIFT = 8;  // First bucket below 256 cycles (~1 us at 240 MHz)
+const uint8_t MICROS_HISTOGRAM_SHIFT = 4; // First bucket below 16 us
+LatencyHistogram stageCycles[STAGE_COUNT];
+// Scheduling: how far each acquisition wake-up is from the 10 ms period, how
+// long loop() takes to come around, and how often either missed its deadline
+// (a skipped acquisition period; a loop pass slower than the BLE interval)
+LatencyHistogram acquisitionJitter(MICROS_HISTOGRAM_SHIFT);
+LatencyHistogram loopInterval(MICROS_HISTOGRAM_SHIFT);
+volatile uint32_t acquisitionMissedDeadlines = 0;
+volatile uint32_t loopMissedDeadlines = 0;
+
+// Cycles since startCycles, for one stage
+inline void recordStage(Stage stage, uint32_t startCycles) {
+  stageCycles[stage].record(ESP.getCycleCount() - startCycles);
+}
+
+// Boot timeline - when each part of the start-up began and ended, in ms of
+// millis() (the timer starts shortly after reset; the ROM and second-stage
+// bootloader before it are not counted). Sampling is brought up first and
+// everything else while it runs, so the acquisition phase ends at the first
+// sample. Exported on /metrics and printed by METRICS.
+enum BootPhase {
+  BOOT_CONFIG,      // NVS settings (setup)
+  BOOT_SENSORS,     // I2C, display and accelerometer (setup)
+  BOOT_ACQUISITION, // FIFO, detector and task, up to the first sample drained
+  BOOT_CALIBRATION, // Restored from NVS, or measured (acquisition task)
+  BOOT_ANALYSIS,    // Spectrum and JMA filter design (setup)
+  BOOT_EVENT_STORE, // LittleFS mount (setup)
+  BOOT_BLE,         // (setup)
+  BOOT_WIFI,        // Until connected, or the access point is up (loop)
+  BOOT_NTP,         // Until the first valid sync (lwIP task)
+  BOOT_PHASE_COUNT
+};
+const char* const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+  "config", "sensors", "acquisition", "calibration", "analysis", "event_store", "ble", "wifi", "ntp"
+};
+volatile int32_t bootPhaseStartMs[BOOT_PHASE_COUNT]; // -1 until the phase begins
+volatile int32_t bootPhaseEndMs[BOOT_PHASE_COUNT];   // -1 until it ends
 
-// Peak value tracking (deviation from baseline)
-float x_peak = 0, y_peak = 0, z_peak = 0;
-float magnitude_peak = 0;
-float deviation_magnitude_peak = 0; // Track peak deviation magnitude separately
-int mercalli_peak = 0;
-bool resetRequested = false;
+// Only the first begin and end count; later recalibrations and NTP syncs are
+// not part of the boot
+inline void beginBootPhase(BootPhase phase) {
+  if (bootPhaseStartMs[phase] < 0) bootPhaseStartMs[phase] = (int32_t)millis();
+}
 
-// Moving baseline for detecting changes
-float x_baseline = 0, y_baseline = 0, z_baseline = 0;
-const float baseline_alpha = 0.95; // Smoothing factor for baseline (higher = slower adaptation)
-const int baseline_samples = 20; // Number of samples before starting peak detection
-int sample_count = 0;
+inline void endBootPhase(BootPhase phase) {
+  if (bootPhaseStartMs[phase] >= 0 && bootPhaseEndMs[phase] < 0) bootPhaseEndMs[phase] = (int32_t)millis();
+}
 
 // Noise filtering
 float noise_threshold = 0.1; // Will be automatically determined during calibration
 
-// Software calibration offsets (applied in software, not hardware)
-float calibration_offset_x = 0;
-float calibration_offset_y = 0;
-float calibration_offset_z = 0;
+// Software calibration offsets in counts (applied in software, not hardware)
+int16_t calibration_offset_x = 0;
+int16_t calibration_offset_y = 0;
+int16_t calibration_offset_z = 0;
 bool calibrated = false;
+bool calibrationRestored = false; // Offsets from NVS, not measured since boot
+
+// Calibration runs in the acquisition task on the live samples, bypassing the
+// detector until it is done; the web server and BLE carry on meanwhile
+Calibrator calibrator;
+volatile bool calibrationRequested = false; // Set by any task, handled by the acquisition task
+uint32_t calibrationCount = 0;              // Completed since boot (acquisition task)
+
+// Detector and calibrator state, copied by the acquisition task after each
+// pass. Nothing outside that task reads the detector or calibrator: the web
+// handlers copy detectorSnapshot under webStateMutex, loop() reads
+// loopSnapshot, its own copy taken once per pass.
+struct DetectorSnapshot {
+  DetectorPeaks peaks;           // Counts, as the detector keeps them
+  float ms2_per_count;
+  float noise_threshold;         // The gate in use (m/s²)
+  IntensityMode intensity_mode;
+  int filter_sections;
+  bool baseline_ready;
+  int baseline_progress;
+  int baseline_target;
+  bool calibrating;
+  int calibration_progress;
+  bool calibration_good;
+  bool calibrated;
+  bool calibration_restored;     // From NVS, not measured since boot
+  int16_t offset_x, offset_y, offset_z; // Calibration in use (counts)
+  float calibration_threshold;   // Its noise threshold (m/s²)
+  uint32_t calibrations;         // Completed since boot...
+  CalibrationResult calibration; // ...and the latest of them
+  bool noise_valid;
+  bool noise_adapting;
+  int noise_window_progress;
+  uint32_t noise_windows;
+  float noise_sigma[3];          // Counts
+  uint32_t noise_history_count;
+  float noise_history[NOISE_FLOOR_HISTORY]; // Counts, oldest first
+};
+DetectorSnapshot detectorSnapshot = {}; // Under webStateMutex
+DetectorSnapshot loopSnapshot = {};     // Owned by loop()
 
 // Button pin for reset (optional - can use serial command instead)
 #define RESET_BUTTON_PIN 4  // Changed to GPIO4; GPIO2 can be problematic on some boards.
 
 // Function declarations
 void updateDisplay();
-void resetPeakValues();
+void drawDisplayLayout(DisplayLayout layout);
+void drawField(DisplayField& field, const char* text);
+void showDisplay();
+void startAcquisition();
+void startAcquisitionTask();
+void acquisitionTask(void* parameter);
+void processSample(const RawSample& raw, int64_t time_us);
+void captureDetectorSnapshot(DetectorSnapshot& snapshot);
+void trackEventMotion(bool restart);
+int16_t roundCounts(float counts);
+float deviationMagnitude(const RawSample& dev);
+void requestPeakReset();
+void showResetScreen();
+void holdDisplay(unsigned long duration);
 void checkForSerialCommand();
-void calibrateAccelerometer();
-int calculateMercalli(float magnitude);
-void setupWifi();
+void startCalibration();
+void applyCalibration();
+void reportCalibration(const CalibrationResult& result);
+void restoreCalibration();
+void saveCalibration(const CalibrationResult& result, float ms2_per_count);
+bool haveWifiCredentials();
+void startNetwork();
+void updateNetwork();
+void startWebServer();
 void startAccessPoint();
 void setupBLE();
-void handleRoot();
-void handleData();
-void handleReset();
-void handleBleViewer();
-void handleWifiConfig();
-void handleWifiSave();
-String getSensorDataJson();
-void saveWifiCredentials();
-void loadWifiCredentials();
+bool accessPointActive();
+void updateWifiScan();
+void setupWebServer();
+void lockWebState();
+void unlockWebState();
+void handleRoot(AsyncWebServerRequest* request);
+void handleData(AsyncWebServerRequest* request);
+void handleReset(AsyncWebServerRequest* request);
+void handleBleViewer(AsyncWebServerRequest* request);
+void handleWifiConfig(AsyncWebServerRequest* request);
+void handleWifiSave(AsyncWebServerRequest* request);
+void writeSensorDataJson(JsonWriter& json);
+void loadStationConfig();
+void updateStationConfig();
+void applyConfigChanges(const StationConfig& next, bool initial);
+const char* changeStationConfig(const char* name, const char* value);
+void reportConfigChange(const char* name, const char* value);
+void printStationConfig();
+void handleConfigParams(AsyncWebServerRequest* request);
+void handleConfigParamsUpdate(AsyncWebServerRequest* request);
+void setPushTargetAddress(PushTarget& target, const char* address);
+bool resolvePushTarget(PushTarget& target);
+bool sendPushPacket(PushTarget& target, WiFiUDP& udp, const uint8_t* data, size_t length);
+void printPushTarget(const PushTarget& target);
+void updateCollector();
+void trackCollectorTrigger(const ProcessedSample& sample);
+void sendTriggerPacket(uint8_t type, int64_t local_us, float staLta, float magnitude, uint8_t mercalli);
+void queueTelemetrySample(const RawSample& sample, int64_t time_us);
 void printStatus();
 void initializeTime();
-void logSeismicEvent(float mercalli, float x, float y, float z, float mag);
+void onTimeSync(struct timeval* tv);
+bool clockToUtc(int64_t local_us, time_t* seconds, uint16_t* ms);
+ClockModel clockSnapshot();
+void logSeismicEvent(float mercalli, float x, float y, float z, float mag, int64_t onset_us);
+void storeSeismicEvent(SeismicEvent& event);
+void appendStoredEvent(const SeismicEvent& event);
+void timestampPendingEvents();
+bool eventUtc(uint32_t boot, int64_t onset_us, time_t* seconds, uint16_t* ms);
+void formatEventTime(time_t timestamp, uint16_t ms, uint32_t boot, int64_t onset_us, char* buffer, size_t size);
+void fillEventMotion(SeismicEvent& event);
 void clearEventLog();
-void handleEvents();
-void handleClearEvents();
-String getEventsJson();
-String formatTimestamp(time_t timestamp);
+void setupEventStore();
+void handleEventExport(AsyncWebServerRequest* request);
+void handleEvents(AsyncWebServerRequest* request);
+void handleClearEvents(AsyncWebServerRequest* request);
+void handleWaveform(AsyncWebServerRequest* request);
+void setupSpectrum();
+bool updateSpectrum();
+void setupJmaIntensity();
+void updateJmaIntensity();
+void handleSpectrum(AsyncWebServerRequest* request);
+void handleMetrics(AsyncWebServerRequest* request);
+void printMetrics();
+void benchmarkFft();
+void resetBleStream();
+void queueBleSample(const RawSample& sample, uint32_t time_ms);
+void sendBleFrames();
+void queueStreamSample(const RawSample& sample, uint32_t time_ms);
+void publishStreamFrame();
+void writeEventSummaryJson(JsonWriter& json);
+void formatTimestamp(time_t timestamp, char* buffer, size_t size);
+void formatTimestamp(time_t timestamp, uint16_t ms, char* buffer, size_t size);
 
 // BLE Callback Classes
 class MyServerCallbacks: public BLEServerCallbacks {
@@ -193,22 +706,35 @@ class ResetCharacteristicCallbacks: public BLECharacteristicCallbacks {
         std::string value = pCharacteristic->getValue();
         if (value.length() > 0) {
             Serial.println("BLE: Reset command received");
-            resetPeakValues();
+            requestPeakReset();
         }
     }
 };
 
 void setup() {
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) bootPhaseStartMs[i] = bootPhaseEndMs[i] = -1;
+  for (int i = 0; i < STAGE_COUNT; i++) stageCycles[i].configure(CYCLE_HISTOGRAM_SHIFT);
   Serial.begin(115200);
-  EEPROM.begin(EEPROM_SIZE);
-  loadWifiCredentials();
-  
-  // Initialize I2C
+  acquisitionMutex = xSemaphoreCreateMutex();
+  webStateMutex = xSemaphoreCreateMutex();
+  
+  // Only what sampling needs comes before it: the settings (thresholds and
+  // the stored calibration) and the sensors. A station restarted by a
+  // brown-out during an aftershock sequence is blind until then.
+  beginBootPhase(BOOT_CONFIG);
+  loadStationConfig();
+  endBootPhase(BOOT_CONFIG);
+  
+  beginBootPhase(BOOT_SENSORS);
+  // Initialize I2C (400 kHz is needed to drain the FIFO at 400 Hz and up)
   Wire.begin();
+  Wire.setClock(400000);
   
   // Initialize reset button (optional)
   pinMode(RESET_BUTTON_PIN, INPUT_PULLUP);
   
+  waveform.begin(waveformPreBuffer, WAVEFORM_PRE_SAMPLES, waveformStorage, WAVEFORM_SLOT_SAMPLES, WAVEFORM_SLOTS);
+  
   // Initialize the display
   if(!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
     Serial.println(F("SSD1306 allocation failed"));
@@ -223,14 +749,34 @@ void setup() {
     display.setTextColor(SSD1306_WHITE);
     display.setCursor(0,0);
     display.println(ADXL345_ERROR);
-    display.display();
+    showDisplay();
     for(;;); // Don't proceed, loop forever
   }
   
   // Set accelerometer range (optional)
   accel.setRange(ADXL345_RANGE_4_G);
   
-  // Show splash screen
+  // Offsets are applied in software; clear any left in the sensor
+  for (uint8_t reg = ADXL345_REG_OFSX; reg <= ADXL345_REG_OFSZ; reg++) {
+    accelBus.writeRegister(reg, 0);
+  }
+  endBootPhase(BOOT_SENSORS);
+  
+  // From here on sampling and detection run in their own task, with the
+  // stored calibration or, without one, calibrating on the first samples.
+  // The phase ends when the task drains its first samples.
+  beginBootPhase(BOOT_ACQUISITION);
+  startAcquisition();
+  restoreCalibration();
+  startAcquisitionTask();
+  
+  // Everything else is brought up while it samples
+  beginBootPhase(BOOT_ANALYSIS);
+  setupSpectrum();
+  setupJmaIntensity();
+  endBootPhase(BOOT_ANALYSIS);
+  
+  // Show splash screen; loop() leaves it up for DISPLAY_HOLD_TIME
   display.clearDisplay();
   display.setTextColor(SSD1306_WHITE);
   
@@ -249,66 +795,53 @@ void setup() {
   display.setCursor((SCREEN_WIDTH - text_width) / 2, 45);
   display.println(SPLASH_COPYRIGHT);
   
-  display.display();
-
-  delay(2000);
+  showDisplay();
+  holdDisplay(DISPLAY_HOLD_TIME);
   
-  // Setup WiFi and display IP
-  setupWifi();
+  beginBootPhase(BOOT_EVENT_STORE);
+  setupEventStore();
+  endBootPhase(BOOT_EVENT_STORE);
   
-  // Start web server if WiFi is connected OR in AP mode
-  if (WiFi.status() == WL_CONNECTED || WiFi.getMode() == WIFI_AP) {
-    Serial.println(F("Setting up web server routes..."));
-    server.on("/", HTTP_GET, handleRoot);
-    server.on("/data", HTTP_GET, handleData);
-    server.on("/reset", HTTP_POST, handleReset);
-    server.on("/ble", HTTP_GET, handleBleViewer);
-    server.on("/config", HTTP_GET, handleWifiConfig);
-    server.on("/save", HTTP_POST, handleWifiSave);
-    server.on("/events", HTTP_GET, handleEvents);
-    server.on("/clearevents", HTTP_POST, handleClearEvents);
-
-    
-    // Add catch-all handler for debugging
-    server.onNotFound([](){
-      server.send(404, "text/plain", "Not found");
-    });
-    
-    server.begin();
-    Serial.println("Web server started successfully");
-    Serial.print(F("Server listening on: "));
-    if (WiFi.getMode() == WIFI_AP) {
-      Serial.println(F("192.168.4.1"));
-    } else {
-      Serial.println(WiFi.localIP());
-      // Initialize NTP time sync when connected to internet
-      initializeTime();
-    }
-  } else {
-    Serial.println(F("No WiFi connection - web server not started"));
-  }
-
-  // Setup BLE
-  setupBLE();
-
-  // Calibrate the accelerometer
-  calibrateAccelerometer();
+  // Low four bytes of the factory MAC, readable before WiFi is started
+  uint64_t mac = ESP.getEfuseMac();
+  for (int i = 2; i < 6; i++) stationId = (stationId << 8) | (uint8_t)(mac >> (8 * i));
   
-  // Reset peak values after calibration to start fresh
-  resetPeakValues();
+  // Returns at once; loop() finishes the connection, then starts the web
+  // server and NTP
+  startNetwork();
   
+  beginBootPhase(BOOT_BLE);
+  setupBLE();
+  endBootPhase(BOOT_BLE);
   
   Serial.println(F("Seismometer initialized successfully."));
-  Serial.println(F("Available serial commands: STATUS, RESET, CLEAREVENTS, CALIBRATE, SSID <name>, PASS <password>, BOOT"));
+  Serial.println(F("Available serial commands: STATUS, RESET, CLEAREVENTS, CALIBRATE, WAVEPOST <seconds>, STREAMRATE <hz>, FFTBENCH, METRICS, INTENSITY <THRESHOLDS|REGRESSION>, CONFIG, SET <name> <value>, COLLECTOR <host[:port]|OFF>, TELEMETRY <host[:port]|OFF>, SSID <name>, PASS <password>, BOOT"));
   Serial.println(F("Press button on GPIO 4 to reset peak values."));
-  
-  if (WiFi.getMode() == WIFI_AP) {
-    Serial.println(F("*** Access Point Mode Active ***"));
-    Serial.println(F("Connect to the AP and go to http://192.168.4.1 to configure WiFi"));
-  }
 }
 
 void loop() {
+  // Time between passes; anything slower than the BLE interval is a miss
+  static int64_t lastLoopStart = 0;
+  int64_t loopStart = esp_timer_get_time();
+  if (lastLoopStart != 0) {
+    uint32_t gap = (uint32_t)(loopStart - lastLoopStart);
+    loopInterval.record(gap);
+    if (gap > updateInterval * 1000) loopMissedDeadlines++;
+  }
+  lastLoopStart = loopStart;
+  
+  // WiFi connection or access point, then the web server and NTP
+  updateNetwork();
+  
+  // Once, when sampling has started: how long it took from reset
+  static bool bootReported = false;
+  if (!bootReported && bootPhaseEndMs[BOOT_ACQUISITION] >= 0) {
+    bootReported = true;
+    Serial.print(F("Boot: first sample "));
+    Serial.print(bootPhaseEndMs[BOOT_ACQUISITION]);
+    Serial.println(F(" ms after reset (METRICS for the timeline)"));
+  }
+  
   // Ensure WiFi mode stability - if we're supposed to be in AP mode but lost it, restart AP
   static bool wasInApMode = false;
   static unsigned long lastModeCheck = 0;
@@ -316,7 +849,7 @@ void loop() {
   if (millis() - lastModeCheck >= 5000) { // Check every 5 seconds
     lastModeCheck = millis();
     
-    if (WiFi.getMode() == WIFI_AP) {
+    if (accessPointActive()) {
       wasInApMode = true;
     } else if (wasInApMode && WiFi.status() != WL_CONNECTED) {
       // We were in AP mode but lost it, and we're not connected to a WiFi network
@@ -325,221 +858,666 @@ void loop() {
     }
   }
   
-  // Handle web server requests
-  if (WiFi.status() == WL_CONNECTED || WiFi.getMode() == WIFI_AP) {
-    server.handleClient();
+  // Background WiFi scan for /config
+  if (WiFi.status() == WL_CONNECTED || accessPointActive()) {
+    updateWifiScan();
+  }
+  
+  // Settings changed by /config/params, /save or a serial command
+  updateStationConfig();
+  
+  // Restart requested by /save, once its reply has gone out
+  if (restartAt != 0 && (long)(millis() - restartAt) >= 0) {
+    Serial.println("Rebooting to apply new WiFi settings...");
+    ESP.restart();
   }
 
   // Check for reset command
+  uint32_t serialStart = ESP.getCycleCount();
   checkForSerialCommand();
+  recordStage(STAGE_SERIAL, serialStart);
   
   // Add periodic status check every 60 seconds
   static unsigned long lastStatusCheck = 0;
   if (millis() - lastStatusCheck >= 60000) {
     lastStatusCheck = millis();
-    if (WiFi.getMode() == WIFI_AP) {
+    if (accessPointActive()) {
       Serial.print(F("AP Mode - Connected clients: "));
       Serial.println(WiFi.softAPgetStationNum());
     }
   }
   
-  if (millis() - lastUpdate >= updateInterval) {
-    // Get a new sensor reading
-    sensors_event_t event;
-    accel.getEvent(&event);
-    
-    // Store accelerometer values and apply software calibration
-    x_accel = event.acceleration.x + calibration_offset_x;
-    y_accel = event.acceleration.y + calibration_offset_y;
-    z_accel = event.acceleration.z + calibration_offset_z;
-    
-    // Calculate magnitude of acceleration vector
-    magnitude = sqrt(x_accel*x_accel + y_accel*y_accel + z_accel*z_accel);
+  // A new BLE client starts with an empty sample queue
+  static bool bleWasConnected = false;
+  if (deviceConnected && !bleWasConnected) resetBleStream();
+  bleWasConnected = deviceConnected;
+  
+  // The detector state this pass works from
+  lockWebState();
+  loopSnapshot = detectorSnapshot;
+  unlockWebState();
+  
+  // Consume whatever the acquisition task has published since the last pass
+  ProcessedSample sample;
+  bool newSample = false;
+  bool streaming = liveStream.count() > 0;
+  while (sampleRing.pop(sample)) {
+    newSample = true;
     
-    // Update moving baseline (exponential moving average)
-    if (sample_count < baseline_samples) {
-      // Initial baseline establishment
-      x_baseline = x_accel;
-      y_baseline = y_accel;
-      z_baseline = z_accel;
-      sample_count++;
-    } else {
-      // Slowly adapt baseline to current position
-      x_baseline = baseline_alpha * x_baseline + (1.0 - baseline_alpha) * x_accel;
-      y_baseline = baseline_alpha * y_baseline + (1.0 - baseline_alpha) * y_accel;
-      z_baseline = baseline_alpha * z_baseline + (1.0 - baseline_alpha) * z_accel;
-      
-      // Calculate deviations from baseline
-      float x_deviation = abs(x_accel - x_baseline);
-      float y_deviation = abs(y_accel - y_baseline);
-      float z_deviation = abs(z_accel - z_baseline);
-      
-      // Apply noise threshold - ignore small deviations
-      if (x_deviation < noise_threshold) x_deviation = 0;
-      if (y_deviation < noise_threshold) y_deviation = 0;
-      if (z_deviation < noise_threshold) z_deviation = 0;
-      
-      // Calculate deviation magnitude
-      float deviation_magnitude = sqrt(x_deviation*x_deviation + y_deviation*y_deviation + z_deviation*z_deviation);
-      
-      // Update peak deviations
-      if (x_deviation > x_peak) x_peak = x_deviation;
-      if (y_deviation > y_peak) y_peak = y_deviation;
-      if (z_deviation > z_peak) z_peak = z_deviation;
-      
-      // Update peak deviation magnitude and Mercalli (based on deviation, not raw magnitude)
-      if (deviation_magnitude > deviation_magnitude_peak) {
-        deviation_magnitude_peak = deviation_magnitude;
-        mercalli_peak = calculateMercalli(deviation_magnitude_peak);
-      }
-      
-      // Log significant seismic events when connected to internet
-      if (timeInitialized) {
-        int current_mercalli = calculateMercalli(deviation_magnitude);
-        
-        // Log events that are:
-        // 1. Mercalli V (5) and above - always log if higher than last OR interval passed
-        // 2. Mercalli III-IV - log if interval passed AND higher than last
-        // 3. Always log if increase is significant (2+ Mercalli levels), regardless of time
-        bool shouldLog = false;
-        bool intervalPassed = (millis() - lastEventTime >= MIN_EVENT_INTERVAL);
-        bool isHigherThanLast = (current_mercalli > lastLoggedMercalli);
-        bool significantIncrease = (current_mercalli - lastLoggedMercalli >= 2);
-        
-        if (current_mercalli >= 5) {
-          // Always log Mercalli V and above if enough time has passed OR if it's higher than last
-          shouldLog = intervalPassed || isHigherThanLast;
-        } else if (current_mercalli >= 3) {
-          // Log Mercalli III-IV if interval passed and higher, OR if it's a significant jump
-          shouldLog = (intervalPassed && isHigherThanLast) || significantIncrease;
-        }
-        
-        if (shouldLog) {
-          // Use current values, not peak values for event logging
-          float x_dev = abs(x_accel - x_baseline);
-          float y_dev = abs(y_accel - y_baseline);
-          float z_dev = abs(z_accel - z_baseline);
-          if (x_dev < noise_threshold) x_dev = 0;
-          if (y_dev < noise_threshold) y_dev = 0;
-          if (z_dev < noise_threshold) z_dev = 0;
-          
-          logSeismicEvent(current_mercalli, x_dev, y_dev, z_dev, deviation_magnitude);
-          lastLoggedMercalli = current_mercalli;
-          lastEventTime = millis();
-        }
-      }
-      
-      // Still track raw magnitude peak for reference
-      if (magnitude > magnitude_peak) {
-        magnitude_peak = magnitude;
-      }
+    RawSample decimated;
+    if (spectrumDecimator.push(sample.raw, decimated)) {
+      spectrum.push(decimated);
+      if (jma.push(decimated)) updateJmaIntensity();
     }
     
-    // Update display
+    RawSample live;
+    if (liveDecimator.push(sample.dev, live)) {
+      uint32_t time_ms = (uint32_t)(sample.time_us / 1000);
+      if (deviceConnected) queueBleSample(live, time_ms);
+      if (streaming) queueStreamSample(live, time_ms);
+      if (telemetryTarget.resolved) queueTelemetrySample(live, sample.time_us);
+    }
+    trackCollectorTrigger(sample);
+  }
+  if (newSample) {
+    lockWebState();
+    latestSample = sample;
+    unlockWebState();
+  }
+  
+  // Live stream frames
+  static unsigned long lastStreamFrame = 0;
+  if (streaming && millis() - lastStreamFrame >= 1000UL / streamRateHz) {
+    lastStreamFrame = millis();
+    publishStreamFrame();
+  }
+  
+  updateCollector();
+  
+  static unsigned long lastSpectrum = 0;
+  if (millis() - lastSpectrum >= SPECTRUM_INTERVAL) {
+    lastSpectrum = millis();
+    updateSpectrum();
+  }
+  
+  if (jmaResetRequested) {
+    jmaResetRequested = false;
+    jma.resetPeak();
+    lockWebState();
+    jmaIntensityPeak = jma.valid() ? jma.peak() : NAN;
+    unlockWebState();
+  }
+  if (resetScreenRequested) {
+    resetScreenRequested = false;
+    Serial.println("Peak values and baseline reset.");
+    showResetScreen();
+    holdDisplay(RESET_HOLD_TIME);
+  }
+  
+  // Events logged before the first sync get their time once it arrives
+  static bool eventsSynced = false;
+  bool synced = timeInitialized;
+  if (synced && !eventsSynced) timestampPendingEvents();
+  eventsSynced = synced;
+  
+  // Events are at least min_event_interval_ms apart, so one is held back at a time
+  if (!eventPending && eventRing.pop(pendingEvent)) {
+    eventPending = true;
+    eventSpectrumDone = false;
+    eventPendingSince = millis();
+    eventJmaIntensity = jma.valid() ? jma.intensity() : NAN;
+  }
+  if (eventPending && !eventSpectrumDone && millis() - eventPendingSince >= SPECTRUM_EVENT_DELAY) {
+    pendingEvent.dominant_hz = updateSpectrum() ? spectrumResult.dominant_hz : 0;
+    eventSpectrumDone = true;
+  }
+  if (eventPending && millis() - eventPendingSince >= JMA_EVENT_DELAY) {
+    pendingEvent.jma_intensity = eventJmaIntensity;
+    fillEventMotion(pendingEvent);
+    storeSeismicEvent(pendingEvent);
+    eventPending = false;
+  }
+  
+  static uint32_t calibrationsReported = 0;
+  if (loopSnapshot.calibrations != calibrationsReported) {
+    calibrationsReported = loopSnapshot.calibrations;
+    reportCalibration(loopSnapshot.calibration);
+    if (loopSnapshot.calibration.good) saveCalibration(loopSnapshot.calibration, loopSnapshot.ms2_per_count);
+  }
+  
+  // Redraw changed fields; the refresh rate is capped separately from sampling,
+  // and a one-off screen is left up for DISPLAY_HOLD_TIME first
+  static unsigned long lastDisplayUpdate = 0;
+  if (displayHoldStart != 0 && millis() - displayHoldStart >= displayHoldTime) displayHoldStart = 0;
+  if (displayHoldStart == 0 && millis() - lastDisplayUpdate >= DISPLAY_REFRESH_INTERVAL) {
+    lastDisplayUpdate = millis();
+    uint32_t start = ESP.getCycleCount();
     updateDisplay();
-
+    recordStage(STAGE_DISPLAY_DRAW, start);
+  }
+  
+  // Display bus usage over the last second
+  static unsigned long lastDisplayStats = 0;
+  static uint32_t lastDisplayBytes = 0;
+  static uint32_t lastDisplayMicros = 0;
+  unsigned long statsElapsed = millis() - lastDisplayStats;
+  if (statsElapsed >= 1000) {
+    uint32_t bytes = oledFlusher.bytesSent();
+    uint32_t transferMicros = displayTransferMicros;
+    displayBytesPerSecond = (bytes - lastDisplayBytes) * 1000.0f / statsElapsed;
+    displayTransferMsPerSecond = (transferMicros - lastDisplayMicros) / (float)statsElapsed;
+    lastDisplayBytes = bytes;
+    lastDisplayMicros = transferMicros;
+    lastDisplayStats = millis();
+  }
+  
+  if (millis() - lastUpdate >= updateInterval) {
     // Notify BLE client if connected
     if (deviceConnected) {
-      String jsonData = getSensorDataJson();
-      pDataCharacteristic->setValue(jsonData.c_str());
-      pDataCharacteristic->notify();
+      uint32_t start = ESP.getCycleCount();
+      sendBleFrames();
+      recordStage(STAGE_BLE_NOTIFY, start);
     }
     
     lastUpdate = millis();
   }
 }
 
+void startAcquisition() {
+  xSemaphoreTake(acquisitionMutex, portMAX_DELAY);
+  if (!accelFifo.begin(ACQUISITION_RATE, FIFO_WATERMARK)) {
+    xSemaphoreGive(acquisitionMutex);
+    Serial.println(F("ERROR: Failed to start ADXL345 FIFO"));
+    return;
+  }
+  
+  // Filter coefficients and detector windows follow the actual sample rate
+  float rate = accelFifo.sampleRateHz();
+  DetectorConfig config = defaultDetectorConfig(rate);
+  config.noise_threshold = noise_threshold;
+  applyStationConfig(appliedConfig, config);
+  detector.configure(config);
+  lockWebState();
+  captureDetectorSnapshot(detectorSnapshot); // The scale, before the first pass publishes
+  unlockWebState();
+  
+  uint32_t decimation = (uint32_t)(rate / WAVEFORM_RATE + 0.5f);
+  waveformDecimator.setFactor(decimation);
+  float waveformRate = rate / waveformDecimator.getFactor();
+  liveDecimator.setFactor((uint32_t)(rate / LIVE_SAMPLE_RATE + 0.5f));
+  liveSampleRate = rate / liveDecimator.getFactor();
+  waveform.configure(waveformRate, (uint32_t)(WAVEFORM_PRE_SECONDS * waveformRate),
+                     (uint32_t)(waveform_post_seconds * waveformRate));
+  xSemaphoreGive(acquisitionMutex);
+  
+  Serial.print(F("ADXL345 FIFO streaming at "));
+  Serial.print(rate, 0);
+  Serial.println(F(" Hz"));
+}
+
+void startAcquisitionTask() {
+  if (acquisitionTaskHandle != NULL) return;
+  
+  xTaskCreatePinnedToCore(acquisitionTask, "acquisition", ACQUISITION_STACK_SIZE, NULL,
+                          ACQUISITION_PRIORITY, &acquisitionTaskHandle, APP_CPU_NUM);
+  Serial.println(F("Acquisition task started"));
+}
+
+void acquisitionTask(void* parameter) {
+  TickType_t lastWake = xTaskGetTickCount();
+  const uint32_t tick_period_us = ACQUISITION_PERIOD * portTICK_PERIOD_MS * 1000;
+  int64_t lastWoke = 0;
+  
+  for (;;) {
+    // The FIFO buffers 80 ms at 400 Hz, so a 10 ms period leaves plenty of slack
+    vTaskDelayUntil(&lastWake, ACQUISITION_PERIOD);
+    
+    // Jitter is the distance of each wake-up interval from the period; a
+    // whole period skipped is a missed deadline
+    int64_t woke = esp_timer_get_time();
+    if (lastWoke != 0) {
+      uint32_t interval = (uint32_t)(woke - lastWoke);
+      acquisitionJitter.record(interval > tick_period_us ? interval - tick_period_us : tick_period_us - interval);
+      if (interval >= 2 * tick_period_us) acquisitionMissedDeadlines++;
+    }
+    lastWoke = woke;
+    
+    xSemaphoreTake(acquisitionMutex, portMAX_DELAY);
+    if (resetRequested) {
+      detector.reset();
+      detectorCyclesMax = 0;
+      resetRequested = false;
+    }
+    if (eventHistoryResetRequested) {
+      detector.resetEventHistory();
+      eventHistoryResetRequested = false;
+    }
+    if (calibrationRequested) {
+      calibrator.start(defaultCalibrationConfig(accelFifo.sampleRateHz(), detector.config().ms2_per_count));
+      calibrationRequested = false;
+    }
+    
+    // Drain everything the sensor has queued since the last pass. The FIFO
+    // level is read first, when the newest entry is between 0 and 1 sample
+    // periods old; the others are back-dated a period each from there.
+    int64_t drainStart = esp_timer_get_time();
+    uint32_t readStart = ESP.getCycleCount();
+    size_t count = accelFifo.drain(fifoBuffer, ADXL345_FIFO_DEPTH);
+    recordStage(STAGE_SENSOR_READ, readStart);
+    if (count > 0) endBootPhase(BOOT_ACQUISITION);
+    float sample_period_us = 1e6f / accelFifo.sampleRateHz();
+    int64_t newest_us = drainStart - (int64_t)(sample_period_us / 2);
+    for (size_t i = 0; i < count; i++) {
+      processSample(fifoBuffer[i], newest_us - (int64_t)((count - 1 - i) * sample_period_us));
+    }
+    static DetectorSnapshot snapshot;
+    captureDetectorSnapshot(snapshot);
+    xSemaphoreGive(acquisitionMutex);
+    
+    // Publish without waiting: a reader holding the lock only costs it this
+    // pass, the next one publishes 10 ms later
+    if (xSemaphoreTake(webStateMutex, 0) == pdTRUE) {
+      detectorSnapshot = snapshot;
+      xSemaphoreGive(webStateMutex);
+    }
+    
+    // Spend part of the remaining period on the display
+    if (oledFlusher.busy()) {
+      uint32_t start = micros();
+      uint32_t startCycles = ESP.getCycleCount();
+      oledFlusher.service(DISPLAY_BYTES_PER_PASS);
+      recordStage(STAGE_DISPLAY_FLUSH, startCycles);
+      displayTransferMicros += micros() - start;
+    }
+  }
+}
+
+void captureDetectorSnapshot(DetectorSnapshot& snapshot) {
+  const NoiseFloorTracker& noise = detector.noiseFloor();
+  snapshot.peaks = detector.peaks();
+  snapshot.ms2_per_count = detector.config().ms2_per_count;
+  snapshot.noise_threshold = detector.noiseThreshold();
+  snapshot.intensity_mode = detector.config().intensity_mode;
+  snapshot.filter_sections = detector.filter().sectionCount();
+  snapshot.baseline_ready = detector.baselineReady();
+  snapshot.baseline_progress = detector.baselineProgress();
+  snapshot.baseline_target = detector.baselineTarget();
+  snapshot.calibrating = calibrator.active();
+  snapshot.calibration_progress = calibrator.progress();
+  snapshot.calibration_good = calibrator.result().good;
+  snapshot.calibrated = calibrated;
+  snapshot.calibration_restored = calibrationRestored;
+  snapshot.offset_x = calibration_offset_x;
+  snapshot.offset_y = calibration_offset_y;
+  snapshot.offset_z = calibration_offset_z;
+  snapshot.calibration_threshold = noise_threshold;
+  snapshot.calibrations = calibrationCount;
+  snapshot.calibration = calibrator.result();
+  snapshot.noise_valid = noise.valid();
+  snapshot.noise_adapting = noise.adapting();
+  snapshot.noise_window_progress = noise.windowProgress();
+  snapshot.noise_windows = noise.windowCount();
+  for (int axis = 0; axis < 3; axis++) snapshot.noise_sigma[axis] = noise.sigma(axis);
+  snapshot.noise_history_count = noise.historyCount();
+  for (uint32_t i = 0; i < snapshot.noise_history_count; i++) snapshot.noise_history[i] = noise.history(i);
+}
+
+void processSample(const RawSample& raw, int64_t time_us) {
+  // While calibrating, the detector is bypassed and the live outputs show no
+  // deviations
+  if (calibrator.active()) {
+    if (calibrator.push(raw)) applyCalibration();
+    ProcessedSample published = {};
+    published.raw = raw;
+    published.time_us = time_us;
+    sampleRing.push(published);
+    return;
+  }
+  
+  // Apply software calibration; the detector works in counts
+  int32_t x = raw.x + calibration_offset_x;
+  int32_t y = raw.y + calibration_offset_y;
+  int32_t z = raw.z + calibration_offset_z;
+  
+  DetectorOutput result;
+  uint32_t now_ms = (uint32_t)(time_us / 1000);
+  uint32_t startCycles = ESP.getCycleCount();
+  detector.update(x, y, z, now_ms, result);
+  uint32_t cycles = ESP.getCycleCount() - startCycles;
+  detectorCyclesAvg += (cycles - detectorCyclesAvg) / 64.0f;
+  if (cycles > detectorCyclesMax) detectorCyclesMax = cycles;
+  stageCycles[STAGE_DETECTION].record(cycles);
+  
+  RawSample decimated;
+  if (waveformDecimator.push(raw, decimated)) {
+    waveform.push(decimated);
+  }
+  
+  ProcessedSample published;
+  published.raw = raw;
+  published.dev.x = roundCounts(result.x_dev);
+  published.dev.y = roundCounts(result.y_dev);
+  published.dev.z = roundCounts(result.z_dev);
+  published.mercalli = result.mercalli;
+  published.triggered = result.triggered;
+  published.sta_lta = result.sta_lta;
+  published.mmi = result.mmi;
+  published.time_us = time_us;
+  sampleRing.push(published);
+  
+  // Use current values, not peak values for event logging; the onset is the
+  // sample that triggered
+  if (result.should_log) {
+    logSeismicEvent(result.mercalli, detector.toMs2(result.x_dev), detector.toMs2(result.y_dev),
+                    detector.toMs2(result.z_dev), detector.magnitudeMs2(result.dev_mag_sq), time_us);
+  }
+  if (result.triggered) trackEventMotion(result.should_log);
+}
+
+// Called from the acquisition task while triggered; a logged event starts over
+void trackEventMotion(bool restart) {
+  const MotionPeaks& motion = detector.eventMotion();
+  portENTER_CRITICAL(&eventMotionLock);
+  if (restart) loggedEventMotion = motion;
+  if (motion.pga > loggedEventMotion.pga) loggedEventMotion.pga = motion.pga;
+  if (motion.pgv > loggedEventMotion.pgv) loggedEventMotion.pgv = motion.pgv;
+  if (motion.pgd > loggedEventMotion.pgd) loggedEventMotion.pgd = motion.pgd;
+  portEXIT_CRITICAL(&eventMotionLock);
+}
+
+// Called from loop() when the held event is stored
+void fillEventMotion(SeismicEvent& event) {
+  portENTER_CRITICAL(&eventMotionLock);
+  MotionPeaks motion = loggedEventMotion;
+  portEXIT_CRITICAL(&eventMotionLock);
+  float scale = loopSnapshot.ms2_per_count;
+  float cmPerCount = scale * 100.0f;
+  event.pga = motion.pga * scale;
+  event.pgv = motion.pgv * scale;
+  event.pgd = motion.pgd * scale;
+  event.mmi = mmiFromGroundMotion(motion.pga * cmPerCount, motion.pgv * cmPerCount);
+}
+
+void resetBleStream() {
+  bleSampleCount = 0;
+  bleGap = false;
+  bleSequence = 0;
+}
+
+// Called from loop() for every live sample while a client is connected
+void queueBleSample(const RawSample& sample, uint32_t time_ms) {
+  // If the link cannot keep up, start over rather than fall further behind
+  if (bleSampleCount == BLE_SAMPLE_BUFFER) {
+    bleSampleCount = 0;
+    bleGap = true;
+  }
+  if (bleSampleCount == 0) bleFirstSampleMs = time_ms;
+  bleSamples[bleSampleCount++] = sample;
+}
+
+// Called from loop() every updateInterval: send the queued samples in as few
+// notifications as the MTU allows. At least one frame goes out per update so
+// the status fields keep flowing while there are no samples.
+void sendBleFrames() {
+  // A notification carries at most MTU - 3 bytes
+  blePeerMtu = pServer->getPeerMTU(pServer->getConnId());
+  size_t maxBytes = blePeerMtu > 3 ? blePeerMtu - 3 : 0;
+  size_t capacity = bleFrameCapacity(maxBytes);
+  if (maxBytes < BLE_FRAME_HEADER_SIZE) {
+    // The client never negotiated a usable MTU; nothing fits
+    bleSampleCount = 0;
+    bleGap = true;
+    return;
+  }
+  
+  const DetectorPeaks& peaks = loopSnapshot.peaks;
+  float staLta = latestSample.sta_lta * 100.0f + 0.5f;
+  float peakMagnitude = sqrtf(peaks.dev_mag_sq) + 0.5f;
+  
+  BleFrameHeader header;
+  header.rate_dhz = (uint16_t)(liveSampleRate * 10.0f + 0.5f);
+  header.scale_um = (uint16_t)(loopSnapshot.ms2_per_count * 1e6f + 0.5f);
+  header.mercalli_now = latestSample.mercalli;
+  header.mercalli_peak = peaks.mercalli;
+  header.sta_lta_x100 = staLta > 65535.0f ? 65535 : (uint16_t)staLta;
+  header.peak_x = roundCounts(peaks.x);
+  header.peak_y = roundCounts(peaks.y);
+  header.peak_z = roundCounts(peaks.z);
+  header.peak_magnitude = peakMagnitude > 65535.0f ? 65535 : (uint16_t)peakMagnitude;
+  
+  size_t sent = 0;
+  for (int frame = 0; frame < BLE_MAX_FRAMES_PER_UPDATE; frame++) {
+    size_t count = bleSampleCount - sent;
+    if (count > capacity) count = capacity;
+    
+    header.sequence = bleSequence++;
+    header.time_ms = bleFirstSampleMs + (uint32_t)(sent * 1000.0f / liveSampleRate + 0.5f);
+    header.flags = latestSample.triggered ? BLE_FRAME_TRIGGERED : 0;
+    if (bleGap) header.flags |= BLE_FRAME_GAP;
+    bleGap = false;
+    
+    size_t length = encodeBleFrame(header, bleSamples + sent, count, bleFrame, maxBytes);
+    pDataCharacteristic->setValue(bleFrame, length);
+    pDataCharacteristic->notify();
+    bleFramesSent++;
+    
+    sent += count;
+    if (sent == bleSampleCount) break;
+  }
+  
+  // Whatever did not fit goes out with the next update
+  bleSampleCount -= sent;
+  if (bleSampleCount > 0) {
+    memmove(bleSamples, bleSamples + sent, bleSampleCount * sizeof(RawSample));
+    bleFirstSampleMs += (uint32_t)(sent * 1000.0f / liveSampleRate + 0.5f);
+  }
+}
+
+// Called from loop() for every live sample while /stream has clients
+void queueStreamSample(const RawSample& sample, uint32_t time_ms) {
+  if (streamSampleCount == STREAM_SAMPLE_BUFFER) {
+    streamSampleCount = 0;
+    streamGap = true;
+  }
+  if (streamSampleCount == 0) streamFirstSampleMs = time_ms;
+  streamSamples[streamSampleCount++] = sample;
+}
+
+// One SSE message: the live samples since the last frame (counts), current
+// and peak values and the event count, so the dashboard needs no polling
+void publishStreamFrame() {
+  char frame[STREAM_FRAME_MAX];
+  JsonWriter json(frame, sizeof(frame));
+  const DetectorPeaks& peaks = loopSnapshot.peaks;
+  
+  json.beginObject();
+  json.field("t", streamFirstSampleMs);
+  json.field("rate", liveSampleRate, 1);
+  json.field("scale", loopSnapshot.ms2_per_count, 6);
+  json.field("mercalli", latestSample.mercalli);
+  json.field("mercalli_peak", peaks.mercalli);
+  json.field("sta_lta", latestSample.sta_lta, 1);
+  json.field("triggered", latestSample.triggered);
+  json.field("gap", streamGap);
+  json.beginArray("peak"); // x, y, z and magnitude in counts
+  json.field(NULL, peaks.x, 0);
+  json.field(NULL, peaks.y, 0);
+  json.field(NULL, peaks.z, 0);
+  json.field(NULL, sqrtf(peaks.dev_mag_sq), 0);
+  json.endArray();
+  json.beginArray("samples"); // Interleaved x, y, z counts
+  for (size_t i = 0; i < streamSampleCount; i++) {
+    json.field(NULL, streamSamples[i].x);
+    json.field(NULL, streamSamples[i].y);
+    json.field(NULL, streamSamples[i].z);
+  }
+  json.endArray();
+  json.field("log_revision", eventLogRevision);
+  json.field("time_sync", timeInitialized);
+  if (loopSnapshot.calibrating || calibrationRequested) json.field("calibration", loopSnapshot.calibration_progress);
+  json.endObject();
+  json.finish();
+  
+  streamSampleCount = 0;
+  streamGap = false;
+  if (json.overflowed()) return;
+  // Queued per client; a full queue drops the frame for that client only
+  liveStream.send(frame);
+  streamFramesPublished++;
+}
+
+int16_t roundCounts(float counts) {
+  if (counts >= 32767.0f) return 32767;
+  if (counts <= -32768.0f) return -32768;
+  return (int16_t)lroundf(counts);
+}
+
+// Magnitude of a published deviation triplet in m/s²
+float deviationMagnitude(const RawSample& dev) {
+  int32_t squared = (int32_t)dev.x * dev.x + (int32_t)dev.y * dev.y + (int32_t)dev.z * dev.z;
+  return sqrtf((float)squared) * loopSnapshot.ms2_per_count;
+}
+
 void updateDisplay() {
+  const DetectorSnapshot& state = loopSnapshot;
+  DisplayLayout layout;
+  if (state.calibrating || calibrationRequested) {
+    layout = DISPLAY_LAYOUT_CALIBRATION;
+  } else {
+    layout = state.baseline_ready ? DISPLAY_LAYOUT_PEAKS : DISPLAY_LAYOUT_BASELINE;
+  }
+  if (layout != displayLayout) drawDisplayLayout(layout);
+  
+  char text[12];
+  if (layout == DISPLAY_LAYOUT_CALIBRATION) {
+    snprintf(text, sizeof(text), "%d%%", state.calibration_progress);
+    drawField(calibrationField, text);
+    oledFlusher.submit(display.getBuffer());
+    return;
+  }
+  
+  // Peak values
+  const DetectorPeaks& peaks = state.peaks;
+  snprintf(text, sizeof(text), "%.2f", peaks.x * state.ms2_per_count);
+  drawField(peakXField, text);
+  snprintf(text, sizeof(text), "%.2f", peaks.y * state.ms2_per_count);
+  drawField(peakYField, text);
+  snprintf(text, sizeof(text), "%.2f", peaks.z * state.ms2_per_count);
+  drawField(peakZField, text);
+  
+  if (layout == DISPLAY_LAYOUT_PEAKS) {
+    // Peak Mercalli in large font, current Mercalli from the newest sample below it
+    snprintf(text, sizeof(text), "%d", peaks.mercalli);
+    drawField(mercalliPeakField, text);
+    snprintf(text, sizeof(text), "%d", latestSample.mercalli);
+    drawField(mercalliNowField, text);
+  } else {
+    snprintf(text, sizeof(text), "%d/%d", state.baseline_progress, state.baseline_target);
+    drawField(progressField, text);
+  }
+  
+  // Unchanged frames are not sent; a busy flusher picks this one up next time
+  oledFlusher.submit(display.getBuffer());
+}
+
+// Static labels, drawn once per layout change
+void drawDisplayLayout(DisplayLayout layout) {
   display.clearDisplay();
+  display.setTextColor(SSD1306_WHITE);
   
   // Display header
   display.setTextSize(1);
   display.setCursor(0, 2);
-  if (sample_count >= baseline_samples) {
-    display.println(PEAK_VALUES_HEADER);
+  if (layout == DISPLAY_LAYOUT_CALIBRATION) {
+    display.println(CALIBRATING_MESSAGE);
   } else {
-    display.println(BASELINE_HEADER);
+    display.println(layout == DISPLAY_LAYOUT_PEAKS ? PEAK_VALUES_HEADER : BASELINE_HEADER);
   }
   
   // Draw separator line
   display.drawLine(0, 12, SCREEN_WIDTH, 12, SSD1306_WHITE);
   
-  // Display peak values with better spacing and smaller font
-  display.setTextSize(1);
-  display.setCursor(0, 15);
-  display.print(X_LABEL);
-  display.setTextSize(2);
-  display.print(x_peak, 2);
-  
-  display.setTextSize(1);
-  display.setCursor(0, 32);
-  display.print(Y_LABEL);
-  display.setTextSize(2);
-  display.print(y_peak, 2);
+  if (layout == DISPLAY_LAYOUT_CALIBRATION) {
+    IPAddress ip = accessPointActive() ? WiFi.softAPIP() : WiFi.localIP();
+    display.setCursor(0, 20);
+    display.print(KEEP_STILL_MESSAGE);
+    display.setCursor(0, 35);
+    display.print(PROGRESS_LABEL);
+    display.setCursor(0, 50);
+    display.print(IP_LABEL);
+    display.print(ip);
+  } else {
+    display.setCursor(0, 15);
+    display.print(X_LABEL);
+    display.setCursor(0, 32);
+    display.print(Y_LABEL);
+    display.setCursor(0, 49);
+    display.print(Z_LABEL);
+  }
   
-  display.setTextSize(1);
-  display.setCursor(0, 49);
-  display.print(Z_LABEL);
-  display.setTextSize(2);
-  display.print(z_peak, 2);
-  
-  // Display Mercalli intensity on the right side with better layout
-  if (sample_count >= baseline_samples) {
-    // Calculate current deviation magnitude for Mercalli display
-    float x_deviation = abs(x_accel - x_baseline);
-    float y_deviation = abs(y_accel - y_baseline);
-    float z_deviation = abs(z_accel - z_baseline);
-    
-    // Apply noise threshold - ignore small deviations
-    if (x_deviation < noise_threshold) x_deviation = 0;
-    if (y_deviation < noise_threshold) y_deviation = 0;
-    if (z_deviation < noise_threshold) z_deviation = 0;
-    
-    float deviation_magnitude = sqrt(x_deviation*x_deviation + y_deviation*y_deviation + z_deviation*z_deviation);
-    int current_mercalli = calculateMercalli(deviation_magnitude);
-    
-    display.setTextSize(1);
+  if (layout == DISPLAY_LAYOUT_PEAKS) {
     display.setCursor(80, 15);
-    display.println(MERCALLI_LABEL);
-    
-    // Peak Mercalli in large font (most important)
-    display.setTextSize(3);
-    display.setCursor(90, 25);
-    display.print(mercalli_peak);
-    
-    // Current Mercalli below in smaller font
-    display.setTextSize(1);
+    display.print(MERCALLI_LABEL);
     display.setCursor(80, 50);
     display.print(NOW_LABEL);
-    display.setTextSize(1);
-    display.print(current_mercalli);
-  } else {
-    display.setTextSize(1);
+  } else if (layout == DISPLAY_LAYOUT_BASELINE) {
     display.setCursor(80, 25);
-    display.println(BASELINE_STATUS);
+    display.print(BASELINE_STATUS);
     display.setCursor(80, 35);
-    display.println(SETUP_STATUS);
-    display.setCursor(80, 45);
-    display.print(sample_count);
-    display.print("/");
-    display.print(baseline_samples);
+    display.print(SETUP_STATUS);
   }
   
-  display.display();
+  // Everything on the new layout has to be drawn again
+  DisplayField* fields[] = { &peakXField, &peakYField, &peakZField,
+                             &mercalliPeakField, &mercalliNowField, &progressField,
+                             &calibrationField };
+  for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+    fields[i]->text[0] = '\0';
+  }
+  displayLayout = layout;
 }
 
-void resetPeakValues() {
-  x_peak = 0;
-  y_peak = 0;
-  z_peak = 0;
-  magnitude_peak = 0;
-  deviation_magnitude_peak = 0;
-  mercalli_peak = 0;
-  sample_count = 0; // Reset baseline establishment
-  lastLoggedMercalli = 0;  // Reset event logging threshold
-  Serial.println("Peak values and baseline reset.");
+void drawField(DisplayField& field, const char* text) {
+  if (strncmp(field.text, text, sizeof(field.text) - 1) == 0) return;
   
-  // Show reset confirmation on display briefly
+  display.fillRect(field.x, field.y, field.chars * 6 * field.size, 8 * field.size, SSD1306_BLACK);
+  display.setTextSize(field.size);
+  display.setCursor(field.x, field.y);
+  display.print(text);
+  
+  strncpy(field.text, text, sizeof(field.text) - 1);
+  field.text[sizeof(field.text) - 1] = '\0';
+}
+
+// Show the whole buffer now, for one-off screens (splash, calibration, reset).
+// Once the acquisition task runs, the frame goes through the flusher like any
+// other, so the transfer still happens between sensor reads.
+void showDisplay() {
+  if (acquisitionTaskHandle == NULL) {
+    display.display();
+    oledFlusher.markShown(display.getBuffer());
+  } else {
+    while (!oledFlusher.submit(display.getBuffer())) delay(1);
+    while (oledFlusher.busy()) delay(1);
+  }
+  displayLayout = DISPLAY_LAYOUT_NONE;
+}
+
+void holdDisplay(unsigned long duration) {
+  displayHoldStart = millis();
+  displayHoldTime = duration;
+}
+
+void requestPeakReset() {
+  // Safe from any task: peak state belongs to the acquisition task (and the
+  // JMA peak and the display to loop()); they act on it on their next pass
+  resetRequested = true;
+  jmaResetRequested = true;
+  resetScreenRequested = true;
+}
+
+void showResetScreen() {
+  // Reset confirmation
   display.clearDisplay();
   display.setTextSize(2);
   display.setTextColor(SSD1306_WHITE);
@@ -551,8 +1529,7 @@ void resetPeakValues() {
   display.setCursor((SCREEN_WIDTH - text_width) / 2, 20);
   display.println(RESET_MESSAGE);
   
-  display.display();
-  delay(400);
+  showDisplay();
 }
 
 void checkForSerialCommand() {
@@ -565,11 +1542,15 @@ void checkForSerialCommand() {
     upperCommand.toUpperCase();
 
     if (upperCommand == "RESET") {
-      resetPeakValues();
+      requestPeakReset();
     } else if (upperCommand == "CLEAREVENTS") {
       clearEventLog();
     } else if (upperCommand == "CALIBRATE") {
-      calibrateAccelerometer();
+      startCalibration();
+    } else if (upperCommand == "FFTBENCH") {
+      benchmarkFft();
+    } else if (upperCommand == "METRICS") {
+      printMetrics();
     } else if (upperCommand == "BOOT") {
       ESP.restart();
     } else if (upperCommand == "STATUS") {
@@ -583,7 +1564,7 @@ void checkForSerialCommand() {
         Serial.println(ssid);
         Serial.print(F("  IP Address: "));
         Serial.println(WiFi.localIP());
-      } else if (WiFi.getMode() == WIFI_AP) {
+      } else if (accessPointActive()) {
         Serial.println(F("Access Point Mode"));
         Serial.print(F("  AP Name: Seismometer-"));
         String mac = WiFi.macAddress();
@@ -606,43 +1587,242 @@ void checkForSerialCommand() {
       // BLE Status
       Serial.print(F("BLE Status: "));
       if (deviceConnected) {
-        Serial.println(F("Client Connected"));
+        Serial.print(F("Client Connected (MTU "));
+        Serial.print(blePeerMtu);
+        Serial.print(F("), "));
+        Serial.print(bleFramesSent);
+        Serial.println(F(" frames sent"));
       } else {
         Serial.println(F("Advertising"));
       }
+      
+      // Live stream
+      Serial.print(F("Live Stream: "));
+      Serial.print(liveStream.count());
+      Serial.print(F(" clients at "));
+      Serial.print(streamRateHz);
+      Serial.print(F(" Hz, "));
+      Serial.print(streamFramesPublished);
+      Serial.print(F(" frames published, "));
+      Serial.print(liveStream.avgPacketsWaiting());
+      Serial.println(F(" queued per client"));
+
+      // Network collector and telemetry push
+      Serial.print(F("Station ID: "));
+      Serial.println(stationId, HEX);
+      Serial.print(F("Collector: "));
+      printPushTarget(collectorTarget);
+      Serial.print(F("Telemetry: "));
+      printPushTarget(telemetryTarget);
 
       // Calibration Status
+      const DetectorSnapshot& state = loopSnapshot;
       Serial.print(F("Calibration Status: "));
-      if (calibrated) {
-        Serial.println(F("Complete"));
+      if (state.calibrating || calibrationRequested) {
+        Serial.print(F("In progress, "));
+        Serial.print(state.calibration_progress);
+        Serial.println(F("%"));
+      } else if (state.calibrated) {
+        if (state.calibration_restored) Serial.println(F("Restored from NVS"));
+        else Serial.println(state.calibration_good ? F("Complete") : F("Complete, verification failed"));
         Serial.print(F("  Noise Threshold: "));
-        Serial.println(noise_threshold, 4);
+        Serial.println(state.calibration_threshold, 4);
         Serial.print(F("  Offsets (X,Y,Z): "));
-        Serial.print(calibration_offset_x, 3);
+        Serial.print(state.offset_x);
         Serial.print(F(", "));
-        Serial.print(calibration_offset_y, 3);
+        Serial.print(state.offset_y);
         Serial.print(F(", "));
-        Serial.println(calibration_offset_z, 3);
+        Serial.print(state.offset_z);
+        Serial.println(F(" counts"));
       } else {
         Serial.println(F("Not Calibrated"));
       }
+      Serial.print(F("Noise Gate: "));
+      Serial.print(state.noise_threshold, 4);
+      Serial.print(F(" m/s2"));
+      if (state.noise_valid) {
+        Serial.print(F(", floor sigma X "));
+        Serial.print(state.noise_sigma[0] * state.ms2_per_count, 4);
+        Serial.print(F(" Y "));
+        Serial.print(state.noise_sigma[1] * state.ms2_per_count, 4);
+        Serial.print(F(" Z "));
+        Serial.print(state.noise_sigma[2] * state.ms2_per_count, 4);
+        Serial.print(F(" after "));
+        Serial.print(state.noise_windows);
+        Serial.print(F(" windows"));
+        if (!state.noise_adapting) Serial.print(F(", frozen"));
+        Serial.println();
+      } else {
+        Serial.print(F(", measuring noise floor ("));
+        Serial.print(state.noise_window_progress);
+        Serial.println(F("%)"));
+      }
+
+      ClockModel clock = clockSnapshot();
+      Serial.print(F("Clock: "));
+      if (clock.valid()) {
+        Serial.print(F("NTP synced "));
+        Serial.print(clock.syncCount());
+        Serial.print(F(" times, drift "));
+        Serial.print(clock.driftPpm(), 2);
+        Serial.print(F(" ppm, last residual "));
+        Serial.print(clock.lastResidualUs() / 1000.0f, 1);
+        Serial.print(F(" ms, "));
+        Serial.print((unsigned long)((esp_timer_get_time() - clock.lastSyncLocalUs()) / 1000000));
+        Serial.print(F(" s ago"));
+        if (clock.rejectedCount() > 0) {
+          Serial.print(F(", "));
+          Serial.print(clock.rejectedCount());
+          Serial.print(F(" rejected"));
+        }
+        Serial.println();
+      } else {
+        Serial.print(F("Waiting for NTP (events are stored with boot-relative times, boot "));
+        Serial.print(bootNumber);
+        Serial.println(F(")"));
+      }
+
+      // Acquisition Status
+      Serial.print(F("Acquisition: "));
+      if (accelFifo.isStreaming()) {
+        Serial.print(accelFifo.sampleRateHz(), 0);
+        Serial.println(F(" Hz FIFO stream"));
+      } else {
+        Serial.println(F("Stopped"));
+      }
+      Serial.print(F("  Samples: "));
+      Serial.println(accelFifo.sampleCount());
+      Serial.print(F("  FIFO overruns: "));
+      Serial.println(accelFifo.overrunCount());
+      Serial.print(F("  Max FIFO level: "));
+      Serial.println(accelFifo.maxFifoLevel());
+      Serial.print(F("  Bus errors: "));
+      Serial.println(accelFifo.busErrorCount());
+      Serial.print(F("  Sample ring high water: "));
+      Serial.print(sampleRing.highWaterMark());
+      Serial.print(F("/"));
+      Serial.println(sampleRing.capacity());
+      Serial.print(F("  Sample ring drops: "));
+      Serial.println(sampleRing.dropCount());
+      Serial.print(F("  Event queue drops: "));
+      Serial.println(eventRing.dropCount());
+      Serial.print(F("  Detector cycles/sample: "));
+      Serial.print(detectorCyclesAvg, 0);
+      Serial.print(F(" avg, "));
+      Serial.print(detectorCyclesMax);
+      Serial.print(F(" max ("));
+      Serial.print(state.filter_sections);
+      Serial.println(F(" filter sections)"));
+      Serial.print(F("Spectrum: "));
+      if (spectrumResult.sequence > 0) {
+        Serial.print(spectrumResult.dominant_hz, 2);
+        Serial.print(F(" Hz dominant, "));
+        Serial.print(spectrumCycles);
+        Serial.print(F(" cycles per update ("));
+        Serial.print(fftImplementation());
+        Serial.println(F(" FFT)"));
+      } else {
+        Serial.println(F("collecting"));
+      }
+      Serial.print(F("JMA intensity: "));
+      if (jma.valid()) {
+        Serial.print(jma.intensity(), 2);
+        Serial.print(F(" (class "));
+        Serial.print(jmaIntensityClass(jma.intensity()));
+        Serial.print(F("), peak "));
+        Serial.print(jma.peak(), 2);
+        Serial.print(F(", "));
+        Serial.print(jmaCycles);
+        Serial.print(F(" cycles per block of "));
+        Serial.print(jma.config().points - jma.config().taps + 1);
+        Serial.println(F(" samples"));
+      } else {
+        Serial.println(F("collecting"));
+      }
+      const MotionPeaks& motion = state.peaks.motion;
+      Serial.print(F("Ground motion: PGA "));
+      Serial.print(motion.pga * state.ms2_per_count, 3);
+      Serial.print(F(" m/s2, PGV "));
+      Serial.print(motion.pgv * state.ms2_per_count * 100.0f, 2);
+      Serial.print(F(" cm/s, PGD "));
+      Serial.print(motion.pgd * state.ms2_per_count * 100.0f, 2);
+      Serial.print(F(" cm, MMI "));
+      Serial.print(motion.mmi, 1);
+      Serial.print(F(" (intensity from "));
+      Serial.print(state.intensity_mode == INTENSITY_REGRESSION ? F("regression") : F("thresholds"));
+      Serial.println(F(")"));
+      Serial.print(F("Event store: "));
+      if (eventStoreReady) {
+        Serial.print(eventStore.recordCount());
+        Serial.print(F("/"));
+        Serial.print(eventStore.capacity());
+        Serial.print(F(" events in "));
+        Serial.print(eventStore.segmentCount());
+        Serial.print(F(" segments, next #"));
+        Serial.print(eventStore.nextSequence());
+        Serial.print(F(", "));
+        Serial.print(eventStore.errorCount());
+        Serial.println(F(" write errors"));
+      } else {
+        Serial.println(F("unavailable"));
+      }
+      Serial.print(F("Waveform capture: "));
+      Serial.print(WAVEFORM_SLOTS);
+      Serial.print(F(" slots, "));
+      Serial.print(WAVEFORM_PRE_SECONDS, 0);
+      Serial.print(F(" s pre / "));
+      Serial.print(waveform_post_seconds, 0);
+      Serial.print(F(" s post at "));
+      Serial.print(WAVEFORM_RATE, 0);
+      Serial.println(F(" Hz"));
+      Serial.print(F("  Captured: "));
+      Serial.print(waveform.captureCount());
+      Serial.print(F(", dropped: "));
+      Serial.println(waveform.dropCount());
+      Serial.print(F("Display: "));
+      Serial.print(displayBytesPerSecond, 0);
+      Serial.print(F(" I2C bytes/s, "));
+      Serial.print(displayTransferMsPerSecond, 1);
+      Serial.print(F(" ms/s in transfers, "));
+      Serial.print(oledFlusher.framesSent());
+      Serial.print(F(" frames, "));
+      Serial.print(oledFlusher.errorCount());
+      Serial.println(F(" errors"));
       Serial.println(F("---------------------"));
-    } else if (upperCommand.startsWith("SSID ")) {
-      String newSsid = command.substring(5);
-      ssid = newSsid;
-      saveWifiCredentials();
-      Serial.println("SSID updated to: " + newSsid);
-      Serial.println("Rebooting to apply changes...");
-      delay(1000);
-      ESP.restart();
-    } else if (upperCommand.startsWith("PASS ")) {
-      String newPass = command.substring(5);
-      password = newPass;
-      saveWifiCredentials();
-      Serial.println("Password updated.");
-      Serial.println("Rebooting to apply changes...");
-      delay(1000);
-      ESP.restart();
+    } else if (upperCommand.startsWith("WAVEPOST ")) {
+      reportConfigChange("waveform_post_seconds", command.substring(9).c_str());
+    } else if (upperCommand.startsWith("STREAMRATE ")) {
+      reportConfigChange("stream_rate_hz", command.substring(11).c_str());
+    } else if (upperCommand.startsWith("INTENSITY ")) {
+      reportConfigChange("intensity_mode", command.substring(10).c_str());
+    } else if (upperCommand == "CONFIG") {
+      printStationConfig();
+    } else if (upperCommand.startsWith("SET ")) {
+      String assignment = command.substring(4);
+      assignment.trim();
+      int space = assignment.indexOf(' ');
+      String name = space > 0 ? assignment.substring(0, space) : assignment;
+      String value = space > 0 ? assignment.substring(space + 1) : "";
+      name.toLowerCase();
+      reportConfigChange(name.c_str(), value.c_str());
+    } else if (upperCommand.startsWith("COLLECTOR ") || upperCommand.startsWith("TELEMETRY ")) {
+      String address = command.substring(10);
+      address.trim();
+      if (address.equalsIgnoreCase("OFF")) address = "";
+      reportConfigChange(upperCommand.startsWith("COLLECTOR ") ? "collector" : "telemetry", address.c_str());
+    } else if (upperCommand.startsWith("SSID ") || upperCommand.startsWith("PASS ")) {
+      bool isSsid = upperCommand.startsWith("SSID ");
+      const char* problem = changeStationConfig(isSsid ? "wifi_ssid" : "wifi_password", command.substring(5).c_str());
+      if (problem) {
+        Serial.print(F("Cannot change WiFi settings: "));
+        Serial.println(problem);
+      } else {
+        updateStationConfig(); // Saved before the restart
+        Serial.println(isSsid ? "SSID updated to: " + command.substring(5) : String("Password updated."));
+        Serial.println("Rebooting to apply changes...");
+        delay(1000);
+        ESP.restart();
+      }
     } else {
       Serial.print(F("Unknown command: "));
       Serial.println(command);
@@ -666,7 +1846,7 @@ void checkForSerialCommand() {
       buttonState = reading;
       if (buttonState == LOW) {
         Serial.println("Button was pressed. Resetting values.");
-        resetPeakValues();
+        requestPeakReset();
       } else { // buttonState is HIGH
         Serial.println("Button was released.");
       }
@@ -676,270 +1856,146 @@ void checkForSerialCommand() {
   lastButtonState = reading;
 }
 
-void calibrateAccelerometer() {
-  Serial.println("Starting accelerometer calibration...");
-  Serial.println("Keep the device still during calibration.");
-  
-  // Display calibration message
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 10);
-  display.println(CALIBRATING_MESSAGE);
-  display.setCursor(0, 25);
-  display.println(KEEP_STILL_MESSAGE);
-  display.println(WiFi.localIP().toString());
-  display.display();
-  
-  // Wait a bit for user to read message
-  delay(2000);
-  
-  // Clear any existing hardware offsets first
-  Wire.beginTransmission(0x53);
-  Wire.write(0x1E); Wire.write(0); // Clear OFSX
-  Wire.endTransmission();
-  Wire.beginTransmission(0x53);
-  Wire.write(0x1F); Wire.write(0); // Clear OFSY
-  Wire.endTransmission();
-  Wire.beginTransmission(0x53);
-  Wire.write(0x20); Wire.write(0); // Clear OFSZ
-  Wire.endTransmission();
-  delay(100);
-  
-  // Calibration parameters
-  const int numSamples = 100;
-  const int sampleDelay = 50; // 50ms between samples
-  float sumX = 0, sumY = 0, sumZ = 0;
-  float sumX2 = 0, sumY2 = 0, sumZ2 = 0; // For standard deviation calculation
-  int validSamples = 0;
-  
-  // Show countdown and collect samples
-  for (int i = 0; i < numSamples; i++) {
-    // Update display with progress
-    if (i % 10 == 0) { // Update every 10 samples
-      display.clearDisplay();
-      display.setTextSize(1);
-      display.setTextColor(SSD1306_WHITE);
-      display.setCursor(0, 10);
-      display.println(CALIBRATING_MESSAGE);
-      display.setCursor(0, 25);
-      display.print(PROGRESS_LABEL);
-      display.print((i * 100) / numSamples);
-      display.println("%");
-      
-      // Countdown timer
-      int secondsLeft = ((numSamples - i) * sampleDelay) / 1000;
-      display.setCursor(0, 40);
-      display.print(TIME_LEFT_LABEL);
-      display.print(secondsLeft);
-      display.println("s");
-
-      // ip address
-      display.setCursor(0, 55);
-      display.print("IP: ");
-      display.print(WiFi.localIP().toString());
-      display.display();
-    }
-    
-    // Get sensor reading (raw, no calibration applied yet)
-    sensors_event_t event;
-    if (accel.getEvent(&event)) {
-      sumX += event.acceleration.x;
-      sumY += event.acceleration.y;
-      sumZ += event.acceleration.z;
-      
-      // Collect sum of squares for standard deviation calculation
-      sumX2 += event.acceleration.x * event.acceleration.x;
-      sumY2 += event.acceleration.y * event.acceleration.y;
-      sumZ2 += event.acceleration.z * event.acceleration.z;
-      
-      validSamples++;
-    }
-    
-    delay(sampleDelay);
+// Ask the acquisition task to calibrate; it takes about 3.5 s, during which
+// the detector is bypassed
+void startCalibration() {
+  beginBootPhase(BOOT_CALIBRATION);
+  calibrationRequested = true;
+  Serial.println(F("Calibrating - keep the device still for a few seconds."));
+}
+
+// Called by the acquisition task on the sample that completes a calibration
+void applyCalibration() {
+  const CalibrationResult& result = calibrator.result();
+  calibration_offset_x = result.offset_x;
+  calibration_offset_y = result.offset_y;
+  calibration_offset_z = result.offset_z;
+  noise_threshold = result.noise_threshold;
+  calibrated = true;
+  calibrationRestored = false;
+  calibrationCount++;
+  endBootPhase(BOOT_CALIBRATION);
+  
+  // Peaks and baseline start over from calibrated samples
+  detector.setNoiseThreshold(noise_threshold);
+  detector.reset();
+}
+
+// Called from loop() once a calibration is done, with the snapshot's copy
+void reportCalibration(const CalibrationResult& result) {
+  Serial.print(F("Noise analysis - StdDev X: ")); Serial.print(result.std_x, 4);
+  Serial.print(F(" Y: ")); Serial.print(result.std_y, 4);
+  Serial.print(F(" Z: ")); Serial.println(result.std_z, 4);
+  Serial.print(F("Auto noise threshold set to: ")); Serial.print(result.noise_threshold, 4);
+  Serial.println(F(" m/s2"));
+  Serial.print(F("Raw averages (counts) - X: ")); Serial.print(result.mean_x, 2);
+  Serial.print(F(" Y: ")); Serial.print(result.mean_y, 2);
+  Serial.print(F(" Z: ")); Serial.println(result.mean_z, 2);
+  Serial.print(F("Software offsets (counts) - X: ")); Serial.print(result.offset_x);
+  Serial.print(F(" Y: ")); Serial.print(result.offset_y);
+  Serial.print(F(" Z: ")); Serial.println(result.offset_z);
+  Serial.print(F("Calibrated averages - X: ")); Serial.print(result.residual_x, 3);
+  Serial.print(F(" Y: ")); Serial.print(result.residual_y, 3);
+  Serial.print(F(" Z: ")); Serial.println(result.residual_z, 3);
+  if (result.good) {
+    Serial.println(F("Software calibration successful."));
+  } else {
+    Serial.println(F("Software calibration may have issues - was the device moved?"));
   }
-  
-  if (validSamples > 0) {
-    // Calculate average raw readings
-    float avgX = sumX / validSamples;
-    float avgY = sumY / validSamples;
-    float avgZ = sumZ / validSamples;
-    
-    // Calculate standard deviation for noise threshold determination
-    float varX = (sumX2 / validSamples) - (avgX * avgX);
-    float varY = (sumY2 / validSamples) - (avgY * avgY);
-    float varZ = (sumZ2 / validSamples) - (avgZ * avgZ);
-    
-    float stdX = sqrt(varX);
-    float stdY = sqrt(varY);
-    float stdZ = sqrt(varZ);
-    
-    // Use 3 times the maximum standard deviation as noise threshold
-    // This should capture 99.7% of noise variations (3-sigma rule)
-    float maxStd = max(max(stdX, stdY), stdZ);
-    noise_threshold = 3.0 * maxStd;
-    
-    // Ensure minimum threshold of 0.05 m/s2 for very quiet sensors
-    if (noise_threshold < 0.05) noise_threshold = 0.05;
-    
-    Serial.print("Noise analysis - StdDev X: "); Serial.print(stdX, 4);
-    Serial.print(" Y: "); Serial.print(stdY, 4);
-    Serial.print(" Z: "); Serial.println(stdZ, 4);
-    Serial.print("Auto noise threshold set to: "); Serial.print(noise_threshold, 4);
-    Serial.println(" m/s2");
-    
-    // Calculate software calibration offsets
-    // These will be applied in software to make all axes read ~0
-    calibration_offset_x = -avgX;
-    calibration_offset_y = -avgY;
-    calibration_offset_z = -avgZ;
-    calibrated = true;
-    
-    Serial.println("Software calibration complete.");
-    Serial.print("Raw averages - X: "); Serial.print(avgX, 3);
-    Serial.print(" Y: "); Serial.print(avgY, 3);
-    Serial.print(" Z: "); Serial.println(avgZ, 3);
-    Serial.print("Software offsets - X: "); Serial.print(calibration_offset_x, 3);
-    Serial.print(" Y: "); Serial.print(calibration_offset_y, 3);
-    Serial.print(" Z: "); Serial.println(calibration_offset_z, 3);
-    
-    // Verify calibration by taking test readings with software offsets applied
-    Serial.println("Taking verification readings...");
-    float testSumX = 0, testSumY = 0, testSumZ = 0;
-    int testSamples = 10;
-    
-    for (int i = 0; i < testSamples; i++) {
-      sensors_event_t event;
-      if (accel.getEvent(&event)) {
-        float calibratedX = event.acceleration.x + calibration_offset_x;
-        float calibratedY = event.acceleration.y + calibration_offset_y;
-        float calibratedZ = event.acceleration.z + calibration_offset_z;
-        
-        testSumX += calibratedX;
-        testSumY += calibratedY;
-        testSumZ += calibratedZ;
-        
-        Serial.print("Sample "); Serial.print(i+1); Serial.print(": ");
-        Serial.print("X:"); Serial.print(calibratedX, 3);
-        Serial.print(" Y:"); Serial.print(calibratedY, 3);
-        Serial.print(" Z:"); Serial.println(calibratedZ, 3);
-      }
-      delay(50);
-    }
-    
-    float testAvgX = testSumX / testSamples;
-    float testAvgY = testSumY / testSamples;
-    float testAvgZ = testSumZ / testSamples;
-    
-    Serial.print("Calibrated averages - X: "); Serial.print(testAvgX, 3);
-    Serial.print(" Y: "); Serial.print(testAvgY, 3);
-    Serial.print(" Z: "); Serial.println(testAvgZ, 3);
-    
-    // Check if calibration was successful
-    bool calibrationGood = (abs(testAvgX) < 0.1 && abs(testAvgY) < 0.1 && abs(testAvgZ) < 0.1);
-    
-    // Show completion on display
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(0, 5);
-    display.println(CALIBRATION_HEADER);
-    if (calibrationGood) {
-      display.setCursor(0, 20);
-      display.println(COMPLETE_MESSAGE);
-      display.setCursor(0, 30);
-      display.print(X_LABEL);
-      display.print(testAvgX, 2);
-      display.print(Y_LABEL);
-      display.print(testAvgY, 2);
-      display.setCursor(0, 40);
-      display.print(Z_LABEL);
-      display.print(testAvgZ, 2);
-      display.println(" m/s2");
-      display.setCursor(0, 50);
-      display.print(NOISE_LABEL);
-      display.print(noise_threshold, 3);
-      Serial.println("Software calibration successful.");
-    } else {
-      display.setCursor(0, 20);
-      display.println(WARNING_MESSAGE);
-      display.setCursor(0, 35);
-      display.println(CALIBRATION_ISSUE);
-      Serial.println("Software calibration may have issues.");
-    }
+}
 
-    display.display();
-    delay(3000);
-    
-  } else {
-    Serial.println("Calibration failed - no valid samples.");
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(0, 20);
-    display.println(CALIBRATION_HEADER);
-    display.setCursor(0, 35);
-    display.println(FAILED_MESSAGE);
-    display.display();
-    delay(3000);
+// Called from setup() before sampling starts: the offsets of the last good
+// calibration, when there is one for this sensor scale, so a restart does
+// not need the device to lie still. Without one, calibrate.
+void restoreCalibration() {
+  beginBootPhase(BOOT_CALIBRATION);
+  StoredCalibration stored;
+  float scale = detector.config().ms2_per_count;
+  if (!configStorageReady || !configStore.loadCalibration(stored) ||
+      fabsf(stored.ms2_per_count - scale) > scale * 1e-4f) {
+    startCalibration();
+    return;
   }
+  calibration_offset_x = stored.offset_x;
+  calibration_offset_y = stored.offset_y;
+  calibration_offset_z = stored.offset_z;
+  noise_threshold = stored.noise_threshold;
+  detector.setNoiseThreshold(noise_threshold);
+  calibrated = true;
+  calibrationRestored = true;
+  endBootPhase(BOOT_CALIBRATION);
+  
+  Serial.print(F("Calibration restored - offsets (counts) X: ")); Serial.print(stored.offset_x);
+  Serial.print(F(" Y: ")); Serial.print(stored.offset_y);
+  Serial.print(F(" Z: ")); Serial.print(stored.offset_z);
+  Serial.print(F(", noise threshold ")); Serial.print(stored.noise_threshold, 4);
+  Serial.println(F(" m/s2 (CALIBRATE measures again)"));
 }
 
-int calculateMercalli(float magnitude) {
-  // Simple linear mapping from magnitude to Mercalli intensity
-  // Adjust the mapping as needed for your specific requirements
-  if (magnitude < MERCALLI_1_THRESHOLD) return 1;
-  else if (magnitude < MERCALLI_2_THRESHOLD) return 2;
-  else if (magnitude < MERCALLI_3_THRESHOLD) return 3;
-  else if (magnitude < MERCALLI_4_THRESHOLD) return 4;
-  else if (magnitude < MERCALLI_5_THRESHOLD) return 5;
-  else if (magnitude < MERCALLI_6_THRESHOLD) return 6;
-  else if (magnitude < MERCALLI_7_THRESHOLD) return 7;
-  else if (magnitude < MERCALLI_8_THRESHOLD) return 8;
-  else if (magnitude < MERCALLI_9_THRESHOLD) return 9;
-  else if (magnitude < MERCALLI_10_THRESHOLD) return 10;
-  else if (magnitude < MERCALLI_11_THRESHOLD) return 11;
-  else return 12; // XII - Extreme
+// Called from loop() after a good calibration, for the next boot
+void saveCalibration(const CalibrationResult& result, float ms2_per_count) {
+  StoredCalibration stored = { result.offset_x, result.offset_y, result.offset_z, result.noise_threshold,
+                               ms2_per_count };
+  if (!configStorageReady || !configStore.saveCalibration(stored)) {
+    Serial.println(F("Calibration: NVS write failed, it will be measured again after a restart"));
+  }
 }
 
-void setupWifi() {
-  delay(10);
-  
-  // First, check if we have valid credentials
-  if (ssid.length() == 0 || ssid == "YOUR_SSID_HERE") {
+bool haveWifiCredentials() {
+  return ssid.length() > 0 && ssid != "YOUR_SSID_HERE";
+}
+
+// Called from setup(): start connecting and return at once
+void startNetwork() {
+  beginBootPhase(BOOT_WIFI);
+  networkState = NETWORK_CONNECTING;
+  wifiConnectStart = millis();
+  if (!haveWifiCredentials()) {
     Serial.println(F("No valid WiFi credentials found. Starting Access Point mode..."));
-    startAccessPoint();
-    return;
+    return; // updateNetwork() starts it
   }
   
   Serial.print(F("Connecting to WiFi: "));
   Serial.println(ssid);
-
-  // Set WiFi to station mode first
   WiFi.mode(WIFI_STA);
-  delay(100);
-  
-  // Attempt to connect to WiFi network
   WiFi.begin(ssid.c_str(), password.c_str());
-  
-  // Wait for connection
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-  
-  Serial.println();
+}
+
+// Called from loop() until WiFi is connected or the access point is up
+void updateNetwork() {
+  if (networkState != NETWORK_CONNECTING) return;
   
   if (WiFi.status() == WL_CONNECTED) {
-    Serial.println(F("Connected to WiFi"));
-    Serial.print(F("IP Address: "));
+    networkState = NETWORK_CONNECTED;
+    endBootPhase(BOOT_WIFI);
+    Serial.print(F("Connected to WiFi after "));
+    Serial.print(millis() - wifiConnectStart);
+    Serial.print(F(" ms, IP Address: "));
     Serial.println(WiFi.localIP());
-  } else {
-    Serial.println(F("Failed to connect to WiFi. Starting Access Point mode..."));
-    startAccessPoint();
+    startWebServer();
+    initializeTime();
+    return;
   }
+  if (haveWifiCredentials() && millis() - wifiConnectStart < WIFI_CONNECT_TIMEOUT) return;
+  
+  if (haveWifiCredentials()) Serial.println(F("Failed to connect to WiFi. Starting Access Point mode..."));
+  startAccessPoint();
+  networkState = NETWORK_ACCESS_POINT;
+  endBootPhase(BOOT_WIFI);
+  startWebServer();
+}
+
+void startWebServer() {
+  if (WiFi.status() != WL_CONNECTED && !accessPointActive()) {
+    Serial.println(F("No WiFi connection - web server not started"));
+    return;
+  }
+  Serial.println(F("Setting up web server routes..."));
+  setupWebServer();
+  server.begin();
+  Serial.println("Web server started successfully");
+  Serial.print(F("Server listening on: "));
+  Serial.println(accessPointActive() ? WiFi.softAPIP() : WiFi.localIP());
 }
 
 void startAccessPoint() {
@@ -985,16 +2041,17 @@ void startAccessPoint() {
     display.println(apName);
     display.setCursor(0, 50);
     display.println("192.168.4.1");
-    display.display();
-    delay(2000);
+    showDisplay();
+    holdDisplay(DISPLAY_HOLD_TIME);
   } else {
     Serial.println(F("Failed to start Access Point"));
   }
 }
 
 void setupBLE() {
-  // Create the BLE Device
+  // Create the BLE Device; allow an MTU large enough for a full data frame
   BLEDevice::init("Seismometer");
+  BLEDevice::setMTU(BLE_FRAME_MAX_SIZE + 3);
   
   // Create the BLE Server
   pServer = BLEDevice::createServer();
@@ -1026,29 +2083,155 @@ void setupBLE() {
   Serial.println(F("BLE Server setup complete, advertising..."));
 }
 
-void handleRoot() {
+void lockWebState() {
+  xSemaphoreTake(webStateMutex, portMAX_DELAY);
+}
+
+void unlockWebState() {
+  xSemaphoreGive(webStateMutex);
+}
+
+// Scanning for networks enables the station interface next to the access
+// point (WIFI_AP_STA); either way the configuration portal is up
+bool accessPointActive() {
+  return (WiFi.getMode() & WIFI_MODE_AP) != 0;
+}
+
+// A route handler with its time recorded under STAGE_HTTP
+template <void (*handler)(AsyncWebServerRequest*)>
+void timed(AsyncWebServerRequest* request) {
+  uint32_t start = ESP.getCycleCount();
+  handler(request);
+  recordStage(STAGE_HTTP, start);
+}
+
+void setupWebServer() {
+  server.on("/", HTTP_GET, timed<handleRoot>);
+  server.on("/data", HTTP_GET, timed<handleData>);
+  server.on("/reset", HTTP_POST, timed<handleReset>);
+  server.on("/ble", HTTP_GET, timed<handleBleViewer>);
+  // Before /config, which would match it as a prefix
+  server.on("/config/params", HTTP_GET, timed<handleConfigParams>);
+  server.on("/config/params", HTTP_POST, timed<handleConfigParamsUpdate>);
+  server.on("/config", HTTP_GET, timed<handleWifiConfig>);
+  server.on("/save", HTTP_POST, timed<handleWifiSave>);
+  server.on("/events", HTTP_GET, timed<handleEvents>);
+  server.on("/clearevents", HTTP_POST, timed<handleClearEvents>);
+  server.on("/events/waveform", HTTP_GET, timed<handleWaveform>);
+  server.on("/events/export", HTTP_GET, timed<handleEventExport>);
+  server.on("/spectrum", HTTP_GET, timed<handleSpectrum>);
+  server.on("/metrics", HTTP_GET, handleMetrics); // Not timed itself, so a scrape does not show up in what it reads
+  
+  // Live stream; beyond STREAM_MAX_CLIENTS the request falls through to 404
+  liveStream.onConnect([](AsyncEventSourceClient* client) {
+    client->send("connected", "hello", 0, 2000); // Reconnect after 2 s
+  });
+  liveStream.setFilter([](AsyncWebServerRequest* request) {
+    return liveStream.count() < STREAM_MAX_CLIENTS;
+  });
+  server.addHandler(&liveStream);
+  
+  // The portal's first page should already have networks to offer
+  if (accessPointActive()) wifiScanWanted = true;
+  
+  // Add catch-all handler for debugging
+  server.onNotFound([](AsyncWebServerRequest* request) {
+    request->send(404, "text/plain", "Not found");
+  });
+}
+
+// Called from loop(): collect finished scans and start one when a page asked
+// for fresher results. scanNetworks(true) returns at once.
+void updateWifiScan() {
+  int found = WiFi.scanComplete();
+  if (found == WIFI_SCAN_RUNNING) return;
+  
+  if (found >= 0) {
+    if (found > WIFI_SCAN_MAX_NETWORKS) found = WIFI_SCAN_MAX_NETWORKS;
+    lockWebState();
+    for (int i = 0; i < found; i++) {
+      WifiNetwork& network = wifiNetworks[i];
+      strncpy(network.ssid, WiFi.SSID(i).c_str(), sizeof(network.ssid) - 1);
+      network.ssid[sizeof(network.ssid) - 1] = '\0';
+      network.rssi = WiFi.RSSI(i);
+      network.open = WiFi.encryptionType(i) == WIFI_AUTH_OPEN;
+    }
+    wifiNetworkCount = found;
+    wifiScanTime = millis();
+    wifiScanValid = true;
+    unlockWebState();
+    WiFi.scanDelete();
+  }
+  
+  if (wifiScanWanted) {
+    wifiScanWanted = false;
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) Serial.println(F("WiFi scan failed to start"));
+  }
+}
+
+// Sends a body with chunked transfer encoding. The body is freed with the
+// response, whether it was sent in full or the client went away.
+void sendChunked(AsyncWebServerRequest* request, const char* contentType, ChunkedBody* body,
+                 const char* disposition = NULL) {
+  std::shared_ptr<ChunkedBody> page(body);
+  AsyncWebServerResponse* response = request->beginChunkedResponse(contentType,
+    [page](uint8_t* buffer, size_t maxLength, size_t index) -> size_t {
+      return page->fill(buffer, maxLength);
+    });
+  if (disposition) response->addHeader("Content-Disposition", disposition);
+  request->send(response);
+}
+
+// A page generated by tools/embed_web_assets.py: gzipped in flash and sent
+// as it is. The ETag changes with the page, so browsers revalidate each load
+// and get a bodiless 304 while it is unchanged.
+void sendStaticPage(AsyncWebServerRequest* request, const uint8_t* data, size_t length,
+                    const char* etag) {
+  AsyncWebServerResponse* response;
+  if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value() == etag) {
+    response = request->beginResponse(304);
+  } else {
+    response = request->beginResponse(200, "text/html", data, length);
+    response->addHeader("Content-Encoding", "gzip");
+  }
+  response->addHeader("ETag", etag);
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+
+void handleRoot(AsyncWebServerRequest* request) {
   // If in AP mode, show WiFi config page, otherwise show normal dashboard
-  if (WiFi.getMode() == WIFI_AP) {
-    handleWifiConfig();
+  if (accessPointActive()) {
+    handleWifiConfig(request);
   } else {
-    String page = FPSTR(WIFI_HTML_PAGE);
-    page.replace("%IP_ADDRESS%", WiFi.localIP().toString());
-    server.send(200, "text/html", page);
+    sendStaticPage(request, WIFI_HTML_PAGE_GZ, WIFI_HTML_PAGE_GZ_LEN, WIFI_HTML_PAGE_ETAG);
   }
 }
 
-void handleData() {
-  String json = getSensorDataJson();
-  server.send(200, "application/json", json);
+void handleData(AsyncWebServerRequest* request) {
+  char buffer[1792];
+  JsonWriter json(buffer, sizeof(buffer));
+  lockWebState();
+  writeSensorDataJson(json);
+  unlockWebState();
+  json.finish();
+  request->send(200, "application/json", buffer);
 }
 
-void handleBleViewer() {
-  server.send(200, "text/html", HTML_PAGE);
+void handleBleViewer(AsyncWebServerRequest* request) {
+  sendStaticPage(request, BLE_HTML_PAGE_GZ, BLE_HTML_PAGE_GZ_LEN, BLE_HTML_PAGE_ETAG);
 }
 
-void handleWifiConfig() {
-  // Scan for available WiFi networks
-  int numNetworks = WiFi.scanNetworks();
+void handleWifiConfig(AsyncWebServerRequest* request) {
+  // Networks from the last background scan; ask loop() for a fresh one if it is getting old
+  WifiNetwork networks[WIFI_SCAN_MAX_NETWORKS];
+  lockWebState();
+  int numNetworks = wifiNetworkCount;
+  memcpy(networks, wifiNetworks, numNetworks * sizeof(WifiNetwork));
+  bool scanned = wifiScanValid;
+  unsigned long scanAge = millis() - wifiScanTime;
+  unlockWebState();
+  if (!scanned || scanAge >= WIFI_SCAN_MAX_AGE) wifiScanWanted = true;
   
   String html = "<!DOCTYPE html><html><head><title>Seismometer WiFi Setup</title>";
   html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
@@ -1081,9 +2264,9 @@ void handleWifiConfig() {
   if (numNetworks > 0) {
     html += "<div id='networkList'>";
     for (int i = 0; i < numNetworks; i++) {
-      String networkSSID = WiFi.SSID(i);
-      int32_t rssi = WiFi.RSSI(i);
-      String encType = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN) ? "Open" : "Secured";
+      String networkSSID = networks[i].ssid;
+      int32_t rssi = networks[i].rssi;
+      String encType = networks[i].open ? "Open" : "Secured";
       
       // Convert RSSI to signal strength percentage
       int signalStrength = 2 * (rssi + 100);
@@ -1097,6 +2280,8 @@ void handleWifiConfig() {
     }
     html += "</div>";
     html += "<p style='margin-top:10px;font-size:14px;color:#666;'>Or enter network name manually:</p>";
+  } else if (!scanned) {
+    html += "<p style='color:#666;'>Scanning for networks - reload in a few seconds, or enter the network name manually.</p>";
   } else {
     html += "<p style='color:#dc3545;'>No WiFi networks found. Please enter network name manually.</p>";
   }
@@ -1160,33 +2345,33 @@ void handleWifiConfig() {
   html += "</script>";
   html += "</body></html>";
   
-  server.send(200, "text/html", html);
+  request->send(200, "text/html", html);
 }
 
-void handleWifiSave() {
+void handleWifiSave(AsyncWebServerRequest* request) {
   Serial.println(F("WiFi credentials received via web interface"));
   
-  if (server.hasArg("ssid")) {
-    String newSsid = server.arg("ssid");
-    String newPass = server.hasArg("password") ? server.arg("password") : "";
+  if (request->hasParam("ssid", true)) {
+    String newSsid = request->getParam("ssid", true)->value();
+    String newPass = request->hasParam("password", true) ? request->getParam("password", true)->value() : "";
     
     // Validate input
     if (newSsid.length() == 0) {
-      server.send(400, "text/plain", "SSID cannot be empty");
+      request->send(400, "text/plain", "SSID cannot be empty");
       return;
     }
     
     if (newSsid.length() > 63) {
-      server.send(400, "text/plain", "SSID too long (max 63 characters)");
+      request->send(400, "text/plain", "SSID too long (max 63 characters)");
       return;
     }
     
     if (newPass.length() > 63) {
-      server.send(400, "text/plain", "Password too long (max 63 characters)");
+      request->send(400, "text/plain", "Password too long (max 63 characters)");
       return;
     }
     
-    // Send response FIRST, before doing anything that might cause issues
+    // The reply goes out after this handler returns; loop() restarts once it has
     String html = "<!DOCTYPE html><html><head><title>WiFi Saved</title>";
     html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
     html += "<style>body{font-family:Arial,sans-serif;margin:20px;text-align:center;background:#f0f0f0}";
@@ -1201,323 +2386,1648 @@ void handleWifiSave() {
     html += "</div>";
     html += "</body></html>";
     
-    server.send(200, "text/html", html);
+    request->send(200, "text/html", html);
     
-    // Now save the credentials
-    ssid = newSsid;
-    password = newPass;
-    saveWifiCredentials();
+    // Now save the credentials; loop() writes them before it restarts
+    changeStationConfig("wifi_ssid", newSsid.c_str());
+    changeStationConfig("wifi_password", newPass.c_str());
     
-    delay(3000);
-    Serial.println("Rebooting to apply new WiFi settings...");
-    ESP.restart();
+    restartAt = millis() + 3000;
+    if (restartAt == 0) restartAt = 1;
   } else {
-    server.send(400, "text/plain", "Missing SSID parameter");
+    request->send(400, "text/plain", "Missing SSID parameter");
   }
 }
 
-void saveWifiCredentials() {
-  // Ensure we don't exceed memory bounds
-  if (ssid.length() >= SSID_LEN || password.length() >= PASS_LEN) {
-    Serial.println(F("ERROR: Credentials too long for EEPROM storage"));
-    return;
-  }
-  
-  // Clear the EEPROM region for credentials before writing
-  for (int i = 0; i < EEPROM_SIZE; i++) {
-    EEPROM.write(i, 0);
+// A string the pre-NVS firmware kept in EEPROM; empty if none
+static void readLegacyString(int address, char* out, size_t size) {
+  size_t length = 0;
+  for (int i = 0; i < EEPROM_STRING_LEN && length + 1 < size; i++) {
+    char c = EEPROM.read(address + i);
+    if (c == 0 || c == (char)255) break; // 255 is uninitialized EEPROM value
+    out[length++] = c;
   }
+  out[length] = 0;
+}
 
-  // Write SSID to EEPROM
-  for (int i = 0; i < ssid.length() && i < (SSID_LEN - 1); ++i) {
-    EEPROM.write(SSID_ADDR + i, ssid[i]);
+// Schema 0 to 1: credentials and push targets move from EEPROM into NVS
+static void migrateStationConfig(uint16_t fromVersion, StationConfig& config, void* context) {
+  if (fromVersion > 0) return;
+  EEPROM.begin(EEPROM_SIZE);
+  readLegacyString(SSID_ADDR, config.wifi_ssid, sizeof(config.wifi_ssid));
+  readLegacyString(PASS_ADDR, config.wifi_password, sizeof(config.wifi_password));
+  readLegacyString(COLLECTOR_ADDR, config.collector, sizeof(config.collector));
+  readLegacyString(TELEMETRY_ADDR, config.telemetry, sizeof(config.telemetry));
+  EEPROM.end();
+  Serial.println(F("Config: settings migrated from EEPROM"));
+}
+
+// Called from setup() before anything uses a setting
+void loadStationConfig() {
+  stationConfig = defaultStationConfig();
+  configStorageReady = configStorage.begin();
+  if (configStorageReady) {
+    ConfigLoadResult result = configStore.load(stationConfig, migrateStationConfig, NULL);
+    Serial.print(F("Config: schema "));
+    Serial.print(result.stored_version);
+    Serial.print(F(", "));
+    Serial.print(result.loaded);
+    Serial.print(F(" settings loaded"));
+    if (result.rejected > 0) {
+      Serial.print(F(", "));
+      Serial.print(result.rejected);
+      Serial.print(F(" invalid ones reset to defaults"));
+    }
+    Serial.println();
+    bootNumber = configStore.nextBoot();
+    configStore.loadClockAnchors(clockAnchors);
+    Serial.print(F("Boot "));
+    Serial.println(bootNumber);
+    // Store the migration and replace invalid keys now rather than on the first change
+    if ((result.migrated || result.rejected > 0) && configStore.save(stationConfig) < 0) {
+      Serial.println(F("Config: NVS write failed"));
+    }
+  } else {
+    clockAnchors.count = 0;
+    Serial.println(F("Config: NVS unavailable, defaults in use and changes are not kept"));
   }
-  // Ensure null termination
-  EEPROM.write(SSID_ADDR + min((int)ssid.length(), SSID_LEN - 1), 0);
-  
-  // Write Password to EEPROM
-  if (password.length() > 0) {
-    for (int i = 0; i < password.length() && i < (PASS_LEN - 1); ++i) {
-      EEPROM.write(PASS_ADDR + i, password[i]);
+  appliedConfig = stationConfig;
+  applyConfigChanges(appliedConfig, true);
+}
+
+// Called from loop(): save and apply what changed since the last pass
+void updateStationConfig() {
+  lockWebState();
+  uint32_t revision = stationConfigRevision;
+  bool changed = revision != appliedConfigRevision;
+  StationConfig next;
+  if (changed) next = stationConfig;
+  unlockWebState();
+  if (!changed) return;
+  
+  if (configStorageReady) {
+    uint32_t start = millis();
+    int written = configStore.save(next);
+    if (written < 0) {
+      Serial.println(F("Config: NVS write failed"));
+    } else if (written > 0) {
+      Serial.print(F("Config: "));
+      Serial.print(written);
+      Serial.print(F(" keys written in "));
+      Serial.print(millis() - start);
+      Serial.println(F(" ms"));
     }
-    // Ensure null termination
-    EEPROM.write(PASS_ADDR + min((int)password.length(), PASS_LEN - 1), 0);
   }
-  
-  if (EEPROM.commit()) {
-    Serial.println(F("WiFi credentials saved to EEPROM"));
-  } else {
-    Serial.println(F("ERROR: Failed to save credentials to EEPROM"));
+  applyConfigChanges(next, false);
+  appliedConfig = next;
+  appliedConfigRevision = revision;
+}
+
+// Put settings into effect. At boot (initial) this only sets the variables
+// the rest of setup() reads; afterwards the running parts are updated too.
+void applyConfigChanges(const StationConfig& next, bool initial) {
+  if (next.wifi_ssid[0]) {
+    // Used by the next connection attempt, so after a restart
+    ssid = next.wifi_ssid;
+    password = next.wifi_password;
+  }
+  if (initial || strcmp(next.collector, appliedConfig.collector) != 0) {
+    setPushTargetAddress(collectorTarget, next.collector);
+  }
+  if (initial || strcmp(next.telemetry, appliedConfig.telemetry) != 0) {
+    setPushTargetAddress(telemetryTarget, next.telemetry);
+  }
+  updateInterval = next.update_interval_ms;
+  streamRateHz = (int)next.stream_rate_hz;
+  waveform_post_seconds = next.waveform_post_seconds;
+  if (initial) return; // startAcquisition() configures the detector and waveforms
+  
+  waveform.setPostTrigger((uint32_t)(waveform_post_seconds * accelFifo.sampleRateHz() / waveformDecimator.getFactor()));
+  // Between two drains; the FIFO keeps filling meanwhile
+  xSemaphoreTake(acquisitionMutex, portMAX_DELAY);
+  DetectorConfig tuned = detector.config();
+  applyStationConfig(next, tuned);
+  detector.retune(tuned);
+  xSemaphoreGive(acquisitionMutex);
+}
+
+// Called from any task: check one setting and hand it to loop(). Returns the
+// problem, NULL if it was accepted.
+const char* changeStationConfig(const char* name, const char* value) {
+  lockWebState();
+  StationConfig next = stationConfig;
+  ConfigSetResult result = setConfigParam(next, name, value);
+  const char* problem = NULL;
+  if (result == CONFIG_SET_UNKNOWN) problem = "unknown setting";
+  else if (result == CONFIG_SET_INVALID) problem = "invalid value or out of range";
+  else problem = checkStationConfig(next);
+  if (!problem) {
+    stationConfig = next;
+    stationConfigRevision++;
   }
+  unlockWebState();
+  return problem;
 }
 
-void loadWifiCredentials() {
-  // Read SSID
-  String loadedSsid = "";
-  for (int i = 0; i < SSID_LEN; ++i) {
-    char c = EEPROM.read(SSID_ADDR + i);
-    if (c == 0) break; // Stop at null terminator
-    if (c != 255) { // 255 is uninitialized EEPROM value
-      loadedSsid += c;
+// Serial commands SET, WAVEPOST, STREAMRATE, INTENSITY, COLLECTOR and TELEMETRY
+void reportConfigChange(const char* name, const char* value) {
+  const char* problem = changeStationConfig(name, value);
+  if (problem) {
+    Serial.print(F("Cannot set "));
+    Serial.print(name);
+    Serial.print(F(": "));
+    Serial.println(problem);
+    return;
+  }
+  const ConfigParam* param = findConfigParam(name);
+  char text[CONFIG_STRING_SIZE];
+  lockWebState();
+  formatConfigValue(*param, stationConfig, text, sizeof(text));
+  unlockWebState();
+  Serial.print(name);
+  Serial.print(F(" set to "));
+  Serial.print(text[0] ? text : "(none)");
+  if (param->unit) {
+    Serial.print(F(" "));
+    Serial.print(param->unit);
+  }
+  Serial.println(param->flags & CONFIG_REBOOT ? F(", after a restart") : F(""));
+}
+
+// Serial command CONFIG
+void printStationConfig() {
+  lockWebState();
+  StationConfig config = stationConfig;
+  unlockWebState();
+  Serial.print(F("--- Settings (schema "));
+  Serial.print(configStore.storedVersion());
+  Serial.print(F(", "));
+  Serial.print(configStore.writeCount());
+  Serial.println(F(" NVS writes since boot) ---"));
+  char text[CONFIG_STRING_SIZE];
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    const ConfigParam& param = configParam(i);
+    formatConfigValue(param, config, text, sizeof(text));
+    Serial.print(param.name);
+    Serial.print(F(" = "));
+    Serial.print(text);
+    if (param.unit) {
+      Serial.print(F(" "));
+      Serial.print(param.unit);
     }
+    Serial.println();
   }
-  
-  // Read Password
-  String loadedPass = "";
-  for (int i = 0; i < PASS_LEN; ++i) {
-    char c = EEPROM.read(PASS_ADDR + i);
-    if (c == 0) break; // Stop at null terminator
-    if (c != 255) { // 255 is uninitialized EEPROM value
-      loadedPass += c;
+}
+
+// /config/params: every setting with its default and limits, one per piece.
+// The settings are copied when the request arrives.
+class ConfigParamsBody : public ChunkedBody {
+  public:
+    ConfigParamsBody() {
+      lockWebState();
+      config = stationConfig;
+      unlockWebState();
+    }
+    
+  protected:
+    size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) {
+      if (index == 0) {
+        StationConfig defaults = defaultStationConfig();
+        int changed = 0;
+        for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+          if (!configValueEquals(configParam(i), config, defaults)) changed++;
+        }
+        JsonWriter json(out, size);
+        json.beginObject();
+        json.field("schema", (unsigned long)configStore.storedVersion());
+        json.field("nvs_writes", (unsigned long)configStore.writeCount());
+        json.field("changed", changed);
+        json.beginArray("params");
+        return json.finish(); // Closed by the last piece
+      }
+      size_t i = index - 1;
+      if (i == CONFIG_PARAM_COUNT) {
+        *text = "]}";
+        return 2;
+      }
+      if (i > CONFIG_PARAM_COUNT) return 0;
+      
+      size_t comma = i > 0 ? 1 : 0;
+      out[0] = ',';
+      JsonWriter json(out + comma, size - comma);
+      writeConfigParamJson(json, configParam(i), config);
+      return comma + json.finish();
+    }
+    
+  private:
+    StationConfig config;
+};
+
+void handleConfigParams(AsyncWebServerRequest* request) {
+  sendChunked(request, "application/json", new ConfigParamsBody());
+}
+
+// POST /config/params with form fields name=value. Every field is checked
+// before any is applied, so a bad one changes nothing.
+void handleConfigParamsUpdate(AsyncWebServerRequest* request) {
+  char problem[96] = "";
+  lockWebState();
+  StationConfig next = stationConfig;
+  size_t fields = request->params();
+  for (size_t i = 0; i < fields && !problem[0]; i++) {
+    const AsyncWebParameter* field = request->getParam(i);
+    if (!field->isPost()) continue;
+    ConfigSetResult result = setConfigParam(next, field->name().c_str(), field->value().c_str());
+    if (result != CONFIG_SET_OK) {
+      snprintf(problem, sizeof(problem), "%s: %s", field->name().c_str(),
+               result == CONFIG_SET_UNKNOWN ? "unknown setting" : "invalid value or out of range");
     }
   }
+  if (!problem[0]) {
+    const char* inconsistent = checkStationConfig(next);
+    if (inconsistent) strncpy(problem, inconsistent, sizeof(problem) - 1);
+  }
+  if (!problem[0]) {
+    stationConfig = next;
+    stationConfigRevision++; // loop() saves and applies it
+  }
+  unlockWebState();
+  
+  if (problem[0]) {
+    request->send(400, "text/plain", problem);
+    return;
+  }
+  handleConfigParams(request);
+}
 
-  if (loadedSsid.length() > 0) {
-    ssid = loadedSsid;
-    Serial.print(F("Loaded SSID: "));
-    Serial.println(ssid);
+// "host" or "host:port", empty when off
+void setPushTargetAddress(PushTarget& target, const char* address) {
+  String host = address;
+  host.trim();
+  target.port = target.default_port;
+  int colon = host.lastIndexOf(':');
+  if (colon > 0) {
+    long port = host.substring(colon + 1).toInt();
+    if (port > 0 && port < 65536) target.port = (uint16_t)port;
+    host = host.substring(0, colon);
   }
+  target.host = host;
+  target.resolved = false;
+  target.last_resolve = 0;
+}
 
-  if (loadedPass.length() > 0) {
-    password = loadedPass;
-    Serial.println(F("Loaded password from EEPROM"));
+// Called from loop(); a failed lookup is retried every PUSH_RESOLVE_INTERVAL.
+// A literal address, unicast or multicast, needs no DNS.
+bool resolvePushTarget(PushTarget& target) {
+  if (target.host.length() == 0 || WiFi.status() != WL_CONNECTED) return false;
+  if (target.resolved) return true;
+  if (target.last_resolve != 0 && millis() - target.last_resolve < PUSH_RESOLVE_INTERVAL) return false;
+  target.last_resolve = millis();
+  target.resolved = WiFi.hostByName(target.host.c_str(), target.ip) == 1;
+  return target.resolved;
+}
+
+bool sendPushPacket(PushTarget& target, WiFiUDP& udp, const uint8_t* data, size_t length) {
+  if (!target.resolved || WiFi.status() != WL_CONNECTED) return false;
+  if (udp.beginPacket(target.ip, target.port) && udp.write(data, length) == length && udp.endPacket()) {
+    target.sent++;
+    return true;
   }
+  target.errors++;
+  return false;
 }
 
-String getSensorDataJson() {
-  // Calculate current deviation magnitude for JSON
-  float x_dev = abs(x_accel - x_baseline);
-  float y_dev = abs(y_accel - y_baseline);
-  float z_dev = abs(z_accel - z_baseline);
-  if (x_dev < noise_threshold) x_dev = 0;
-  if (y_dev < noise_threshold) y_dev = 0;
-  if (z_dev < noise_threshold) z_dev = 0;
-  float dev_mag = sqrt(x_dev*x_dev + y_dev*y_dev + z_dev*z_dev);
-  int current_mercalli = calculateMercalli(dev_mag);
+void printPushTarget(const PushTarget& target) {
+  if (target.host.length() == 0) {
+    Serial.println(F("off"));
+    return;
+  }
+  Serial.print(target.host);
+  Serial.print(F(":"));
+  Serial.print(target.port);
+  Serial.print(target.resolved ? F(" (") : F(" (unresolved"));
+  if (target.resolved) Serial.print(target.ip);
+  Serial.print(F("), "));
+  Serial.print(target.sent);
+  Serial.print(F(" packets sent, "));
+  Serial.print(target.errors);
+  Serial.println(F(" errors"));
+}
 
-  // Create JSON response
-  String json = "{";
-  json += "\"mercalli_peak\":" + String(mercalli_peak) + ",";
-  json += "\"mercalli_now\":" + String(current_mercalli) + ",";
-  json += "\"x_peak\":" + String(x_peak) + ",";
-  json += "\"y_peak\":" + String(y_peak) + ",";
-  json += "\"z_peak\":" + String(z_peak) + ",";
-  json += "\"dev_mag_peak\":" + String(deviation_magnitude_peak) + ",";
-  json += "\"x_now\":" + String(x_dev) + ",";
-  json += "\"y_now\":" + String(y_dev) + ",";
-  json += "\"z_now\":" + String(z_dev) + ",";
-  json += "\"dev_mag_now\":" + String(dev_mag) + ",";
-  json += getEventsJson();
-  json += "}";
+// Called from loop(): resolve the destinations and send collector heartbeats
+void updateCollector() {
+  resolvePushTarget(telemetryTarget);
+  if (!resolvePushTarget(collectorTarget)) return;
   
-  return json;
+  static unsigned long lastHeartbeat = 0;
+  if (lastHeartbeat == 0 || millis() - lastHeartbeat >= COLLECTOR_HEARTBEAT_INTERVAL) {
+    lastHeartbeat = millis();
+    sendTriggerPacket(TRIGGER_PACKET_HEARTBEAT, esp_timer_get_time(), latestSample.sta_lta,
+                      deviationMagnitude(latestSample.dev), latestSample.mercalli);
+  }
+}
+
+// Called from loop() for every published sample: report trigger edges, the
+// onset with the values at that sample and the release with the peaks in between
+void trackCollectorTrigger(const ProcessedSample& sample) {
+  if (sample.triggered) {
+    float magnitude = deviationMagnitude(sample.dev);
+    if (!collectorTriggered) {
+      collectorTriggered = true;
+      collectorPeakStaLta = 0;
+      collectorPeakMagnitude = 0;
+      collectorPeakMercalli = 0;
+      sendTriggerPacket(TRIGGER_PACKET_ON, sample.time_us, sample.sta_lta, magnitude, sample.mercalli);
+    }
+    if (sample.sta_lta > collectorPeakStaLta) collectorPeakStaLta = sample.sta_lta;
+    if (magnitude > collectorPeakMagnitude) collectorPeakMagnitude = magnitude;
+    if (sample.mercalli > collectorPeakMercalli) collectorPeakMercalli = sample.mercalli;
+  } else if (collectorTriggered) {
+    collectorTriggered = false;
+    sendTriggerPacket(TRIGGER_PACKET_OFF, sample.time_us, collectorPeakStaLta, collectorPeakMagnitude,
+                      collectorPeakMercalli);
+  }
+}
+
+// One datagram; the time is UTC once NTP has synced, uptime before
+void sendTriggerPacket(uint8_t type, int64_t local_us, float staLta, float magnitude, uint8_t mercalli) {
+  if (!collectorTarget.resolved) return;
+  
+  TriggerPacket packet;
+  packet.station = stationId;
+  packet.sequence = collectorSequence++;
+  packet.type = type;
+  packet.mercalli = mercalli;
+  ClockModel clock = clockSnapshot();
+  packet.flags = clock.valid() ? TRIGGER_FLAG_TIME_SYNCED : 0;
+  packet.time_us = clock.toUtc(local_us);
+  float ratio = staLta * 100.0f + 0.5f;
+  packet.sta_lta_x100 = ratio > 65535.0f ? 65535 : (uint16_t)ratio;
+  float mm = magnitude * 1000.0f + 0.5f;
+  packet.magnitude_mm = mm > 65535.0f ? 65535 : (uint16_t)mm;
+  
+  uint8_t buffer[TRIGGER_PACKET_SIZE];
+  encodeTriggerPacket(packet, buffer);
+  sendPushPacket(collectorTarget, collectorUdp, buffer, sizeof(buffer));
+}
+
+// Called from loop() for every live sample while telemetry has a resolved
+// address; a full packet goes out at once. A packet that cannot be sent still
+// uses its sequence number, so listeners see the gap.
+void queueTelemetrySample(const RawSample& sample, int64_t time_us) {
+  if (telemetrySampleCount == 0) telemetryPacket.time_us = time_us;
+  telemetryPacket.samples[telemetrySampleCount++] = sample;
+  if (telemetrySampleCount < TELEMETRY_SAMPLES) return;
+  telemetrySampleCount = 0;
+  
+  const DetectorPeaks& peaks = loopSnapshot.peaks;
+  float staLta = latestSample.sta_lta * 100.0f + 0.5f;
+  float peakMagnitude = sqrtf(peaks.dev_mag_sq) + 0.5f;
+  ClockModel clock = clockSnapshot();
+  uint32_t ringDrops = sampleRing.dropCount();
+  
+  telemetryPacket.station = stationId;
+  telemetryPacket.sequence = telemetrySequence++;
+  telemetryPacket.time_us = clock.toUtc(telemetryPacket.time_us);
+  telemetryPacket.rate_dhz = (uint16_t)(liveSampleRate * 10.0f + 0.5f);
+  telemetryPacket.scale_um = (uint16_t)(loopSnapshot.ms2_per_count * 1e6f + 0.5f);
+  telemetryPacket.mercalli_now = latestSample.mercalli;
+  telemetryPacket.mercalli_peak = peaks.mercalli;
+  telemetryPacket.flags = clock.valid() ? TELEMETRY_TIME_SYNCED : 0;
+  if (latestSample.triggered) telemetryPacket.flags |= TELEMETRY_TRIGGERED;
+  if (ringDrops != telemetryRingDrops) telemetryPacket.flags |= TELEMETRY_GAP;
+  telemetryRingDrops = ringDrops;
+  telemetryPacket.sta_lta_x100 = staLta > 65535.0f ? 65535 : (uint16_t)staLta;
+  telemetryPacket.peak_x = roundCounts(peaks.x);
+  telemetryPacket.peak_y = roundCounts(peaks.y);
+  telemetryPacket.peak_z = roundCounts(peaks.z);
+  telemetryPacket.peak_magnitude = peakMagnitude > 65535.0f ? 65535 : (uint16_t)peakMagnitude;
+  
+  uint8_t buffer[TELEMETRY_PACKET_SIZE];
+  encodeTelemetryPacket(telemetryPacket, buffer);
+  sendPushPacket(telemetryTarget, telemetryUdp, buffer, sizeof(buffer));
 }
 
+void writeSensorDataJson(JsonWriter& json) {
+  // Current deviations from the newest published sample, detector state from
+  // the newest snapshot (both under webStateMutex, held by the caller)
+  // Counts to m/s² happens here, at the edge
+  const DetectorSnapshot& state = detectorSnapshot;
+  float scale = state.ms2_per_count;
+  float x_dev = latestSample.dev.x * scale;
+  float y_dev = latestSample.dev.y * scale;
+  float z_dev = latestSample.dev.z * scale;
+  const RawSample& dev = latestSample.dev;
+  float dev_mag = sqrtf((float)((int32_t)dev.x * dev.x + (int32_t)dev.y * dev.y + (int32_t)dev.z * dev.z)) * scale;
+  int current_mercalli = latestSample.mercalli;
+  const DetectorPeaks& peaks = state.peaks;
+  bool calibrating = state.calibrating || calibrationRequested;
+  
+  // For the dashboard footer; the page itself is static
+  IPAddress ip = accessPointActive() ? WiFi.softAPIP() : WiFi.localIP();
+  char localAddress[16];
+  snprintf(localAddress, sizeof(localAddress), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+
+  json.beginObject();
+  json.field("mercalli_peak", peaks.mercalli);
+  json.field("mercalli_now", current_mercalli);
+  json.field("x_peak", peaks.x * scale);
+  json.field("y_peak", peaks.y * scale);
+  json.field("z_peak", peaks.z * scale);
+  json.field("dev_mag_peak", sqrtf(peaks.dev_mag_sq) * scale);
+  json.field("x_now", x_dev);
+  json.field("y_now", y_dev);
+  json.field("z_now", z_dev);
+  json.field("dev_mag_now", dev_mag);
+  json.field("sta_lta", latestSample.sta_lta);
+  json.field("triggered", latestSample.triggered);
+  json.field("mmi_now", latestSample.mmi, 1);
+  json.beginObject("ground_motion"); // Horizontal peaks since the last reset
+  json.field("pga", peaks.motion.pga * scale, 3);
+  json.field("pgv", peaks.motion.pgv * scale, 4);
+  json.field("pgd", peaks.motion.pgd * scale, 5);
+  json.field("mmi", peaks.motion.mmi, 1);
+  json.field("mode", state.intensity_mode == INTENSITY_REGRESSION ? "regression" : "thresholds");
+  json.endObject();
+  json.beginObject("jma"); // Instrumental intensity of the last minute; null until ready
+  json.field("intensity", jmaIntensityNow);
+  json.field("class", isnan(jmaIntensityNow) ? NULL : jmaIntensityClass(jmaIntensityNow));
+  json.field("level_gal", jmaLevelGal, 1);
+  json.field("peak", jmaIntensityPeak);
+  json.field("peak_class", isnan(jmaIntensityPeak) ? NULL : jmaIntensityClass(jmaIntensityPeak));
+  json.endObject();
+  json.field("sample_rate", accelFifo.sampleRateHz(), 0);
+  json.field("fifo_overruns", accelFifo.overrunCount());
+  json.field("ring_high_water", sampleRing.highWaterMark());
+  json.field("ring_drops", sampleRing.dropCount());
+  json.field("detector_cycles_avg", detectorCyclesAvg, 0);
+  json.field("detector_cycles_max", detectorCyclesMax);
+  json.field("display_bytes_per_s", displayBytesPerSecond, 0);
+  json.field("display_transfer_ms_per_s", displayTransferMsPerSecond, 1);
+  json.field("calibrating", calibrating);
+  json.field("calibration_progress", state.calibration_progress);
+  json.field("calibrated", state.calibrated);
+  json.field("calibration_ok", state.calibrated && (state.calibration_restored || state.calibration_good));
+  json.field("calibration_restored", state.calibration_restored);
+  json.field("noise_threshold", state.noise_threshold, 4); // The gate in use
+  json.beginObject("noise_floor"); // Background noise sigma per axis (m/s²)
+  json.field("valid", state.noise_valid);
+  json.field("adapting", state.noise_adapting);
+  json.field("window_progress", state.noise_window_progress);
+  json.field("windows", state.noise_windows);
+  json.field("x", state.noise_sigma[0] * scale, 4);
+  json.field("y", state.noise_sigma[1] * scale, 4);
+  json.field("z", state.noise_sigma[2] * scale, 4);
+  json.beginArray("history"); // Largest axis after each window, oldest first
+  for (uint32_t i = 0; i < state.noise_history_count; i++) {
+    json.field(NULL, state.noise_history[i] * scale, 4);
+  }
+  json.endArray();
+  json.endObject();
+  ClockModel clock = clockSnapshot();
+  json.beginObject("clock"); // esp_timer to UTC model, updated by every NTP sync
+  json.field("synced", clock.valid());
+  json.field("drift_ppm", clock.driftPpm(), 2);
+  json.field("syncs", clock.syncCount());
+  json.field("rejected", clock.rejectedCount());
+  json.field("last_residual_ms", clock.lastResidualUs() / 1000.0f, 1);
+  if (clock.valid()) json.field("last_sync_age_s", (unsigned long)((esp_timer_get_time() - clock.lastSyncLocalUs()) / 1000000));
+  else json.fieldNull("last_sync_age_s");
+  json.endObject();
+  json.field("ip", localAddress);
+  writeEventSummaryJson(json);
+  json.endObject();
+}
+
+// Start SNTP and return; onTimeSync() picks up every sync in the background
 void initializeTime() {
+  beginBootPhase(BOOT_NTP);
   Serial.println("Initializing NTP time sync...");
+  sntp_set_time_sync_notification_cb(onTimeSync);
+  sntp_set_sync_interval(NTP_SYNC_INTERVAL);
   configTime(gmtOffset_sec, daylightOffset_sec, ntpServer1, ntpServer2, ntpServer3);
-  
-  // Wait for time to be set - be more patient
-  int attempts = 0;
-  time_t now;
-  while (attempts < 30) {  // Increased from 10 to 30 attempts
-    now = time(nullptr);
-    if (now > 1000000000) {  // Check if we have a reasonable timestamp (after year 2001)
-      timeInitialized = true;
-      Serial.println();
-      Serial.print("Time synchronized: ");
-      Serial.println(ctime(&now));
-      return;
-    }
-    Serial.print(".");
-    delay(1000);
-    attempts++;
-  }
-  
-  Serial.println();
-  Serial.println("Failed to sync time with NTP server");
-  timeInitialized = false;
 }
 
-void logSeismicEvent(float mercalli, float x, float y, float z, float mag) {
-  if (!timeInitialized) return;
-  
-  time_t now = time(nullptr);
-  
-  // Validate timestamp
-  if (now < 1000000000) {  // Less than year 2001, time sync issue
-    Serial.println("Event logging skipped - invalid timestamp");
-    return;
+// Called from the lwIP task right after SNTP set the system time to tv
+void onTimeSync(struct timeval* tv) {
+  int64_t local_us = esp_timer_get_time();
+  if (tv->tv_sec < 1000000000) return; // Before 2001: not a real time
+  int64_t utc_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+  
+  portENTER_CRITICAL(&clockLock);
+  clockModel.addSync(local_us, utc_us);
+  bool valid = clockModel.valid();
+  portEXIT_CRITICAL(&clockLock);
+  timeInitialized = valid;
+  if (valid) endBootPhase(BOOT_NTP);
+}
+
+ClockModel clockSnapshot() {
+  portENTER_CRITICAL(&clockLock);
+  ClockModel copy = clockModel;
+  portEXIT_CRITICAL(&clockLock);
+  return copy;
+}
+
+// UTC of an esp_timer value; false until the first NTP sync
+bool clockToUtc(int64_t local_us, time_t* seconds, uint16_t* ms) {
+  portENTER_CRITICAL(&clockLock);
+  bool valid = clockModel.valid();
+  int64_t utc_us = clockModel.toUtc(local_us);
+  portEXIT_CRITICAL(&clockLock);
+  if (!valid || utc_us < 0) return false;
+  *seconds = (time_t)(utc_us / 1000000);
+  *ms = (uint16_t)((utc_us % 1000000) / 1000);
+  return true;
+}
+
+// Called from the acquisition task: stamp the event and hand it to loop().
+// Before the first sync it has only its boot and esp_timer onset.
+void logSeismicEvent(float mercalli, float x, float y, float z, float mag, int64_t onset_us) {
+  SeismicEvent event;
+  event.boot = bootNumber;
+  event.onset_us = onset_us;
+  if (!clockToUtc(onset_us, &event.timestamp, &event.timestamp_ms)) {
+    event.timestamp = 0;
+    event.timestamp_ms = 0;
   }
+  event.mercalli = mercalli;
+  event.x_peak = x;
+  event.y_peak = y;
+  event.z_peak = z;
+  event.magnitude = mag;
+  event.dominant_hz = 0; // Filled in by loop() once the spectrum covers the event
+  event.jma_intensity = NAN; // Likewise, once the JMA result does
+  event.pga = event.pgv = event.pgd = event.mmi = NAN; // And once the shaking has passed
+  // The capture keeps raw counts, so it keeps the calibration they were taken under
+  WaveformCalibration calibration = { calibration_offset_x, calibration_offset_y, calibration_offset_z,
+                                      detector.config().ms2_per_count };
+  event.waveform_id = waveform.trigger((uint32_t)(onset_us / 1000), (uint32_t)event.timestamp, (int)mercalli,
+                                       calibration);
+  eventRing.push(event);
+}
+
+// Called from loop(): store the event in the circular buffer and on flash, and
+// report it. One without a time yet is written with its boot-relative onset.
+void storeSeismicEvent(SeismicEvent& event) {
+  if (event.timestamp == 0) clockToUtc(event.onset_us, &event.timestamp, &event.timestamp_ms);
   
-  // Store event in circular buffer
-  eventLog[eventIndex].timestamp = now;
-  eventLog[eventIndex].mercalli = mercalli;
-  eventLog[eventIndex].x_peak = x;
-  eventLog[eventIndex].y_peak = y;
-  eventLog[eventIndex].z_peak = z;
-  eventLog[eventIndex].magnitude = mag;
+  lockWebState();
+  eventLog[eventIndex] = event;
   
   eventIndex = (eventIndex + 1) % MAX_EVENTS;
   if (eventCount < MAX_EVENTS) eventCount++;
+  eventLogRevision++;
+  
+  appendStoredEvent(event);
+  unlockWebState();
   
+  char when[32];
+  formatEventTime(event.timestamp, event.timestamp_ms, event.boot, event.onset_us, when, sizeof(when));
   Serial.println("*** SEISMIC EVENT LOGGED ***");
   Serial.print("Time: ");
-  Serial.print(ctime(&now));
+  Serial.println(when);
   Serial.print("Mercalli: ");
-  Serial.println(mercalli);
+  Serial.println(event.mercalli);
   Serial.print("Current deviations - X: ");
-  Serial.print(x, 3);
+  Serial.print(event.x_peak, 3);
   Serial.print(", Y: ");
-  Serial.print(y, 3);
+  Serial.print(event.y_peak, 3);
   Serial.print(", Z: ");
-  Serial.println(z, 3);
+  Serial.println(event.z_peak, 3);
   Serial.print("Magnitude: ");
-  Serial.println(mag, 3);
+  Serial.println(event.magnitude, 3);
+  if (event.dominant_hz > 0) {
+    Serial.print("Dominant frequency: ");
+    Serial.print(event.dominant_hz, 2);
+    Serial.println(" Hz");
+  }
+  if (!isnan(event.jma_intensity)) {
+    Serial.print("JMA intensity: ");
+    Serial.print(event.jma_intensity, 2);
+    Serial.print(" (class ");
+    Serial.print(jmaIntensityClass(event.jma_intensity));
+    Serial.println(")");
+  }
+  if (!isnan(event.mmi)) {
+    Serial.print("Ground motion - PGA: ");
+    Serial.print(event.pga, 3);
+    Serial.print(" m/s2, PGV: ");
+    Serial.print(event.pgv * 100.0f, 2);
+    Serial.print(" cm/s, PGD: ");
+    Serial.print(event.pgd * 100.0f, 2);
+    Serial.print(" cm, MMI ");
+    Serial.println(event.mmi, 1);
+  }
+  if (event.waveform_id != 0) {
+    Serial.print("Waveform: /events/waveform?id=");
+    Serial.println(event.waveform_id);
+  }
   Serial.println("**************************");
 }
 
+// Under webStateMutex
+void appendStoredEvent(const SeismicEvent& event) {
+  if (!eventStoreReady) return;
+  StoredEvent stored;
+  stored.timestamp = (uint32_t)event.timestamp;
+  stored.timestamp_ms = event.timestamp_ms;
+  stored.mercalli = event.mercalli;
+  stored.x_peak = event.x_peak;
+  stored.y_peak = event.y_peak;
+  stored.z_peak = event.z_peak;
+  stored.magnitude = event.magnitude;
+  stored.dominant_hz = event.dominant_hz;
+  stored.jma_intensity = event.jma_intensity;
+  stored.pga = event.pga;
+  stored.pgv = event.pgv;
+  stored.pgd = event.pgd;
+  stored.mmi = event.mmi;
+  stored.boot = event.boot;
+  stored.onset_us = event.onset_us;
+  stored.flags = event.timestamp == 0 ? EVENT_UNSYNCED : 0;
+  if (!eventStore.append(stored)) {
+    Serial.println(F("Event store: write failed"));
+  } else if (event.timestamp == 0) {
+    unsyncedEventsStored = true;
+  }
+}
+
+// Called from loop() when the clock becomes valid: give the events of this
+// boot logged without a time one, and if any went to flash that way keep the
+// UTC time this boot started, from which theirs is derived after a restart
+void timestampPendingEvents() {
+  int stamped = 0;
+  bool anchorSaved = true;
+  lockWebState();
+  for (int i = 0; i < eventCount; i++) {
+    SeismicEvent& event = eventLog[(eventIndex - eventCount + i + MAX_EVENTS) % MAX_EVENTS];
+    if (event.timestamp != 0 || event.boot != bootNumber) continue;
+    if (!clockToUtc(event.onset_us, &event.timestamp, &event.timestamp_ms)) break;
+    stamped++;
+  }
+  if (stamped > 0) eventLogRevision++;
+  bool anchor = unsyncedEventsStored && bootNumber != 0 && configStorageReady;
+  ClockAnchors anchors;
+  if (anchor) {
+    portENTER_CRITICAL(&clockLock);
+    int64_t bootUtc = clockModel.toUtc(0);
+    portEXIT_CRITICAL(&clockLock);
+    addClockAnchor(clockAnchors, bootNumber, bootUtc);
+    anchors = clockAnchors;
+  }
+  unlockWebState();
+  if (anchor) anchorSaved = configStore.saveClockAnchors(anchors);
+  
+  if (stamped > 0) {
+    Serial.print(F("Clock synced: "));
+    Serial.print(stamped);
+    Serial.println(F(" events logged before it now have a time"));
+  }
+  if (!anchorSaved) Serial.println(F("Config: NVS write failed, unsynced events keep boot-relative times"));
+}
+
+// UTC of an onset in the given boot: from the clock model for this boot, from
+// the time the boot started for earlier ones; false if neither is known.
+// Under webStateMutex.
+bool eventUtc(uint32_t boot, int64_t onset_us, time_t* seconds, uint16_t* ms) {
+  if (boot == 0) return false;
+  if (boot == bootNumber) return clockToUtc(onset_us, seconds, ms);
+  int64_t bootUtc;
+  if (!findClockAnchor(clockAnchors, boot, bootUtc)) return false;
+  int64_t utc_us = bootUtc + onset_us;
+  *seconds = (time_t)(utc_us / 1000000);
+  *ms = (uint16_t)((utc_us % 1000000) / 1000);
+  return true;
+}
+
+// Called from loop() and from the /clearevents handler
 void clearEventLog() {
+  lockWebState();
   eventCount = 0;
   eventIndex = 0;
-  lastLoggedMercalli = 0;
+  eventLogRevision++;
+  eventHistoryResetRequested = true;
+  bool cleared = !eventStoreReady || eventStore.clear();
+  unlockWebState();
+  if (!cleared) Serial.println(F("Event store: clear failed"));
   Serial.println("Event log cleared.");
 }
 
-String formatTimestamp(time_t timestamp) {
-  struct tm * timeinfo = localtime(&timestamp);
-  char buffer[32];
-  strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S UTC", timeinfo);
-  return String(buffer);
+void setupEventStore() {
+  if (!LittleFS.begin(true) || !eventStorage.begin() ||
+      !eventStore.begin(EVENT_SEGMENT_RECORDS, EVENT_SEGMENTS)) {
+    Serial.println(F("Event store unavailable, events are kept in RAM only"));
+    return;
+  }
+  eventStoreReady = true;
+  
+  // Refill the in-memory log with the newest events, oldest first.
+  // Their waveforms did not survive the restart.
+  static StoredEvent recent[MAX_EVENTS];
+  size_t count = eventStore.readLatest(recent, MAX_EVENTS);
+  for (size_t i = count; i-- > 0;) {
+    SeismicEvent& event = eventLog[eventIndex];
+    event.timestamp = recent[i].timestamp;
+    event.timestamp_ms = recent[i].timestamp_ms;
+    event.boot = recent[i].boot; // An earlier boot
+    event.onset_us = recent[i].onset_us;
+    if (recent[i].flags & EVENT_UNSYNCED) {
+      if (!eventUtc(event.boot, event.onset_us, &event.timestamp, &event.timestamp_ms)) {
+        event.timestamp = 0;
+        event.timestamp_ms = 0;
+      }
+    }
+    event.mercalli = recent[i].mercalli;
+    event.x_peak = recent[i].x_peak;
+    event.y_peak = recent[i].y_peak;
+    event.z_peak = recent[i].z_peak;
+    event.magnitude = recent[i].magnitude;
+    event.dominant_hz = recent[i].dominant_hz;
+    event.jma_intensity = recent[i].jma_intensity; // NAN in records from older firmware
+    event.pga = recent[i].pga;
+    event.pgv = recent[i].pgv;
+    event.pgd = recent[i].pgd;
+    event.mmi = recent[i].mmi;
+    event.waveform_id = 0;
+    eventIndex = (eventIndex + 1) % MAX_EVENTS;
+    if (eventCount < MAX_EVENTS) eventCount++;
+  }
+  
+  Serial.print(F("Event store: "));
+  Serial.print(eventStore.recordCount());
+  Serial.print(F(" events on flash, "));
+  Serial.print(count);
+  Serial.print(F(" restored"));
+  if (eventStore.tornRecords() > 0) {
+    Serial.print(F(", "));
+    Serial.print(eventStore.tornRecords());
+    Serial.print(F(" torn records skipped"));
+  }
+  Serial.println();
 }
 
-void handleEvents() {
-  // Check if client wants JSON data
-  if (server.hasArg("format") && server.arg("format") == "json") {
-    String json = "{";
-    json += "\"timeInitialized\":" + String(timeInitialized ? "true" : "false") + ",";
-    json += "\"eventCount\":" + String(eventCount) + ",";
-    json += "\"events\":[";
+// Every event on flash as CSV, a few lines per piece, oldest first
+class EventExportBody : public ChunkedBody {
+  public:
+    EventExportBody() {
+      cursor.segment = 0;
+      cursor.record = 0;
+    }
     
-    if (eventCount > 0) {
-      // Show events in reverse chronological order (newest first)
-      for (int i = 0; i < eventCount; i++) {
-        int idx = (eventIndex - 1 - i + MAX_EVENTS) % MAX_EVENTS;
-        if (i > 0) json += ",";
-        
-        json += "{";
-        json += "\"timestamp\":\"" + formatTimestamp(eventLog[idx].timestamp) + "\",";
-        json += "\"mercalli\":" + String(eventLog[idx].mercalli) + ",";
-        json += "\"x_peak\":" + String(eventLog[idx].x_peak, 3) + ",";
-        json += "\"y_peak\":" + String(eventLog[idx].y_peak, 3) + ",";
-        json += "\"z_peak\":" + String(eventLog[idx].z_peak, 3) + ",";
-        json += "\"magnitude\":" + String(eventLog[idx].magnitude, 3);
-        json += "}";
+  protected:
+    size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) {
+      if (index == 0) {
+        *text = "sequence,timestamp,mercalli,x_peak,y_peak,z_peak,magnitude,dominant_hz,"
+                "jma_intensity,pga,pgv,pgd,mmi,synced,boot,onset_s\n";
+        return strlen(*text);
+      }
+      
+      StoredEvent batch[2]; // A line is well under 250 bytes
+      time_t times[2];
+      uint16_t ms[2];
+      lockWebState();
+      size_t count = eventStore.readNext(cursor, batch, 2);
+      for (size_t i = 0; i < count; i++) {
+        times[i] = batch[i].timestamp;
+        ms[i] = batch[i].timestamp_ms;
+        if ((batch[i].flags & EVENT_UNSYNCED) && !eventUtc(batch[i].boot, batch[i].onset_us, &times[i], &ms[i])) {
+          times[i] = 0;
+        }
       }
+      unlockWebState();
+      
+      size_t used = 0;
+      for (size_t i = 0; i < count && used < size; i++) {
+        const StoredEvent& event = batch[i];
+        char when[32];
+        formatEventTime(times[i], ms[i], event.boot, event.onset_us, when, sizeof(when));
+        // Unknown values (NaN) are left empty
+        char motion[5][16];
+        const float values[5] = { event.jma_intensity, event.pga, event.pgv, event.pgd, event.mmi };
+        for (int k = 0; k < 5; k++) {
+          if (isnan(values[k])) motion[k][0] = '\0';
+          else snprintf(motion[k], sizeof(motion[k]), "%.4g", values[k]);
+        }
+        used += snprintf(out + used, size - used,
+                         "%lu,%s,%.0f,%.3f,%.3f,%.3f,%.3f,%.2f,%s,%s,%s,%s,%s,%d,%lu,%.3f\n",
+                         (unsigned long)event.sequence, when, event.mercalli,
+                         event.x_peak, event.y_peak, event.z_peak, event.magnitude, event.dominant_hz,
+                         motion[0], motion[1], motion[2], motion[3], motion[4],
+                         (event.flags & EVENT_UNSYNCED) ? 0 : 1, (unsigned long)event.boot,
+                         event.onset_us / 1e6);
+      }
+      return used;
     }
     
-    json += "]}";
-    server.send(200, "application/json", json);
-  } else {
-    // Serve HTML page for event viewing
-    String html = "<!DOCTYPE html><html><head><title>Seismic Event Log</title>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-    html += "<style>body{font-family:Arial,sans-serif;margin:20px;background:#f0f0f0;color:#333}";
-    html += ".container{max-width:800px;margin:0 auto;background:white;padding:20px;border-radius:10px;box-shadow:0 2px 10px rgba(0,0,0,0.1)}";
-    html += "h1{color:#333;text-align:center}";
-    html += ".status{text-align:center;padding:15px;margin:20px 0;border-radius:8px}";
-    html += ".status.online{background:#d4edda;border:1px solid #c3e6cb;color:#155724}";
-    html += ".status.offline{background:#f8d7da;border:1px solid #f5c6cb;color:#721c24}";
-    html += "table{width:100%;border-collapse:collapse;margin-top:20px}";
-    html += "th,td{padding:12px;text-align:left;border-bottom:1px solid #ddd}";
-    html += "th{background:#f8f9fa;font-weight:bold}";
-    html += ".mercalli{font-weight:bold;font-size:1.1em}";
-    html += ".mercalli-low{color:#28a745}";
-    html += ".mercalli-medium{color:#ffc107}";
-    html += ".mercalli-high{color:#dc3545}";
-    html += ".back-link{display:inline-block;margin-bottom:20px;padding:8px 16px;background:#007bff;color:white;text-decoration:none;border-radius:5px}";
-    html += ".back-link:hover{background:#0056b3}";
-    html += ".refresh-btn{margin-left:10px;padding:8px 16px;background:#28a745;color:white;border:none;border-radius:5px;cursor:pointer}";
-    html += ".clear-btn{margin-left:10px;padding:8px 16px;background:#dc3545;color:white;border:none;border-radius:5px;cursor:pointer}";
-    html += ".clear-btn:hover{background:#c82333}";
-    html += "</style></head><body>";
-    html += "<div class='container'>";
-    html += "<a href='/' class='back-link'>← Back to Dashboard</a>";
-    html += "<button class='refresh-btn' onclick='location.reload()'>Refresh</button>";
-    html += "<button class='clear-btn' onclick='clearEvents()'>Clear Events</button>";
-    html += "<h1>Seismic Event Log</h1>";
+  private:
+    EventCursor cursor;
+};
+
+// Every event on flash, oldest first
+void handleEventExport(AsyncWebServerRequest* request) {
+  if (!eventStoreReady) {
+    request->send(503, "text/plain", "Event store unavailable");
+    return;
+  }
+  sendChunked(request, "text/csv", new EventExportBody(), "attachment; filename=\"events.csv\"");
+}
+
+void formatTimestamp(time_t timestamp, char* buffer, size_t size) {
+  if (timestamp == 0) {
+    snprintf(buffer, size, "time not synced");
+    return;
+  }
+  struct tm timeinfo;
+  gmtime_r(&timestamp, &timeinfo);
+  strftime(buffer, size, "%Y-%m-%d %H:%M:%S UTC", &timeinfo);
+}
+
+// An event onset: UTC when known, else its boot and the seconds since it
+void formatEventTime(time_t timestamp, uint16_t ms, uint32_t boot, int64_t onset_us, char* buffer, size_t size) {
+  if (timestamp != 0 || boot == 0) {
+    formatTimestamp(timestamp, ms, buffer, size);
+    return;
+  }
+  snprintf(buffer, size, "boot %lu +%.3f s", (unsigned long)boot, onset_us / 1e6);
+}
+
+// With milliseconds, for event onsets
+void formatTimestamp(time_t timestamp, uint16_t ms, char* buffer, size_t size) {
+  if (timestamp == 0) {
+    formatTimestamp(timestamp, buffer, size);
+    return;
+  }
+  struct tm timeinfo;
+  gmtime_r(&timestamp, &timeinfo);
+  size_t used = strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &timeinfo);
+  snprintf(buffer + used, size - used, ".%03u UTC", (unsigned)ms);
+}
+
+// The in-memory event log, newest first, one row per piece between a head
+// and a tail. Rows are counted back from the newest event when the request
+// arrived; each row is copied under the lock on its own, so loop() is never
+// held up for a whole page.
+class EventRows : public ChunkedBody {
+  public:
+    EventRows() : row(0), headDone(false), rowsDone(false), tailPart(0) {
+      lockWebState();
+      rows = eventCount;
+      newest = eventIndex;
+      unlockWebState();
+    }
+    
+  protected:
+    size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) {
+      if (!headDone) {
+        size_t length = renderHead(index, out, size, text);
+        if (length > 0) return length;
+        headDone = true;
+      }
+      if (!rowsDone) {
+        SeismicEvent event;
+        if (eventRow(row, event)) return renderRow(row++, event, out, size);
+        rowsDone = true;
+      }
+      return renderTail(tailPart++, out, size, text);
+    }
+    
+    // Each returns 0 after its last part
+    virtual size_t renderHead(uint32_t part, char* out, size_t size, const char** text) = 0;
+    virtual size_t renderRow(int i, const SeismicEvent& event, char* out, size_t size) = 0;
+    virtual size_t renderTail(uint32_t part, char* out, size_t size, const char** text) = 0;
+    
+    int rows;   // In the snapshot
+    int row;    // Rows rendered so far
+    
+  private:
+    // Row i of the snapshot; false past its end or once the log was cleared
+    bool eventRow(int i, SeismicEvent& event) {
+      if (i >= rows) return false;
+      lockWebState();
+      bool valid = i < eventCount;
+      if (valid) event = eventLog[(newest - 1 - i + MAX_EVENTS) % MAX_EVENTS];
+      unlockWebState();
+      return valid;
+    }
+    
+    int newest;
+    bool headDone;
+    bool rowsDone;
+    uint32_t tailPart;
+};
+
+// /events?format=json
+class EventsJsonBody : public EventRows {
+  protected:
+    size_t renderHead(uint32_t part, char* out, size_t size, const char** text) {
+      if (part > 0) return 0;
+      JsonWriter json(out, size);
+      json.beginObject();
+      json.field("timeInitialized", timeInitialized);
+      json.field("eventCount", rows);
+      json.beginArray("events");
+      return json.finish(); // Closed by the tail
+    }
     
-    if (timeInitialized) {
-      html += "<div class='status online'>Time synchronized - Event logging active</div>";
+    size_t renderRow(int i, const SeismicEvent& event, char* out, size_t size) {
+      char when[32];
+      formatEventTime(event.timestamp, event.timestamp_ms, event.boot, event.onset_us, when, sizeof(when));
       
-      if (eventCount > 0) {
-        html += "<p><strong>Total Events:</strong> " + String(eventCount) + " (Mercalli III and above)</p>";
-        html += "<table>";
-        html += "<tr><th>Timestamp (UTC)</th><th>Mercalli</th><th>Event Deviations (m/s²)</th><th>Magnitude</th></tr>";
-        
-        // Show events in reverse chronological order (newest first)
-        for (int i = 0; i < eventCount; i++) {
-          int idx = (eventIndex - 1 - i + MAX_EVENTS) % MAX_EVENTS;
-          
-          html += "<tr>";
-          html += "<td>" + formatTimestamp(eventLog[idx].timestamp) + "</td>";
-          
-          String mercalliClass = "mercalli-low";
-          if (eventLog[idx].mercalli >= 7) mercalliClass = "mercalli-high";
-          else if (eventLog[idx].mercalli >= 5) mercalliClass = "mercalli-medium";
-          
-          html += "<td class='mercalli " + mercalliClass + "'>" + String(eventLog[idx].mercalli) + "</td>";
-          html += "<td>X: " + String(eventLog[idx].x_peak, 3) + 
-                  ", Y: " + String(eventLog[idx].y_peak, 3) + 
-                  ", Z: " + String(eventLog[idx].z_peak, 3) + "</td>";
-          html += "<td>" + String(eventLog[idx].magnitude, 3) + "</td>";
-          html += "</tr>";
-        }
-        html += "</table>";
+      size_t comma = i > 0 ? 1 : 0;
+      out[0] = ',';
+      JsonWriter json(out + comma, size - comma);
+      json.beginObject();
+      json.field("timestamp", when);
+      json.field("synced", event.timestamp != 0);
+      json.field("boot", (unsigned long)event.boot);
+      json.field("onset_s", event.onset_us / 1e6f, 3);
+      json.field("mercalli", event.mercalli);
+      json.field("x_peak", event.x_peak, 3);
+      json.field("y_peak", event.y_peak, 3);
+      json.field("z_peak", event.z_peak, 3);
+      json.field("magnitude", event.magnitude, 3);
+      json.field("dominant_hz", event.dominant_hz);
+      json.field("jma_intensity", event.jma_intensity);
+      json.field("jma_class", isnan(event.jma_intensity) ? NULL : jmaIntensityClass(event.jma_intensity));
+      json.field("pga", event.pga, 3);
+      json.field("pgv", event.pgv, 4);
+      json.field("pgd", event.pgd, 5);
+      json.field("mmi", event.mmi, 1);
+      json.field("waveform_id", waveform.available(event.waveform_id) ? event.waveform_id : 0);
+      json.endObject();
+      return comma + json.finish();
+    }
+    
+    size_t renderTail(uint32_t part, char* out, size_t size, const char** text) {
+      if (part > 0) return 0;
+      *text = "]}";
+      return 2;
+    }
+};
+
+const char EVENTS_PAGE_HEAD[] PROGMEM =
+  "<!DOCTYPE html><html><head><title>Seismic Event Log</title>"
+  "<meta name='viewport' content='width=device-width, initial-scale=1'>"
+  "<style>body{font-family:Arial,sans-serif;margin:20px;background:#f0f0f0;color:#333}"
+  ".container{max-width:800px;margin:0 auto;background:white;padding:20px;border-radius:10px;box-shadow:0 2px 10px rgba(0,0,0,0.1)}"
+  "h1{color:#333;text-align:center}"
+  ".status{text-align:center;padding:15px;margin:20px 0;border-radius:8px}"
+  ".status.online{background:#d4edda;border:1px solid #c3e6cb;color:#155724}"
+  ".status.offline{background:#f8d7da;border:1px solid #f5c6cb;color:#721c24}"
+  "table{width:100%;border-collapse:collapse;margin-top:20px}"
+  "th,td{padding:12px;text-align:left;border-bottom:1px solid #ddd}"
+  "th{background:#f8f9fa;font-weight:bold}"
+  ".mercalli{font-weight:bold;font-size:1.1em}"
+  ".mercalli-low{color:#28a745}"
+  ".mercalli-medium{color:#ffc107}"
+  ".mercalli-high{color:#dc3545}"
+  ".back-link{display:inline-block;margin-bottom:20px;padding:8px 16px;background:#007bff;color:white;text-decoration:none;border-radius:5px}"
+  ".back-link:hover{background:#0056b3}"
+  ".refresh-btn{margin-left:10px;padding:8px 16px;background:#28a745;color:white;border:none;border-radius:5px;cursor:pointer}"
+  ".clear-btn{margin-left:10px;padding:8px 16px;background:#dc3545;color:white;border:none;border-radius:5px;cursor:pointer}"
+  ".clear-btn:hover{background:#c82333}"
+  "</style></head><body>"
+  "<div class='container'>"
+  "<a href='/' class='back-link'>← Back to Dashboard</a>"
+  "<button class='refresh-btn' onclick='location.reload()'>Refresh</button>"
+  "<button class='clear-btn' onclick='clearEvents()'>Clear Events</button>"
+  "<h1>Seismic Event Log</h1>";
+
+const char EVENTS_PAGE_FOOT[] PROGMEM =
+  "</div></body>"
+  "<script>"
+  "function clearEvents(){"
+  "if(confirm('Are you sure you want to clear all event log entries? This cannot be undone.')){"
+  "fetch('/clearevents',{method:'POST'})"
+  ".then(response=>response.text())"
+  ".then(data=>{alert('Event log cleared successfully');location.reload();})"
+  ".catch(error=>{alert('Error clearing event log: '+error);});"
+  "}}"
+  "</script>"
+  "</html>";
+
+// The /events page. Events logged before the clock is set are listed
+// without a time until it is.
+class EventsPage : public EventRows {
+  public:
+    EventsPage() : synced(timeInitialized) {}
+    
+  protected:
+    size_t renderHead(uint32_t part, char* out, size_t size, const char** text) {
+      if (part == 0) {
+        *text = EVENTS_PAGE_HEAD;
+        return strlen(EVENTS_PAGE_HEAD);
+      }
+      if (part > 1) return 0;
+      
+      size_t used = synced
+        ? snprintf(out, size, "<div class='status online'>Time synchronized - Event logging active</div>")
+        : snprintf(out, size, "<div class='status offline'>Time not synchronized - Events are logged and timestamped once it is</div>");
+      if (rows == 0) return used;
+      used += snprintf(out + used, size - used, "<p><strong>Total Events:</strong> %d (Mercalli III and above)</p>", rows);
+      if (eventStoreReady) {
+        lockWebState();
+        unsigned long stored = eventStore.recordCount();
+        unlockWebState();
+        used += snprintf(out + used, size - used,
+                         "<p>%lu events stored on flash - <a href='/events/export'>download all (CSV)</a></p>", stored);
+      }
+      used += snprintf(out + used, size - used,
+                       "<table><tr><th>Timestamp (UTC)</th><th>Mercalli</th><th>JMA</th><th>MMI</th><th>Event Deviations (m/s²)</th>"
+                       "<th>Magnitude</th><th>PGA (m/s²) / PGV (cm/s)</th><th>Dominant (Hz)</th><th>Waveform</th></tr>");
+      return used < size ? used : size;
+    }
+    
+    size_t renderRow(int i, const SeismicEvent& event, char* out, size_t size) {
+      char when[32];
+      formatEventTime(event.timestamp, event.timestamp_ms, event.boot, event.onset_us, when, sizeof(when));
+      const char* mercalliClass = "mercalli-low";
+      if (event.mercalli >= 7) mercalliClass = "mercalli-high";
+      else if (event.mercalli >= 5) mercalliClass = "mercalli-medium";
+      char dominant[12] = "-";
+      if (event.dominant_hz > 0) snprintf(dominant, sizeof(dominant), "%.2f", event.dominant_hz);
+      char intensity[20] = "-";
+      if (!isnan(event.jma_intensity)) {
+        snprintf(intensity, sizeof(intensity), "%.2f (%s)", event.jma_intensity,
+                 jmaIntensityClass(event.jma_intensity));
+      }
+      char mmi[8] = "-";
+      char motion[32] = "-";
+      if (!isnan(event.mmi)) {
+        snprintf(mmi, sizeof(mmi), "%.1f", event.mmi);
+        snprintf(motion, sizeof(motion), "%.3f / %.2f", event.pga, event.pgv * 100.0f);
+      }
+      
+      size_t used = snprintf(out, size,
+                             "<tr><td>%s</td><td class='mercalli %s'>%.2f</td><td>%s</td><td>%s</td>"
+                             "<td>X: %.3f, Y: %.3f, Z: %.3f</td><td>%.3f</td><td>%s</td><td>%s</td>",
+                             when, mercalliClass, event.mercalli, intensity, mmi,
+                             event.x_peak, event.y_peak, event.z_peak, event.magnitude, motion, dominant);
+      if (used >= size) return size;
+      if (waveform.available(event.waveform_id)) {
+        unsigned long id = event.waveform_id;
+        used += snprintf(out + used, size - used,
+                         "<td><a href='/events/waveform?id=%lu'>CSV</a> "
+                         "<a href='/events/waveform?id=%lu&format=bin'>BIN</a></td></tr>", id, id);
       } else {
-        html += "<p style='text-align:center;color:#666;margin:40px 0;'>No seismic events recorded yet.</p>";
-        html += "<p style='text-align:center;color:#666;'>Events with Mercalli intensity III and above will be logged here.</p>";
+        used += snprintf(out + used, size - used, "<td>-</td></tr>");
       }
-    } else {
-      html += "<div class='status offline'>Time not synchronized - Event logging disabled</div>";
-      html += "<p style='text-align:center;color:#666;'>Device must be connected to the internet for time synchronization and event logging.</p>";
+      return used < size ? used : size;
     }
     
-    html += "</div></body>";
-    html += "<script>";
-    html += "function clearEvents(){";
-    html += "if(confirm('Are you sure you want to clear all event log entries? This cannot be undone.')){";
-    html += "fetch('/clearevents',{method:'POST'})";
-    html += ".then(response=>response.text())";
-    html += ".then(data=>{alert('Event log cleared successfully');location.reload();})";
-    html += ".catch(error=>{alert('Error clearing event log: '+error);});";
-    html += "}}";
-    html += "</script>";
-    html += "</html>";
-    server.send(200, "text/html", html);
-  }
-}
-
-String getEventsJson() {
-  String json = "\"eventCount\":" + String(eventCount) + ",";
-  json += "\"timeSync\":" + String(timeInitialized ? "true" : "false");
+    size_t renderTail(uint32_t part, char* out, size_t size, const char** text) {
+      if (part == 0) {
+        if (rows > 0) {
+          *text = "</table>";
+        } else {
+          *text = "<p style='text-align:center;color:#666;margin:40px 0;'>No seismic events recorded yet.</p>"
+                  "<p style='text-align:center;color:#666;'>Events with Mercalli intensity III and above will be logged here.</p>";
+        }
+        return strlen(*text);
+      }
+      if (part > 1) return 0;
+      *text = EVENTS_PAGE_FOOT;
+      return strlen(EVENTS_PAGE_FOOT);
+    }
+    
+  private:
+    bool synced;
+};
+
+void handleEvents(AsyncWebServerRequest* request) {
+  // Both forms are streamed a row at a time; the log can outgrow any sensible buffer
+  if (request->hasParam("format") && request->getParam("format")->value() == "json") {
+    sendChunked(request, "application/json", new EventsJsonBody());
+  } else {
+    sendChunked(request, "text/html", new EventsPage());
+  }
+}
+
+// Event log summary, as members of the enclosing /data object
+void writeEventSummaryJson(JsonWriter& json) {
+  json.field("eventCount", eventCount);
+  json.field("timeSync", timeInitialized);
   if (eventCount > 0) {
     // Show most recent event
     int idx = (eventIndex - 1 + MAX_EVENTS) % MAX_EVENTS;
-    json += ",\"lastEvent\":{";
-    json += "\"timestamp\":\"" + formatTimestamp(eventLog[idx].timestamp) + "\",";
-    json += "\"mercalli\":" + String(eventLog[idx].mercalli);
-    json += "}";
+    char when[32];
+    formatEventTime(eventLog[idx].timestamp, eventLog[idx].timestamp_ms, eventLog[idx].boot,
+                    eventLog[idx].onset_us, when, sizeof(when));
+    json.beginObject("lastEvent");
+    json.field("timestamp", when);
+    json.field("mercalli", eventLog[idx].mercalli);
+    json.endObject();
   }
-  return json;
 }
 
-void handleReset() {
-  resetPeakValues();
-  server.send(204, "text/plain", ""); // 204 No Content is a good response for a successful action with no reply body
+void handleReset(AsyncWebServerRequest* request) {
+  requestPeakReset();
+  request->send(204, "text/plain", ""); // 204 No Content is a good response for a successful action with no reply body
 }
 
-void handleClearEvents() {
+void handleClearEvents(AsyncWebServerRequest* request) {
   clearEventLog();
-  server.send(200, "text/plain", "Event log cleared successfully");
+  request->send(200, "text/plain", "Event log cleared successfully");
+}
+
+void setupSpectrum() {
+  float rate = accelFifo.sampleRateHz();
+  spectrumDecimator.setFactor((uint32_t)(rate / SPECTRUM_RATE + 0.5f));
+  SpectrumConfig config = defaultSpectrumConfig(rate / spectrumDecimator.getFactor());
+  config.points = SPECTRUM_POINTS;
+  if (!spectrum.begin(config, spectrumSamples, spectrumWork)) {
+    Serial.println(F("Spectrum unavailable"));
+    return;
+  }
+  Serial.print(F("Spectrum: "));
+  Serial.print(SPECTRUM_POINTS);
+  Serial.print(F(" points at "));
+  Serial.print(config.sample_rate, 0);
+  Serial.print(F(" Hz, "));
+  Serial.print(fftImplementation());
+  Serial.println(F(" FFT"));
+}
+
+// Called from loop(); false until a full window has been collected
+bool updateSpectrum() {
+  SpectrumResult result;
+  uint32_t start = ESP.getCycleCount();
+  if (!spectrum.compute(result)) return false;
+  spectrumCycles = ESP.getCycleCount() - start; // Includes any preemption by acquisition
+  stageCycles[STAGE_SPECTRUM].record(spectrumCycles);
+  
+  lockWebState();
+  spectrumResult = result;
+  spectrumTime = millis();
+  unlockWebState();
+  return true;
+}
+
+void setupJmaIntensity() {
+  lockWebState();
+  float scale = detectorSnapshot.ms2_per_count;
+  unlockWebState();
+  JmaConfig config = defaultJmaConfig(spectrum.config().sample_rate, scale);
+  config.points = JMA_POINTS;
+  if (jmaWindowSamples(config) > JMA_WINDOW_SAMPLES) {
+    config.window_seconds = JMA_WINDOW_SAMPLES / config.sample_rate;
+  }
+  if (!jma.begin(config, jmaSamples, jmaWork, jmaWindow)) {
+    Serial.println(F("JMA intensity unavailable"));
+    return;
+  }
+  Serial.print(F("JMA intensity: "));
+  Serial.print(config.taps);
+  Serial.print(F("-tap filter, "));
+  Serial.print(config.window_seconds, 0);
+  Serial.print(F(" s window, up to "));
+  Serial.print(jma.latencySamples() / config.sample_rate, 1);
+  Serial.println(F(" s behind"));
+}
+
+// Called from loop() as soon as a block is due, before the next sample
+void updateJmaIntensity() {
+  uint32_t start = ESP.getCycleCount();
+  jma.process();
+  jmaCycles = ESP.getCycleCount() - start;
+  stageCycles[STAGE_JMA].record(jmaCycles);
+  if (!jma.valid()) return;
+  
+  float intensity = jma.intensity();
+  if (eventPending && (isnan(eventJmaIntensity) || intensity > eventJmaIntensity)) {
+    eventJmaIntensity = intensity;
+  }
+  lockWebState();
+  jmaIntensityNow = intensity;
+  jmaIntensityPeak = jma.peak();
+  jmaLevelGal = jma.level();
+  unlockWebState();
+}
+
+// Dominant frequency and RMS per band of the last SPECTRUM_POINTS samples;
+// amplitudes in m/s²
+void handleSpectrum(AsyncWebServerRequest* request) {
+  lockWebState();
+  SpectrumResult result = spectrumResult;
+  unsigned long age = millis() - spectrumTime;
+  float scale = detectorSnapshot.ms2_per_count;
+  unlockWebState();
+  if (result.sequence == 0) {
+    request->send(503, "text/plain", "Spectrum not ready yet");
+    return;
+  }
+  
+  const SpectrumConfig& config = spectrum.config();
+  char buffer[1024];
+  JsonWriter json(buffer, sizeof(buffer));
+  json.beginObject();
+  json.field("sequence", result.sequence);
+  json.field("age_ms", age);
+  json.field("points", result.points);
+  json.field("sample_rate", result.sample_rate, 1);
+  json.field("resolution_hz", result.resolution_hz, 3);
+  json.field("fft", fftImplementation());
+  json.field("compute_cycles", spectrumCycles);
+  json.field("dominant_hz", result.dominant_hz);
+  json.beginArray("dominant_axis_hz"); // x, y, z
+  for (int axis = 0; axis < 3; axis++) json.field(NULL, result.dominant_axis_hz[axis]);
+  json.endArray();
+  json.beginArray("dominant_rms");
+  for (int axis = 0; axis < 3; axis++) json.field(NULL, result.dominant_rms[axis] * scale, 4);
+  json.endArray();
+  json.beginArray("rms"); // From min_hz up
+  for (int axis = 0; axis < 3; axis++) json.field(NULL, result.rms[axis] * scale, 4);
+  json.endArray();
+  json.field("min_hz", config.min_hz, 1);
+  json.beginArray("bands");
+  for (int band = 0; band < config.band_count; band++) {
+    float high = config.bands[band].high_hz;
+    if (high > result.sample_rate / 2) high = result.sample_rate / 2;
+    json.beginObject();
+    json.field("low_hz", config.bands[band].low_hz, 1);
+    json.field("high_hz", high, 1);
+    json.beginArray("rms");
+    for (int axis = 0; axis < 3; axis++) json.field(NULL, result.band_rms[axis][band] * scale, 4);
+    json.endArray();
+    json.endObject();
+  }
+  json.endArray();
+  json.endObject();
+  json.finish();
+  request->send(200, "application/json", buffer);
+}
+
+// /metrics in the Prometheus text format: one histogram per stage (seconds
+// per call), scheduling jitter and the missed-deadline counters. The
+// histograms are copied when the scrape starts and written out a few lines
+// per piece.
+class MetricsBody : public ChunkedBody {
+  public:
+    MetricsBody() : line(0) {
+      cyclesToSeconds = 1.0 / (getCpuFrequencyMhz() * 1e6);
+      for (int i = 0; i < STAGE_COUNT; i++) {
+        stageCycles[i].snapshot(histograms[i]);
+        setSeries(i, "seismo_stage_duration_seconds", "Time per call of each firmware stage",
+                  STAGE_NAMES[i], cyclesToSeconds);
+      }
+      acquisitionJitter.snapshot(histograms[STAGE_COUNT]);
+      setSeries(STAGE_COUNT, "seismo_acquisition_jitter_seconds",
+                "Distance of each acquisition wake-up interval from the 10 ms period", NULL, 1e-6);
+      loopInterval.snapshot(histograms[STAGE_COUNT + 1]);
+      setSeries(STAGE_COUNT + 1, "seismo_loop_interval_seconds", "Time between loop() passes", NULL, 1e-6);
+    }
+    
+  protected:
+    size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) {
+      // Whole lines only; one that does not fit starts the next piece
+      size_t used = 0;
+      for (;;) {
+        size_t length = renderLine(line, out + used, size - used);
+        if (length == 0 || length >= size - used) break;
+        used += length;
+        line++;
+      }
+      return used;
+    }
+    
+  private:
+    static const int SERIES = STAGE_COUNT + 2;
+    static const uint32_t SERIES_LINES = LATENCY_BUCKETS + 3; // Buckets, +Inf, sum, count
+    
+    void setSeries(int i, const char* name, const char* help, const char* stage, double unit) {
+      families[i] = name;
+      helps[i] = help;
+      stages[i] = stage;
+      units[i] = unit;
+    }
+    
+    // Line n of the body into out; its length (possibly >= size when it did
+    // not fit), 0 past the end
+    size_t renderLine(uint32_t n, char* out, size_t size) {
+      for (int i = 0; i < SERIES; i++) {
+        bool header = i == 0 || strcmp(families[i], families[i - 1]) != 0;
+        if (header) {
+          if (n == 0) return snprintf(out, size, "# HELP %s %s\n", families[i], helps[i]);
+          if (n == 1) return snprintf(out, size, "# TYPE %s histogram\n", families[i]);
+          n -= 2;
+        }
+        if (n < SERIES_LINES) return renderSeriesLine(i, n, out, size);
+        n -= SERIES_LINES;
+      }
+      return renderScalarLine(n, out, size);
+    }
+    
+    size_t renderSeriesLine(int i, uint32_t n, char* out, size_t size) {
+      const LatencyHistogram& h = histograms[i];
+      char labels[48] = "";
+      if (stages[i]) snprintf(labels, sizeof(labels), "stage=\"%s\",", stages[i]);
+      if (n <= LATENCY_BUCKETS) {
+        uint32_t cumulative = 0;
+        for (uint32_t b = 0; b <= n; b++) cumulative += h.bucketCount(b);
+        if (n == LATENCY_BUCKETS) {
+          return snprintf(out, size, "%s_bucket{%sle=\"+Inf\"} %lu\n", families[i], labels,
+                          (unsigned long)h.count());
+        }
+        return snprintf(out, size, "%s_bucket{%sle=\"%g\"} %lu\n", families[i], labels,
+                        h.bound(n) * units[i], (unsigned long)cumulative);
+      }
+      if (stages[i]) snprintf(labels, sizeof(labels), "{stage=\"%s\"}", stages[i]);
+      if (n == LATENCY_BUCKETS + 1) {
+        return snprintf(out, size, "%s_sum%s %.9g\n", families[i], labels, (double)h.sum() * units[i]);
+      }
+      return snprintf(out, size, "%s_count%s %lu\n", families[i], labels, (unsigned long)h.count());
+    }
+    
+    size_t renderScalarLine(uint32_t n, char* out, size_t size) {
+      if (n == 0) return snprintf(out, size, "# HELP seismo_stage_duration_max_seconds Longest call of each stage since boot\n");
+      if (n == 1) return snprintf(out, size, "# TYPE seismo_stage_duration_max_seconds gauge\n");
+      n -= 2;
+      if (n < STAGE_COUNT) {
+        return snprintf(out, size, "seismo_stage_duration_max_seconds{stage=\"%s\"} %.9g\n",
+                        STAGE_NAMES[n], histograms[n].max() * cyclesToSeconds);
+      }
+      n -= STAGE_COUNT;
+      switch (n) {
+        case 0: return snprintf(out, size, "# HELP seismo_missed_deadlines_total Acquisition periods skipped and loop() passes slower than the BLE interval\n");
+        case 1: return snprintf(out, size, "# TYPE seismo_missed_deadlines_total counter\n");
+        case 2: return snprintf(out, size, "seismo_missed_deadlines_total{task=\"acquisition\"} %lu\n",
+                                (unsigned long)acquisitionMissedDeadlines);
+        case 3: return snprintf(out, size, "seismo_missed_deadlines_total{task=\"loop\"} %lu\n",
+                                (unsigned long)loopMissedDeadlines);
+        case 4: return snprintf(out, size, "# TYPE seismo_fifo_overruns_total counter\n");
+        case 5: return snprintf(out, size, "seismo_fifo_overruns_total %lu\n", (unsigned long)accelFifo.overrunCount());
+        case 6: return snprintf(out, size, "# TYPE seismo_sample_ring_drops_total counter\n");
+        case 7: return snprintf(out, size, "seismo_sample_ring_drops_total %lu\n", (unsigned long)sampleRing.dropCount());
+        case 8: return snprintf(out, size, "# TYPE seismo_uptime_seconds gauge\n");
+        case 9: return snprintf(out, size, "seismo_uptime_seconds %.3f\n", esp_timer_get_time() / 1e6);
+        default: return renderBootLine(n - 10, out, size);
+      }
+    }
+    
+    // Start and duration of each boot phase; NaN for one not yet begun or ended
+    size_t renderBootLine(uint32_t n, char* out, size_t size) {
+      for (int duration = 0; duration < 2; duration++) {
+        const char* family = duration ? "seismo_boot_phase_duration_seconds" : "seismo_boot_phase_start_seconds";
+        if (n == 0) {
+          return snprintf(out, size, "# HELP %s %s\n", family, duration ? "Time each boot phase took"
+                          : "When each boot phase began, from the timer start just after reset");
+        }
+        if (n == 1) return snprintf(out, size, "# TYPE %s gauge\n", family);
+        n -= 2;
+        if (n < BOOT_PHASE_COUNT) {
+          int32_t start = bootPhaseStartMs[n];
+          int32_t end = bootPhaseEndMs[n];
+          float value = NAN;
+          if (!duration && start >= 0) value = start / 1000.0f;
+          if (duration && start >= 0 && end >= 0) value = (end - start) / 1000.0f;
+          if (isnan(value)) return snprintf(out, size, "%s{phase=\"%s\"} NaN\n", family, BOOT_PHASE_NAMES[n]);
+          return snprintf(out, size, "%s{phase=\"%s\"} %.3f\n", family, BOOT_PHASE_NAMES[n], value);
+        }
+        n -= BOOT_PHASE_COUNT;
+      }
+      return 0;
+    }
+    
+    LatencyHistogram histograms[SERIES];
+    const char* families[SERIES];
+    const char* helps[SERIES];
+    const char* stages[SERIES]; // Label value, NULL for none
+    double units[SERIES];       // Seconds per histogram unit
+    double cyclesToSeconds;
+    uint32_t line;
+};
+
+void handleMetrics(AsyncWebServerRequest* request) {
+  sendChunked(request, "text/plain; version=0.0.4", new MetricsBody());
+}
+
+// METRICS: the stage histograms summarised, in microseconds
+void printMetrics() {
+  float cyclesPerMicro = getCpuFrequencyMhz();
+  char row[80];
+  Serial.println(F("Stage             calls    p50 us    p99 us    max us"));
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    LatencyHistogram h;
+    stageCycles[i].snapshot(h);
+    snprintf(row, sizeof(row), "%-15s %7lu %9.1f %9.1f %9.1f", STAGE_NAMES[i], (unsigned long)h.count(),
+             h.quantileBound(0.5f) / cyclesPerMicro, h.quantileBound(0.99f) / cyclesPerMicro,
+             h.max() / cyclesPerMicro);
+    Serial.println(row);
+  }
+  
+  LatencyHistogram jitter, interval;
+  acquisitionJitter.snapshot(jitter);
+  loopInterval.snapshot(interval);
+  Serial.print(F("Acquisition jitter: p99 "));
+  Serial.print(jitter.quantileBound(0.99f));
+  Serial.print(F(" us, max "));
+  Serial.print(jitter.max());
+  Serial.print(F(" us, "));
+  Serial.print(acquisitionMissedDeadlines);
+  Serial.println(F(" missed periods"));
+  Serial.print(F("Loop interval: p50 "));
+  Serial.print(interval.quantileBound(0.5f));
+  Serial.print(F(" us, p99 "));
+  Serial.print(interval.quantileBound(0.99f));
+  Serial.print(F(" us, max "));
+  Serial.print(interval.max());
+  Serial.print(F(" us, "));
+  Serial.print(loopMissedDeadlines);
+  Serial.print(F(" passes over "));
+  Serial.print(updateInterval);
+  Serial.println(F(" ms"));
+  Serial.println(F("(Buckets are powers of two: percentiles are upper bounds, within 2x)"));
+  
+  Serial.println(F("Boot phase     start ms  took ms"));
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    int32_t start = bootPhaseStartMs[i];
+    int32_t end = bootPhaseEndMs[i];
+    if (start < 0) snprintf(row, sizeof(row), "%-12s %10s", BOOT_PHASE_NAMES[i], "-");
+    else if (end < 0) snprintf(row, sizeof(row), "%-12s %10ld  running", BOOT_PHASE_NAMES[i], (long)start);
+    else snprintf(row, sizeof(row), "%-12s %10ld %8ld", BOOT_PHASE_NAMES[i], (long)start, (long)(end - start));
+    Serial.println(row);
+  }
+}
+
+// FFTBENCH: cycles per complex FFT at each size the spectrum stage supports.
+// The minimum of several runs leaves out preemption by the acquisition task.
+void benchmarkFft() {
+  const int RUNS = 20;
+  float* data = (float*)malloc(2 * SPECTRUM_MAX_POINTS * sizeof(float));
+  if (!data || !fftBegin()) {
+    free(data);
+    Serial.println(F("FFT benchmark: not enough memory"));
+    return;
+  }
+  
+  Serial.print(F("FFT benchmark ("));
+  Serial.print(fftImplementation());
+  Serial.println(F("):"));
+  for (uint32_t points = 256; points <= SPECTRUM_MAX_POINTS; points *= 2) {
+    uint32_t best = 0xFFFFFFFF;
+    uint64_t total = 0;
+    for (int run = 0; run < RUNS; run++) {
+      for (uint32_t i = 0; i < 2 * points; i++) data[i] = (float)((i * 37) % 256) - 128.0f;
+      uint32_t start = ESP.getCycleCount();
+      fftComplex(data, points);
+      uint32_t cycles = ESP.getCycleCount() - start;
+      total += cycles;
+      if (cycles < best) best = cycles;
+    }
+    Serial.print(F("  "));
+    Serial.print(points);
+    Serial.print(F(" points: "));
+    Serial.print(best);
+    Serial.print(F(" cycles min, "));
+    Serial.print((uint32_t)(total / RUNS));
+    Serial.print(F(" avg ("));
+    Serial.print(best / (float)ESP.getCpuFreqMHz(), 0);
+    Serial.println(F(" us)"));
+  }
+  Serial.print(F("  Last spectrum ("));
+  Serial.print(SPECTRUM_POINTS);
+  Serial.print(F(" points, 2 FFTs, 3 axes): "));
+  Serial.print(spectrumCycles);
+  Serial.println(F(" cycles"));
+  Serial.print(F("  Last JMA block ("));
+  Serial.print(JMA_POINTS);
+  Serial.print(F(" points, 4 FFTs, every "));
+  Serial.print(jma.config().points - jma.config().taps + 1);
+  Serial.print(F(" samples): "));
+  Serial.print(jmaCycles);
+  Serial.println(F(" cycles"));
+  free(data);
+}
+
+// Binary waveform download: this header followed by sample_count packed
+// little-endian int16 x,y,z triples (raw counts, before calibration offsets)
+struct __attribute__((packed)) WaveformFileHeader {
+  char magic[4];          // "SWF1"
+  uint32_t id;
+  uint32_t timestamp;     // Unix seconds at the trigger
+  uint32_t trigger_ms;    // Board clock (ms since boot) at the trigger sample
+  float sample_rate;      // Hz
+  uint32_t pre_samples;   // Samples up to and including the trigger
+  uint32_t sample_count;
+  float ms2_per_lsb;      // Count to m/s² conversion at the trigger
+  int16_t offset_x, offset_y, offset_z; // Calibration offsets at the trigger (counts)
+  int32_t mercalli;
+};
+
+// A pinned waveform slot, released when the response is done with it
+struct WaveformPin {
+  WaveformPin(const WaveformInfo& info, const RawSample* samples) : info(info), samples(samples) {}
+  ~WaveformPin() { waveform.release(info.id); }
+  
+  WaveformInfo info;
+  const RawSample* samples;
+};
+
+// Header and samples straight out of the slot, as the connection takes them
+void sendWaveformBinary(AsyncWebServerRequest* request, std::shared_ptr<WaveformPin> pin,
+                        const char* disposition) {
+  std::shared_ptr<WaveformFileHeader> header(new WaveformFileHeader());
+  const WaveformInfo& info = pin->info;
+  memcpy(header->magic, "SWF1", 4);
+  header->id = info.id;
+  header->timestamp = info.timestamp;
+  header->trigger_ms = info.trigger_ms;
+  header->sample_rate = info.sample_rate;
+  header->pre_samples = info.pre_samples;
+  header->sample_count = info.sample_count;
+  header->ms2_per_lsb = info.calibration.ms2_per_count;
+  header->offset_x = info.calibration.offset_x;
+  header->offset_y = info.calibration.offset_y;
+  header->offset_z = info.calibration.offset_z;
+  header->mercalli = info.mercalli;
+  
+  size_t total = sizeof(WaveformFileHeader) + info.sample_count * sizeof(RawSample);
+  AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", total,
+    [pin, header, total](uint8_t* buffer, size_t maxLength, size_t index) -> size_t {
+      size_t written = 0;
+      while (written < maxLength && index < total) {
+        const uint8_t* source;
+        size_t available;
+        if (index < sizeof(WaveformFileHeader)) {
+          source = (const uint8_t*)header.get() + index;
+          available = sizeof(WaveformFileHeader) - index;
+        } else {
+          source = (const uint8_t*)pin->samples + (index - sizeof(WaveformFileHeader));
+          available = total - index;
+        }
+        size_t count = available < maxLength - written ? available : maxLength - written;
+        memcpy(buffer + written, source, count);
+        written += count;
+        index += count;
+      }
+      return written;
+    });
+  response->addHeader("Content-Disposition", disposition);
+  request->send(response);
+}
+
+// Time is relative to the trigger; values are calibrated m/s²
+class WaveformCsv : public ChunkedBody {
+  public:
+    explicit WaveformCsv(std::shared_ptr<WaveformPin> pin) : pin(pin) {}
+    
+  protected:
+    size_t renderPiece(uint32_t index, char* out, size_t size, const char** text) {
+      const WaveformInfo& info = pin->info;
+      if (index == 0) {
+        char when[32];
+        formatTimestamp((time_t)info.timestamp, when, sizeof(when));
+        return snprintf(out, size,
+                        "# event %lu, %s, Mercalli %d, %.0f Hz, %lu pre-trigger samples\n"
+                        "t,x,y,z\n",
+                        (unsigned long)info.id, when,
+                        info.mercalli, info.sample_rate, (unsigned long)info.pre_samples);
+      }
+      
+      const uint32_t LINES = 10; // Under 40 bytes each
+      const WaveformCalibration& calibration = info.calibration;
+      uint32_t first = (index - 1) * LINES;
+      size_t used = 0;
+      for (uint32_t i = first; i < first + LINES && i < info.sample_count && used < size; i++) {
+        const RawSample& sample = pin->samples[i];
+        float t = ((int32_t)i - (int32_t)info.pre_samples + 1) / info.sample_rate;
+        used += snprintf(out + used, size - used, "%.3f,%.4f,%.4f,%.4f\n", t,
+                         (sample.x + calibration.offset_x) * calibration.ms2_per_count,
+                         (sample.y + calibration.offset_y) * calibration.ms2_per_count,
+                         (sample.z + calibration.offset_z) * calibration.ms2_per_count);
+      }
+      return used < size ? used : size;
+    }
+    
+  private:
+    std::shared_ptr<WaveformPin> pin;
+};
+
+// /events/waveform?id=N[&format=bin] - download the waveform of a logged event
+void handleWaveform(AsyncWebServerRequest* request) {
+  uint32_t id = request->hasParam("id") ? strtoul(request->getParam("id")->value().c_str(), NULL, 10) : 0;
+  WaveformInfo info;
+  const RawSample* samples;
+  if (!waveform.acquire(id, info, samples)) {
+    // A slot is read by one download at a time
+    if (waveform.available(id)) {
+      request->send(503, "text/plain", "Waveform is being downloaded, try again shortly");
+    } else {
+      request->send(404, "text/plain", "Waveform not available");
+    }
+    return;
+  }
+  std::shared_ptr<WaveformPin> pin(new WaveformPin(info, samples));
+  
+  bool binary = request->hasParam("format") && request->getParam("format")->value() == "bin";
+  char disposition[64];
+  snprintf(disposition, sizeof(disposition), "attachment; filename=\"event-%lu.%s\"",
+           (unsigned long)id, binary ? "bin" : "csv");
+  
+  if (binary) {
+    sendWaveformBinary(request, pin, disposition);
+  } else {
+    sendChunked(request, "text/csv", new WaveformCsv(pin), disposition);
+  }
 }
\ No newline at end of file
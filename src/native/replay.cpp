@@ -0,0 +1,434 @@
+// Host-side trace replay for the seismometer signal-processing core.
+//
+// Feeds recorded or synthetic 3-axis traces through the same Detector the
+// firmware runs, as fast as the host allows, and reports throughput, the
+// events that would have been logged and the final peaks. The trace also goes
+// through the JMA intensity stage, and its peak intensity is reported.
+//
+// Build and run with PlatformIO:
+//   pio run -e native
+//   .pio/build/native/program --synthetic 3600
+//   .pio/build/native/program --rate 400 trace.csv
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include <adxl345_fifo.h>
+#include <detector.h>
+#include <decimator.h>
+#include <ble_frame.h>
+#include <spectrum.h>
+#include <jma_intensity.h>
+
+struct ReplayOptions {
+  const char* path;
+  float rate;
+  float noise;
+  float highpass;
+  float lowpass;
+  int order;
+  float syntheticSeconds;
+  int bleMtu;
+  bool counts;
+  bool binary;
+  bool quiet;
+  bool fixedNoise;
+  bool regression;
+};
+
+struct ReplayStats {
+  uint64_t samples;
+  double processingSeconds;
+  uint32_t events;
+  float jmaPeak;   // Highest JMA intensity of the trace
+  bool jmaValid;
+};
+
+// Batches the band-passed output into BLE frames the way the firmware does
+// (100 Hz, one update every 100 ms, frames sized to the MTU) to count what
+// the link has to carry; the codec itself is covered by test_ble_frame
+class BleLink {
+  public:
+    BleLink(int mtu, float rate)
+      : maxBytes(mtu > 3 ? mtu - 3 : 0), rate(rate), sequence(0), samplesSinceUpdate(0),
+        frames(0), bytes(0) {
+      decimator.setFactor((uint32_t)(rate / 100.0f + 0.5f));
+    }
+
+    void push(const DetectorOutput& out) {
+      RawSample dev = { (int16_t)lroundf(out.x_dev), (int16_t)lroundf(out.y_dev),
+                        (int16_t)lroundf(out.z_dev) };
+      RawSample decimated;
+      if (decimator.push(dev, decimated)) pending.push_back(decimated);
+      if (++samplesSinceUpdate >= rate / 10.0f) {
+        update();
+        samplesSinceUpdate = 0;
+      }
+    }
+
+    uint64_t frameCount() const { return frames; }
+    uint64_t byteCount() const { return bytes; }
+
+  private:
+    void update() {
+      size_t capacity = bleFrameCapacity(maxBytes);
+      size_t sent = 0;
+      do {
+        size_t count = pending.size() - sent;
+        if (count > capacity) count = capacity;
+
+        BleFrameHeader header;
+        memset(&header, 0, sizeof(header));
+        header.sequence = sequence++;
+        uint8_t frame[BLE_FRAME_MAX_SIZE];
+        size_t length = encodeBleFrame(header, pending.data() + sent, count, frame, maxBytes);
+        if (length == 0) break;
+        frames++;
+        bytes += length;
+        sent += count;
+      } while (sent < pending.size());
+      pending.clear();
+    }
+
+    size_t maxBytes;
+    float rate;
+    Decimator decimator;
+    std::vector<RawSample> pending;
+    uint16_t sequence;
+    uint32_t samplesSinceUpdate;
+    uint64_t frames;
+    uint64_t bytes;
+};
+
+// Source of samples in raw sensor counts; returns the number of samples written
+class TraceSource {
+  public:
+    virtual ~TraceSource() {}
+    virtual size_t read(RawSample* out, size_t maxSamples) = 0;
+};
+
+// Quantise m/s² to counts the way the sensor would
+static int16_t toCounts(float ms2) {
+  float counts = roundf(ms2 / ADXL345_MS2_PER_LSB);
+  if (counts > 32767) counts = 32767;
+  if (counts < -32768) counts = -32768;
+  return (int16_t)counts;
+}
+
+// CSV with x,y,z or t,x,y,z per line; non-numeric lines (headers) are skipped
+class CsvTrace : public TraceSource {
+  public:
+    CsvTrace(FILE* file, bool counts) : file(file), scale(counts ? ADXL345_MS2_PER_LSB : 1.0f) {}
+
+    size_t read(RawSample* out, size_t maxSamples) {
+      char line[256];
+      size_t count = 0;
+      while (count < maxSamples && fgets(line, sizeof(line), file)) {
+        float v[4];
+        int n = sscanf(line, "%f%*[ ,;\t]%f%*[ ,;\t]%f%*[ ,;\t]%f", &v[0], &v[1], &v[2], &v[3]);
+        if (n < 3) continue;
+        const float* axes = (n == 4) ? &v[1] : &v[0];
+        out[count].x = toCounts(axes[0] * scale);
+        out[count].y = toCounts(axes[1] * scale);
+        out[count].z = toCounts(axes[2] * scale);
+        count++;
+      }
+      return count;
+    }
+
+  private:
+    FILE* file;
+    float scale;
+};
+
+// Packed little-endian int16 x,y,z counts, the layout of RawSample
+class BinaryTrace : public TraceSource {
+  public:
+    explicit BinaryTrace(FILE* file) : file(file) {}
+
+    size_t read(RawSample* out, size_t maxSamples) {
+      return fread(out, sizeof(RawSample), maxSamples, file);
+    }
+
+  private:
+    FILE* file;
+};
+
+// Quiet sensor at 1 g with a damped 3 Hz burst every minute, stepping through
+// increasing amplitudes so several intensity levels are exercised
+class SyntheticTrace : public TraceSource {
+  public:
+    SyntheticTrace(float seconds, float rate)
+      : total((uint64_t)(seconds * rate)), produced(0), rate(rate), rng(0x9E3779B9u) {}
+
+    size_t read(RawSample* out, size_t maxSamples) {
+      static const float amplitudes[] = { 0.3f, 0.8f, 1.5f, 3.0f, 6.0f };
+      size_t count = 0;
+      for (; count < maxSamples && produced < total; count++, produced++) {
+        float t = produced / rate;
+        float burst = 0;
+        int minute = (int)(t / 60.0f);
+        float sinceStart = t - minute * 60.0f - 30.0f;
+        if (minute > 0 && sinceStart >= 0 && sinceStart < 20.0f) {
+          float amplitude = amplitudes[(minute - 1) % 5];
+          burst = amplitude * expf(-sinceStart / 4.0f) * sinf(2.0f * (float)M_PI * 3.0f * sinceStart);
+        }
+        out[count].x = toCounts(noise() + burst);
+        out[count].y = toCounts(noise() + 0.6f * burst);
+        out[count].z = toCounts(9.80665f + noise() + 0.3f * burst);
+      }
+      return count;
+    }
+
+  private:
+    // Roughly Gaussian noise with sigma 0.01 m/s² (sum of four uniforms)
+    float noise() {
+      float sum = 0;
+      for (int i = 0; i < 4; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        sum += (rng & 0xFFFF) / 65535.0f - 0.5f;
+      }
+      return sum * 0.0173f;
+    }
+
+    uint64_t total;
+    uint64_t produced;
+    float rate;
+    uint32_t rng;
+};
+
+static void printUsage(const char* program) {
+  printf("Usage: %s [options] <trace.csv|trace.bin>\n", program);
+  printf("       %s [options] --synthetic <seconds>\n\n", program);
+  printf("Options:\n");
+  printf("  --rate <hz>         Sample rate of the trace (default 400)\n");
+  printf("  --noise <m/s2>      Noise gate threshold (default 0.1)\n");
+  printf("  --fixed-noise       Keep the noise gate instead of adapting it to the noise floor\n");
+  printf("  --highpass <hz>     High-pass corner of the detection band (default 0.1)\n");
+  printf("  --lowpass <hz>      Low-pass corner, 0 for high-pass only (default 10)\n");
+  printf("  --order <2|4>       Order of both band edges (default 2)\n");
+  printf("  --counts            CSV values are raw ADXL345 counts instead of m/s2\n");
+  printf("  --binary            Input is packed little-endian int16 x,y,z counts\n");
+  printf("  --synthetic <sec>   Generate a synthetic trace instead of reading a file\n");
+  printf("  --ble-mtu <bytes>   Also pack the output into BLE frames for this MTU\n");
+  printf("  --regression        Intensity from PGA and PGV by regression instead of thresholds\n");
+  printf("  --quiet             Do not list individual events\n");
+}
+
+static bool parseOptions(int argc, char** argv, ReplayOptions& options) {
+  memset(&options, 0, sizeof(options));
+  options.rate = 400;
+  options.noise = 0.1f;
+  FilterBandConfig band = defaultFilterBandConfig();
+  options.highpass = band.highpass_hz;
+  options.lowpass = band.lowpass_hz;
+  options.order = band.highpass_order;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (strcmp(arg, "--rate") == 0 && hasValue) options.rate = atof(argv[++i]);
+    else if (strcmp(arg, "--noise") == 0 && hasValue) options.noise = atof(argv[++i]);
+    else if (strcmp(arg, "--highpass") == 0 && hasValue) options.highpass = atof(argv[++i]);
+    else if (strcmp(arg, "--lowpass") == 0 && hasValue) options.lowpass = atof(argv[++i]);
+    else if (strcmp(arg, "--order") == 0 && hasValue) options.order = atoi(argv[++i]);
+    else if (strcmp(arg, "--synthetic") == 0 && hasValue) options.syntheticSeconds = atof(argv[++i]);
+    else if (strcmp(arg, "--ble-mtu") == 0 && hasValue) options.bleMtu = atoi(argv[++i]);
+    else if (strcmp(arg, "--counts") == 0) options.counts = true;
+    else if (strcmp(arg, "--binary") == 0) options.binary = true;
+    else if (strcmp(arg, "--quiet") == 0) options.quiet = true;
+    else if (strcmp(arg, "--fixed-noise") == 0) options.fixedNoise = true;
+    else if (strcmp(arg, "--regression") == 0) options.regression = true;
+    else if (arg[0] != '-' && !options.path) options.path = arg;
+    else return false;
+  }
+
+  if (options.rate <= 0 || options.highpass <= 0) return false;
+  if (options.order != 2 && options.order != 4) return false;
+  if (!options.path && options.syntheticSeconds <= 0) return false;
+  if (options.path && !options.binary) {
+    size_t length = strlen(options.path);
+    options.binary = (length > 4 && strcmp(options.path + length - 4, ".bin") == 0);
+  }
+  return true;
+}
+
+static ReplayStats replay(TraceSource& source, const ReplayOptions& options, Detector& detector,
+                          BleLink* ble) {
+  const size_t CHUNK = 65536;
+  std::vector<RawSample> samples(CHUNK);
+  ReplayStats stats = { 0, 0, 0, 0, false };
+
+  // JMA intensity at 100 Hz, decimated as the firmware does
+  Decimator jmaDecimator;
+  jmaDecimator.setFactor((uint32_t)(options.rate / 100.0f + 0.5f));
+  JmaConfig jmaConfig = defaultJmaConfig(options.rate / jmaDecimator.getFactor(), ADXL345_MS2_PER_LSB);
+  std::vector<RawSample> jmaSamples(jmaConfig.points);
+  std::vector<float> jmaWork(JMA_WORK_SIZE(jmaConfig.points));
+  std::vector<uint16_t> jmaWindow(jmaWindowSamples(jmaConfig));
+  JmaIntensity jma;
+  jma.begin(jmaConfig, jmaSamples.data(), jmaWork.data(), jmaWindow.data());
+
+  DetectorConfig config = defaultDetectorConfig(options.rate);
+  config.noise_threshold = options.noise;
+  config.noise_floor.enabled = !options.fixedNoise;
+  config.filter.highpass_hz = options.highpass;
+  config.filter.lowpass_hz = options.lowpass;
+  config.filter.highpass_order = options.order;
+  config.filter.lowpass_order = options.order;
+  config.intensity_mode = options.regression ? INTENSITY_REGRESSION : INTENSITY_THRESHOLDS;
+  detector.configure(config);
+  detector.setLoggingEnabled(true);
+
+  // Only the detector is timed, not file parsing
+  for (;;) {
+    size_t count = source.read(samples.data(), CHUNK);
+    if (count == 0) break;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+      uint64_t index = stats.samples + i;
+      uint32_t now_ms = (uint32_t)(index * 1000.0 / options.rate);
+      DetectorOutput out;
+      detector.update(samples[i].x, samples[i].y, samples[i].z, now_ms, out);
+      if (ble) ble->push(out);
+      if (out.should_log) {
+        stats.events++;
+        if (!options.quiet) {
+          printf("  event t=%10.3fs  Mercalli %2d (MMI %.1f)  X %.3f  Y %.3f  Z %.3f  mag %.3f  "
+                 "STA/LTA %.1f\n", index / options.rate, out.mercalli, out.mmi,
+                 detector.toMs2(out.x_dev), detector.toMs2(out.y_dev), detector.toMs2(out.z_dev),
+                 detector.magnitudeMs2(out.dev_mag_sq), out.sta_lta);
+        }
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stats.processingSeconds += elapsed.count();
+    stats.samples += count;
+
+    for (size_t i = 0; i < count; i++) {
+      RawSample decimated;
+      if (jmaDecimator.push(samples[i], decimated) && jma.push(decimated)) jma.process();
+    }
+  }
+  stats.jmaValid = jma.valid();
+  stats.jmaPeak = jma.peak();
+  return stats;
+}
+
+// Cost of the filter stage alone, on white noise around 1 g (in counts)
+static double benchmarkFilter(const SosFilter3& design) {
+  const size_t SAMPLES = 4000000;
+  SosFilter3 filter = design;
+  filter.prime(0, 0, 256.0f);
+
+  uint32_t rng = 12345;
+  float sink = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < SAMPLES; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    float n = (int32_t)(rng >> 29) - 4;
+    float x = n, y = -n, z = 256.0f + n;
+    filter.process(x, y, z);
+    sink += x + y + z;
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  if (sink == 12345.0f) printf(" ");  // Keep the loop from being optimised away
+  return elapsed.count() * 1e9 / SAMPLES;
+}
+
+// Cost of one complex FFT of `points` (the spectrum stage runs two per result)
+static double benchmarkFft(uint32_t points) {
+  const int RUNS = 2000;
+  std::vector<float> data(2 * points);
+  uint32_t rng = 12345;
+  for (size_t i = 0; i < data.size(); i++) {
+    rng = rng * 1664525u + 1013904223u;
+    data[i] = (int32_t)(rng >> 24) - 128;
+  }
+
+  fftBegin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int run = 0; run < RUNS; run++) fftComplex(data.data(), points);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  if (data[0] == 12345.0f) printf(" ");
+  return elapsed.count() * 1e9 / RUNS;
+}
+
+int main(int argc, char** argv) {
+  ReplayOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  FILE* file = NULL;
+  TraceSource* source = NULL;
+  if (options.path) {
+    file = fopen(options.path, options.binary ? "rb" : "r");
+    if (!file) {
+      fprintf(stderr, "Cannot open %s\n", options.path);
+      return 1;
+    }
+    if (options.binary) source = new BinaryTrace(file);
+    else source = new CsvTrace(file, options.counts);
+  } else {
+    source = new SyntheticTrace(options.syntheticSeconds, options.rate);
+  }
+
+  Detector detector;
+  if (!options.quiet) printf("Events:\n");
+  BleLink* ble = options.bleMtu > 0 ? new BleLink(options.bleMtu, options.rate) : NULL;
+  ReplayStats stats = replay(*source, options, detector, ble);
+  const DetectorPeaks& peaks = detector.peaks();
+
+  double traceSeconds = stats.samples / options.rate;
+  double rate = stats.processingSeconds > 0 ? stats.samples / stats.processingSeconds : 0;
+  printf("Samples:         %llu (%.1f s of data at %.0f Hz)\n",
+         (unsigned long long)stats.samples, traceSeconds, options.rate);
+  printf("Processing time: %.3f s\n", stats.processingSeconds);
+  printf("Throughput:      %.0f samples/s (%.0fx real time)\n", rate, rate / options.rate);
+  printf("Filter stage:    %.1f ns/sample, 3 axes, %d sections\n",
+         benchmarkFilter(detector.filter()), detector.filter().sectionCount());
+  printf("FFT (%s):  256 pts %.1f us, 512 pts %.1f us, 1024 pts %.1f us\n", fftImplementation(),
+         benchmarkFft(256) / 1000, benchmarkFft(512) / 1000, benchmarkFft(1024) / 1000);
+  printf("Events logged:   %u\n", stats.events);
+  printf("Triggers:        X %u  Y %u  Z %u\n", detector.trigger(0).triggerCount(),
+         detector.trigger(1).triggerCount(), detector.trigger(2).triggerCount());
+  printf("Final peaks:     X %.3f  Y %.3f  Z %.3f  mag %.3f  Mercalli %d\n",
+         detector.toMs2(peaks.x), detector.toMs2(peaks.y), detector.toMs2(peaks.z),
+         detector.magnitudeMs2(peaks.dev_mag_sq), peaks.mercalli);
+  printf("Ground motion:   PGA %.3f m/s2  PGV %.4f m/s  PGD %.5f m  MMI %.1f (%s)\n",
+         detector.toMs2(peaks.motion.pga), detector.toMs2(peaks.motion.pgv),
+         detector.toMs2(peaks.motion.pgd), peaks.motion.mmi,
+         options.regression ? "regression" : "thresholds drive Mercalli");
+  if (stats.jmaValid) {
+    printf("JMA intensity:   %.2f peak (class %s)\n", stats.jmaPeak, jmaIntensityClass(stats.jmaPeak));
+  } else {
+    printf("JMA intensity:   trace shorter than one block\n");
+  }
+  const NoiseFloorTracker& noise = detector.noiseFloor();
+  if (noise.valid()) {
+    printf("Noise floor:     X %.4f  Y %.4f  Z %.4f sigma, gate %.3f after %u windows\n",
+           detector.toMs2(noise.sigma(0)), detector.toMs2(noise.sigma(1)),
+           detector.toMs2(noise.sigma(2)), detector.noiseThreshold(), noise.windowCount());
+  } else {
+    printf("Noise gate:      %.3f (fixed)\n", detector.noiseThreshold());
+  }
+
+  if (ble) {
+    printf("BLE frames:      %llu at MTU %d (%.1f frames/s, %.0f bytes/s)\n",
+           (unsigned long long)ble->frameCount(), options.bleMtu, ble->frameCount() / traceSeconds,
+           ble->byteCount() / traceSeconds);
+    delete ble;
+  }
+
+  delete source;
+  if (file) fclose(file);
+  return 0;
+}
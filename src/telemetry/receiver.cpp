@@ -0,0 +1,379 @@
+// Reference receiver for the UDP telemetry push.
+//
+// Stations configured with TELEMETRY send a TelemetryPacket
+// (lib/SeismoCore/telemetry_packet.h) every TELEMETRY_SAMPLES live samples to
+// a unicast or multicast address. Any number of receivers can listen; this one
+// reports throughput, loss from the sequence numbers and the latency from a
+// packet's newest sample to its arrival (for stations with NTP time).
+//
+// Build and run with PlatformIO:
+//   pio run -e telemetry
+//   .pio/build/telemetry/program                        # unicast to this host
+//   .pio/build/telemetry/program --group 239.0.83.84    # multicast
+//   .pio/build/telemetry/program --simulate 20 --loss 0.02  # localhost stand-in
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <map>
+#include <latency_histogram.h>
+#include <sequence_tracker.h>
+#include <telemetry_packet.h>
+
+#define UDP_BATCH 32
+
+struct ReceiverOptions {
+  uint16_t port;
+  const char* group;   // Multicast group to join, NULL for unicast
+  float duration_s;    // 0: until interrupted
+  float interval_s;    // Between reports
+  uint16_t simulate;   // Stand-in stations, 0 for none
+  float rate;          // Stand-in sample rate, Hz
+  float loss;          // Stand-in packets skipped on purpose
+};
+
+// Per station, since the first packet
+struct StationStats {
+  SequenceTracker sequence;
+  uint64_t samples;
+  uint8_t flags;
+  uint8_t mercalli_now;
+  uint8_t mercalli_peak;
+  bool gaps;                // A packet said samples were dropped on the station
+  StationStats() : samples(0), flags(0), mercalli_now(0), mercalli_peak(0), gaps(false) {}
+};
+
+struct StandInReport {
+  uint32_t sent;
+  uint32_t skipped;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static int64_t utcNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static double cpuSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int openSocket(const ReceiverOptions& options) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return -1;
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)); // Several listeners on one host
+  int buffer = 1 << 20;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(options.port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  if (options.group) {
+    struct ip_mreq membership;
+    memset(&membership, 0, sizeof(membership));
+    if (inet_pton(AF_INET, options.group, &membership.imr_multiaddr) != 1 ||
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+}
+
+// Stations pushing a 2 Hz sine at the device's live rate, in real time, to
+// the group or to 127.0.0.1
+static StandInReport runStandIn(const ReceiverOptions& options) {
+  StandInReport report = { 0, 0 };
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  unsigned char loop = 1;
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+  struct sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(options.port);
+  if (!options.group || inet_pton(AF_INET, options.group, &to.sin_addr) != 1) {
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  }
+
+  int64_t period = (int64_t)(TELEMETRY_SAMPLES * 1e6 / options.rate);
+  int64_t start = utcNow();
+  int64_t end = start + (int64_t)(options.duration_s * 1e6);
+  uint32_t rng = 12345;
+  uint8_t buffer[TELEMETRY_PACKET_SIZE];
+  TelemetryPacket packet;
+  memset(&packet, 0, sizeof(packet));
+  packet.rate_dhz = (uint16_t)(options.rate * 10 + 0.5f);
+  packet.scale_um = 38300;
+  packet.flags = TELEMETRY_TIME_SYNCED;
+
+  for (uint32_t sequence = 0;; sequence++) {
+    // Packet n carries samples [n*N, n*N + N) and goes out when the last is taken
+    int64_t first = start + sequence * period;
+    int64_t due = first + period - (int64_t)(1e6 / options.rate);
+    if (due >= end || stopRequested) break;
+    int64_t wait = due - utcNow();
+    if (wait > 0) {
+      struct timespec ts = { (time_t)(wait / 1000000), (long)(wait % 1000000) * 1000 };
+      nanosleep(&ts, NULL);
+    }
+
+    for (uint16_t s = 0; s < options.simulate; s++) {
+      packet.station = 0x5EED0000u + s;
+      packet.sequence = sequence;
+      packet.time_us = first;
+      for (int i = 0; i < TELEMETRY_SAMPLES; i++) {
+        float t = (sequence * TELEMETRY_SAMPLES + i) / options.rate;
+        int16_t v = (int16_t)lroundf(20.0f * sinf(2.0f * (float)M_PI * 2.0f * t + s));
+        packet.samples[i].x = v;
+        packet.samples[i].y = -v;
+        packet.samples[i].z = v / 2;
+      }
+      rng = rng * 1664525u + 1013904223u;
+      if ((rng >> 8) / 16777216.0f < options.loss) {
+        report.skipped++;
+        continue;
+      }
+      encodeTelemetryPacket(packet, buffer);
+      if (sendto(fd, buffer, sizeof(buffer), 0, (struct sockaddr*)&to, sizeof(to)) == (ssize_t)sizeof(buffer)) {
+        report.sent++;
+      }
+    }
+  }
+  close(fd);
+  return report;
+}
+
+class Receiver {
+  public:
+    Receiver() : latency(6), packets(0), invalid(0), windowPackets(0), windowBytes(0), windowSamples(0) {}
+
+    void read(int fd) {
+      static uint8_t buffers[UDP_BATCH][TELEMETRY_PACKET_SIZE + 1]; // One spare byte shows oversized datagrams
+      struct mmsghdr messages[UDP_BATCH];
+      struct iovec vectors[UDP_BATCH];
+      for (int i = 0; i < UDP_BATCH; i++) {
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = sizeof(buffers[i]);
+        memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      int received;
+      while ((received = recvmmsg(fd, messages, UDP_BATCH, MSG_DONTWAIT, NULL)) > 0) {
+        int64_t arrival = utcNow();
+        for (int i = 0; i < received; i++) handle(buffers[i], messages[i].msg_len, arrival);
+        if (received < UDP_BATCH) break;
+      }
+    }
+
+    void report(double seconds) {
+      uint32_t missing = 0, duplicates = 0, reordered = 0, restarts = 0;
+      for (std::map<uint32_t, StationStats>::iterator it = stations.begin(); it != stations.end(); ++it) {
+        missing += it->second.sequence.missingCount();
+        duplicates += it->second.sequence.duplicateCount();
+        reordered += it->second.sequence.reorderedCount();
+        restarts += it->second.sequence.restartCount();
+      }
+      uint64_t expected = packets + missing;
+      printf("%u stations  %.0f packets/s  %.1f kB/s  %.0f samples/s  lost %u (%.2f%%)  dup %u  reordered %u  "
+             "restarts %u  invalid %u  latency p50 <%.1f ms p99 <%.1f ms max %.1f ms\n",
+             (unsigned)stations.size(), windowPackets / seconds, windowBytes / seconds / 1000,
+             windowSamples / seconds, missing, expected ? 100.0 * missing / expected : 0.0, duplicates,
+             reordered, restarts, invalid, latency.quantileBound(0.5f) / 1000.0,
+             latency.quantileBound(0.99f) / 1000.0, latency.max() / 1000.0);
+      if (stations.size() <= 8) {
+        for (std::map<uint32_t, StationStats>::iterator it = stations.begin(); it != stations.end(); ++it) {
+          const StationStats& s = it->second;
+          printf("  %08x  seq %u  received %u  lost %u  Mercalli %u (peak %u)%s%s%s\n", it->first,
+                 s.sequence.highest(), s.sequence.receivedCount(), s.sequence.missingCount(), s.mercalli_now,
+                 s.mercalli_peak, s.flags & TELEMETRY_TRIGGERED ? "  TRIGGERED" : "",
+                 s.flags & TELEMETRY_TIME_SYNCED ? "" : "  (no NTP)", s.gaps ? "  station dropped samples" : "");
+        }
+      }
+      fflush(stdout);
+      windowPackets = 0;
+      windowBytes = 0;
+      windowSamples = 0;
+    }
+
+    uint64_t packetCount() const { return packets; }
+    uint32_t invalidCount() const { return invalid; }
+    uint32_t missingCount() const {
+      uint32_t missing = 0;
+      for (std::map<uint32_t, StationStats>::const_iterator it = stations.begin(); it != stations.end(); ++it) {
+        missing += it->second.sequence.missingCount();
+      }
+      return missing;
+    }
+
+  private:
+    void handle(const uint8_t* data, size_t length, int64_t arrival) {
+      TelemetryPacket packet;
+      if (!decodeTelemetryPacket(data, length, packet)) {
+        invalid++;
+        return;
+      }
+      StationStats& s = stations[packet.station];
+      if (s.sequence.accept(packet.sequence) == SEQUENCE_DUPLICATE) return;
+
+      packets++;
+      windowPackets++;
+      windowBytes += length;
+      windowSamples += TELEMETRY_SAMPLES;
+      s.samples += TELEMETRY_SAMPLES;
+      s.flags = packet.flags;
+      s.mercalli_now = packet.mercalli_now;
+      s.mercalli_peak = packet.mercalli_peak;
+      if (packet.flags & TELEMETRY_GAP) s.gaps = true;
+
+      if ((packet.flags & TELEMETRY_TIME_SYNCED) && packet.rate_dhz > 0) {
+        int64_t newest = packet.time_us + (int64_t)((TELEMETRY_SAMPLES - 1) * 1e7 / packet.rate_dhz);
+        int64_t delay = arrival - newest;
+        latency.record(delay < 0 ? 0 : delay > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)delay);
+      }
+    }
+
+    std::map<uint32_t, StationStats> stations;
+    LatencyHistogram latency; // µs from a packet's newest sample to its arrival, all stations
+    uint64_t packets;
+    uint32_t invalid;
+    uint64_t windowPackets;
+    uint64_t windowBytes;
+    uint64_t windowSamples;
+};
+
+static void printUsage(const char* program) {
+  printf("Usage: %s [options]\n", program);
+  printf("  --port N        UDP port (default %d)\n", TELEMETRY_PORT);
+  printf("  --group ADDR    Join this multicast group\n");
+  printf("  --duration S    Stop after S seconds (default: run until interrupted)\n");
+  printf("  --interval S    Seconds between reports (default 5)\n");
+  printf("  --simulate N    Stand-in: N stations on this host send to the port (and group)\n");
+  printf("  --rate HZ       Stand-in sample rate (default 100)\n");
+  printf("  --loss P        Stand-in packets skipped on purpose, 0 to 1 (default 0)\n");
+}
+
+static bool parseOptions(int argc, char** argv, ReceiverOptions& options) {
+  options.port = TELEMETRY_PORT;
+  options.group = NULL;
+  options.duration_s = 0;
+  options.interval_s = 5;
+  options.simulate = 0;
+  options.rate = 100;
+  options.loss = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--port") && hasValue) options.port = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--group") && hasValue) options.group = argv[++i];
+    else if (!strcmp(arg, "--duration") && hasValue) options.duration_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--interval") && hasValue) options.interval_s = atof(argv[++i]);
+    else if (!strcmp(arg, "--simulate") && hasValue) options.simulate = (uint16_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--rate") && hasValue) options.rate = atof(argv[++i]);
+    else if (!strcmp(arg, "--loss") && hasValue) options.loss = atof(argv[++i]);
+    else return false;
+  }
+  if (options.simulate && options.duration_s <= 0) options.duration_s = 20;
+  return options.interval_s > 0 && options.rate > 0;
+}
+
+int main(int argc, char** argv) {
+  ReceiverOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  int fd = openSocket(options);
+  if (fd < 0) {
+    perror("Cannot listen");
+    return 1;
+  }
+  printf("Listening on UDP port %u%s%s\n", options.port, options.group ? ", group " : "",
+         options.group ? options.group : "");
+  fflush(stdout);
+
+  int reportPipe[2] = { -1, -1 };
+  pid_t child = -1;
+  if (options.simulate) {
+    if (pipe(reportPipe) != 0) return 1;
+    child = fork();
+    if (child == 0) {
+      close(reportPipe[0]);
+      StandInReport report = runStandIn(options);
+      ssize_t written = write(reportPipe[1], &report, sizeof(report));
+      _exit(written == (ssize_t)sizeof(report) ? 0 : 1);
+    }
+    close(reportPipe[1]);
+    if (child < 0) return 1;
+  }
+
+  Receiver receiver;
+  int64_t started = utcNow();
+  int64_t lastReport = started;
+  double cpuStarted = cpuSeconds();
+  // The stand-in's last packets get a moment to arrive
+  int64_t end = options.duration_s > 0 ? started + (int64_t)((options.duration_s + 0.5) * 1e6) : 0;
+  struct pollfd watched = { fd, POLLIN, 0 };
+
+  while (!stopRequested) {
+    int n = poll(&watched, 1, 100);
+    if (n < 0 && errno != EINTR) break;
+    if (n > 0) receiver.read(fd);
+    int64_t now = utcNow();
+    if (now - lastReport >= options.interval_s * 1e6) {
+      receiver.report((now - lastReport) / 1e6);
+      lastReport = now;
+    }
+    if (end && now >= end) break;
+  }
+  int64_t now = utcNow();
+  if (now - lastReport > 100000) receiver.report((now - lastReport) / 1e6);
+  double wall = (now - started) / 1e6;
+  printf("Receiver CPU: %.3f s in %.1f s (%.2f%% of one core)\n", cpuSeconds() - cpuStarted, wall,
+         (cpuSeconds() - cpuStarted) / wall * 100);
+  close(fd);
+
+  if (!options.simulate) return 0;
+  StandInReport report = { 0, 0 };
+  bool reported = read(reportPipe[0], &report, sizeof(report)) == (ssize_t)sizeof(report);
+  close(reportPipe[0]);
+  waitpid(child, NULL, 0);
+  // Skipped packets after a station's last delivered one leave no gap to see
+  bool ok = reported && receiver.invalidCount() == 0 && receiver.packetCount() == report.sent &&
+            receiver.missingCount() <= report.skipped;
+  printf("Stand-in: %u sent, %u skipped on purpose; received %llu, %u counted lost\n%s\n", report.sent,
+         report.skipped, (unsigned long long)receiver.packetCount(), receiver.missingCount(),
+         ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -1,165 +1,231 @@
 #pragma once
+// Generated by tools/embed_web_assets.py from src/wifi_viewer.html - do not edit.
+// 11408 bytes, 3544 gzipped.
 #include <Arduino.h>
 
-const char WIFI_HTML_PAGE[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<title>Mercalli Seismometer</title>
-<meta name="viewport" content="width=device-width, initial-scale=1">
-<style>
-  body { font-family: Arial, sans-serif; background-color: #f0f0f0; color: #333; text-align: center; margin: 20px; }
-  h1 { color: #333; margin-bottom: 30px; }
-  .container { max-width: 800px; margin: 0 auto; padding: 20px; background-color: white; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }
-  .grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 20px; margin-top: 20px; }
-  .card { background-color: #f8f9fa; padding: 20px; border-radius: 8px; border: 1px solid #e9ecef; }
-  .card h2 { margin-top: 0; color: #333; font-size: 1.2em; }
-  .mercalli-peak { font-size: 4em; color: #dc3545; font-weight: bold; }
-  .mercalli-now { font-size: 2em; color: #28a745; }
-  .peak-values p, .current-values p { margin: 5px 0; font-size: 1.1em; }
-  .peak-values span, .current-values span { font-weight: bold; color: #007bff; }
-  button { background-color: #007bff; color: white; border: none; padding: 15px 30px; font-size: 1em; border-radius: 5px; cursor: pointer; margin-top: 20px; }
-  button:hover { background-color: #0056b3; }
-  .footer { margin-top: 20px; font-size: 0.8em; color: #666; }
-  .status-indicator { display: inline-block; width: 12px; height: 12px; border-radius: 50%; margin-right: 8px; }
-  .status-connected { background-color: #28a745; }
-  .status-disconnected { background-color: #dc3545; }
-  .loading { color: #666; font-style: italic; }
-  .event-info { background-color: #e7f3ff; padding: 10px; border-radius: 5px; margin-top: 15px; font-size: 0.9em; }
-  .event-info h3 { margin-top: 0; margin-bottom: 10px; color: #333; }
-  .time-sync { color: #28a745; font-weight: bold; }
-  .no-time-sync { color: #dc3545; font-style: italic; }
-  .events-link { display: inline-block; margin-top: 10px; padding: 8px 16px; background: #17a2b8; color: white; text-decoration: none; border-radius: 5px; font-size: 0.9em; }
-  .events-link:hover { background: #138496; color: white; text-decoration: none; }
-</style>
-<script>
-  let isLoading = false;
-  
-  function resetPeaks() {
-    if (isLoading) return;
-    isLoading = true;
-    
-    const button = document.querySelector('button');
-    const originalText = button.textContent;
-    button.textContent = 'Resetting...';
-    button.disabled = true;
-    
-    fetch('/reset', { method: 'POST' })
-      .then(response => {
-        if (response.ok) { 
-          console.log('Peak values reset'); 
-          updateData(); // Immediate update
-        } else { 
-          console.error('Reset failed'); 
-        }
-      })
-      .catch(error => {
-        console.error('Reset error:', error);
-      })
-      .finally(() => {
-        setTimeout(() => {
-          button.textContent = originalText;
-          button.disabled = false;
-          isLoading = false;
-        }, 1000);
-      });
-  }
-  
-  function updateData() {
-    fetch('/data')
-      .then(response => response.json())
-      .then(data => {
-        document.getElementById('mercalli-peak').innerText = data.mercalli_peak;
-        document.getElementById('mercalli-now').innerText = data.mercalli_now;
-        document.getElementById('x-peak').innerText = data.x_peak.toFixed(3);
-        document.getElementById('y-peak').innerText = data.y_peak.toFixed(3);
-        document.getElementById('z-peak').innerText = data.z_peak.toFixed(3);
-        document.getElementById('dev-mag-peak').innerText = data.dev_mag_peak.toFixed(3);
-        document.getElementById('x-now').innerText = data.x_now.toFixed(3);
-        document.getElementById('y-now').innerText = data.y_now.toFixed(3);
-        document.getElementById('z-now').innerText = data.z_now.toFixed(3);
-        document.getElementById('dev-mag-now').innerText = data.dev_mag_now.toFixed(3);
-        
-        // Update event information
-        const eventInfo = document.getElementById('event-info');
-        if (data.timeSync) {
-          document.getElementById('time-status').innerHTML = '<span class="time-sync">Time Synchronized</span>';
-          document.getElementById('event-count').innerText = data.eventCount || 0;
-          
-          if (data.lastEvent) {
-            document.getElementById('last-event').innerHTML = 
-              'Last Event: Mercalli ' + data.lastEvent.mercalli + ' at ' + data.lastEvent.timestamp;
-          } else {
-            document.getElementById('last-event').innerText = 'No events recorded yet';
-          }
-        } else {
-          document.getElementById('time-status').innerHTML = '<span class="no-time-sync">Time not synchronized</span>';
-          document.getElementById('event-count').innerText = 'N/A';
-          document.getElementById('last-event').innerText = 'Time sync required for event logging';
-        }
-        
-        // Remove loading states
-        document.querySelectorAll('.loading').forEach(el => {
-          el.classList.remove('loading');
-        });
-      })
-      .catch(error => {
-        console.error('Data fetch error:', error);
-      });
-  }
-
-  // Optimized loading - no auto-refresh, manual updates only
-  document.addEventListener('DOMContentLoaded', function() {
-    // Initial load after a brief delay to let page render
-    setTimeout(updateData, 100);
-    
-    // Update every 3 seconds (less frequent than before)
-    setInterval(updateData, 3000);
-  });
-</script>
-</head>
-<body>
-  <div class="container">
-    <h1><span class="status-indicator status-connected"></span>Mercalli Seismometer</h1>
-    <div class="grid">
-      <div class="card mercalli">
-        <h2>PEAK MERCALLI VALUE</h2>
-        <p class="mercalli-peak loading" id="mercalli-peak">Loading...</p>
-      </div>
-      <div class="card mercalli">
-        <h2>CURRENT MERCALLI VALUE</h2>
-        <p class="mercalli-now loading" id="mercalli-now">Loading...</p>
-      </div>
-    </div>
-    <div class="grid">
-      <div class="card peak-values">
-        <h2>Peak Deviations (m/s<sup>2</sup>)</h2>
-        <p>X: <span class="loading" id="x-peak">---</span></p>
-        <p>Y: <span class="loading" id="y-peak">---</span></p>
-        <p>Z: <span class="loading" id="z-peak">---</span></p>
-        <p>Magnitude: <span class="loading" id="dev-mag-peak">---</span></p>
-      </div>
-      <div class="card current-values">
-        <h2>Current Deviations (m/s<sup>2</sup>)</h2>
-        <p>X: <span class="loading" id="x-now">---</span></p>
-        <p>Y: <span class="loading" id="y-now">---</span></p>
-        <p>Z: <span class="loading" id="z-now">---</span></p>
-        <p>Magnitude: <span class="loading" id="dev-mag-now">---</span></p>
-      </div>
-    </div>
-    <button onclick="resetPeaks()">Reset Peak Values</button>
-    <div class="event-info">
-      <h3>Event Logging</h3>
-      <div id="time-status" class="no-time-sync">⚠ Time not synchronized</div>
-      <div>Events Logged: <span id="event-count">0</span></div>
-      <div id="last-event">No events recorded yet</div>
-      <a href="/events" target="_blank" class="events-link">View Event Log</a>
-    </div>
-    <div class="footer">
-      <p>Device IP: %IP_ADDRESS%</p>
-      <p>(c) 2025 John Schop</p>
-    </div>
-  </div>
-</body>
-</html>
-)rawliteral";
+const char WIFI_HTML_PAGE_ETAG[] = "\"b009e76938d62203\"";
+const size_t WIFI_HTML_PAGE_GZ_LEN = 3544;
+const uint8_t WIFI_HTML_PAGE_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x1a, 0xdb, 0x72, 0xdb, 0xc6,
+  0xf5, 0xdd, 0x5f, 0xb1, 0x61, 0x9a, 0x01, 0x18, 0xf3, 0xce, 0xc8, 0x96, 0x79, 0xeb, 0xa8, 0xb2,
+  0x9c, 0x28, 0x95, 0x6d, 0x8d, 0xa4, 0xa4, 0x49, 0x3c, 0x1e, 0x67, 0x09, 0x2c, 0xc9, 0xb5, 0x40,
+  0x2c, 0x02, 0x2c, 0x25, 0x92, 0xb6, 0x7e, 0xa4, 0x4f, 0xfd, 0x85, 0xf6, 0x13, 0xf2, 0x29, 0xfd,
+  0x92, 0x9e, 0xbd, 0x00, 0xd8, 0x05, 0x40, 0x4a, 0xf2, 0x74, 0xa4, 0x91, 0x00, 0xec, 0x39, 0x67,
+  0xcf, 0xfd, 0xb2, 0xc0, 0x93, 0xd1, 0x57, 0x2f, 0xdf, 0x1e, 0x5f, 0xfd, 0x7a, 0x7e, 0x82, 0x16,
+  0x7c, 0x19, 0x4c, 0x9e, 0x8c, 0xd2, 0x7f, 0x04, 0xfb, 0xf0, 0x8f, 0x53, 0x1e, 0x90, 0xc9, 0x6b,
+  0x12, 0x7b, 0x38, 0x08, 0x28, 0xba, 0x24, 0x34, 0x59, 0xb2, 0x25, 0xe1, 0x24, 0x1e, 0xb5, 0xd5,
+  0xda, 0x93, 0x11, 0xdc, 0x62, 0x14, 0xe2, 0x25, 0x19, 0xd7, 0x6e, 0x28, 0xb9, 0x8d, 0x58, 0xcc,
+  0x6b, 0xc8, 0x63, 0x21, 0x27, 0x21, 0x1f, 0xd7, 0x6e, 0xa9, 0xcf, 0x17, 0x63, 0x9f, 0xdc, 0x50,
+  0x8f, 0x34, 0xe5, 0x4d, 0x03, 0xd1, 0x90, 0x72, 0x8a, 0x83, 0x66, 0x02, 0x54, 0xc9, 0xb8, 0x5b,
+  0x03, 0x22, 0x09, 0xdf, 0x08, 0x62, 0x08, 0x4d, 0x99, 0xbf, 0x41, 0x9f, 0xd0, 0x0c, 0xf0, 0x9b,
+  0x33, 0xbc, 0xa4, 0xc1, 0x66, 0x80, 0x8e, 0x62, 0x80, 0x6e, 0xa0, 0x04, 0x87, 0x49, 0x33, 0x21,
+  0x31, 0x9d, 0x0d, 0xd1, 0x14, 0x7b, 0xd7, 0xf3, 0x98, 0xad, 0x42, 0xbf, 0xe9, 0xb1, 0x80, 0xc5,
+  0x03, 0xf4, 0xf5, 0xac, 0x23, 0x7e, 0x86, 0x28, 0xbd, 0xef, 0xf7, 0xfb, 0x43, 0xc4, 0xc9, 0x9a,
+  0x37, 0x71, 0x40, 0xe7, 0xe1, 0x00, 0x79, 0xc0, 0x10, 0x89, 0x87, 0x68, 0x89, 0xe3, 0x39, 0x85,
+  0xfb, 0x5e, 0x27, 0x5a, 0x0f, 0xd1, 0x1d, 0x6c, 0xba, 0xe8, 0xc2, 0x96, 0x16, 0x9e, 0x82, 0x69,
+  0x4e, 0x19, 0xe7, 0x6c, 0x39, 0x40, 0xfd, 0x0c, 0xb4, 0x25, 0x24, 0xc3, 0x34, 0x24, 0x31, 0xa0,
+  0x2c, 0xf1, 0x5a, 0xc9, 0x34, 0x40, 0x87, 0x1d, 0x09, 0x92, 0xd2, 0xee, 0x20, 0xbc, 0xe2, 0x6c,
+  0x88, 0x22, 0xec, 0xfb, 0x34, 0x9c, 0xa7, 0x9b, 0x95, 0xd9, 0xbe, 0x5d, 0x50, 0x4e, 0x60, 0x81,
+  0xc5, 0x3e, 0x89, 0x9b, 0x31, 0xf6, 0xe9, 0x2a, 0x19, 0xa0, 0xae, 0x82, 0x66, 0xeb, 0x66, 0xb2,
+  0xc0, 0x3e, 0xbb, 0x15, 0x04, 0x7b, 0xd1, 0x5a, 0x3e, 0x47, 0xf1, 0x7c, 0x8a, 0xdd, 0x4e, 0x43,
+  0xfe, 0xb4, 0xba, 0x75, 0xcd, 0xd7, 0x3c, 0xa6, 0x3e, 0xb0, 0xe4, 0xd3, 0x24, 0x0a, 0x30, 0x28,
+  0x4d, 0xdc, 0x0f, 0xe5, 0xdf, 0x26, 0x27, 0x4b, 0x78, 0xc6, 0x89, 0xd8, 0x73, 0xb5, 0x0c, 0x81,
+  0x7e, 0x4c, 0x22, 0x82, 0xb9, 0x2b, 0x78, 0x6c, 0xce, 0x28, 0x6f, 0xa0, 0x25, 0x0d, 0x41, 0x18,
+  0xb7, 0x27, 0xa4, 0x68, 0xa0, 0xee, 0x2c, 0xae, 0x03, 0xdd, 0x39, 0x8e, 0x52, 0xc6, 0xb5, 0x3e,
+  0x38, 0x8b, 0x4c, 0xbd, 0xb5, 0x3c, 0x1c, 0x8b, 0x4d, 0xab, 0xac, 0x71, 0x38, 0x7b, 0x31, 0xc3,
+  0x65, 0x05, 0xd8, 0x72, 0x1e, 0xe6, 0xcf, 0x40, 0x68, 0x90, 0x2d, 0x61, 0x01, 0x88, 0xf1, 0x35,
+  0x79, 0x41, 0x3c, 0x32, 0x33, 0x37, 0x59, 0xf4, 0xa4, 0xbe, 0x73, 0x2e, 0x8a, 0x96, 0x96, 0x1e,
+  0x93, 0xd0, 0x2d, 0x01, 0x42, 0xad, 0x1e, 0x59, 0x6a, 0xe4, 0xa5, 0xf6, 0xdd, 0x26, 0x08, 0x7c,
+  0x9d, 0x3a, 0x96, 0x02, 0xfb, 0x4e, 0x00, 0xa5, 0x34, 0x7c, 0xaf, 0x7f, 0xf0, 0xdd, 0x81, 0x26,
+  0x73, 0x4b, 0xe8, 0x7c, 0xc1, 0x07, 0xc0, 0x59, 0xe0, 0x17, 0xe9, 0x84, 0xec, 0xd6, 0x26, 0xd3,
+  0x33, 0xc9, 0xf4, 0x0e, 0xf1, 0x73, 0x41, 0x46, 0xe2, 0x88, 0x2d, 0x9b, 0x37, 0x38, 0x58, 0x91,
+  0x04, 0x45, 0x0d, 0x10, 0x64, 0x15, 0xc7, 0xe0, 0x83, 0xd9, 0xa3, 0x4c, 0xa2, 0x01, 0x3a, 0x00,
+  0xd9, 0x3b, 0x05, 0x21, 0xba, 0x99, 0x10, 0x26, 0xa1, 0x24, 0xc2, 0x61, 0x99, 0x96, 0x78, 0x9a,
+  0xb2, 0x65, 0x73, 0x9f, 0x72, 0xd6, 0xe9, 0x3c, 0x9f, 0xce, 0xb4, 0x4a, 0xa7, 0x2b, 0x70, 0xeb,
+  0xb0, 0xda, 0x70, 0x29, 0x5c, 0x95, 0x7f, 0x0e, 0x50, 0xc8, 0x42, 0x62, 0x18, 0xb5, 0x2b, 0xf8,
+  0x56, 0xc1, 0x61, 0xb2, 0x2e, 0x18, 0x2f, 0x58, 0xfa, 0x40, 0xc0, 0x00, 0xd3, 0x89, 0x20, 0x1a,
+  0x31, 0x6a, 0x86, 0x62, 0xd1, 0xad, 0x14, 0x7b, 0x83, 0x05, 0xbb, 0x91, 0x51, 0x56, 0xc9, 0xe4,
+  0xc1, 0xb3, 0x69, 0x5f, 0x6b, 0x67, 0xc6, 0x18, 0xd7, 0xe1, 0x58, 0xa4, 0x66, 0x30, 0xd5, 0x69,
+  0x1d, 0x9a, 0x86, 0x7a, 0xf6, 0xec, 0x99, 0x46, 0x4f, 0x38, 0xe6, 0xab, 0xa4, 0x49, 0x43, 0x9f,
+  0x7a, 0x98, 0xb3, 0xd8, 0x0c, 0x22, 0x1a, 0x06, 0x10, 0xea, 0xcd, 0x69, 0xc0, 0xbc, 0xeb, 0x21,
+  0xd2, 0xa1, 0xde, 0xed, 0x09, 0xd2, 0x0b, 0xad, 0x65, 0x75, 0x57, 0x94, 0xb6, 0xf3, 0x4d, 0x26,
+  0x5c, 0xac, 0xe0, 0x0e, 0xb3, 0xa0, 0xd1, 0x1b, 0x42, 0x22, 0x09, 0x89, 0xc7, 0xc9, 0x8e, 0x00,
+  0xb2, 0x3c, 0x49, 0xa3, 0x00, 0x5f, 0xf7, 0x60, 0xa5, 0x6e, 0x2c, 0xb1, 0x02, 0x86, 0x85, 0x99,
+  0x8c, 0xdc, 0x26, 0xa5, 0x56, 0x4a, 0x11, 0x09, 0x17, 0x04, 0xe4, 0x90, 0x1c, 0x3d, 0x0d, 0x4f,
+  0x6e, 0x84, 0x47, 0xd1, 0x70, 0xc6, 0xaa, 0x89, 0x93, 0xe7, 0xb3, 0xbe, 0x70, 0x8d, 0xdc, 0xfc,
+  0x55, 0x31, 0x7d, 0x50, 0xcc, 0x17, 0xdd, 0x83, 0x92, 0x29, 0x5e, 0x64, 0xae, 0x6d, 0xec, 0xb9,
+  0xe8, 0x97, 0x43, 0xbc, 0x90, 0x87, 0xd5, 0x86, 0x56, 0xdc, 0x4b, 0x2a, 0x9c, 0x2e, 0x49, 0x33,
+  0xd9, 0x84, 0x9e, 0x21, 0x6b, 0xaa, 0xc0, 0x5d, 0x11, 0x1d, 0xb2, 0x66, 0x15, 0x9a, 0x95, 0x08,
+  0x76, 0x6a, 0x29, 0x69, 0x82, 0x63, 0x5c, 0xef, 0x76, 0x15, 0x4b, 0x7e, 0xc9, 0x74, 0xa6, 0xb4,
+  0x43, 0x91, 0xc7, 0x9f, 0xd9, 0xd5, 0x00, 0xf6, 0xed, 0x3e, 0xc7, 0xbd, 0xe9, 0x61, 0x31, 0xee,
+  0x64, 0xfd, 0xf2, 0x89, 0xc7, 0x62, 0xcc, 0x29, 0xc4, 0x84, 0x0e, 0xc0, 0x2a, 0x95, 0xef, 0x53,
+  0xb0, 0x62, 0xb7, 0x22, 0xa2, 0xc4, 0xc6, 0xfd, 0xc3, 0xef, 0x5e, 0x3c, 0x7b, 0xe0, 0xc6, 0x4a,
+  0xdb, 0x31, 0xf6, 0x48, 0x65, 0xbc, 0x19, 0xcb, 0x1e, 0x0e, 0x6f, 0x70, 0x02, 0x50, 0x69, 0xd4,
+  0x74, 0x44, 0x4c, 0x64, 0x51, 0x73, 0xd8, 0x29, 0x69, 0x60, 0x26, 0x7c, 0x6b, 0x4f, 0x31, 0xa8,
+  0x12, 0x3a, 0xdf, 0xb0, 0x19, 0x90, 0x39, 0x09, 0x7d, 0x3b, 0x37, 0xef, 0x0c, 0x7a, 0x0b, 0xa5,
+  0xb5, 0xae, 0xb0, 0xff, 0x5d, 0x11, 0x68, 0x53, 0xe1, 0x5b, 0x25, 0xa0, 0xad, 0x01, 0x94, 0x67,
+  0xdc, 0x51, 0x5b, 0xf7, 0x37, 0xa3, 0xc4, 0x8b, 0x69, 0xc4, 0x45, 0xa3, 0x13, 0x10, 0x8e, 0x68,
+  0x72, 0xa6, 0x43, 0x74, 0x8c, 0x66, 0x38, 0x48, 0xc8, 0x10, 0x16, 0xe0, 0x77, 0xb6, 0x0a, 0x3d,
+  0xa1, 0x75, 0xa8, 0xd3, 0x09, 0xe1, 0xe7, 0x90, 0xfd, 0x13, 0xb7, 0x8e, 0x3e, 0xc1, 0x0a, 0x42,
+  0x74, 0x86, 0xdc, 0x0c, 0xaf, 0x0e, 0x10, 0x7c, 0x15, 0x87, 0x43, 0xb5, 0x64, 0x90, 0xe3, 0xf1,
+  0x8a, 0xa8, 0xa7, 0xf2, 0x0f, 0xa4, 0x8d, 0x84, 0xa7, 0x79, 0x7f, 0x8c, 0x7c, 0xe6, 0xad, 0x96,
+  0xe0, 0x17, 0xad, 0x3f, 0x56, 0x24, 0xde, 0x5c, 0x92, 0x00, 0x52, 0x0a, 0x8b, 0x5d, 0x47, 0x01,
+  0x38, 0xf5, 0xa1, 0x81, 0xc4, 0x20, 0x81, 0xd1, 0x10, 0x07, 0x57, 0xe0, 0x11, 0x80, 0xaa, 0x40,
+  0x5a, 0xc2, 0x3f, 0x8e, 0x55, 0x93, 0xa7, 0x80, 0xcb, 0xcf, 0x01, 0xd8, 0xb9, 0x10, 0x02, 0x70,
+  0x60, 0xa9, 0xd5, 0x6a, 0x39, 0x16, 0x20, 0x04, 0x0e, 0x9e, 0x06, 0x90, 0xc7, 0x4a, 0xbc, 0xce,
+  0x08, 0xf7, 0x16, 0xae, 0xd3, 0x96, 0xc2, 0x3b, 0x0d, 0xe1, 0x68, 0x84, 0x2f, 0x18, 0xb8, 0x88,
+  0x73, 0xfe, 0xf6, 0xf2, 0xca, 0x41, 0x77, 0x75, 0x09, 0x27, 0xcc, 0xb8, 0x20, 0xa1, 0x0b, 0x70,
+  0x11, 0x70, 0x4a, 0xd0, 0x78, 0xa2, 0x75, 0x94, 0xea, 0x29, 0x5d, 0x69, 0xb1, 0x6b, 0x50, 0x1f,
+  0xca, 0xd6, 0x94, 0x68, 0x2c, 0x20, 0x90, 0x22, 0xe7, 0xae, 0x23, 0x14, 0x8c, 0x74, 0x21, 0x55,
+  0x9b, 0x42, 0xf3, 0x63, 0x00, 0xaf, 0x22, 0x1f, 0xba, 0xa7, 0x97, 0x98, 0x63, 0x17, 0x16, 0xda,
+  0x6d, 0x74, 0xba, 0x5c, 0x12, 0x9f, 0xc2, 0x33, 0xbd, 0x94, 0xc1, 0xde, 0x21, 0x02, 0x56, 0xac,
+  0xde, 0x8a, 0xc4, 0xb1, 0x50, 0xb1, 0xd4, 0x08, 0x58, 0x9b, 0x82, 0xec, 0xd6, 0x3e, 0x77, 0xfa,
+  0x2a, 0x97, 0x0e, 0xca, 0x11, 0x28, 0x42, 0xe2, 0xd9, 0xb2, 0x55, 0x92, 0x94, 0x37, 0x03, 0xd0,
+  0x97, 0xbc, 0xd0, 0x26, 0x34, 0xc9, 0xcd, 0x84, 0x15, 0x83, 0x8d, 0x0b, 0xae, 0x64, 0x51, 0x03,
+  0xe4, 0x2b, 0x48, 0x84, 0x6c, 0xc5, 0x4b, 0x4b, 0x3b, 0xcc, 0x6a, 0xba, 0xc4, 0xb0, 0x0c, 0x6c,
+  0x98, 0x36, 0xf3, 0xea, 0xcc, 0x2c, 0x55, 0x2e, 0xaf, 0x39, 0x6d, 0x88, 0x24, 0xd1, 0x31, 0x38,
+  0x17, 0x57, 0x77, 0x2a, 0x24, 0x40, 0xeb, 0x67, 0xf4, 0x86, 0x20, 0x19, 0x6e, 0x03, 0x04, 0x86,
+  0x47, 0x01, 0x06, 0xef, 0xbc, 0xba, 0x38, 0x3a, 0x3e, 0xf9, 0x70, 0x79, 0x72, 0xfc, 0xf6, 0xcd,
+  0xcb, 0x4b, 0xc4, 0x66, 0x90, 0x52, 0xa0, 0x62, 0x45, 0x38, 0x49, 0x60, 0xff, 0x04, 0x43, 0xe3,
+  0x0b, 0x46, 0x9d, 0xc5, 0x6c, 0x89, 0x20, 0x06, 0x63, 0x82, 0x97, 0x4f, 0x52, 0xbf, 0xb6, 0x31,
+  0xc7, 0xb0, 0xf7, 0x50, 0x87, 0xa5, 0x4a, 0x60, 0x63, 0x14, 0xae, 0x82, 0x60, 0xa8, 0x78, 0x81,
+  0xed, 0x3f, 0x21, 0xe8, 0x8c, 0x37, 0x0d, 0xb4, 0x1d, 0xa0, 0x57, 0x50, 0x59, 0x79, 0xbf, 0x77,
+  0x14, 0xc7, 0x78, 0x83, 0x62, 0x21, 0xcc, 0x74, 0x35, 0x9b, 0x91, 0x38, 0x81, 0x2a, 0x80, 0x96,
+  0xed, 0xe4, 0xcf, 0xff, 0x34, 0x50, 0x08, 0xba, 0x69, 0x00, 0xb9, 0x70, 0xce, 0x17, 0x52, 0x08,
+  0x41, 0x59, 0xb0, 0x7c, 0xc6, 0xe6, 0x17, 0x30, 0x0e, 0x25, 0x54, 0x46, 0x62, 0xb3, 0x9b, 0xee,
+  0xea, 0xc7, 0xf8, 0xf6, 0x1c, 0x92, 0xc8, 0x9e, 0x74, 0x20, 0x2c, 0x05, 0x64, 0x5d, 0xea, 0x37,
+  0x94, 0xbf, 0xa6, 0x49, 0x41, 0x49, 0x44, 0x02, 0x33, 0xb4, 0xe7, 0x84, 0x9f, 0x04, 0x44, 0x5c,
+  0xfe, 0x6d, 0x73, 0xea, 0x03, 0x8e, 0x56, 0x2c, 0x09, 0x5a, 0x14, 0x7a, 0x88, 0x58, 0xc7, 0xb3,
+  0xa4, 0x93, 0xad, 0x78, 0xc0, 0x61, 0x72, 0x46, 0x13, 0xde, 0x8a, 0xc9, 0x12, 0xaa, 0x85, 0xeb,
+  0xe8, 0x26, 0xc2, 0x31, 0x8d, 0x91, 0x31, 0xb4, 0x00, 0x65, 0x07, 0xe4, 0x52, 0x2a, 0xf6, 0x55,
+  0x0c, 0x33, 0xa0, 0x2b, 0xcb, 0x8d, 0xcd, 0xd6, 0x4c, 0x2c, 0xc0, 0x4e, 0x3f, 0x5e, 0xbe, 0x7d,
+  0xd3, 0x8a, 0x70, 0x9c, 0x68, 0xa8, 0x16, 0x84, 0x0e, 0xb6, 0x52, 0x8d, 0x1c, 0x08, 0x85, 0xf0,
+  0x02, 0xa3, 0x25, 0xef, 0x8c, 0xbc, 0x90, 0x4a, 0xef, 0x58, 0x3d, 0x3d, 0x38, 0xbc, 0x02, 0x4f,
+  0x9f, 0x7e, 0x10, 0x4f, 0x35, 0xd9, 0x32, 0x0a, 0xb4, 0xef, 0x25, 0x8c, 0x22, 0xf0, 0x3a, 0x25,
+  0xec, 0x2a, 0x38, 0x71, 0xf7, 0xae, 0xf3, 0x1e, 0x7d, 0xab, 0x18, 0xac, 0xb7, 0x38, 0x7b, 0x45,
+  0xd7, 0xc4, 0x77, 0xfb, 0xf5, 0x22, 0xea, 0xa6, 0x0a, 0xb5, 0xfb, 0x20, 0xd4, 0x6d, 0x15, 0x6a,
+  0xef, 0x41, 0xa8, 0x30, 0x5e, 0x37, 0x97, 0x78, 0x5e, 0x45, 0xa0, 0xbf, 0x8f, 0x80, 0xa9, 0x7a,
+  0x1d, 0x2a, 0x99, 0xf2, 0xd5, 0xbd, 0x69, 0x1d, 0x0f, 0xea, 0xb4, 0xf0, 0x18, 0xbd, 0xd4, 0xd2,
+  0xbe, 0xdd, 0x46, 0x7d, 0x13, 0x4a, 0x3f, 0x1d, 0xa3, 0xd7, 0x98, 0x2f, 0x5a, 0xb2, 0xb6, 0x6b,
+  0x7e, 0x62, 0x91, 0x30, 0xbf, 0xb5, 0xe3, 0x4e, 0x33, 0x22, 0x92, 0xf5, 0x57, 0x2a, 0xec, 0x3e,
+  0x7f, 0x56, 0xf1, 0x97, 0x92, 0xff, 0x6a, 0x3c, 0xd6, 0x34, 0xeb, 0x59, 0x62, 0x4a, 0x03, 0x14,
+  0x42, 0x12, 0x1a, 0x13, 0x72, 0x6b, 0x05, 0xa4, 0xab, 0xa1, 0x21, 0x58, 0xf7, 0x2d, 0x6e, 0xf7,
+  0x2d, 0x8a, 0xe0, 0x85, 0xee, 0x21, 0x8d, 0xdf, 0x41, 0x16, 0xc7, 0x8a, 0x5d, 0x95, 0xaa, 0x67,
+  0x90, 0x96, 0x5d, 0x59, 0xc6, 0x81, 0x15, 0xe8, 0x55, 0x29, 0x1a, 0x29, 0x1d, 0xc1, 0xe5, 0xd3,
+  0xa7, 0x39, 0xb7, 0x4a, 0x2f, 0x1f, 0x65, 0xa1, 0x13, 0x82, 0x85, 0x46, 0xd6, 0x54, 0x4f, 0xd6,
+  0xef, 0x3e, 0xbe, 0xcf, 0x15, 0xfb, 0xae, 0x0f, 0x5a, 0xa2, 0x99, 0xdd, 0x6c, 0xd0, 0x4d, 0x05,
+  0x28, 0x7a, 0x8a, 0xba, 0x3b, 0xc0, 0xb7, 0xd5, 0xe0, 0xbd, 0x1d, 0xe0, 0xa1, 0xca, 0x09, 0xee,
+  0x47, 0x41, 0xb2, 0x8e, 0xbe, 0xd1, 0x72, 0x9b, 0x52, 0x0b, 0x53, 0x29, 0x4f, 0x98, 0xa0, 0x4e,
+  0x51, 0x48, 0xa1, 0x09, 0xb1, 0x87, 0x86, 0x68, 0x02, 0x91, 0xa1, 0x05, 0xb0, 0x36, 0x98, 0xc9,
+  0x45, 0x04, 0x53, 0x99, 0xcf, 0x2d, 0x79, 0xc0, 0x52, 0x85, 0xb5, 0x32, 0xf3, 0x46, 0xe4, 0xaa,
+  0xf8, 0x5e, 0x97, 0x7d, 0xdd, 0x0a, 0x52, 0x05, 0xb5, 0xd9, 0x0b, 0xb5, 0xd5, 0x50, 0xdb, 0xbd,
+  0x50, 0x69, 0xe8, 0x29, 0x58, 0xe9, 0xf3, 0x8b, 0x4d, 0xc4, 0xb8, 0xab, 0x8b, 0x45, 0x45, 0xd4,
+  0x29, 0x3d, 0x0a, 0xc7, 0x51, 0x63, 0x1d, 0x88, 0xf7, 0x7b, 0x00, 0xb5, 0xad, 0x81, 0xfe, 0xf2,
+  0x29, 0x8f, 0x94, 0x0c, 0xaf, 0x53, 0xbf, 0x43, 0x3f, 0x6c, 0x7f, 0xcf, 0x03, 0x45, 0xc1, 0x80,
+  0xfc, 0x74, 0xaa, 0x9a, 0x73, 0x19, 0x23, 0x10, 0x67, 0x04, 0x2a, 0x3c, 0xf1, 0xeb, 0x29, 0xd9,
+  0xa7, 0x40, 0x17, 0x4c, 0x90, 0x01, 0x42, 0x5d, 0x49, 0x37, 0x30, 0x90, 0xef, 0xbe, 0xf9, 0x3d,
+  0xcd, 0xfe, 0xd0, 0xb9, 0xe4, 0xf4, 0x39, 0xd4, 0xf8, 0x39, 0x89, 0x6d, 0x7a, 0x0e, 0xd0, 0xbb,
+  0xba, 0x38, 0xfd, 0xfe, 0xfb, 0x93, 0x8b, 0x93, 0x97, 0x4e, 0x21, 0x0b, 0xa9, 0xfa, 0xda, 0x54,
+  0xd0, 0xa0, 0x0c, 0x75, 0x61, 0xa6, 0x1a, 0xa8, 0xa2, 0x27, 0x22, 0xf3, 0x23, 0x9f, 0x70, 0x68,
+  0x80, 0x12, 0xc4, 0xc2, 0x60, 0x83, 0x3c, 0xa8, 0x22, 0x73, 0x02, 0x73, 0x02, 0x04, 0x98, 0xac,
+  0xeb, 0x6c, 0x3e, 0x54, 0x4d, 0xa0, 0xb8, 0x5d, 0x8a, 0x3f, 0x61, 0x41, 0x78, 0x00, 0xf9, 0x10,
+  0xa7, 0x45, 0x54, 0x66, 0x08, 0xbb, 0xb0, 0xe6, 0x7e, 0x59, 0xae, 0xb8, 0x65, 0x0a, 0xa9, 0x51,
+  0xad, 0x3e, 0xcf, 0x30, 0x55, 0x9e, 0xa2, 0x8c, 0x1a, 0x9d, 0x6f, 0x61, 0x17, 0xee, 0xbc, 0x99,
+  0x45, 0xd0, 0x4c, 0x42, 0x7f, 0x9d, 0xf0, 0xa3, 0x90, 0x2e, 0xa5, 0xae, 0x55, 0x89, 0x14, 0xf0,
+  0x57, 0x22, 0xdc, 0x8c, 0x4d, 0x8a, 0x85, 0x35, 0x83, 0xc9, 0xfa, 0xfe, 0x1d, 0xed, 0x41, 0x96,
+  0x9c, 0xd5, 0xb8, 0xb5, 0xbb, 0xfe, 0x3b, 0x32, 0xc2, 0xed, 0xd6, 0x5e, 0x8e, 0x66, 0x80, 0xa3,
+  0x90, 0x5b, 0x85, 0x5b, 0x2f, 0xa0, 0x80, 0xfc, 0x0f, 0xf1, 0xd0, 0x44, 0x52, 0x23, 0x5c, 0x0e,
+  0x56, 0xbc, 0x57, 0x68, 0x3f, 0xc8, 0xa7, 0x16, 0x87, 0x7c, 0x9d, 0x03, 0x01, 0x73, 0xb2, 0x9d,
+  0x14, 0x7e, 0xd3, 0xf3, 0x33, 0xae, 0xf8, 0x1a, 0xd0, 0x09, 0x8e, 0x2f, 0x60, 0x1e, 0x71, 0x21,
+  0xfd, 0xc2, 0xaf, 0x3e, 0x33, 0x56, 0xbb, 0x94, 0xca, 0x85, 0x3d, 0x00, 0xa5, 0x4e, 0x76, 0xb9,
+  0x81, 0x06, 0x1d, 0x1c, 0xd8, 0xd3, 0x1d, 0x85, 0x74, 0x2d, 0x8c, 0x66, 0x01, 0x83, 0x94, 0x9d,
+  0x30, 0xf4, 0xc7, 0x8a, 0x42, 0xf4, 0x85, 0x8c, 0x82, 0xc7, 0xfb, 0x0c, 0xaa, 0x5e, 0xc8, 0xa0,
+  0x4d, 0xa1, 0x41, 0x20, 0xfd, 0x2f, 0x0a, 0x18, 0xcf, 0x42, 0x34, 0x96, 0xbe, 0x09, 0xf9, 0xbd,
+  0xd5, 0x39, 0x18, 0xe6, 0x69, 0x5f, 0x89, 0x84, 0xd7, 0x34, 0x11, 0x3d, 0xe7, 0x3b, 0x9d, 0xc6,
+  0x1b, 0x69, 0x92, 0x4e, 0x2f, 0xb6, 0xef, 0x73, 0x37, 0xa9, 0x2a, 0x17, 0x66, 0xa5, 0xd3, 0x55,
+  0x23, 0xdd, 0x50, 0xa6, 0x12, 0x71, 0x26, 0x2b, 0x1f, 0xe8, 0xd4, 0x82, 0xa7, 0x89, 0x2b, 0x36,
+  0x85, 0xdc, 0x69, 0x67, 0x93, 0x2c, 0x08, 0xd5, 0x38, 0x2a, 0x71, 0x20, 0x04, 0x9d, 0x3f, 0xff,
+  0xed, 0x40, 0xc6, 0x94, 0xb7, 0x46, 0x22, 0x82, 0x47, 0x8e, 0xea, 0x53, 0x1d, 0xab, 0x13, 0x00,
+  0xf5, 0x43, 0x10, 0xb3, 0x6b, 0xe8, 0xe8, 0x36, 0xb2, 0x11, 0x73, 0xf4, 0xf0, 0xed, 0xe4, 0xf6,
+  0x99, 0x12, 0x68, 0xfd, 0xcf, 0x81, 0x19, 0xd7, 0x30, 0x9a, 0x68, 0x15, 0xaf, 0x98, 0xb0, 0x98,
+  0xf6, 0x86, 0x36, 0xea, 0x19, 0xcb, 0xe2, 0x64, 0x04, 0x96, 0x2d, 0x53, 0x16, 0x40, 0xd4, 0xbe,
+  0x6e, 0xb9, 0x31, 0x91, 0xd3, 0xb4, 0x70, 0xec, 0x77, 0x8e, 0x9e, 0xcd, 0x85, 0x5c, 0x7a, 0x02,
+  0x97, 0x97, 0x6a, 0xce, 0x76, 0xde, 0x2b, 0xd4, 0x3d, 0xb6, 0x68, 0x81, 0x09, 0x4e, 0x30, 0x8c,
+  0x54, 0x52, 0x87, 0x0d, 0x84, 0xad, 0x69, 0xa7, 0x2c, 0xbd, 0xda, 0xfa, 0x1d, 0x7e, 0x3f, 0x34,
+  0x40, 0x4a, 0xf2, 0x3f, 0xd8, 0xb2, 0xf6, 0xfc, 0xc6, 0x55, 0xe7, 0x0d, 0x18, 0xd2, 0xa0, 0xae,
+  0x51, 0x80, 0x9f, 0x22, 0x2a, 0x6a, 0xaf, 0x49, 0xe2, 0xfd, 0xb0, 0x80, 0x1c, 0x89, 0x60, 0xa2,
+  0x50, 0x08, 0x55, 0xd0, 0xb6, 0x91, 0x6b, 0x75, 0x4d, 0x66, 0xe5, 0xcd, 0x50, 0x44, 0x91, 0xcd,
+  0x95, 0x0f, 0x30, 0x8a, 0x83, 0xb6, 0xf6, 0x39, 0x28, 0xdb, 0xd6, 0x6a, 0xcf, 0xa0, 0x20, 0x4f,
+  0x1d, 0xd0, 0x18, 0x32, 0x2d, 0xd4, 0x7c, 0xc3, 0xe2, 0xe2, 0x6d, 0x41, 0xb4, 0x81, 0x31, 0x56,
+  0x56, 0x0f, 0xc3, 0xd6, 0xe9, 0xc2, 0x13, 0x7b, 0xb8, 0x2d, 0x9b, 0xfa, 0xae, 0x72, 0xb0, 0x80,
+  0xda, 0x11, 0x73, 0x35, 0x57, 0xb8, 0xf6, 0x34, 0x91, 0xb0, 0x55, 0xac, 0xa6, 0x33, 0xe8, 0xde,
+  0x64, 0x35, 0xb9, 0x94, 0x4f, 0x5c, 0x47, 0x0f, 0x78, 0xa9, 0x4b, 0x2b, 0xc0, 0x16, 0x0b, 0x97,
+  0x24, 0x49, 0xb0, 0x8c, 0xa9, 0xd2, 0xb8, 0x32, 0xb4, 0xca, 0x92, 0x22, 0x04, 0x19, 0x45, 0x1f,
+  0xb2, 0x26, 0x68, 0xba, 0x41, 0x94, 0x27, 0x24, 0x98, 0xd9, 0x14, 0xf5, 0x48, 0x8e, 0xd4, 0xb8,
+  0xbc, 0xb3, 0x00, 0x3a, 0x19, 0x25, 0x7d, 0x00, 0x52, 0x29, 0xaa, 0x59, 0x75, 0xb4, 0xa4, 0xe9,
+  0x09, 0x88, 0x18, 0x90, 0x9c, 0xdd, 0x87, 0x1d, 0xd9, 0xf1, 0xc6, 0xc7, 0x84, 0x85, 0x6e, 0xdd,
+  0x06, 0x14, 0xb8, 0xf6, 0x30, 0xbf, 0xb3, 0x32, 0xd8, 0xf3, 0x54, 0xdd, 0x1a, 0x0f, 0x05, 0x19,
+  0x7b, 0xb4, 0x1a, 0x3e, 0x82, 0xa0, 0xe8, 0x8a, 0xf6, 0xd1, 0x83, 0xf5, 0x07, 0x90, 0x5b, 0xef,
+  0x64, 0x6c, 0x2d, 0x39, 0x32, 0x32, 0xdb, 0x03, 0xa8, 0x6d, 0x76, 0x52, 0xdb, 0x7c, 0x01, 0xb5,
+  0xed, 0x4e, 0x6a, 0xdb, 0x2f, 0xa0, 0x66, 0x0d, 0x72, 0x15, 0x34, 0x61, 0xfd, 0x03, 0xac, 0x7f,
+  0x01, 0xe5, 0xf5, 0x2e, 0x5b, 0xac, 0x85, 0x11, 0x1e, 0xab, 0xc1, 0x1d, 0xb4, 0x36, 0x8f, 0xa7,
+  0xb5, 0xdd, 0x45, 0x6b, 0xfb, 0x78, 0x5a, 0x66, 0x2f, 0xbe, 0x47, 0x79, 0xbb, 0xe8, 0x8a, 0x1c,
+  0x27, 0x01, 0x69, 0x54, 0xb7, 0x1a, 0x7c, 0xf1, 0xea, 0x9a, 0x46, 0x10, 0xd0, 0xe9, 0x6a, 0x8e,
+  0x93, 0x5d, 0x40, 0x0e, 0xf9, 0x49, 0x06, 0x32, 0x92, 0x67, 0x1b, 0x48, 0xbc, 0xd1, 0x88, 0x55,
+  0xd7, 0x57, 0x48, 0xc3, 0x72, 0xfd, 0x54, 0xbc, 0xf0, 0xd8, 0xd3, 0xac, 0xe5, 0xaf, 0x45, 0x9c,
+  0x87, 0x48, 0xae, 0x5e, 0x64, 0xa8, 0xbc, 0xa3, 0x25, 0xff, 0xe1, 0xea, 0xf5, 0x59, 0x2a, 0xb9,
+  0x58, 0xbe, 0xdc, 0x84, 0x9e, 0x71, 0x0e, 0xf7, 0x57, 0xe4, 0x8c, 0xe4, 0x4b, 0x43, 0x79, 0xe2,
+  0x33, 0xae, 0x65, 0xaf, 0x42, 0x6a, 0x13, 0x71, 0x18, 0x88, 0x04, 0xf8, 0x22, 0x66, 0x21, 0xdd,
+  0x12, 0x7f, 0xd4, 0x16, 0x90, 0x13, 0xc7, 0x40, 0x1f, 0x14, 0xd0, 0xcd, 0x97, 0x29, 0x9a, 0x82,
+  0xe8, 0xa9, 0x12, 0x83, 0x0a, 0x54, 0x14, 0xf5, 0x2e, 0x02, 0xe1, 0x98, 0x20, 0x01, 0x0d, 0x0c,
+  0x2f, 0x23, 0x58, 0x60, 0x21, 0x64, 0x5d, 0x2a, 0x8e, 0xc3, 0xd3, 0x9d, 0x1e, 0x20, 0xb2, 0xd2,
+  0x90, 0x9c, 0x33, 0xab, 0x8c, 0x2d, 0x97, 0x8f, 0xe5, 0x14, 0xfa, 0xf9, 0x33, 0xea, 0x54, 0x58,
+  0x59, 0x4c, 0x06, 0x27, 0xe6, 0x69, 0xd5, 0x3d, 0x1b, 0x0a, 0xf8, 0xa6, 0x24, 0x5b, 0x50, 0xb1,
+  0x81, 0x8c, 0x90, 0x73, 0x26, 0x4e, 0x25, 0x25, 0xdd, 0x01, 0xca, 0x3e, 0x9c, 0x10, 0x4d, 0x98,
+  0xbd, 0x69, 0x96, 0x03, 0x65, 0x2f, 0x86, 0x79, 0x15, 0x48, 0xa6, 0xa3, 0x61, 0xe9, 0x80, 0xf9,
+  0xcb, 0x18, 0xd6, 0x0a, 0x72, 0xde, 0xb0, 0xd4, 0x14, 0xa2, 0x42, 0xc5, 0x3e, 0xd8, 0x60, 0x43,
+  0xb8, 0xa1, 0xf5, 0xbb, 0x4a, 0x07, 0xbf, 0x90, 0x47, 0x82, 0x28, 0x7d, 0xad, 0x28, 0xfc, 0x8d,
+  0x24, 0x65, 0x4b, 0x59, 0xef, 0x14, 0x8e, 0x82, 0xc0, 0x75, 0x5a, 0xd9, 0x21, 0x62, 0xd6, 0x82,
+  0x89, 0xb3, 0x4a, 0xfb, 0xa4, 0xf9, 0xfe, 0xd3, 0x47, 0xf3, 0x58, 0xf8, 0xcb, 0x4e, 0xca, 0x45,
+  0x95, 0xd5, 0xa3, 0xe5, 0xce, 0xe3, 0x72, 0x55, 0xa3, 0x8d, 0x23, 0x67, 0xfd, 0x66, 0xc0, 0x63,
+  0xe0, 0xd4, 0xe6, 0x49, 0xf2, 0x10, 0xc9, 0x02, 0x8d, 0xa8, 0x9e, 0x63, 0x25, 0x5d, 0x50, 0xe5,
+  0x2d, 0x94, 0xdf, 0x54, 0xbf, 0x6a, 0xb6, 0x7d, 0x62, 0x68, 0x07, 0xfb, 0xbe, 0xb4, 0xae, 0x10,
+  0x93, 0x80, 0x4d, 0x80, 0xa9, 0xb7, 0xaf, 0xf5, 0xd1, 0xba, 0x38, 0x1a, 0x27, 0xbe, 0x38, 0x9f,
+  0xd4, 0xcd, 0x81, 0xf5, 0xd6, 0xe7, 0x96, 0x86, 0x3e, 0xa4, 0x2e, 0xa3, 0x55, 0xc9, 0x3d, 0xd7,
+  0xea, 0x97, 0x74, 0x63, 0x65, 0xbb, 0x8a, 0x71, 0xca, 0x9f, 0x77, 0x1c, 0xf2, 0xc4, 0xdd, 0x3c,
+  0xd4, 0x38, 0x15, 0xef, 0xe5, 0x41, 0x60, 0x0b, 0xa6, 0x9f, 0x9f, 0xca, 0xcb, 0x59, 0x15, 0xae,
+  0x21, 0x50, 0xf5, 0x9b, 0xac, 0x51, 0x5b, 0x7f, 0x2b, 0x24, 0xbe, 0xdc, 0x11, 0x2f, 0xb6, 0x46,
+  0x3e, 0xbd, 0x49, 0xd3, 0x42, 0xf6, 0xb1, 0x4c, 0x6d, 0x22, 0xd1, 0x47, 0x8b, 0xee, 0xc4, 0xca,
+  0x1b, 0xa5, 0x97, 0xef, 0xc5, 0x97, 0xe3, 0xb5, 0x89, 0xce, 0x09, 0xd5, 0x1f, 0x21, 0x01, 0x3d,
+  0x45, 0xd8, 0xd8, 0x54, 0x7c, 0xf3, 0xa2, 0xf7, 0x2b, 0x70, 0x23, 0x3e, 0x24, 0x49, 0xe3, 0x2e,
+  0x83, 0x10, 0x5c, 0xf5, 0x26, 0xe7, 0x27, 0x47, 0x7f, 0x47, 0xaf, 0x4f, 0x2e, 0x8e, 0x8f, 0xce,
+  0xce, 0x4e, 0xd1, 0xcf, 0x47, 0x67, 0x3f, 0x9d, 0x00, 0xf5, 0x9e, 0x01, 0x14, 0xa5, 0x64, 0xec,
+  0x4f, 0x4a, 0xb4, 0x87, 0xd6, 0x10, 0xf5, 0x0b, 0x4b, 0xb5, 0x89, 0x7e, 0xd5, 0x01, 0xad, 0xdf,
+  0xa8, 0x1d, 0x65, 0x1c, 0xb5, 0x81, 0xa5, 0xc7, 0xb2, 0x77, 0xfc, 0xd3, 0xc5, 0xc5, 0xc9, 0x9b,
+  0xab, 0xc7, 0x72, 0x28, 0x3e, 0x56, 0xa9, 0x66, 0x10, 0x56, 0xee, 0xe7, 0xcf, 0xbc, 0x7c, 0xb0,
+  0x82, 0x8d, 0x8f, 0x55, 0x8a, 0x3a, 0x16, 0xfa, 0x7a, 0x09, 0xf5, 0x54, 0x96, 0xc5, 0x04, 0xb9,
+  0x30, 0x82, 0x8e, 0x92, 0x55, 0x34, 0xe9, 0x81, 0x8d, 0xe1, 0x5f, 0xbd, 0x28, 0xcf, 0xe4, 0x97,
+  0x01, 0xb2, 0xdc, 0xc5, 0x92, 0x65, 0xad, 0xb5, 0xdc, 0x6c, 0x36, 0xb5, 0x8f, 0x18, 0x52, 0x48,
+  0xf4, 0x5f, 0xf7, 0xa1, 0x6f, 0xee, 0x45, 0xff, 0x6d, 0x1f, 0xfa, 0xf6, 0x5e, 0xf4, 0xd7, 0x78,
+  0x1e, 0x52, 0xbe, 0xf2, 0xc9, 0x3e, 0x32, 0x66, 0xc7, 0xb7, 0x83, 0xd8, 0x7e, 0x87, 0xb1, 0x3f,
+  0x04, 0x2a, 0xba, 0x8d, 0x5a, 0xfc, 0xbf, 0x2a, 0x5d, 0x7a, 0xce, 0x17, 0xeb, 0xfc, 0x1e, 0xec,
+  0x7b, 0x54, 0x7e, 0x0f, 0xf6, 0xa3, 0x34, 0xbe, 0x9b, 0xd6, 0xfd, 0x11, 0x20, 0x35, 0x2f, 0x07,
+  0xee, 0x3c, 0x0e, 0x40, 0x8b, 0xb2, 0x5c, 0xc8, 0x63, 0x3b, 0xe4, 0xca, 0xb7, 0x93, 0xdd, 0x0e,
+  0x4a, 0x2c, 0x05, 0x8f, 0xf4, 0x39, 0x9d, 0x60, 0x44, 0xe3, 0x8f, 0xda, 0xea, 0x59, 0x95, 0x85,
+  0xcd, 0x8f, 0x0b, 0x6a, 0x76, 0xe6, 0x5c, 0xd7, 0x26, 0xbf, 0x68, 0xd6, 0x6d, 0x61, 0x37, 0xb5,
+  0xc9, 0xaf, 0x95, 0x0b, 0xdb, 0xda, 0xe4, 0x37, 0xbd, 0x90, 0x2b, 0x4d, 0x02, 0x64, 0xdc, 0xa8,
+  0x83, 0xa3, 0x2c, 0xe7, 0x42, 0xcb, 0x96, 0x03, 0x58, 0xd3, 0x6d, 0x6d, 0x62, 0x4d, 0xb6, 0x99,
+  0x0e, 0x2b, 0x15, 0xa7, 0x3f, 0x3b, 0x80, 0x36, 0x2f, 0xa0, 0xde, 0xf5, 0xb8, 0x66, 0x7e, 0xd5,
+  0x50, 0x9b, 0xa8, 0xb7, 0xd7, 0x32, 0x37, 0xfc, 0x2c, 0x7d, 0x78, 0xd4, 0x56, 0x08, 0x65, 0xb5,
+  0xe7, 0x5d, 0xb1, 0xa1, 0xf6, 0xfe, 0x44, 0x9d, 0x29, 0x9f, 0xb1, 0xf9, 0x1c, 0xb8, 0x01, 0x6d,
+  0xf7, 0x2d, 0x55, 0x4a, 0xe1, 0xf2, 0xfe, 0xb8, 0x56, 0xdd, 0xb2, 0xfe, 0xf7, 0x9f, 0xff, 0x42,
+  0x95, 0x6d, 0x6b, 0x29, 0xfa, 0xd4, 0x76, 0x89, 0xdc, 0x8f, 0xf8, 0x03, 0x43, 0x43, 0x46, 0x4b,
+  0x5a, 0x9b, 0x74, 0xca, 0x3a, 0x31, 0x18, 0xca, 0x7b, 0xb3, 0xda, 0xa4, 0xba, 0x1b, 0xb3, 0xf1,
+  0x30, 0x5a, 0xc4, 0x64, 0x36, 0xae, 0xb5, 0x15, 0x64, 0x0d, 0x41, 0xbd, 0x87, 0x7e, 0x6f, 0x5c,
+  0xfb, 0x30, 0x0d, 0x70, 0x78, 0x5d, 0xb3, 0x34, 0xa4, 0xbe, 0xf6, 0xa9, 0x4d, 0x7e, 0xa6, 0xe9,
+  0x11, 0x89, 0x60, 0x76, 0xd4, 0xc6, 0x7b, 0x7d, 0x5a, 0x7d, 0x46, 0x97, 0x2b, 0x36, 0x9a, 0xbc,
+  0x94, 0xa3, 0x0f, 0x3a, 0x3d, 0x37, 0x85, 0xcc, 0xe6, 0x21, 0x08, 0x9e, 0x8a, 0xd0, 0x89, 0x26,
+  0xae, 0x57, 0x47, 0xbd, 0x4e, 0xef, 0x00, 0xfd, 0xc8, 0x16, 0x21, 0xba, 0xf4, 0x16, 0x2c, 0xca,
+  0x00, 0xb2, 0xad, 0xf5, 0x05, 0x98, 0x5a, 0x76, 0x0d, 0x60, 0x34, 0xf9, 0xdd, 0xf1, 0xff, 0x00,
+  0x83, 0x90, 0x5e, 0xfa, 0x90, 0x2c, 0x00, 0x00,
+};
@@ -0,0 +1,152 @@
+// Adxl345Fifo against the simulated register file: how many entries a drain
+// returns, the watermark bit and how overruns are counted.
+//
+// Run: pio test -e native -f test_adxl345_fifo
+
+#include <unity.h>
+#include <adxl345_fifo.h>
+#include <adxl345_sim.h>
+
+// Numbers every sample so order and losses show up in the output
+static RawSample countingSensor(uint32_t index, void* context) {
+  (void)context;
+  RawSample sample = { (int16_t)index, (int16_t)-(int16_t)index, 256 };
+  return sample;
+}
+
+static Adxl345Sim* sim;
+static Adxl345Fifo* fifo;
+
+void setUp(void) {
+  sim = new Adxl345Sim();
+  sim->setGenerator(countingSensor, NULL);
+  fifo = new Adxl345Fifo(*sim);
+}
+
+void tearDown(void) {
+  delete fifo;
+  delete sim;
+}
+
+static void test_begin_configures_stream_mode(void) {
+  TEST_ASSERT_TRUE(fifo->begin(ADXL345_ODR_400_HZ, 20));
+  TEST_ASSERT_TRUE(fifo->isStreaming());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 400.0f, fifo->sampleRateHz());
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_MODE_STREAM | 20, sim->reg(ADXL345_REG_FIFO_CTL));
+  TEST_ASSERT_EQUAL_UINT8(0x08, sim->reg(ADXL345_REG_POWER_CTL));
+
+  // Out-of-range watermarks fall back to half the FIFO
+  TEST_ASSERT_TRUE(fifo->begin(ADXL345_ODR_400_HZ, 0));
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_MODE_STREAM | 16, sim->reg(ADXL345_REG_FIFO_CTL));
+  TEST_ASSERT_TRUE(fifo->begin(ADXL345_ODR_400_HZ, ADXL345_FIFO_DEPTH));
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_MODE_STREAM | 16, sim->reg(ADXL345_REG_FIFO_CTL));
+}
+
+static void test_drain_returns_every_queued_entry_in_order(void) {
+  fifo->begin(ADXL345_ODR_400_HZ, 16);
+  sim->advance(0.05f); // 20 samples at 400 Hz
+  TEST_ASSERT_EQUAL_UINT8(20, sim->fifoLevel());
+
+  RawSample out[ADXL345_FIFO_DEPTH];
+  uint32_t readsBefore = sim->readTransactions();
+  size_t count = fifo->drain(out, ADXL345_FIFO_DEPTH);
+  TEST_ASSERT_EQUAL(20, count);
+  for (size_t i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_INT16((int16_t)i, out[i].x);
+    TEST_ASSERT_EQUAL_INT16(-(int16_t)i, out[i].y);
+    TEST_ASSERT_EQUAL_INT16(256, out[i].z);
+  }
+  // INT_SOURCE and FIFO_STATUS, then one burst per entry
+  TEST_ASSERT_EQUAL_UINT32(2 + 20, sim->readTransactions() - readsBefore);
+  TEST_ASSERT_EQUAL_UINT8(0, sim->fifoLevel());
+  TEST_ASSERT_EQUAL_UINT32(20, fifo->sampleCount());
+  TEST_ASSERT_EQUAL_UINT8(20, fifo->maxFifoLevel());
+
+  // Nothing new, nothing read
+  TEST_ASSERT_EQUAL(0, fifo->drain(out, ADXL345_FIFO_DEPTH));
+}
+
+static void test_drain_stops_at_max_samples(void) {
+  fifo->begin(ADXL345_ODR_400_HZ, 16);
+  sim->produce(12);
+
+  RawSample out[ADXL345_FIFO_DEPTH];
+  TEST_ASSERT_EQUAL(5, fifo->drain(out, 5));
+  TEST_ASSERT_EQUAL_UINT8(7, sim->fifoLevel());
+  TEST_ASSERT_EQUAL(7, fifo->drain(out, ADXL345_FIFO_DEPTH));
+  TEST_ASSERT_EQUAL_INT16(5, out[0].x); // The rest follows on
+  TEST_ASSERT_EQUAL_UINT32(12, fifo->sampleCount());
+  TEST_ASSERT_EQUAL_UINT32(0, fifo->overrunCount());
+}
+
+static void test_watermark_bit_follows_the_level(void) {
+  fifo->begin(ADXL345_ODR_400_HZ, 10);
+  sim->produce(10);
+  uint8_t intSource = 0;
+  sim->readRegisters(ADXL345_REG_INT_SOURCE, &intSource, 1);
+  TEST_ASSERT_EQUAL_UINT8(0, intSource & ADXL345_INT_WATERMARK);
+
+  sim->produce(1);
+  sim->readRegisters(ADXL345_REG_INT_SOURCE, &intSource, 1);
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_INT_WATERMARK, intSource & ADXL345_INT_WATERMARK);
+
+  RawSample out[ADXL345_FIFO_DEPTH];
+  TEST_ASSERT_EQUAL(11, fifo->drain(out, ADXL345_FIFO_DEPTH));
+  sim->readRegisters(ADXL345_REG_INT_SOURCE, &intSource, 1);
+  TEST_ASSERT_EQUAL_UINT8(0, intSource & ADXL345_INT_WATERMARK);
+}
+
+static void test_overrun_keeps_the_newest_entries_and_is_counted_once(void) {
+  fifo->begin(ADXL345_ODR_400_HZ, 16);
+  sim->produce(ADXL345_FIFO_DEPTH + 8);
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_DEPTH, sim->fifoLevel());
+  TEST_ASSERT_EQUAL_UINT32(8, sim->droppedCount());
+
+  RawSample out[ADXL345_FIFO_DEPTH];
+  size_t count = fifo->drain(out, ADXL345_FIFO_DEPTH);
+  TEST_ASSERT_EQUAL(ADXL345_FIFO_DEPTH, count);
+  TEST_ASSERT_EQUAL_INT16(8, out[0].x);
+  TEST_ASSERT_EQUAL_INT16(ADXL345_FIFO_DEPTH + 7, out[count - 1].x);
+  TEST_ASSERT_EQUAL_UINT32(1, fifo->overrunCount());
+  TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_DEPTH, fifo->maxFifoLevel());
+
+  // Reading cleared the condition; a drain in time adds nothing
+  sim->produce(16);
+  TEST_ASSERT_EQUAL(16, fifo->drain(out, ADXL345_FIFO_DEPTH));
+  TEST_ASSERT_EQUAL_UINT32(1, fifo->overrunCount());
+
+  // A second overflow is a second overrun
+  sim->advance(0.1f); // 40 samples, 8 lost
+  TEST_ASSERT_EQUAL(ADXL345_FIFO_DEPTH, fifo->drain(out, ADXL345_FIFO_DEPTH));
+  TEST_ASSERT_EQUAL_UINT32(2, fifo->overrunCount());
+  TEST_ASSERT_EQUAL_UINT32(16, sim->droppedCount());
+
+  fifo->resetStats();
+  TEST_ASSERT_EQUAL_UINT32(0, fifo->overrunCount());
+  TEST_ASSERT_EQUAL_UINT32(0, fifo->sampleCount());
+}
+
+static void test_stopped_fifo_is_not_drained(void) {
+  fifo->begin(ADXL345_ODR_400_HZ, 16);
+  sim->produce(8);
+  TEST_ASSERT_TRUE(fifo->stop());
+  TEST_ASSERT_FALSE(fifo->isStreaming());
+  TEST_ASSERT_EQUAL_UINT8(0, sim->fifoLevel()); // Bypass flushes the FIFO
+
+  RawSample out[ADXL345_FIFO_DEPTH];
+  sim->produce(1);
+  TEST_ASSERT_EQUAL(0, fifo->drain(out, ADXL345_FIFO_DEPTH));
+  TEST_ASSERT_TRUE(fifo->readSample(out[0])); // The output registers still read
+  TEST_ASSERT_EQUAL_INT16(8, out[0].x);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_configures_stream_mode);
+  RUN_TEST(test_drain_returns_every_queued_entry_in_order);
+  RUN_TEST(test_drain_stops_at_max_samples);
+  RUN_TEST(test_watermark_bit_follows_the_level);
+  RUN_TEST(test_overrun_keeps_the_newest_entries_and_is_counted_once);
+  RUN_TEST(test_stopped_fifo_is_not_drained);
+  return UNITY_END();
+}
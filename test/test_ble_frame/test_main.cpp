@@ -0,0 +1,199 @@
+// BLE frame codec: encode/decode round trip, frames a client must refuse
+// (truncated, wrong version, more samples than it has room for) and how many
+// samples fit in one notification at a given MTU.
+//
+// Run: pio test -e native -f test_ble_frame
+
+#include <unity.h>
+#include <ble_frame.h>
+#include <string.h>
+
+static BleFrameHeader header;
+static RawSample samples[BLE_FRAME_MAX_SAMPLES];
+static uint8_t frame[BLE_FRAME_MAX_SIZE];
+
+void setUp() {
+  // Every field away from zero, the signed ones negative, so a field written
+  // to the wrong offset or with the wrong sign cannot pass
+  header.sequence = 0xBEEF;
+  header.time_ms = 0x89ABCDEF;
+  header.rate_dhz = 1000;
+  header.scale_um = 39227;
+  header.mercalli_now = 4;
+  header.mercalli_peak = 7;
+  header.flags = BLE_FRAME_TRIGGERED | BLE_FRAME_GAP;
+  header.sta_lta_x100 = 65535;
+  header.peak_x = -1234;
+  header.peak_y = 32767;
+  header.peak_z = -32768;
+  header.peak_magnitude = 40000;
+  for (int i = 0; i < BLE_FRAME_MAX_SAMPLES; i++) {
+    samples[i].x = (int16_t)(i * 257 - 32768);
+    samples[i].y = (int16_t)(-i * 131);
+    samples[i].z = (int16_t)(i * 127 + 1);
+  }
+  memset(frame, 0xA5, sizeof(frame));
+}
+
+void tearDown() {}
+
+static void assertHeadersEqual(const BleFrameHeader& expected, const BleFrameHeader& actual) {
+  TEST_ASSERT_EQUAL_UINT16(expected.sequence, actual.sequence);
+  TEST_ASSERT_EQUAL_UINT32(expected.time_ms, actual.time_ms);
+  TEST_ASSERT_EQUAL_UINT16(expected.rate_dhz, actual.rate_dhz);
+  TEST_ASSERT_EQUAL_UINT16(expected.scale_um, actual.scale_um);
+  TEST_ASSERT_EQUAL_UINT8(expected.mercalli_now, actual.mercalli_now);
+  TEST_ASSERT_EQUAL_UINT8(expected.mercalli_peak, actual.mercalli_peak);
+  TEST_ASSERT_EQUAL_UINT8(expected.flags, actual.flags);
+  TEST_ASSERT_EQUAL_UINT16(expected.sta_lta_x100, actual.sta_lta_x100);
+  TEST_ASSERT_EQUAL_INT16(expected.peak_x, actual.peak_x);
+  TEST_ASSERT_EQUAL_INT16(expected.peak_y, actual.peak_y);
+  TEST_ASSERT_EQUAL_INT16(expected.peak_z, actual.peak_z);
+  TEST_ASSERT_EQUAL_UINT16(expected.peak_magnitude, actual.peak_magnitude);
+}
+
+// At MTU 247, the usual negotiated size, one frame holds 36 samples
+static void test_round_trip() {
+  size_t maxBytes = 247 - 3;
+  size_t count = bleFrameCapacity(maxBytes);
+  TEST_ASSERT_EQUAL(36, count);
+
+  size_t length = encodeBleFrame(header, samples, count, frame, maxBytes);
+  TEST_ASSERT_EQUAL(BLE_FRAME_HEADER_SIZE + count * BLE_FRAME_SAMPLE_SIZE, length);
+  TEST_ASSERT_EQUAL_UINT8(BLE_FRAME_VERSION, frame[0]);
+  TEST_ASSERT_EQUAL_UINT8(count, frame[1]);
+  TEST_ASSERT_EQUAL_UINT8(0, frame[15]); // Reserved
+  TEST_ASSERT_EQUAL_UINT8(0xA5, frame[length]); // Nothing written past the frame
+
+  // Little-endian on the wire whatever the host is
+  TEST_ASSERT_EQUAL_UINT8(0xEF, frame[2]);
+  TEST_ASSERT_EQUAL_UINT8(0xBE, frame[3]);
+  TEST_ASSERT_EQUAL_UINT8(0xEF, frame[4]);
+  TEST_ASSERT_EQUAL_UINT8(0x89, frame[7]);
+
+  BleFrameHeader decoded;
+  RawSample out[BLE_FRAME_MAX_SAMPLES];
+  size_t decodedCount = 0;
+  TEST_ASSERT_TRUE(decodeBleFrame(frame, length, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+  TEST_ASSERT_EQUAL(count, decodedCount);
+  assertHeadersEqual(header, decoded);
+  for (size_t i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL_INT16(samples[i].x, out[i].x);
+    TEST_ASSERT_EQUAL_INT16(samples[i].y, out[i].y);
+    TEST_ASSERT_EQUAL_INT16(samples[i].z, out[i].z);
+  }
+}
+
+// The status-only frame sent when no samples are pending
+static void test_empty_frame() {
+  size_t length = encodeBleFrame(header, NULL, 0, frame, BLE_FRAME_HEADER_SIZE);
+  TEST_ASSERT_EQUAL(BLE_FRAME_HEADER_SIZE, length);
+  TEST_ASSERT_EQUAL_UINT8(0, frame[1]);
+
+  BleFrameHeader decoded;
+  RawSample out[1];
+  size_t decodedCount = 99;
+  TEST_ASSERT_TRUE(decodeBleFrame(frame, length, decoded, out, 0, decodedCount));
+  TEST_ASSERT_EQUAL(0, decodedCount);
+  assertHeadersEqual(header, decoded);
+}
+
+// A frame cut short anywhere is refused and reports no samples
+static void test_truncated_frames_are_refused() {
+  size_t length = encodeBleFrame(header, samples, 10, frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(BLE_FRAME_HEADER_SIZE + 10 * BLE_FRAME_SAMPLE_SIZE, length);
+
+  BleFrameHeader decoded;
+  RawSample out[BLE_FRAME_MAX_SAMPLES];
+  size_t decodedCount;
+  // Inside the header
+  for (size_t cut = 0; cut < BLE_FRAME_HEADER_SIZE; cut++) {
+    decodedCount = 99;
+    TEST_ASSERT_FALSE(decodeBleFrame(frame, cut, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+    TEST_ASSERT_EQUAL(0, decodedCount);
+  }
+  // Inside the samples, including a whole header with none of them
+  for (size_t cut = BLE_FRAME_HEADER_SIZE; cut < length; cut++) {
+    decodedCount = 99;
+    TEST_ASSERT_FALSE(decodeBleFrame(frame, cut, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+    TEST_ASSERT_EQUAL(0, decodedCount);
+  }
+  TEST_ASSERT_TRUE(decodeBleFrame(frame, length, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+  TEST_ASSERT_EQUAL(10, decodedCount);
+}
+
+static void test_unknown_version_is_refused() {
+  size_t length = encodeBleFrame(header, samples, 4, frame, sizeof(frame));
+  BleFrameHeader decoded;
+  RawSample out[BLE_FRAME_MAX_SAMPLES];
+  size_t decodedCount;
+
+  frame[0] = BLE_FRAME_VERSION + 1;
+  TEST_ASSERT_FALSE(decodeBleFrame(frame, length, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+  frame[0] = 0;
+  TEST_ASSERT_FALSE(decodeBleFrame(frame, length, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+  TEST_ASSERT_EQUAL(0, decodedCount);
+  frame[0] = BLE_FRAME_VERSION;
+  TEST_ASSERT_TRUE(decodeBleFrame(frame, length, decoded, out, BLE_FRAME_MAX_SAMPLES, decodedCount));
+}
+
+// More samples than the caller has room for is refused, not written past it
+static void test_too_many_samples_are_refused() {
+  size_t length = encodeBleFrame(header, samples, 8, frame, sizeof(frame));
+  BleFrameHeader decoded;
+  RawSample out[8];
+  size_t decodedCount;
+  TEST_ASSERT_FALSE(decodeBleFrame(frame, length, decoded, out, 7, decodedCount));
+  TEST_ASSERT_EQUAL(0, decodedCount);
+  TEST_ASSERT_TRUE(decodeBleFrame(frame, length, decoded, out, 8, decodedCount));
+  TEST_ASSERT_EQUAL(8, decodedCount);
+}
+
+// Samples per frame at a given payload size (MTU - 3): whole samples after
+// the header, clamped by the 512-byte attribute limit and the 8-bit count
+static void test_capacity_per_mtu() {
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(0));
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(BLE_FRAME_HEADER_SIZE - 1));
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(BLE_FRAME_HEADER_SIZE));
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(BLE_FRAME_HEADER_SIZE + BLE_FRAME_SAMPLE_SIZE - 1));
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(23 - 3)); // Default MTU: not even a header
+  TEST_ASSERT_EQUAL(0, bleFrameCapacity(29 - 3)); // Smallest usable MTU: status only
+  TEST_ASSERT_EQUAL(1, bleFrameCapacity(35 - 3));
+  TEST_ASSERT_EQUAL(36, bleFrameCapacity(247 - 3));
+  TEST_ASSERT_EQUAL(81, bleFrameCapacity(BLE_FRAME_MAX_SIZE));
+  TEST_ASSERT_EQUAL(81, bleFrameCapacity(517 - 3));
+  TEST_ASSERT_EQUAL(81, bleFrameCapacity(65535));
+
+  // Whatever the payload size, a full frame fits in it and in 512 bytes
+  for (size_t maxBytes = 0; maxBytes <= 600; maxBytes++) {
+    size_t capacity = bleFrameCapacity(maxBytes);
+    TEST_ASSERT_TRUE(capacity <= BLE_FRAME_MAX_SAMPLES);
+    if (maxBytes < BLE_FRAME_HEADER_SIZE) continue;
+    size_t length = encodeBleFrame(header, samples, capacity, frame, maxBytes);
+    TEST_ASSERT_EQUAL(BLE_FRAME_HEADER_SIZE + capacity * BLE_FRAME_SAMPLE_SIZE, length);
+    TEST_ASSERT_TRUE(length <= maxBytes);
+    TEST_ASSERT_TRUE(length <= BLE_FRAME_MAX_SIZE);
+    TEST_ASSERT_EQUAL(0, encodeBleFrame(header, samples, capacity + 1, frame, maxBytes));
+  }
+}
+
+// Too small a buffer or too many samples writes nothing
+static void test_encode_refuses_what_does_not_fit() {
+  TEST_ASSERT_EQUAL(0, encodeBleFrame(header, samples, 0, frame, BLE_FRAME_HEADER_SIZE - 1));
+  TEST_ASSERT_EQUAL_UINT8(0xA5, frame[0]);
+  TEST_ASSERT_EQUAL(0, encodeBleFrame(header, samples, BLE_FRAME_MAX_SAMPLES, frame, sizeof(frame)));
+  TEST_ASSERT_EQUAL(0, encodeBleFrame(header, samples, BLE_FRAME_MAX_SAMPLES + 1, frame, 65535));
+  TEST_ASSERT_EQUAL_UINT8(0xA5, frame[0]);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_empty_frame);
+  RUN_TEST(test_truncated_frames_are_refused);
+  RUN_TEST(test_unknown_version_is_refused);
+  RUN_TEST(test_too_many_samples_are_refused);
+  RUN_TEST(test_capacity_per_mtu);
+  RUN_TEST(test_encode_refuses_what_does_not_fit);
+  return UNITY_END();
+}
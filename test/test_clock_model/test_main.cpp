@@ -0,0 +1,186 @@
+// ClockModel against a simulated board: a counter whose crystal runs off by a
+// known number of ppm, and NTP replies with network jitter.
+//
+// Run: pio test -e native -f test_clock_model
+
+#include <unity.h>
+#include <clock_model.h>
+
+const int64_t EPOCH_US = 1760000000LL * 1000000;  // UTC when the board booted
+const int64_t SYNC_INTERVAL_US = 15LL * 60 * 1000000;
+
+// The board: esp_timer runs `ppm` slow against UTC and NTP replies arrive up
+// to `jitter_us` early or late (uniform, from a fixed seed)
+struct Board {
+  double ppm;
+  int64_t jitter_us;
+  uint32_t rng;
+
+  int64_t localAt(int64_t true_us) const { return (int64_t)(true_us * (1.0 - ppm * 1e-6)); }
+  int64_t utcAt(int64_t true_us) const { return EPOCH_US + true_us; }
+  int64_t jitter() {
+    if (jitter_us == 0) return 0;
+    rng = rng * 1664525u + 1013904223u;
+    return (int64_t)(rng >> 8) % (2 * jitter_us + 1) - jitter_us;
+  }
+  bool sync(ClockModel& model, int64_t true_us) {
+    return model.addSync(localAt(true_us), utcAt(true_us) + jitter());
+  }
+};
+
+static Board makeBoard(double ppm, int64_t jitter_us) {
+  Board board = { ppm, jitter_us, 12345 };
+  return board;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_invalid_until_the_first_sync(void) {
+  ClockModel model;
+  TEST_ASSERT_FALSE(model.valid());
+  TEST_ASSERT_EQUAL_INT64(1234, model.toUtc(1234));
+
+  Board board = makeBoard(0, 0);
+  TEST_ASSERT_TRUE(board.sync(model, 5000000));
+  TEST_ASSERT_TRUE(model.valid());
+  TEST_ASSERT_EQUAL_INT64(board.utcAt(6000000), model.toUtc(board.localAt(6000000)));
+  TEST_ASSERT_EQUAL_UINT32(1, model.syncCount());
+}
+
+static void test_drift_is_fitted_through_jitter(void) {
+  ClockModel model;
+  Board board = makeBoard(35, 5000); // 35 ppm slow, ±5 ms replies
+  int64_t t = 10000000;
+  for (int i = 0; i < 12; i++, t += SYNC_INTERVAL_US) {
+    TEST_ASSERT_TRUE(board.sync(model, t));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1.5f, 35.0f, model.driftPpm());
+  TEST_ASSERT_EQUAL_UINT32(12, model.syncCount());
+  TEST_ASSERT_EQUAL_UINT32(0, model.rejectedCount());
+
+  // Half an interval after the last sync (t is one interval past it) the
+  // model is within the jitter; the newest sync alone would be 16 ms out
+  int64_t later = t - SYNC_INTERVAL_US / 2;
+  int64_t error = model.toUtc(board.localAt(later)) - board.utcAt(later);
+  TEST_ASSERT_INT_WITHIN(5000, 0, error);
+  TEST_ASSERT_INT_WITHIN(5000, 0, model.lastResidualUs());
+}
+
+static void test_drift_waits_for_min_drift_span(void) {
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1800.0f, defaultClockModelConfig().min_drift_span_s);
+  ClockModel model;
+  Board board = makeBoard(35, 0);
+  // A sync a minute, as at boot: eight of them span only 7 minutes
+  int64_t t = 10000000;
+  for (int i = 0; i < 8; i++, t += 60000000) board.sync(model, t);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, model.driftPpm());
+
+  // Once the kept syncs span 30 minutes the drift is fitted
+  for (int i = 0; i < 8; i++, t += 5 * 60000000LL) board.sync(model, t);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 35.0f, model.driftPpm());
+}
+
+static void test_min_drift_span_is_configurable(void) {
+  ClockModelConfig config = defaultClockModelConfig();
+  config.min_drift_span_s = 60;
+  ClockModel model;
+  model.configure(config);
+  Board board = makeBoard(-20, 0);
+  board.sync(model, 0);
+  board.sync(model, 30000000);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, model.driftPpm());
+  board.sync(model, 60000000);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, -20.0f, model.driftPpm());
+}
+
+static void test_drift_is_clamped(void) {
+  ClockModelConfig config = defaultClockModelConfig();
+  config.max_drift_ppm = 10;
+  ClockModel model;
+  model.configure(config);
+  Board board = makeBoard(35, 0);
+  int64_t t = 0;
+  for (int i = 0; i < 6; i++, t += SYNC_INTERVAL_US) board.sync(model, t);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, model.driftPpm());
+}
+
+static void test_single_outlier_is_held_back(void) {
+  ClockModel model;
+  Board board = makeBoard(35, 2000);
+  int64_t t = 0;
+  for (int i = 0; i < 6; i++, t += SYNC_INTERVAL_US) board.sync(model, t);
+  float drift = model.driftPpm();
+  int64_t probe = board.localAt(t);
+  int64_t before = model.toUtc(probe);
+
+  // A reply 2 s off (a bad server) changes nothing
+  TEST_ASSERT_FALSE(model.addSync(board.localAt(t), board.utcAt(t) + 2000000));
+  TEST_ASSERT_EQUAL_UINT32(1, model.rejectedCount());
+  TEST_ASSERT_EQUAL_UINT32(6, model.syncCount());
+  TEST_ASSERT_EQUAL_INT64(before, model.toUtc(probe));
+  TEST_ASSERT_EQUAL_FLOAT(drift, model.driftPpm());
+  TEST_ASSERT_INT_WITHIN(10000, 2000000, model.lastResidualUs());
+
+  // The next good reply is accepted and clears the suspicion
+  t += SYNC_INTERVAL_US;
+  TEST_ASSERT_TRUE(board.sync(model, t));
+  TEST_ASSERT_EQUAL_UINT32(0, model.stepCount());
+
+  // A second lone outlier later is again only an outlier
+  t += SYNC_INTERVAL_US;
+  TEST_ASSERT_FALSE(model.addSync(board.localAt(t), board.utcAt(t) - 3000000));
+  t += SYNC_INTERVAL_US;
+  TEST_ASSERT_TRUE(board.sync(model, t));
+  TEST_ASSERT_EQUAL_UINT32(2, model.rejectedCount());
+  TEST_ASSERT_EQUAL_UINT32(0, model.stepCount());
+}
+
+static void test_two_agreeing_outliers_are_a_step(void) {
+  ClockModel model;
+  Board board = makeBoard(35, 2000);
+  int64_t t = 0;
+  for (int i = 0; i < 6; i++, t += SYNC_INTERVAL_US) board.sync(model, t);
+  float drift = model.driftPpm();
+
+  // UTC jumps 10 s (NTP corrected a bad server); the first reply is held
+  // back, the second agrees with it and the model starts over from both
+  const int64_t STEP_US = 10000000;
+  TEST_ASSERT_FALSE(model.addSync(board.localAt(t), board.utcAt(t) + STEP_US + board.jitter()));
+  t += SYNC_INTERVAL_US;
+  TEST_ASSERT_TRUE(model.addSync(board.localAt(t), board.utcAt(t) + STEP_US + board.jitter()));
+  TEST_ASSERT_EQUAL_UINT32(1, model.stepCount());
+  TEST_ASSERT_EQUAL_UINT32(1, model.rejectedCount());
+  TEST_ASSERT_EQUAL_UINT32(8, model.syncCount());
+
+  // The new offset is in use, and the drift carried over (the two syncs
+  // span less than min_drift_span_s)
+  int64_t later = t + 60000000;
+  int64_t error = model.toUtc(board.localAt(later)) - (board.utcAt(later) + STEP_US);
+  TEST_ASSERT_INT_WITHIN(5000, 0, error);
+  TEST_ASSERT_EQUAL_FLOAT(drift, model.driftPpm());
+}
+
+static void test_reset_forgets_everything(void) {
+  ClockModel model;
+  Board board = makeBoard(35, 0);
+  board.sync(model, 0);
+  board.sync(model, SYNC_INTERVAL_US);
+  model.reset();
+  TEST_ASSERT_FALSE(model.valid());
+  TEST_ASSERT_EQUAL_UINT32(0, model.syncCount());
+  TEST_ASSERT_EQUAL_INT64(42, model.toUtc(42));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_invalid_until_the_first_sync);
+  RUN_TEST(test_drift_is_fitted_through_jitter);
+  RUN_TEST(test_drift_waits_for_min_drift_span);
+  RUN_TEST(test_min_drift_span_is_configurable);
+  RUN_TEST(test_drift_is_clamped);
+  RUN_TEST(test_single_outlier_is_held_back);
+  RUN_TEST(test_two_agreeing_outliers_are_a_step);
+  RUN_TEST(test_reset_forgets_everything);
+  return UNITY_END();
+}
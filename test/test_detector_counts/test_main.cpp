@@ -0,0 +1,242 @@
+// Detector in integer counts against a reference detector that runs the same
+// stages in float m/s², as the sample path did before it moved to counts:
+// same events, same intensities, and peaks that agree once converted.
+//
+// Run: pio test -e native -f test_detector_counts
+
+#include <unity.h>
+#include <detector.h>
+#include <adxl345_fifo.h>
+#include <math.h>
+
+const float RATE = 400.0f;
+const float SCALE = ADXL345_MS2_PER_LSB;
+
+// Threshold-mode detection in m/s²: band-pass, per-axis STA/LTA on the
+// squared deviation, fixed noise gate, square-root magnitude and the
+// MERCALLI_n_THRESHOLD steps
+class ReferenceDetector {
+  public:
+    void configure(const DetectorConfig& config) {
+      cfg = config;
+      designFilterBand(cfg.filter, cfg.sample_rate, filter);
+      warmupSamples = (int)(cfg.warmup_seconds * cfg.sample_rate);
+      for (int i = 0; i < 3; i++) triggers[i].configure(cfg.trigger, cfg.sample_rate);
+      sampleCount = 0;
+      sum[0] = sum[1] = sum[2] = 0;
+      peak[0] = peak[1] = peak[2] = peakMagnitude = 0;
+      inEvent = eventLogged = hasLogged = false;
+      lastEventTime = 0;
+    }
+
+    // Returns the intensity of the sample, 0 during warm-up
+    int update(float x, float y, float z, uint32_t now_ms, bool& shouldLog, float& magnitude) {
+      shouldLog = false;
+      magnitude = 0;
+      gated[0] = gated[1] = gated[2] = 0;
+      if (sampleCount < warmupSamples) {
+        sum[0] += x;
+        sum[1] += y;
+        sum[2] += z;
+        if (++sampleCount == warmupSamples) {
+          filter.prime(sum[0] / sampleCount, sum[1] / sampleCount, sum[2] / sampleCount);
+        }
+        return 0;
+      }
+      filter.process(x, y, z);
+      float deviation[3] = { fabsf(x), fabsf(y), fabsf(z) };
+      bool triggered = false;
+      for (int i = 0; i < 3; i++) {
+        triggers[i].update(deviation[i] * deviation[i]);
+        if (triggers[i].triggered()) triggered = true;
+      }
+      float sq = 0;
+      for (int i = 0; i < 3; i++) {
+        if (deviation[i] < cfg.noise_threshold) deviation[i] = 0;
+        if (deviation[i] > peak[i]) peak[i] = deviation[i];
+        gated[i] = deviation[i];
+        sq += deviation[i] * deviation[i];
+      }
+      magnitude = sqrtf(sq);
+      if (magnitude > peakMagnitude) peakMagnitude = magnitude;
+      int mercalli = calculateMercalli(magnitude);
+
+      if (!triggered) {
+        inEvent = false;
+        return mercalli;
+      }
+      if (!inEvent) {
+        inEvent = true;
+        eventLogged = false;
+      }
+      bool intervalPassed = !hasLogged || now_ms - lastEventTime >= cfg.min_event_interval_ms;
+      if (!eventLogged && intervalPassed && mercalli >= cfg.min_log_mercalli) {
+        shouldLog = eventLogged = hasLogged = true;
+        lastEventTime = now_ms;
+      }
+      return mercalli;
+    }
+
+    const StaLtaTrigger& trigger(int axis) const { return triggers[axis]; }
+
+    float gated[3]; // Deviations of the last sample after the gate
+    float peak[3];
+    float peakMagnitude;
+
+  private:
+    DetectorConfig cfg;
+    SosFilter3 filter;
+    StaLtaTrigger triggers[3];
+    int warmupSamples;
+    int sampleCount;
+    float sum[3];
+    bool inEvent, eventLogged, hasLogged;
+    uint32_t lastEventTime;
+};
+
+// Quiet sensor at 1 g with a damped 3 Hz burst every minute at increasing
+// amplitudes (m/s²), in whole counts as the FIFO delivers them
+struct Trace {
+  uint32_t rng;
+
+  float noise() {
+    float sum = 0;
+    for (int i = 0; i < 4; i++) {
+      rng = rng * 1664525u + 1013904223u;
+      sum += (rng >> 16) / 65535.0f - 0.5f;
+    }
+    return sum * 0.0173f; // Sigma about 0.01 m/s²
+  }
+
+  void sample(uint32_t n, int32_t counts[3]) {
+    static const float amplitudes[] = { 0.3f, 0.8f, 1.5f, 3.0f, 6.0f, 12.0f };
+    float t = n / RATE;
+    int minute = (int)(t / 60.0f);
+    float since = t - minute * 60.0f - 30.0f;
+    float burst = 0;
+    if (minute > 0 && since >= 0 && since < 20.0f) {
+      burst = amplitudes[(minute - 1) % 6] * expf(-since / 4.0f) * sinf(2.0f * (float)M_PI * 3.0f * since);
+    }
+    counts[0] = (int32_t)lroundf((noise() + burst) / SCALE);
+    counts[1] = (int32_t)lroundf((noise() + 0.6f * burst) / SCALE);
+    counts[2] = (int32_t)lroundf((9.80665f + noise() + 0.3f * burst) / SCALE);
+  }
+};
+
+// Difference allowed between the two paths (m/s²). Both filter in float, and
+// the rounding in the high-pass state grows with the signal: about 0.05% of
+// the largest motion so far, so 0.1% of it (and never less than 0.001).
+static float tolerance(float largest) {
+  return largest > 1.0f ? 0.001f * largest : 0.001f;
+}
+
+// True when m/s² lies within `tol` of an intensity step, where the two paths
+// may land on either side of it
+static bool nearStep(float magnitude, float tol) {
+  for (int i = 0; i < 11; i++) {
+    if (fabsf(magnitude - MERCALLI_THRESHOLDS[i]) < tol) return true;
+  }
+  return false;
+}
+
+static DetectorConfig makeConfig() {
+  DetectorConfig config = defaultDetectorConfig(RATE);
+  config.noise_floor.enabled = false; // The reference has the fixed gate only
+  config.intensity_mode = INTENSITY_THRESHOLDS;
+  return config;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_thresholds_convert_to_counts(void) {
+  MercalliScale scale;
+  mercalliScale(SCALE, scale);
+  // Just under and just over each step, by a hundredth of a count
+  for (int i = 0; i < 11; i++) {
+    float counts = MERCALLI_THRESHOLDS[i] / SCALE;
+    float below = counts - 0.01f, above = counts + 0.01f;
+    TEST_ASSERT_EQUAL_INT(i + 1, calculateMercalliSquared(below * below, scale));
+    TEST_ASSERT_EQUAL_INT(i + 2, calculateMercalliSquared(above * above, scale));
+    TEST_ASSERT_EQUAL_INT(calculateMercalli(below * SCALE), calculateMercalliSquared(below * below, scale));
+  }
+
+  Detector detector;
+  detector.configure(makeConfig());
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, detector.noiseThreshold());
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.5f, detector.magnitudeMs2(1.5f * 1.5f / (SCALE * SCALE)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, detector.toMs2(0.25f / SCALE));
+}
+
+// Thirty minutes at 400 Hz with bursts from intensity III to IX
+static void test_same_events_as_the_float_path(void) {
+  DetectorConfig config = makeConfig();
+  Detector detector;
+  detector.configure(config);
+  ReferenceDetector reference;
+  reference.configure(config);
+
+  Trace trace = { 0x9E3779B9u };
+  const uint32_t samples = (uint32_t)(30 * 60 * RATE);
+  uint32_t events = 0, referenceEvents = 0, matched = 0;
+  uint32_t deviationMismatches = 0, intensityMismatches = 0, boundarySamples = 0;
+  for (uint32_t n = 0; n < samples; n++) {
+    int32_t counts[3];
+    trace.sample(n, counts);
+    uint32_t now_ms = (uint32_t)(n * 1000.0f / RATE);
+
+    DetectorOutput out;
+    detector.update(counts[0], counts[1], counts[2], now_ms, out);
+    bool referenceLog;
+    float magnitude;
+    int mercalli = reference.update(counts[0] * SCALE, counts[1] * SCALE, counts[2] * SCALE,
+                                    now_ms, referenceLog, magnitude);
+    TEST_ASSERT_EQUAL(mercalli != 0, out.baseline_ready);
+    if (!out.baseline_ready) continue;
+
+    // Each axis agrees, or sits at the gate and was cut in one path only
+    float tol = tolerance(reference.peakMagnitude);
+    float deviation[3] = { detector.toMs2(out.x_dev), detector.toMs2(out.y_dev), detector.toMs2(out.z_dev) };
+    bool atGate = false;
+    for (int i = 0; i < 3; i++) {
+      if ((deviation[i] == 0) != (reference.gated[i] == 0)) {
+        atGate = true;
+        if (deviation[i] + reference.gated[i] >= config.noise_threshold + tol) deviationMismatches++;
+      } else if (fabsf(deviation[i] - reference.gated[i]) > tol) {
+        deviationMismatches++;
+      }
+    }
+    if (out.mercalli != mercalli) {
+      if (atGate || nearStep(magnitude, tol)) boundarySamples++;
+      else intensityMismatches++;
+    }
+    if (out.should_log) events++;
+    if (referenceLog) referenceEvents++;
+    if (out.should_log && referenceLog && out.mercalli == mercalli) matched++;
+  }
+
+  TEST_ASSERT_GREATER_THAN_UINT32(20, events);
+  TEST_ASSERT_EQUAL_UINT32(referenceEvents, events);
+  TEST_ASSERT_EQUAL_UINT32(events, matched); // Same samples, same intensities
+  TEST_ASSERT_EQUAL_UINT32(0, deviationMismatches);
+  TEST_ASSERT_EQUAL_UINT32(0, intensityMismatches);
+  TEST_ASSERT_LESS_THAN_UINT32(samples / 1000, boundarySamples);
+
+  for (int i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_UINT32(reference.trigger(i).triggerCount(), detector.trigger(i).triggerCount());
+  }
+  const DetectorPeaks& peaks = detector.peaks();
+  float tol = tolerance(reference.peakMagnitude);
+  TEST_ASSERT_FLOAT_WITHIN(tol, reference.peak[0], detector.toMs2(peaks.x));
+  TEST_ASSERT_FLOAT_WITHIN(tol, reference.peak[1], detector.toMs2(peaks.y));
+  TEST_ASSERT_FLOAT_WITHIN(tol, reference.peak[2], detector.toMs2(peaks.z));
+  TEST_ASSERT_FLOAT_WITHIN(tol, reference.peakMagnitude, detector.magnitudeMs2(peaks.dev_mag_sq));
+  TEST_ASSERT_EQUAL_INT(calculateMercalli(reference.peakMagnitude), peaks.mercalli);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_thresholds_convert_to_counts);
+  RUN_TEST(test_same_events_as_the_float_path);
+  return UNITY_END();
+}
@@ -0,0 +1,503 @@
+// EventStore over segments kept in memory: recovery after a power cut that
+// truncated or corrupted the newest record, segment rotation and reading back.
+// The same cases then run on FileLogStorage in a temporary directory, with the
+// torn write made by cutting or damaging the newest segment file.
+//
+// Run: pio test -e native -f test_event_store
+
+#include <unity.h>
+#include <crc32.h>
+#include <event_store.h>
+#include <file_log_storage.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+
+// Segment files in memory, standing in for LittleFS. failAfter makes the next
+// append write only that many bytes and fail, like a power cut mid-write.
+class MemoryLogStorage : public LogStorage {
+  public:
+    MemoryLogStorage() : failAfter(-1) {}
+
+    size_t listSegments(uint32_t* ids, size_t maxIds) {
+      size_t count = 0;
+      for (std::map<uint32_t, std::vector<uint8_t> >::const_iterator i = segments.begin();
+           i != segments.end() && count < maxIds; ++i) {
+        ids[count++] = i->first;
+      }
+      return count;
+    }
+    int32_t segmentSize(uint32_t id) {
+      std::map<uint32_t, std::vector<uint8_t> >::const_iterator i = segments.find(id);
+      return i == segments.end() ? -1 : (int32_t)i->second.size();
+    }
+    bool append(uint32_t id, const uint8_t* data, size_t length) {
+      std::vector<uint8_t>& segment = segments[id];
+      if (failAfter >= 0) {
+        segment.insert(segment.end(), data, data + failAfter);
+        failAfter = -1;
+        return false;
+      }
+      segment.insert(segment.end(), data, data + length);
+      return true;
+    }
+    bool read(uint32_t id, uint32_t offset, uint8_t* data, size_t length) {
+      std::map<uint32_t, std::vector<uint8_t> >::const_iterator i = segments.find(id);
+      if (i == segments.end() || offset + length > i->second.size()) return false;
+      memcpy(data, i->second.data() + offset, length);
+      return true;
+    }
+    bool remove(uint32_t id) {
+      return segments.erase(id) == 1;
+    }
+
+    std::vector<uint8_t>& newest() { return segments.rbegin()->second; }
+
+    std::map<uint32_t, std::vector<uint8_t> > segments;
+    int failAfter;
+};
+
+const uint32_t PER_SEGMENT = 4;
+const uint32_t SEGMENTS = 3;
+
+static StoredEvent makeEvent(uint32_t n) {
+  StoredEvent event;
+  memset(&event, 0, sizeof(event));
+  event.timestamp = 1760000000 + n;
+  event.timestamp_ms = (uint16_t)(n * 7 % 1000);
+  event.mercalli = 3 + n % 5;
+  event.x_peak = 0.01f * n;
+  event.y_peak = 0.02f * n;
+  event.z_peak = 0.03f * n;
+  event.magnitude = 0.05f * n;
+  event.dominant_hz = 1.25f;
+  event.jma_intensity = 0.5f * n;
+  event.pga = 0.04f * n;
+  event.pgv = 0.002f * n;
+  event.pgd = 0.0001f * n;
+  event.mmi = n % 2 ? NAN : 2.0f + 0.1f * n; // NaN when it was unknown
+  event.boot = 1 + n / 4;
+  event.onset_us = n * 1234567891LL; // Past 32 bits from n = 4
+  if (n % 3 == 0) { // Detected before the clock was set
+    event.timestamp = 0;
+    event.timestamp_ms = 0;
+    event.flags = EVENT_UNSYNCED;
+  }
+  return event;
+}
+
+// A record as firmware before the ground-motion fields wrote it (SEV2)
+static void encodeV2Record(uint32_t sequence, uint32_t timestamp, float mercalli, uint8_t* out) {
+  memset(out, 0, EVENT_RECORD_SIZE_V2);
+  uint32_t magic = EVENT_RECORD_MAGIC_V2;
+  memcpy(out, &magic, 4); // The host is little-endian, like the board
+  memcpy(out + 4, &sequence, 4);
+  memcpy(out + 8, &timestamp, 4);
+  memcpy(out + 12, &mercalli, 4);
+  uint16_t centiHz = 250, ms = 125;
+  memcpy(out + 32, &centiHz, 2);
+  memcpy(out + 34, &ms, 2);
+  uint32_t crc = crc32(out, EVENT_RECORD_SIZE_V2 - 4);
+  memcpy(out + EVENT_RECORD_SIZE_V2 - 4, &crc, 4);
+}
+
+// Appends events 1..count and returns the store's next sequence
+static uint32_t fill(LogStorage& storage, uint32_t count) {
+  EventStore store(storage);
+  store.begin(PER_SEGMENT, SEGMENTS);
+  for (uint32_t n = 1; n <= count; n++) {
+    StoredEvent event = makeEvent(n);
+    store.append(event);
+  }
+  return store.nextSequence();
+}
+
+// Directory of the file-backed cases, created before each test and removed after
+static char directory[32];
+
+// Path of segment `id` in it, as FileLogStorage names them
+static void segmentFile(uint32_t id, char* path, size_t size) {
+  snprintf(path, size, "%s/%08lx.log", directory, (unsigned long)id);
+}
+
+static long fileSize(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return -1;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+// Files in the directory, segments or not
+static int fileCount() {
+  DIR* dir = opendir(directory);
+  if (!dir) return -1;
+  int count = 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (entry->d_name[0] != '.') count++;
+  }
+  closedir(dir);
+  return count;
+}
+
+void setUp(void) {
+  strcpy(directory, "/tmp/event_store_XXXXXX");
+  TEST_ASSERT_NOT_NULL(mkdtemp(directory));
+}
+
+void tearDown(void) {
+  DIR* dir = opendir(directory);
+  if (!dir) return;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (entry->d_name[0] == '.') continue;
+    char path[300];
+    snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+    unlink(path);
+  }
+  closedir(dir);
+  rmdir(directory);
+}
+
+static void test_events_survive_a_restart(void) {
+  MemoryLogStorage storage;
+  TEST_ASSERT_EQUAL_UINT32(7, fill(storage, 6));
+
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(6, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(2, store.segmentCount());
+  TEST_ASSERT_EQUAL_UINT32(7, store.nextSequence());
+  TEST_ASSERT_EQUAL_UINT32(0, store.tornRecords());
+
+  StoredEvent latest[10];
+  TEST_ASSERT_EQUAL(6, store.readLatest(latest, 10));
+  for (uint32_t i = 0; i < 6; i++) {
+    StoredEvent expected = makeEvent(6 - i);
+    TEST_ASSERT_EQUAL_UINT32(6 - i, latest[i].sequence);
+    TEST_ASSERT_EQUAL_UINT32(expected.timestamp, latest[i].timestamp);
+    TEST_ASSERT_EQUAL_UINT16(expected.timestamp_ms, latest[i].timestamp_ms);
+    TEST_ASSERT_EQUAL_FLOAT(expected.mercalli, latest[i].mercalli);
+    TEST_ASSERT_EQUAL_FLOAT(expected.magnitude, latest[i].magnitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.25f, latest[i].dominant_hz);
+    TEST_ASSERT_EQUAL_FLOAT(expected.jma_intensity, latest[i].jma_intensity);
+    TEST_ASSERT_EQUAL_FLOAT(expected.pga, latest[i].pga);
+    TEST_ASSERT_EQUAL_FLOAT(expected.pgv, latest[i].pgv);
+    TEST_ASSERT_EQUAL_FLOAT(expected.pgd, latest[i].pgd);
+    TEST_ASSERT_EQUAL(isnan(expected.mmi), isnan(latest[i].mmi));
+    if (!isnan(expected.mmi)) TEST_ASSERT_EQUAL_FLOAT(expected.mmi, latest[i].mmi);
+    TEST_ASSERT_EQUAL_UINT32(expected.boot, latest[i].boot);
+    TEST_ASSERT_EQUAL_UINT32(expected.flags, latest[i].flags);
+    TEST_ASSERT_TRUE(expected.onset_us == latest[i].onset_us);
+  }
+  TEST_ASSERT_EQUAL(2, store.readLatest(latest, 2));
+  TEST_ASSERT_EQUAL_UINT32(6, latest[0].sequence);
+}
+
+static void test_truncated_last_record_is_dropped(void) {
+  MemoryLogStorage storage;
+  fill(storage, 6);
+  // Power cut while writing event 6: only part of its record reached flash
+  std::vector<uint8_t>& head = storage.newest();
+  head.resize(head.size() - 15);
+
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(0, store.tornRecords()); // A partial record is not counted
+  TEST_ASSERT_EQUAL_UINT32(5, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(6, store.nextSequence()); // Event 6 was never complete
+
+  StoredEvent latest[10];
+  TEST_ASSERT_EQUAL(5, store.readLatest(latest, 10));
+  TEST_ASSERT_EQUAL_UINT32(5, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(makeEvent(5).timestamp, latest[0].timestamp);
+
+  // The next event goes into a fresh segment, not behind the partial bytes
+  StoredEvent event = makeEvent(60);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(3, store.segmentCount());
+  TEST_ASSERT_EQUAL(EVENT_RECORD_SIZE, storage.newest().size());
+  TEST_ASSERT_EQUAL(6, store.readLatest(latest, 10));
+  TEST_ASSERT_EQUAL_UINT32(6, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(makeEvent(60).timestamp, latest[0].timestamp);
+  TEST_ASSERT_EQUAL_UINT32(5, latest[1].sequence);
+}
+
+static void test_corrupted_last_record_is_torn(void) {
+  MemoryLogStorage storage;
+  fill(storage, 6);
+  // Whole record on flash but with garbage in it
+  std::vector<uint8_t>& head = storage.newest();
+  head[head.size() - EVENT_RECORD_SIZE + 13] ^= 0x40;
+
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(1, store.tornRecords());
+  TEST_ASSERT_EQUAL_UINT32(6, store.recordCount()); // Still on storage
+  TEST_ASSERT_EQUAL_UINT32(6, store.nextSequence());
+
+  StoredEvent latest[10];
+  TEST_ASSERT_EQUAL(5, store.readLatest(latest, 10));
+  TEST_ASSERT_EQUAL_UINT32(5, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(1, latest[4].sequence);
+
+  // Appends continue in a new segment; walking the store skips the bad record
+  StoredEvent event = makeEvent(7);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(3, store.segmentCount());
+  EventCursor cursor = {0, 0};
+  StoredEvent all[16];
+  size_t count = 0, n;
+  while ((n = store.readNext(cursor, all + count, 2)) > 0) count += n;
+  TEST_ASSERT_EQUAL(6, count);
+  for (uint32_t i = 0; i < 6; i++) TEST_ASSERT_EQUAL_UINT32(i + 1, all[i].sequence);
+}
+
+static void test_torn_records_are_counted_back_to_the_last_good_one(void) {
+  MemoryLogStorage storage;
+  fill(storage, 7); // Segments of 4 and 3
+  std::vector<uint8_t>& head = storage.newest();
+  memset(head.data() + EVENT_RECORD_SIZE, 0xFF, 2 * EVENT_RECORD_SIZE); // Erased flash
+
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(2, store.tornRecords());
+  TEST_ASSERT_EQUAL_UINT32(6, store.nextSequence());
+  StoredEvent latest[3];
+  TEST_ASSERT_EQUAL(3, store.readLatest(latest, 3));
+  TEST_ASSERT_EQUAL_UINT32(5, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(4, latest[1].sequence);
+}
+
+static void test_failed_append_seals_the_segment(void) {
+  MemoryLogStorage storage;
+  EventStore store(storage);
+  store.begin(PER_SEGMENT, SEGMENTS);
+  StoredEvent event = makeEvent(1);
+  TEST_ASSERT_TRUE(store.append(event));
+  storage.failAfter = 10;
+  event = makeEvent(2);
+  TEST_ASSERT_FALSE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(1, store.errorCount());
+
+  event = makeEvent(3);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(2, store.segmentCount());
+  TEST_ASSERT_EQUAL_UINT32(2, event.sequence); // The failed one used no number
+  StoredEvent latest[4];
+  TEST_ASSERT_EQUAL(2, store.readLatest(latest, 4));
+}
+
+static void test_oldest_segment_is_dropped_whole(void) {
+  MemoryLogStorage storage;
+  fill(storage, 13); // Would need four segments of 4
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(SEGMENTS, store.segmentCount());
+  TEST_ASSERT_EQUAL_UINT32(9, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(14, store.nextSequence());
+
+  StoredEvent latest[16];
+  TEST_ASSERT_EQUAL(9, store.readLatest(latest, 16));
+  TEST_ASSERT_EQUAL_UINT32(13, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(5, latest[8].sequence);
+
+  TEST_ASSERT_TRUE(store.clear());
+  TEST_ASSERT_EQUAL_UINT32(0, store.recordCount());
+  TEST_ASSERT_EQUAL(0, store.readLatest(latest, 16));
+  TEST_ASSERT_TRUE(storage.segments.empty());
+}
+
+// Segments written before an update keep their record size; the new records
+// go into a segment of their own
+static void test_older_records_are_still_read(void) {
+  MemoryLogStorage storage;
+  uint8_t record[EVENT_RECORD_SIZE_V2];
+  for (uint32_t n = 1; n <= 3; n++) {
+    encodeV2Record(n, 1750000000 + n, 4, record);
+    storage.append(1, record, sizeof(record));
+  }
+
+  EventStore store(storage);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(3, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(4, store.nextSequence());
+  TEST_ASSERT_EQUAL_UINT32(0, store.tornRecords());
+  StoredEvent event = makeEvent(4);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(2, store.segmentCount());
+  TEST_ASSERT_EQUAL(EVENT_RECORD_SIZE, storage.newest().size());
+
+  EventStore reopened(storage);
+  TEST_ASSERT_TRUE(reopened.begin(PER_SEGMENT, SEGMENTS));
+  EventCursor cursor = {0, 0};
+  StoredEvent all[8];
+  TEST_ASSERT_EQUAL(3, reopened.readNext(cursor, all, 8));
+  TEST_ASSERT_EQUAL(1, reopened.readNext(cursor, all + 3, 8));
+  for (uint32_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_UINT32(i + 1, all[i].sequence);
+    TEST_ASSERT_EQUAL_UINT32(1750000001 + i, all[i].timestamp);
+    TEST_ASSERT_EQUAL_UINT16(125, all[i].timestamp_ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.5f, all[i].dominant_hz);
+    TEST_ASSERT_TRUE(isnan(all[i].jma_intensity));
+    TEST_ASSERT_TRUE(isnan(all[i].pga));
+    TEST_ASSERT_TRUE(isnan(all[i].mmi));
+    TEST_ASSERT_EQUAL_UINT32(0, all[i].boot);
+    TEST_ASSERT_EQUAL_UINT32(0, all[i].flags);
+  }
+  TEST_ASSERT_EQUAL_UINT32(4, all[3].sequence);
+  TEST_ASSERT_EQUAL_FLOAT(makeEvent(4).pga, all[3].pga);
+  StoredEvent latest[8];
+  TEST_ASSERT_EQUAL(4, reopened.readLatest(latest, 8));
+  TEST_ASSERT_EQUAL_UINT32(1, latest[3].sequence);
+}
+
+static void test_file_segments_survive_a_restart(void) {
+  FileLogStorage storage(directory);
+  TEST_ASSERT_TRUE(storage.begin());
+  TEST_ASSERT_EQUAL_UINT32(7, fill(storage, 6));
+
+  // Anything else in the directory is not a segment
+  char path[300];
+  snprintf(path, sizeof(path), "%s/notes.txt", directory);
+  FILE* other = fopen(path, "wb");
+  fputs("not a segment", other);
+  fclose(other);
+
+  FileLogStorage reopened(directory);
+  TEST_ASSERT_TRUE(reopened.begin());
+  uint32_t ids[8];
+  TEST_ASSERT_EQUAL(2, reopened.listSegments(ids, 8));
+  TEST_ASSERT_EQUAL_INT32(4 * EVENT_RECORD_SIZE, reopened.segmentSize(1));
+  TEST_ASSERT_EQUAL_INT32(2 * EVENT_RECORD_SIZE, reopened.segmentSize(2));
+  TEST_ASSERT_EQUAL_INT32(-1, reopened.segmentSize(3));
+
+  EventStore store(reopened);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(6, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(7, store.nextSequence());
+  StoredEvent latest[10];
+  TEST_ASSERT_EQUAL(6, store.readLatest(latest, 10));
+  for (uint32_t i = 0; i < 6; i++) {
+    TEST_ASSERT_EQUAL_UINT32(6 - i, latest[i].sequence);
+    TEST_ASSERT_EQUAL_UINT32(makeEvent(6 - i).timestamp, latest[i].timestamp);
+  }
+
+  // Appends after the restart continue the newest file
+  StoredEvent event = makeEvent(7);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(7, event.sequence);
+  segmentFile(2, path, sizeof(path));
+  TEST_ASSERT_EQUAL(3 * EVENT_RECORD_SIZE, fileSize(path));
+}
+
+static void test_file_truncated_tail_is_dropped(void) {
+  FileLogStorage storage(directory);
+  TEST_ASSERT_TRUE(storage.begin());
+  fill(storage, 6);
+  // Power cut while writing event 6: the file ends inside its record
+  char path[300];
+  segmentFile(2, path, sizeof(path));
+  TEST_ASSERT_EQUAL_INT(0, truncate(path, 2 * EVENT_RECORD_SIZE - 15));
+
+  FileLogStorage reopened(directory);
+  EventStore store(reopened);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(5, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(6, store.nextSequence());
+  StoredEvent latest[10];
+  TEST_ASSERT_EQUAL(5, store.readLatest(latest, 10));
+  TEST_ASSERT_EQUAL_UINT32(5, latest[0].sequence);
+
+  // The next event starts a new file instead of following the partial bytes
+  StoredEvent event = makeEvent(60);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(3, store.segmentCount());
+  TEST_ASSERT_EQUAL(2 * EVENT_RECORD_SIZE - 15, fileSize(path));
+  segmentFile(3, path, sizeof(path));
+  TEST_ASSERT_EQUAL(EVENT_RECORD_SIZE, fileSize(path));
+  TEST_ASSERT_EQUAL(6, store.readLatest(latest, 10));
+  TEST_ASSERT_EQUAL_UINT32(6, latest[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(makeEvent(60).timestamp, latest[0].timestamp);
+}
+
+static void test_file_corrupted_tail_is_torn(void) {
+  FileLogStorage storage(directory);
+  TEST_ASSERT_TRUE(storage.begin());
+  fill(storage, 6);
+  // The whole record reached the file, with one byte of it damaged
+  char path[300];
+  segmentFile(2, path, sizeof(path));
+  FILE* file = fopen(path, "r+b");
+  TEST_ASSERT_NOT_NULL(file);
+  long offset = EVENT_RECORD_SIZE + 13;
+  fseek(file, offset, SEEK_SET);
+  int byte = fgetc(file);
+  fseek(file, offset, SEEK_SET);
+  fputc(byte ^ 0x40, file);
+  fclose(file);
+
+  FileLogStorage reopened(directory);
+  EventStore store(reopened);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, SEGMENTS));
+  TEST_ASSERT_EQUAL_UINT32(1, store.tornRecords());
+  TEST_ASSERT_EQUAL_UINT32(6, store.nextSequence());
+
+  StoredEvent event = makeEvent(7);
+  TEST_ASSERT_TRUE(store.append(event));
+  TEST_ASSERT_EQUAL_UINT32(3, store.segmentCount());
+  EventCursor cursor = {0, 0};
+  StoredEvent all[16];
+  size_t count = 0, n;
+  while ((n = store.readNext(cursor, all + count, 4)) > 0) count += n;
+  TEST_ASSERT_EQUAL(6, count);
+  for (uint32_t i = 0; i < 6; i++) TEST_ASSERT_EQUAL_UINT32(i + 1, all[i].sequence);
+}
+
+static void test_file_oldest_segment_is_removed(void) {
+  FileLogStorage storage(directory);
+  TEST_ASSERT_TRUE(storage.begin());
+  fill(storage, 13); // Files 1 to 4; the first is gone once the fourth starts
+  TEST_ASSERT_EQUAL_INT(SEGMENTS, fileCount());
+  char path[300];
+  segmentFile(1, path, sizeof(path));
+  TEST_ASSERT_EQUAL(-1, fileSize(path));
+
+  // A lower limit after a restart removes more
+  FileLogStorage reopened(directory);
+  EventStore store(reopened);
+  TEST_ASSERT_TRUE(store.begin(PER_SEGMENT, 2));
+  TEST_ASSERT_EQUAL_UINT32(2, store.segmentCount());
+  TEST_ASSERT_EQUAL_UINT32(5, store.recordCount());
+  TEST_ASSERT_EQUAL_UINT32(14, store.nextSequence());
+  TEST_ASSERT_EQUAL_INT(2, fileCount());
+  StoredEvent latest[16];
+  TEST_ASSERT_EQUAL(5, store.readLatest(latest, 16));
+  TEST_ASSERT_EQUAL_UINT32(9, latest[4].sequence);
+
+  TEST_ASSERT_TRUE(store.clear());
+  TEST_ASSERT_EQUAL_INT(0, fileCount());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_events_survive_a_restart);
+  RUN_TEST(test_truncated_last_record_is_dropped);
+  RUN_TEST(test_corrupted_last_record_is_torn);
+  RUN_TEST(test_torn_records_are_counted_back_to_the_last_good_one);
+  RUN_TEST(test_failed_append_seals_the_segment);
+  RUN_TEST(test_oldest_segment_is_dropped_whole);
+  RUN_TEST(test_older_records_are_still_read);
+  RUN_TEST(test_file_segments_survive_a_restart);
+  RUN_TEST(test_file_truncated_tail_is_dropped);
+  RUN_TEST(test_file_corrupted_tail_is_torn);
+  RUN_TEST(test_file_oldest_segment_is_removed);
+  return UNITY_END();
+}
@@ -0,0 +1,94 @@
+// GroundMotion's leaky integrators against the closed form on steady sines,
+// their immunity to an offset, and the PGA/PGV intensity regression.
+//
+// Run: pio test -e native -f test_ground_motion
+
+#include <unity.h>
+#include <ground_motion.h>
+#include <mercalli.h>
+#include <math.h>
+
+const float RATE = 400;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Velocity A / (2 pi f), displacement A / (2 pi f)² once settled; the
+// displacement stage's high-pass costs a few percent at the low end
+static void test_sines_match_the_closed_form(void) {
+  static const float FREQUENCIES[] = { 0.5f, 1, 2, 5, 10 };
+  const float amplitude = 100; // counts
+  for (size_t f = 0; f < sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]); f++) {
+    float hz = FREQUENCIES[f];
+    GroundMotion motion;
+    motion.configure(defaultGroundMotionConfig(), RATE);
+    uint32_t settle = (uint32_t)(60 * RATE), length = settle + (uint32_t)(10 * RATE);
+    float pgv = 0, pgd = 0;
+    for (uint32_t i = 0; i < length; i++) {
+      motion.update(amplitude * sinf(2.0f * (float)M_PI * hz * i / RATE), 0, 0);
+      if (i < settle) continue;
+      if (fabsf(motion.velocity(0)) > pgv) pgv = fabsf(motion.velocity(0));
+      if (fabsf(motion.displacement(0)) > pgd) pgd = fabsf(motion.displacement(0));
+    }
+    float w = 2.0f * (float)M_PI * hz;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, pgv * w / amplitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.0f, pgd * w * w / amplitude);
+  }
+}
+
+// Plain integration would turn the offset into a ramp and a parabola
+static void test_offset_does_not_drift(void) {
+  GroundMotion motion;
+  motion.configure(defaultGroundMotionConfig(), RATE);
+  for (uint32_t i = 0; i < (uint32_t)(300 * RATE); i++) motion.update(10, -10, 10);
+  for (int axis = 0; axis < 3; axis++) {
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, motion.velocity(axis));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, motion.displacement(axis));
+  }
+
+  motion.reset();
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, motion.horizontalVelocity());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, motion.horizontalDisplacement());
+}
+
+// The larger of X and Y; Z is vertical and left out
+static void test_horizontal_component(void) {
+  GroundMotion motion;
+  motion.configure(defaultGroundMotionConfig(), RATE);
+  for (uint32_t i = 0; i < (uint32_t)(10 * RATE); i++) {
+    float s = sinf(2.0f * (float)M_PI * 2.0f * i / RATE);
+    motion.update(20 * s, -50 * s, 500 * s);
+  }
+  TEST_ASSERT_EQUAL_FLOAT(fabsf(motion.velocity(1)), motion.horizontalVelocity());
+  TEST_ASSERT_EQUAL_FLOAT(fabsf(motion.displacement(1)), motion.horizontalDisplacement());
+  TEST_ASSERT_GREATER_THAN(0, (int)(1000 * motion.horizontalVelocity()));
+}
+
+// Worden et al. (2012) with the ShakeMap blend between V and VII
+static void test_intensity_regression(void) {
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, mmiFromPga(0));
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, mmiFromPgv(-1));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.78f + 1.55f * 1.0f, mmiFromPga(10));     // Below the knee
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, -1.60f + 3.70f * 2.0f, mmiFromPga(100));  // Above it
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.78f + 1.47f * 0.0f, mmiFromPgv(1));
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, mmiFromPga(1e6f));
+
+  // Below V the PGA estimate alone, above VII the PGV estimate alone
+  TEST_ASSERT_EQUAL_FLOAT(mmiFromPga(10), mmiFromGroundMotion(10, 1000));
+  TEST_ASSERT_EQUAL_FLOAT(mmiFromPgv(30), mmiFromGroundMotion(400, 30));
+  // In between, a blend that stays between the two
+  float pga = 100, pgv = 2;
+  float blended = mmiFromGroundMotion(pga, pgv);
+  TEST_ASSERT_TRUE(mmiFromPga(pga) > 5.0f && mmiFromPga(pga) < 7.0f);
+  TEST_ASSERT_TRUE(blended <= fmaxf(mmiFromPga(pga), mmiFromPgv(pgv)));
+  TEST_ASSERT_TRUE(blended >= fminf(mmiFromPga(pga), mmiFromPgv(pgv)));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sines_match_the_closed_form);
+  RUN_TEST(test_offset_does_not_drift);
+  RUN_TEST(test_horizontal_component);
+  RUN_TEST(test_intensity_regression);
+  return UNITY_END();
+}
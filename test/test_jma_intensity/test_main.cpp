@@ -0,0 +1,225 @@
+// JmaIntensity against JMA's definition: circular motions, whose intensity
+// has a closed form, and damped three-axis bursts compared with the intensity
+// of the whole record computed in one double-precision transform and a sort.
+//
+// Run: pio test -e native -f test_jma_intensity
+
+#include <unity.h>
+#include <jma_intensity.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <functional>
+#include <vector>
+
+const float RATE = 100;
+const float GAL_PER_COUNT = ADXL345_MS2_PER_LSB * 100.0f;
+const float FREQUENCIES[] = { 0.5f, 1.0f, 2.0f, 5.0f, 10.0f, 20.0f };
+const float ACCELERATIONS[] = { 50.0f, 400.0f }; // gal
+
+// In-place radix-2 FFT in double precision, for the reference only
+static void referenceFft(std::vector<std::complex<double> >& a, bool inverse) {
+  size_t n = a.size();
+  for (size_t i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j |= bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+  for (size_t length = 2; length <= n; length <<= 1) {
+    double angle = (inverse ? 2 : -2) * M_PI / length;
+    std::complex<double> step(cos(angle), sin(angle));
+    for (size_t start = 0; start < n; start += length) {
+      std::complex<double> w(1, 0);
+      for (size_t k = 0; k < length / 2; k++) {
+        std::complex<double> t = a[start + k + length / 2] * w;
+        a[start + k + length / 2] = a[start + k] - t;
+        a[start + k] += t;
+        w *= step;
+      }
+    }
+  }
+  if (inverse) for (size_t i = 0; i < n; i++) a[i] /= (double)n;
+}
+
+// JMA intensity of a whole record as JMA defines it: each axis transformed in
+// one piece (mean removed, zero-padded), weighted bin by bin, transformed
+// back, and the vector magnitudes sorted for the 0.3 s level
+static double referenceIntensity(const std::vector<RawSample>& record) {
+  size_t n = 1;
+  while (n < 2 * record.size()) n <<= 1;
+  std::vector<double> magnitudeSq(record.size(), 0.0);
+  for (int axis = 0; axis < 3; axis++) {
+    double mean = 0;
+    for (size_t i = 0; i < record.size(); i++) {
+      mean += axis == 0 ? record[i].x : axis == 1 ? record[i].y : record[i].z;
+    }
+    mean /= record.size();
+    std::vector<std::complex<double> > a(n);
+    for (size_t i = 0; i < record.size(); i++) {
+      int16_t v = axis == 0 ? record[i].x : axis == 1 ? record[i].y : record[i].z;
+      a[i] = (v - mean) * GAL_PER_COUNT;
+    }
+    referenceFft(a, false);
+    for (size_t k = 0; k < n; k++) {
+      size_t bin = k <= n / 2 ? k : n - k;
+      a[k] *= jmaFilterWeight((float)(bin * (double)RATE / n));
+    }
+    referenceFft(a, true);
+    for (size_t i = 0; i < record.size(); i++) magnitudeSq[i] += a[i].real() * a[i].real();
+  }
+  size_t needed = (size_t)(0.3 * RATE + 0.5);
+  std::sort(magnitudeSq.begin(), magnitudeSq.end(), std::greater<double>());
+  return log10(magnitudeSq[needed - 1]) + 0.94;
+}
+
+// The buffers the firmware gives the stage, at 100 Hz
+struct Stage {
+  JmaConfig config;
+  std::vector<RawSample> samples;
+  std::vector<float> work;
+  std::vector<uint16_t> window;
+  JmaIntensity jma;
+
+  Stage() : config(defaultJmaConfig(RATE, ADXL345_MS2_PER_LSB)), samples(config.points),
+            work(JMA_WORK_SIZE(config.points)), window(jmaWindowSamples(config)) {
+    TEST_ASSERT_TRUE(jma.begin(config, samples.data(), work.data(), window.data()));
+  }
+};
+
+// Peak intensity of the streaming stage over a record
+static float streamIntensity(const std::vector<RawSample>& record) {
+  Stage stage;
+  for (size_t i = 0; i < record.size(); i++) {
+    if (stage.jma.push(record[i])) stage.jma.process();
+  }
+  TEST_ASSERT_TRUE(stage.jma.valid());
+  return stage.jma.peak();
+}
+
+// Quiet 50 s record at 1 g with a 10 s burst from 20 s: a circular motion in
+// X and Y (constant magnitude, so its level is known in closed form) or a
+// damped sinusoid on all three axes
+static std::vector<RawSample> makeRecord(float hz, float gal, bool circular) {
+  const float seconds = 10;
+  std::vector<RawSample> record((size_t)(50 * RATE));
+  float counts = gal / GAL_PER_COUNT;
+  size_t start = (size_t)(20 * RATE);
+  for (size_t i = 0; i < record.size(); i++) {
+    float t = (float)i / RATE - 20.0f;
+    float x = 0, y = 0, z = 0;
+    if (i >= start && t < seconds) {
+      float phase = 2.0f * (float)M_PI * hz * t;
+      if (circular) {
+        // Eased in and out over a second so the burst edges stay out of the band
+        float ease = std::min(1.0f, std::min(t, seconds - t));
+        x = counts * ease * sinf(phase);
+        y = counts * ease * cosf(phase);
+      } else {
+        float envelope = counts * expf(-t / 3.0f);
+        x = envelope * sinf(phase);
+        y = 0.6f * envelope * sinf(phase + 1.0f);
+        z = 0.4f * envelope * sinf(phase + 2.0f);
+      }
+    }
+    record[i].x = (int16_t)lroundf(x);
+    record[i].y = (int16_t)lroundf(y);
+    record[i].z = (int16_t)lroundf(256.0f + z);
+  }
+  return record;
+}
+
+// A circular motion of `gal` keeps its filtered magnitude at gal times the weight
+static double closedForm(float hz, float gal) {
+  return 2 * log10(gal * jmaFilterWeight(hz)) + 0.94;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_intensity_classes(void) {
+  TEST_ASSERT_EQUAL_STRING("0", jmaIntensityClass(-1.0f));
+  TEST_ASSERT_EQUAL_STRING("0", jmaIntensityClass(0.49f));
+  TEST_ASSERT_EQUAL_STRING("1", jmaIntensityClass(0.50f));
+  TEST_ASSERT_EQUAL_STRING("4", jmaIntensityClass(4.49f));
+  TEST_ASSERT_EQUAL_STRING("5-", jmaIntensityClass(4.50f));
+  TEST_ASSERT_EQUAL_STRING("5+", jmaIntensityClass(5.00f));
+  TEST_ASSERT_EQUAL_STRING("6-", jmaIntensityClass(5.50f));
+  TEST_ASSERT_EQUAL_STRING("6+", jmaIntensityClass(6.00f));
+  TEST_ASSERT_EQUAL_STRING("7", jmaIntensityClass(6.50f));
+  TEST_ASSERT_EQUAL_STRING("7", jmaIntensityClass(9.99f));
+}
+
+// The reference itself, where the answer is known; the finite burst and its
+// easing keep it a little off at the ends of the band
+static void test_reference_matches_the_closed_form(void) {
+  for (size_t f = 0; f < sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]); f++) {
+    for (size_t a = 0; a < sizeof(ACCELERATIONS) / sizeof(ACCELERATIONS[0]); a++) {
+      float hz = FREQUENCIES[f], gal = ACCELERATIONS[a];
+      double reference = referenceIntensity(makeRecord(hz, gal, true));
+      TEST_ASSERT_DOUBLE_WITHIN(0.06, closedForm(hz, gal), reference);
+    }
+  }
+}
+
+static void test_stream_matches_the_closed_form(void) {
+  for (size_t f = 0; f < sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]); f++) {
+    for (size_t a = 0; a < sizeof(ACCELERATIONS) / sizeof(ACCELERATIONS[0]); a++) {
+      float hz = FREQUENCIES[f], gal = ACCELERATIONS[a];
+      float stream = streamIntensity(makeRecord(hz, gal, true));
+      TEST_ASSERT_DOUBLE_WITHIN(0.03, closedForm(hz, gal), stream);
+    }
+  }
+}
+
+// 0.5 to 20 Hz, circular and damped
+static void test_stream_matches_the_whole_record_reference(void) {
+  for (size_t f = 0; f < sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]); f++) {
+    for (size_t a = 0; a < sizeof(ACCELERATIONS) / sizeof(ACCELERATIONS[0]); a++) {
+      for (int circular = 1; circular >= 0; circular--) {
+        std::vector<RawSample> record = makeRecord(FREQUENCIES[f], ACCELERATIONS[a], circular);
+        double reference = referenceIntensity(record);
+        float stream = streamIntensity(record);
+        // The stage truncates to 0.01, so compare against the truncated
+        // reference; 0.03 and the float rounding of the result
+        TEST_ASSERT_DOUBLE_WITHIN(0.031, floor(reference * 100.0 + 1e-6) / 100.0, stream);
+      }
+    }
+  }
+}
+
+static void test_quiet_sensor_is_class_zero(void) {
+  std::vector<RawSample> record = makeRecord(1, 0, true);
+  TEST_ASSERT_EQUAL_STRING("0", jmaIntensityClass(streamIntensity(record)));
+}
+
+// The stage runs beside the detector on the board, two orders of magnitude
+// slower than a desktop; on the host it must be far ahead of 100 Hz
+static void test_keeps_far_ahead_of_real_time(void) {
+  const size_t SAMPLES = 500000;
+  Stage stage;
+  uint32_t rng = 12345;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < SAMPLES; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    int16_t n = (int16_t)((int32_t)(rng >> 28) - 8);
+    RawSample sample = { n, (int16_t)-n, (int16_t)(256 + n) };
+    if (stage.jma.push(sample)) stage.jma.process();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  TEST_ASSERT_TRUE(stage.jma.valid());
+  double realTime = SAMPLES / RATE / elapsed.count();
+  TEST_ASSERT_GREATER_THAN(1000, (int)realTime);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_intensity_classes);
+  RUN_TEST(test_reference_matches_the_closed_form);
+  RUN_TEST(test_stream_matches_the_closed_form);
+  RUN_TEST(test_stream_matches_the_whole_record_reference);
+  RUN_TEST(test_quiet_sensor_is_class_zero);
+  RUN_TEST(test_keeps_far_ahead_of_real_time);
+  return UNITY_END();
+}
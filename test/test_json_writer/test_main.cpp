@@ -0,0 +1,199 @@
+// JsonWriter: output, truncation, streaming through a sink, and no heap
+// allocations while rendering. operator new (and malloc on glibc) are
+// replaced by counting versions for the whole test program.
+//
+// Run: pio test -e native -f test_json_writer
+
+#include <unity.h>
+#include <json_writer.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <string>
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+  if (counting) allocations++;
+  void* block = malloc(size > 0 ? size : 1);
+  if (!block) throw std::bad_alloc();
+  return block;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+
+#ifdef __GLIBC__
+// The C allocator as well, so a printf or strdup inside the writer would show
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* block, size_t size);
+extern "C" void __libc_free(void* block);
+
+extern "C" void* malloc(size_t size) {
+  if (counting) allocations++;
+  return __libc_malloc(size);
+}
+extern "C" void* calloc(size_t count, size_t size) {
+  if (counting) allocations++;
+  return __libc_calloc(count, size);
+}
+extern "C" void* realloc(void* block, size_t size) {
+  if (counting) allocations++;
+  return __libc_realloc(block, size);
+}
+extern "C" void free(void* block) { __libc_free(block); }
+#endif
+
+// Collects what a writer hands to its sink
+struct Collected {
+  char text[4096];
+  size_t length;
+  unsigned chunks;
+};
+
+static void collect(const char* data, size_t length, void* context) {
+  Collected* out = (Collected*)context;
+  if (out->length + length < sizeof(out->text)) memcpy(out->text + out->length, data, length);
+  out->length += length;
+  out->chunks++;
+}
+
+// A document shaped like /data: nested objects, an array of readings and
+// every field type
+static void renderSensorData(JsonWriter& json, unsigned n) {
+  json.beginObject();
+  json.field("x", 0.012f * n);
+  json.field("y", -0.034f);
+  json.field("z", 9.80665f, 3);
+  json.field("mercalli", (int)(n % 12) + 1);
+  json.field("uptime", (unsigned long)n * 100);
+  json.field("calibrating", n % 2 == 0);
+  json.field("mode", "thresholds");
+  json.field("ratio", NAN);
+  json.beginObject("noise_floor");
+  json.field("valid", true);
+  json.beginArray("history");
+  for (int i = 0; i < 30; i++) json.field(NULL, 0.01f * i, 4);
+  json.endArray();
+  json.endObject();
+  json.beginArray("events");
+  for (int i = 0; i < 3; i++) {
+    json.beginObject();
+    json.field("time", "2026-10-16 12:00:00.250");
+    json.field("intensity", i + 3);
+    json.endObject();
+  }
+  json.endArray();
+  json.endObject();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_values_and_separators(void) {
+  char buffer[256];
+  JsonWriter json(buffer, sizeof(buffer));
+  json.beginObject();
+  json.field("int", -42);
+  json.field("big", 4000000000UL);
+  json.field("f", 1.005f, 1);
+  json.field("neg", -0.004f);  // Rounds to zero without a sign
+  json.field("inf", INFINITY);
+  json.field("on", false);
+  json.field("s", "a\"b\\c\nd\x01");
+  json.field("none", (const char*)NULL);
+  json.beginArray("list");
+  json.field(NULL, 1);
+  json.fieldNull(NULL);
+  json.beginObject();
+  json.endObject();
+  json.endArray();
+  json.endObject();
+  size_t length = json.finish();
+
+  const char* expected = "{\"int\":-42,\"big\":4000000000,\"f\":1.0,\"neg\":0.00,\"inf\":null,"
+                         "\"on\":false,\"s\":\"a\\\"b\\\\c\\nd\\u0001\",\"none\":null,"
+                         "\"list\":[1,null,{}]}";
+  TEST_ASSERT_EQUAL_STRING(expected, json.c_str());
+  TEST_ASSERT_EQUAL(strlen(expected), length);
+  TEST_ASSERT_FALSE(json.overflowed());
+}
+
+static void test_truncates_without_a_sink(void) {
+  char buffer[16];
+  JsonWriter json(buffer, sizeof(buffer));
+  json.beginObject();
+  json.field("message", "longer than the buffer");
+  json.endObject();
+  json.finish();
+  TEST_ASSERT_TRUE(json.overflowed());
+  TEST_ASSERT_EQUAL(15, strlen(json.c_str()));
+  TEST_ASSERT_EQUAL_STRING("{\"message\":\"lon", json.c_str());
+}
+
+// Streamed through a tiny buffer, the output is the same as rendered whole
+static void test_sink_streams_the_same_text(void) {
+  char whole[4096];
+  JsonWriter reference(whole, sizeof(whole));
+  renderSensorData(reference, 7);
+  size_t length = reference.finish();
+  TEST_ASSERT_FALSE(reference.overflowed());
+
+  char small[8];
+  Collected out = { {0}, 0, 0 };
+  JsonWriter json(small, sizeof(small), collect, &out);
+  renderSensorData(json, 7);
+  TEST_ASSERT_EQUAL(length, json.finish());
+  TEST_ASSERT_EQUAL(length, out.length);
+  TEST_ASSERT_EQUAL_MEMORY(whole, out.text, length);
+  TEST_ASSERT_GREATER_THAN(length / 7 - 1, out.chunks);
+  TEST_ASSERT_FALSE(json.overflowed());
+}
+
+// The buffers the firmware uses: one static 1 KiB buffer for /data and BLE,
+// and 512 bytes on the stack streamed as chunks for /events
+static void test_rendering_does_not_allocate(void) {
+  static char page[1024];
+  Collected out = { {0}, 0, 0 };
+
+  // The counter sees allocations made while it is on
+  counting = true;
+  std::string* probe = new std::string(64, 'x');
+  counting = false;
+  TEST_ASSERT_GREATER_THAN(0, allocations);
+  delete probe;
+
+  allocations = 0;
+  unsigned overflows = 0;
+  counting = true;
+  for (unsigned n = 0; n < 1000; n++) {
+    JsonWriter json(page, sizeof(page));
+    renderSensorData(json, n);
+    json.finish();
+    if (json.overflowed()) overflows++;
+
+    char chunk[512];
+    out.length = 0;
+    JsonWriter stream(chunk, sizeof(chunk), collect, &out);
+    renderSensorData(stream, n);
+    stream.finish();
+  }
+  counting = false;
+  TEST_ASSERT_EQUAL_UINT32(0, allocations);
+  TEST_ASSERT_EQUAL(0, overflows);
+  TEST_ASSERT_GREATER_THAN(0, out.length);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_values_and_separators);
+  RUN_TEST(test_truncates_without_a_sink);
+  RUN_TEST(test_sink_streams_the_same_text);
+  RUN_TEST(test_rendering_does_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,94 @@
+// RunningStats (compensated Welford in float) against a double-precision
+// reference, on inputs the size of gravity with small noise on top: the case
+// where a plain float accumulator loses the low bits of the mean.
+//
+// Run: pio test -e native -f test_running_stats
+
+#include <unity.h>
+#include <calibrator.h>
+#include <math.h>
+
+// Reference Welford in double precision
+struct ReferenceStats {
+  uint32_t n;
+  double mean;
+  double m2;
+
+  void push(double value) {
+    n++;
+    double delta = value - mean;
+    mean += delta / n;
+    m2 += delta * (value - mean);
+  }
+  double stddev() const { return n < 2 ? 0 : sqrt(m2 / n); }
+};
+
+// Uniform noise in [-1, 1) from a fixed seed
+static float noise(uint32_t& rng) {
+  rng = rng * 1664525u + 1013904223u;
+  return (int32_t)(rng >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+// Feeds both with `count` values around `base` and checks the relative errors
+static void compare(uint32_t count, float base, float amplitude, bool counts,
+                    double meanTolerance, double stddevTolerance) {
+  RunningStats stats;
+  ReferenceStats reference = { 0, 0, 0 };
+  uint32_t rng = 12345;
+  for (uint32_t i = 1; i <= count; i++) {
+    // A slow wander under the noise, as a sensor warming up
+    float value = base + amplitude * noise(rng) + amplitude * 0.05f * sinf(i * 0.001f);
+    if (counts) value = roundf(value);
+    stats.push(value);
+    reference.push(value);
+  }
+  TEST_ASSERT_EQUAL_UINT32(count, stats.count());
+  TEST_ASSERT_DOUBLE_WITHIN(meanTolerance * fabs(reference.mean), reference.mean, stats.mean());
+  TEST_ASSERT_DOUBLE_WITHIN(stddevTolerance * reference.stddev(), reference.stddev(), stats.stddev());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_known_values(void) {
+  RunningStats stats;
+  const float values[] = { 2, 4, 4, 4, 5, 5, 7, 9 };
+  for (size_t i = 0; i < 8; i++) stats.push(values[i]);
+  TEST_ASSERT_EQUAL_FLOAT(5.0f, stats.mean());
+  TEST_ASSERT_EQUAL_FLOAT(4.0f, stats.variance());
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, stats.stddev());
+
+  stats.reset();
+  TEST_ASSERT_EQUAL_UINT32(0, stats.count());
+  stats.push(9.80665f);
+  TEST_ASSERT_EQUAL_FLOAT(9.80665f, stats.mean());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance()); // One value has no spread
+}
+
+static void test_constant_gravity_has_no_variance(void) {
+  RunningStats stats;
+  for (int i = 0; i < 100000; i++) stats.push(9.80665f);
+  TEST_ASSERT_EQUAL_FLOAT(9.80665f, stats.mean());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.stddev());
+}
+
+// What calibration collects: two seconds at 400 Hz of counts around 1 g
+static void test_calibration_window_in_counts(void) {
+  compare(800, 256.0f, 3.0f, true, 1e-6, 1e-5);
+  compare(800, -256.0f, 1.0f, true, 1e-6, 1e-5);
+}
+
+// Long runs in m/s²: noise five decades below the mean
+static void test_long_run_in_ms2(void) {
+  compare(100000, 9.80665f, 0.02f, false, 1e-6, 1e-5);
+  compare(2000000, 9.80665f, 0.02f, false, 1e-6, 1e-5);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_known_values);
+  RUN_TEST(test_constant_gravity_has_no_variance);
+  RUN_TEST(test_calibration_window_in_counts);
+  RUN_TEST(test_long_run_in_ms2);
+  return UNITY_END();
+}
@@ -0,0 +1,153 @@
+// SpscRing with one producer and one consumer thread, the way the acquisition
+// task and loop() share it: order, drop counting and the high-water mark.
+//
+// Run: pio test -e native -f test_spsc_ring
+
+#include <unity.h>
+#include <spsc_ring.h>
+#include <atomic>
+#include <thread>
+
+// Several words, so a torn copy shows up as a mismatch between them
+struct Item {
+  uint32_t sequence;
+  uint32_t inverted;
+  uint64_t tripled;
+};
+
+static Item makeItem(uint32_t sequence) {
+  Item item = { sequence, ~sequence, (uint64_t)sequence * 3 };
+  return item;
+}
+
+static bool intact(const Item& item) {
+  return item.inverted == ~item.sequence && item.tripled == (uint64_t)item.sequence * 3;
+}
+
+const uint32_t ITEMS = 200000;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_full_ring_drops_and_counts(void) {
+  SpscRing<Item, 8> ring;
+  for (uint32_t i = 0; i < 8; i++) TEST_ASSERT_TRUE(ring.push(makeItem(i)));
+  TEST_ASSERT_FALSE(ring.push(makeItem(8)));
+  TEST_ASSERT_FALSE(ring.push(makeItem(9)));
+  TEST_ASSERT_EQUAL_UINT32(2, ring.dropCount());
+  TEST_ASSERT_EQUAL_UINT32(8, ring.highWaterMark());
+  TEST_ASSERT_EQUAL(8, ring.size());
+
+  // The dropped items are the new ones; the queued ones come out in order
+  Item item = {};
+  for (uint32_t i = 0; i < 8; i++) {
+    TEST_ASSERT_TRUE(ring.pop(item));
+    TEST_ASSERT_EQUAL_UINT32(i, item.sequence);
+  }
+  TEST_ASSERT_FALSE(ring.pop(item));
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+static void test_high_water_mark_keeps_the_deepest_level(void) {
+  SpscRing<Item, 16> ring;
+  Item out[16];
+  for (uint32_t i = 0; i < 5; i++) ring.push(makeItem(i));
+  TEST_ASSERT_EQUAL(5, ring.pop(out, 16));
+  for (uint32_t i = 0; i < 3; i++) ring.push(makeItem(i));
+  TEST_ASSERT_EQUAL_UINT32(5, ring.highWaterMark());
+  TEST_ASSERT_EQUAL(2, ring.pop(out, 2));
+  TEST_ASSERT_EQUAL_UINT32(1, out[1].sequence);
+  ring.clear();
+  TEST_ASSERT_TRUE(ring.empty());
+  TEST_ASSERT_EQUAL_UINT32(5, ring.highWaterMark());
+  TEST_ASSERT_EQUAL_UINT32(0, ring.dropCount());
+}
+
+// The producer retries until each push lands, so every item must arrive, in
+// order, and each refused push must have been counted as a drop
+static void test_two_threads_deliver_everything_in_order(void) {
+  static SpscRing<Item, 64> ring;
+  uint32_t refused = 0;
+  std::thread producer([&refused]() {
+    for (uint32_t i = 0; i < ITEMS; i++) {
+      while (!ring.push(makeItem(i))) {
+        refused++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  uint32_t broken = 0;
+  uint32_t outOfOrder = 0;
+  Item batch[16];
+  while (expected < ITEMS) {
+    // Alternate single and batch pops, both are used by loop()
+    size_t count = (expected & 1) ? ring.pop(batch, 16) : (ring.pop(batch[0]) ? 1 : 0);
+    if (count == 0) std::this_thread::yield();
+    for (size_t i = 0; i < count; i++) {
+      if (!intact(batch[i])) broken++;
+      if (batch[i].sequence != expected) outOfOrder++;
+      expected = batch[i].sequence + 1;
+    }
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, broken);
+  TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+  TEST_ASSERT_EQUAL_UINT32(ITEMS, expected);
+  TEST_ASSERT_EQUAL_UINT32(refused, ring.dropCount());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(64, ring.highWaterMark());
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+// The producer never waits, as in the acquisition task: whatever arrives is
+// intact and in increasing order, and arrivals plus drops add up
+static void test_two_threads_account_for_every_drop(void) {
+  static SpscRing<Item, 32> ring;
+  std::atomic<bool> done(false);
+  uint32_t rejected = 0;
+  std::thread producer([&done, &rejected]() {
+    for (uint32_t i = 0; i < ITEMS; i++) {
+      if (!ring.push(makeItem(i))) rejected++;
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t received = 0;
+  uint32_t broken = 0;
+  uint32_t backwards = 0;
+  int64_t last = -1;
+  Item item = {};
+  for (;;) {
+    bool finished = done.load(std::memory_order_acquire);
+    bool any = false;
+    while (ring.pop(item)) {
+      any = true;
+      received++;
+      if (!intact(item)) broken++;
+      if ((int64_t)item.sequence <= last) backwards++;
+      last = item.sequence;
+    }
+    if (finished && !any) break;
+    if (!any) std::this_thread::yield();
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, broken);
+  TEST_ASSERT_EQUAL_UINT32(0, backwards);
+  TEST_ASSERT_EQUAL_UINT32(rejected, ring.dropCount());
+  TEST_ASSERT_EQUAL_UINT32(ITEMS, received + ring.dropCount());
+  TEST_ASSERT_GREATER_THAN_UINT32(0, ring.highWaterMark());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(32, ring.highWaterMark());
+  if (ring.dropCount() > 0) TEST_ASSERT_EQUAL_UINT32(32, ring.highWaterMark());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_ring_drops_and_counts);
+  RUN_TEST(test_high_water_mark_keeps_the_deepest_level);
+  RUN_TEST(test_two_threads_deliver_everything_in_order);
+  RUN_TEST(test_two_threads_account_for_every_drop);
+  return UNITY_END();
+}
@@ -0,0 +1,234 @@
+// Station settings through a device's life, over a key-value store in memory:
+// first boot from EEPROM, reboots, a change, bad values, a corrupted key, the
+// calibration record, the boot counter and the clock anchors.
+//
+// Run: pio test -e native -f test_station_config
+
+#include <unity.h>
+#include <adxl345_fifo.h>
+#include <station_config.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Key-value storage in memory, standing in for NVS
+class MemoryConfigStorage : public ConfigStorage {
+  public:
+    size_t read(const char* key, uint8_t* data, size_t size) {
+      std::map<std::string, std::vector<uint8_t> >::const_iterator entry = values.find(key);
+      if (entry == values.end() || entry->second.size() > size) return 0;
+      memcpy(data, entry->second.data(), entry->second.size());
+      return entry->second.size();
+    }
+    bool write(const char* key, const uint8_t* data, size_t length) {
+      if (strlen(key) > CONFIG_MAX_KEY) return false;
+      values[key].assign(data, data + length);
+      return true;
+    }
+
+    std::map<std::string, std::vector<uint8_t> > values;
+};
+
+// What the pre-NVS firmware kept in EEPROM
+static void migrateFromEeprom(uint16_t fromVersion, StationConfig& config, void* context) {
+  if (fromVersion > 0) return;
+  strcpy(config.wifi_ssid, "station-net");
+  strcpy(config.collector, "10.0.0.2:5683");
+}
+
+static bool sameConfig(const StationConfig& a, const StationConfig& b) {
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    if (!configValueEquals(configParam(i), a, b)) return false;
+  }
+  return true;
+}
+
+// A store after its first boot: migrated and saved
+static void firstBoot(MemoryConfigStorage& storage, StationConfig& config) {
+  ConfigStore store(storage);
+  store.load(config, migrateFromEeprom, NULL);
+  store.save(config);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_every_parameter_round_trips(void) {
+  StationConfig config = defaultStationConfig();
+  TEST_ASSERT_NULL(checkStationConfig(config));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_OK, setConfigParam(config, "collector", "10.0.0.9:5683"));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_OK, setConfigParam(config, "trigger_on", "5.5"));
+  for (size_t i = 0; i < CONFIG_PARAM_COUNT; i++) {
+    const ConfigParam& param = configParam(i);
+    uint8_t value[CONFIG_MAX_VALUE];
+    size_t length = encodeConfigValue(param, config, value);
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_LESS_OR_EQUAL(CONFIG_MAX_VALUE, length);
+    StationConfig decoded = defaultStationConfig();
+    TEST_ASSERT_TRUE(decodeConfigValue(param, value, length, decoded));
+    TEST_ASSERT_TRUE(configValueEquals(param, config, decoded));
+  }
+}
+
+static void test_first_boot_migrates_from_eeprom(void) {
+  MemoryConfigStorage storage;
+  StationConfig config;
+  ConfigStore store(storage);
+  ConfigLoadResult loaded = store.load(config, migrateFromEeprom, NULL);
+  TEST_ASSERT_EQUAL_UINT16(0, loaded.stored_version);
+  TEST_ASSERT_TRUE(loaded.migrated);
+  TEST_ASSERT_EQUAL_STRING("station-net", config.wifi_ssid);
+  // The two migrated keys and the schema
+  TEST_ASSERT_EQUAL_INT(3, store.save(config));
+  TEST_ASSERT_EQUAL(3, storage.values.size());
+}
+
+static void test_reboot_reads_back_and_writes_nothing(void) {
+  MemoryConfigStorage storage;
+  StationConfig config;
+  firstBoot(storage, config);
+
+  StationConfig reloaded;
+  ConfigStore store(storage);
+  ConfigLoadResult loaded = store.load(reloaded, migrateFromEeprom, NULL);
+  TEST_ASSERT_EQUAL_UINT16(CONFIG_SCHEMA_VERSION, loaded.stored_version);
+  TEST_ASSERT_FALSE(loaded.migrated);
+  TEST_ASSERT_EQUAL_UINT16(2, loaded.loaded);
+  TEST_ASSERT_TRUE(sameConfig(config, reloaded));
+  TEST_ASSERT_EQUAL_INT(0, store.save(reloaded));
+}
+
+static void test_a_change_writes_only_its_keys(void) {
+  MemoryConfigStorage storage;
+  StationConfig config;
+  firstBoot(storage, config);
+
+  ConfigStore store(storage);
+  store.load(config);
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_OK, setConfigParam(config, "mercalli_4_threshold", "0.8"));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_OK, setConfigParam(config, "intensity_mode", "REGRESSION"));
+  TEST_ASSERT_EQUAL_INT(2, store.save(config));
+  TEST_ASSERT_EQUAL_INT(0, store.save(config));
+
+  StationConfig reloaded;
+  ConfigStore after(storage);
+  after.load(reloaded);
+  TEST_ASSERT_TRUE(sameConfig(config, reloaded));
+  TEST_ASSERT_EQUAL_FLOAT(0.8f, reloaded.mercalli_thresholds[3]);
+  TEST_ASSERT_EQUAL_UINT8(INTENSITY_REGRESSION, reloaded.intensity_mode);
+}
+
+static void test_bad_values_are_refused(void) {
+  StationConfig config = defaultStationConfig();
+  StationConfig before = config;
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_INVALID, setConfigParam(config, "stream_rate_hz", "5"));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_INVALID, setConfigParam(config, "trigger_on", "4x"));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_INVALID, setConfigParam(config, "min_log_mercalli", "-3"));
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_UNKNOWN, setConfigParam(config, "no_such_param", "1"));
+  TEST_ASSERT_TRUE(sameConfig(before, config));
+
+  // Each threshold is valid alone; the order across them is checked separately
+  TEST_ASSERT_EQUAL_INT(CONFIG_SET_OK, setConfigParam(config, "mercalli_5_threshold", "0.5"));
+  TEST_ASSERT_NOT_NULL(checkStationConfig(config));
+}
+
+// A value of the wrong type reads as the default and is rewritten
+static void test_corrupted_key_is_rejected_and_rewritten(void) {
+  MemoryConfigStorage storage;
+  StationConfig config;
+  firstBoot(storage, config);
+  ConfigStore store(storage);
+  store.load(config);
+  setConfigParam(config, "trigger_on", "5");
+  store.save(config);
+
+  const uint8_t wrongType[] = { CONFIG_U32, 1, 0, 0, 0 };
+  storage.write("trig_on", wrongType, sizeof(wrongType));
+  StationConfig reloaded;
+  ConfigStore after(storage);
+  ConfigLoadResult loaded = after.load(reloaded);
+  TEST_ASSERT_EQUAL_UINT16(1, loaded.rejected);
+  TEST_ASSERT_EQUAL_FLOAT(defaultStationConfig().trigger_on, reloaded.trigger_on);
+  TEST_ASSERT_EQUAL_INT(1, after.save(reloaded));
+
+  ConfigStore last(storage);
+  loaded = last.load(config);
+  TEST_ASSERT_EQUAL_UINT16(0, loaded.rejected);
+  TEST_ASSERT_TRUE(sameConfig(reloaded, config));
+}
+
+static void test_calibration_round_trips(void) {
+  MemoryConfigStorage storage;
+  ConfigStore store(storage);
+  StoredCalibration calibration = { -12, 7, -260, 0.0425f, ADXL345_MS2_PER_LSB };
+  StoredCalibration restored;
+  TEST_ASSERT_FALSE(store.loadCalibration(restored)); // None in an empty store
+
+  TEST_ASSERT_TRUE(store.saveCalibration(calibration));
+  ConfigStore after(storage);
+  TEST_ASSERT_TRUE(after.loadCalibration(restored));
+  TEST_ASSERT_EQUAL_INT16(-12, restored.offset_x);
+  TEST_ASSERT_EQUAL_INT16(7, restored.offset_y);
+  TEST_ASSERT_EQUAL_INT16(-260, restored.offset_z);
+  TEST_ASSERT_EQUAL_FLOAT(calibration.noise_threshold, restored.noise_threshold);
+  TEST_ASSERT_EQUAL_FLOAT(calibration.ms2_per_count, restored.ms2_per_count);
+  TEST_ASSERT_EQUAL(CALIBRATION_RECORD_SIZE, storage.values[CONFIG_CALIBRATION_KEY].size());
+
+  // An X offset of 16384 counts is a fault, not an offset
+  const uint8_t outOfRange[] = { CONFIG_CALIBRATION, 0, 0x40, 0, 0, 0, 0, 0, 0, 0x80, 0x3f, 0, 0, 0x80, 0x3f };
+  TEST_ASSERT_FALSE(decodeCalibration(outOfRange, sizeof(outOfRange), restored));
+  TEST_ASSERT_EQUAL_INT16(-12, restored.offset_x); // Untouched
+  uint8_t record[CALIBRATION_RECORD_SIZE];
+  TEST_ASSERT_EQUAL(CALIBRATION_RECORD_SIZE, encodeCalibration(calibration, record));
+  TEST_ASSERT_FALSE(decodeCalibration(record, CALIBRATION_RECORD_SIZE - 1, restored));
+}
+
+static void test_boot_counter_and_clock_anchors(void) {
+  MemoryConfigStorage storage;
+  ConfigStore store(storage);
+  TEST_ASSERT_EQUAL_UINT32(1, store.nextBoot());
+  TEST_ASSERT_EQUAL_UINT32(2, ConfigStore(storage).nextBoot());
+  TEST_ASSERT_EQUAL_UINT32(3, ConfigStore(storage).nextBoot());
+
+  ClockAnchors anchors;
+  store.loadClockAnchors(anchors);
+  TEST_ASSERT_EQUAL_UINT8(0, anchors.count);
+  // Boots 1 to 10, each starting an hour after the last; only the newest eight stay
+  const int64_t start = 1760000000LL * 1000000;
+  for (uint32_t boot = 1; boot <= 10; boot++) {
+    addClockAnchor(anchors, boot, start + boot * 3600000000LL);
+  }
+  addClockAnchor(anchors, 9, start + 1); // A later sync of the same boot replaces it
+  TEST_ASSERT_EQUAL_UINT8(CLOCK_ANCHOR_COUNT, anchors.count);
+  TEST_ASSERT_TRUE(store.saveClockAnchors(anchors));
+
+  ClockAnchors loaded;
+  ConfigStore(storage).loadClockAnchors(loaded);
+  int64_t utc_us;
+  TEST_ASSERT_FALSE(findClockAnchor(loaded, 2, utc_us));
+  TEST_ASSERT_TRUE(findClockAnchor(loaded, 3, utc_us));
+  TEST_ASSERT_TRUE(utc_us == start + 3 * 3600000000LL);
+  TEST_ASSERT_TRUE(findClockAnchor(loaded, 9, utc_us));
+  TEST_ASSERT_TRUE(utc_us == start + 1);
+  TEST_ASSERT_TRUE(findClockAnchor(loaded, 10, utc_us));
+
+  // A value of the wrong type reads as no anchors
+  const uint8_t wrongType[] = { CONFIG_U32, 1, 0, 0, 0 };
+  storage.write(CONFIG_CLOCK_KEY, wrongType, sizeof(wrongType));
+  ConfigStore(storage).loadClockAnchors(loaded);
+  TEST_ASSERT_EQUAL_UINT8(0, loaded.count);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_parameter_round_trips);
+  RUN_TEST(test_first_boot_migrates_from_eeprom);
+  RUN_TEST(test_reboot_reads_back_and_writes_nothing);
+  RUN_TEST(test_a_change_writes_only_its_keys);
+  RUN_TEST(test_bad_values_are_refused);
+  RUN_TEST(test_corrupted_key_is_rejected_and_rewritten);
+  RUN_TEST(test_calibration_round_trips);
+  RUN_TEST(test_boot_counter_and_clock_anchors);
+  return UNITY_END();
+}
@@ -0,0 +1,61 @@
+"""Gzip the web pages in src/ into C headers that are served straight from flash.
+
+PlatformIO runs this before every esp32dev build (extra_scripts in
+platformio.ini); it can also be run by hand:
+
+    python3 tools/embed_web_assets.py
+
+Edit the .html files, not the generated headers. A header is only rewritten
+when its content changes, so unchanged pages do not trigger a rebuild. The
+output is deterministic (no timestamp in the gzip header), so the ETag only
+changes when the page does.
+"""
+import gzip
+import hashlib
+import os
+
+# (page, generated header, symbol prefix)
+ASSETS = [
+    ("src/wifi_viewer.html", "src/wifi_viewer.h", "WIFI_HTML_PAGE"),
+    ("src/ble_viewer.html", "src/ble_viewer.h", "BLE_HTML_PAGE"),
+]
+
+
+def render_header(source, symbol, data):
+    packed = gzip.compress(data, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(data).hexdigest()[:16]
+    lines = [
+        "#pragma once",
+        "// Generated by tools/embed_web_assets.py from %s - do not edit." % source,
+        "// %d bytes, %d gzipped." % (len(data), len(packed)),
+        "#include <Arduino.h>",
+        "",
+        'const char %s_ETAG[] = "\\"%s\\"";' % (symbol, etag),
+        "const size_t %s_GZ_LEN = %d;" % (symbol, len(packed)),
+        "const uint8_t %s_GZ[] PROGMEM = {" % symbol,
+    ]
+    for i in range(0, len(packed), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def embed(root):
+    for source, header, symbol in ASSETS:
+        with open(os.path.join(root, source), "rb") as f:
+            text = render_header(source, symbol, f.read())
+        path = os.path.join(root, header)
+        if os.path.exists(path):
+            with open(path) as f:
+                if f.read() == text:
+                    continue
+        with open(path, "w") as f:
+            f.write(text)
+        print("embed_web_assets: wrote %s" % header)
+
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO
+    embed(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    embed(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))